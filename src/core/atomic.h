@@ -0,0 +1,21 @@
+#ifndef CORE_ATOMIC_H
+#define CORE_ATOMIC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Returns the value of '*ptr' before the addition.
+static int32_t core_atomicFetchAddi32(volatile int32_t* ptr, int32_t val);
+static int32_t core_atomicLoadi32(volatile const int32_t* ptr);
+static void core_atomicStorei32(volatile int32_t* ptr, int32_t val);
+
+#ifdef __cplusplus
+}
+#endif
+
+#include "inline/atomic.inl"
+
+#endif // CORE_ATOMIC_H
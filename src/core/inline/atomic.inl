@@ -0,0 +1,30 @@
+#ifndef CORE_ATOMIC_H
+#error "Must be included from atomic.h"
+#endif
+
+#include <intrin.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline int32_t core_atomicFetchAddi32(volatile int32_t* ptr, int32_t val)
+{
+	return (int32_t)_InterlockedExchangeAdd((volatile long*)ptr, (long)val);
+}
+
+static inline int32_t core_atomicLoadi32(volatile const int32_t* ptr)
+{
+	const int32_t val = *ptr;
+	_ReadWriteBarrier();
+	return val;
+}
+
+static inline void core_atomicStorei32(volatile int32_t* ptr, int32_t val)
+{
+	_InterlockedExchange((volatile long*)ptr, (long)val);
+}
+
+#ifdef __cplusplus
+}
+#endif
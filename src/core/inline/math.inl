@@ -31,6 +31,16 @@ static inline int32_t core_min3i32(int32_t a, int32_t b, int32_t c)
 	return core_mini32(a, core_mini32(b, c));
 }
 
+static inline int64_t core_maxi64(int64_t a, int64_t b)
+{
+	return a > b ? a : b;
+}
+
+static inline int64_t core_mini64(int64_t a, int64_t b)
+{
+	return a < b ? a : b;
+}
+
 static uint16_t core_minu16(uint16_t a, uint16_t b)
 {
 	return a < b ? a : b;
@@ -41,6 +51,26 @@ static uint16_t core_maxu16(uint16_t a, uint16_t b)
 	return a > b ? a : b;
 }
 
+static uint32_t core_minu32(uint32_t a, uint32_t b)
+{
+	return a < b ? a : b;
+}
+
+static uint32_t core_maxu32(uint32_t a, uint32_t b)
+{
+	return a > b ? a : b;
+}
+
+static inline float core_minf(float a, float b)
+{
+	return a < b ? a : b;
+}
+
+static inline float core_maxf(float a, float b)
+{
+	return a > b ? a : b;
+}
+
 static inline int32_t core_roundDown(int32_t x, int32_t y)
 {
 	return (x / y) * y;
@@ -71,6 +101,11 @@ static inline float core_sinf(float x)
 	return math_api->sinf(x);
 }
 
+static inline float core_sqrtf(float x)
+{
+	return math_api->sqrtf(x);
+}
+
 static inline float core_toRad(float deg)
 {
 	return (deg / 180.0f) * 3.1415926535897932384626433832795f;
@@ -126,6 +126,41 @@ static inline int32_t core_osFsCreateDirectory(core_file_base_dir baseDir, const
 	return os_api->fsCreateDirectory(baseDir, relPath);
 }
 
+static inline core_os_thread* core_osThreadCreate(core_os_thread_func func, void* userData, uint32_t stackSize, const char* name)
+{
+	return os_api->threadCreate(func, userData, stackSize, name);
+}
+
+static inline int32_t core_osThreadShutdown(core_os_thread* thread)
+{
+	return os_api->threadShutdown(thread);
+}
+
+static inline uint32_t core_osThreadGetNumHardwareThreads(void)
+{
+	return os_api->threadGetNumHardwareThreads();
+}
+
+static inline core_os_semaphore* core_osSemaphoreCreate(uint32_t initialCount)
+{
+	return os_api->semaphoreCreate(initialCount);
+}
+
+static inline void core_osSemaphoreDestroy(core_os_semaphore* sem)
+{
+	os_api->semaphoreDestroy(sem);
+}
+
+static inline void core_osSemaphoreSignal(core_os_semaphore* sem, uint32_t count)
+{
+	os_api->semaphoreSignal(sem, count);
+}
+
+static inline bool core_osSemaphoreWait(core_os_semaphore* sem, uint32_t duration_ms)
+{
+	return os_api->semaphoreWait(sem, duration_ms);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -160,6 +160,14 @@ static inline uint32_t core_utf8len(const char* str)
 	return str_api->utf8nlen(str, UINT32_MAX);
 }
 
+// Decodes the UTF-8 sequence at 'str' into 'cp' and returns the start of the next one. 
+// Invalid sequences give 0xFFFFFFFF and skip a single byte. 'cp' is 0 at the null 
+// terminator, which isn't skipped.
+static inline const char* core_utf8ToCodepoint(const char* str, uint32_t* cp)
+{
+	return str_api->utf8ToCodepoint(str, cp);
+}
+
 #ifdef __cplusplus
 }
 #endif
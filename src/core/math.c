@@ -1,16 +1,18 @@
 #include "math.h"
-#include <math.h> // sin/cos
+#include <math.h> // sin/cos/sqrt
 
 static float math_floorf(float x);
 static float math_ceilf(float x);
 static float math_cosf(float x);
 static float math_sinf(float x);
+static float math_sqrtf(float x);
 
 core_math_api* math_api = &(core_math_api){
 	.floorf = math_floorf,
 	.ceilf = math_ceilf,
 	.cosf = math_cosf,
-	.sinf = math_sinf
+	.sinf = math_sinf,
+	.sqrtf = math_sqrtf
 };
 
 static float math_floorf(float x)
@@ -38,3 +40,8 @@ static float math_sinf(float x)
 	// TODO: Replace?
 	return sinf(x);
 }
+
+static float math_sqrtf(float x)
+{
+	return sqrtf(x);
+}
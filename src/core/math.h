@@ -13,6 +13,7 @@ typedef struct core_math_api
 	float (*ceilf)(float x);
 	float (*cosf)(float x);
 	float (*sinf)(float x);
+	float (*sqrtf)(float x);
 } core_math_api;
 
 extern core_math_api* math_api;
@@ -22,8 +23,14 @@ static int32_t core_maxi32(int32_t a, int32_t b);
 static int32_t core_mini32(int32_t a, int32_t b);
 static int32_t core_max3i32(int32_t a, int32_t b, int32_t c);
 static int32_t core_min3i32(int32_t a, int32_t b, int32_t c);
+static int64_t core_maxi64(int64_t a, int64_t b);
+static int64_t core_mini64(int64_t a, int64_t b);
 static uint16_t core_minu16(uint16_t a, uint16_t b);
 static uint16_t core_maxu16(uint16_t a, uint16_t b);
+static uint32_t core_minu32(uint32_t a, uint32_t b);
+static uint32_t core_maxu32(uint32_t a, uint32_t b);
+static float core_minf(float a, float b);
+static float core_maxf(float a, float b);
 static int32_t core_roundDown(int32_t x, int32_t y);
 static int32_t core_roundUp(int32_t x, int32_t y);
 
@@ -31,6 +38,7 @@ static float core_floorf(float x);
 static float core_ceilf(float x);
 static float core_cosf(float x);
 static float core_sinf(float x);
+static float core_sqrtf(float x);
 static float core_toRad(float deg);
 static float core_toDeg(float rad);
 
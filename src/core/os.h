@@ -14,6 +14,14 @@ typedef struct core_os_timer core_os_timer;
 // Opaque type for files
 typedef struct core_os_file core_os_file;
 
+// Opaque type for threads
+typedef struct core_os_thread core_os_thread;
+
+// Opaque type for semaphores
+typedef struct core_os_semaphore core_os_semaphore;
+
+typedef int32_t (*core_os_thread_func)(void* userData);
+
 typedef enum core_file_base_dir
 {
 	CORE_FILE_BASE_DIR_ABSOLUTE_PATH = 0,
@@ -71,6 +79,20 @@ typedef struct core_os_api
 	int32_t         (*fsCopyFile)(core_file_base_dir srcBaseDir, const char* srcRelPath, core_file_base_dir dstBaseDir, const char* dstRelPath);
 	int32_t         (*fsMoveFile)(core_file_base_dir srcBaseDir, const char* srcRelPath, core_file_base_dir dstBaseDir, const char* dstRelPath);
 	int32_t         (*fsCreateDirectory)(core_file_base_dir baseDir, const char* relPath);
+
+	// Threads
+	// 'threadShutdown' waits for the thread function to return and frees the thread object.
+	core_os_thread* (*threadCreate)(core_os_thread_func func, void* userData, uint32_t stackSize, const char* name);
+	int32_t         (*threadShutdown)(core_os_thread* thread);
+	uint32_t        (*threadGetNumHardwareThreads)(void);
+
+	// Semaphores
+	// 'semaphoreWait' returns false if the semaphore wasn't signaled within 'duration_ms' milliseconds.
+	// Use UINT32_MAX to wait forever.
+	core_os_semaphore* (*semaphoreCreate)(uint32_t initialCount);
+	void            (*semaphoreDestroy)(core_os_semaphore* sem);
+	void            (*semaphoreSignal)(core_os_semaphore* sem, uint32_t count);
+	bool            (*semaphoreWait)(core_os_semaphore* sem, uint32_t duration_ms);
 } core_os_api;
 
 extern core_os_api* os_api;
@@ -104,6 +126,15 @@ static int32_t core_osFsCopyFile(core_file_base_dir srcBaseDir, const char* srcR
 static int32_t core_osFsMoveFile(core_file_base_dir srcBaseDir, const char* srcRelPath, core_file_base_dir dstBaseDir, const char* dstRelPath);
 static int32_t core_osFsCreateDirectory(core_file_base_dir baseDir, const char* relPath);
 
+static core_os_thread* core_osThreadCreate(core_os_thread_func func, void* userData, uint32_t stackSize, const char* name);
+static int32_t core_osThreadShutdown(core_os_thread* thread);
+static uint32_t core_osThreadGetNumHardwareThreads(void);
+
+static core_os_semaphore* core_osSemaphoreCreate(uint32_t initialCount);
+static void core_osSemaphoreDestroy(core_os_semaphore* sem);
+static void core_osSemaphoreSignal(core_os_semaphore* sem, uint32_t count);
+static bool core_osSemaphoreWait(core_os_semaphore* sem, uint32_t duration_ms);
+
 #ifdef __cplusplus
 }
 #endif
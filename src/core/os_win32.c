@@ -38,6 +38,13 @@ static int32_t win32_fsRemoveFile(core_file_base_dir baseDir, const char* relPat
 static int32_t win32_fsCopyFile(core_file_base_dir srcBaseDir, const char* srcRelPath, core_file_base_dir dstBaseDir, const char* dstRelPath);
 static int32_t win32_fsMoveFile(core_file_base_dir srcBaseDir, const char* srcRelPath, core_file_base_dir dstBaseDir, const char* dstRelPath);
 static int32_t win32_fsCreateDirectory(core_file_base_dir baseDir, const char* relPath);
+static core_os_thread* win32_threadCreate(core_os_thread_func func, void* userData, uint32_t stackSize, const char* name);
+static int32_t win32_threadShutdown(core_os_thread* thread);
+static uint32_t win32_threadGetNumHardwareThreads(void);
+static core_os_semaphore* win32_semaphoreCreate(uint32_t initialCount);
+static void win32_semaphoreDestroy(core_os_semaphore* sem);
+static void win32_semaphoreSignal(core_os_semaphore* sem, uint32_t count);
+static bool win32_semaphoreWait(core_os_semaphore* sem, uint32_t duration_ms);
 
 core_os_api* os_api = &(core_os_api){
 	.timerCreate = win32_timerCreate,
@@ -64,14 +71,23 @@ core_os_api* os_api = &(core_os_api){
 	.fsCopyFile = win32_fsCopyFile,
 	.fsMoveFile = win32_fsMoveFile,
 	.fsCreateDirectory = win32_fsCreateDirectory,
+	.threadCreate = win32_threadCreate,
+	.threadShutdown = win32_threadShutdown,
+	.threadGetNumHardwareThreads = win32_threadGetNumHardwareThreads,
+	.semaphoreCreate = win32_semaphoreCreate,
+	.semaphoreDestroy = win32_semaphoreDestroy,
+	.semaphoreSignal = win32_semaphoreSignal,
+	.semaphoreWait = win32_semaphoreWait,
 };
 
 typedef void (*pfnGetSystemTimePreciseAsFileTime)(LPFILETIME lpSystemTimeAsFileTime);
+typedef HRESULT (*pfnSetThreadDescription)(HANDLE hThread, PCWSTR lpThreadDescription);
 
 typedef struct core_os_win32
 {
 	core_allocator_i* m_Allocator;
 	pfnGetSystemTimePreciseAsFileTime GetSystemTimePreciseAsFileTime;
+	pfnSetThreadDescription SetThreadDescription;
 	int64_t m_TimerFreq;
 	char m_InstallDir[512];
 	char m_TempDir[512];
@@ -122,6 +138,7 @@ bool core_os_initAPI(void)
 		HMODULE kernel32 = LoadLibraryA("kernel32.dll");
 		if (kernel32) {
 			s_OSContext.GetSystemTimePreciseAsFileTime = (pfnGetSystemTimePreciseAsFileTime)GetProcAddress(kernel32, "GetSystemTimePreciseAsFileTime");
+			s_OSContext.SetThreadDescription = (pfnSetThreadDescription)GetProcAddress(kernel32, "SetThreadDescription");
 			FreeLibrary(kernel32);
 		}
 
@@ -738,4 +755,100 @@ static int32_t win32_fsCreateDirectory(core_file_base_dir baseDir, const char* r
 	return win32_createDirectory_internal(absPath);
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Threads
+//
+typedef struct core_os_thread
+{
+	HANDLE m_Handle;
+	core_os_thread_func m_Func;
+	void* m_UserData;
+} core_os_thread;
+
+static DWORD WINAPI win32_threadProc(LPVOID param)
+{
+	core_os_thread* thread = (core_os_thread*)param;
+	return (DWORD)thread->m_Func(thread->m_UserData);
+}
+
+static core_os_thread* win32_threadCreate(core_os_thread_func func, void* userData, uint32_t stackSize, const char* name)
+{
+	core_os_thread* thread = (core_os_thread*)CORE_ALLOC(s_OSContext.m_Allocator, sizeof(core_os_thread));
+	if (!thread) {
+		return NULL;
+	}
+
+	thread->m_Func = func;
+	thread->m_UserData = userData;
+	thread->m_Handle = CreateThread(NULL, (SIZE_T)stackSize, win32_threadProc, thread, CREATE_SUSPENDED, NULL);
+	if (!thread->m_Handle) {
+		CORE_FREE(s_OSContext.m_Allocator, thread);
+		return NULL;
+	}
+
+	if (name && s_OSContext.SetThreadDescription) {
+		wchar_t nameW[256];
+		if (core_utf8to_utf16((uint16_t*)nameW, CORE_COUNTOF(nameW), name, UINT32_MAX)) {
+			s_OSContext.SetThreadDescription(thread->m_Handle, nameW);
+		}
+	}
+
+	ResumeThread(thread->m_Handle);
+
+	return thread;
+}
+
+static int32_t win32_threadShutdown(core_os_thread* thread)
+{
+	if (!thread) {
+		return CORE_ERROR_INVALID_ARGUMENT;
+	}
+
+	WaitForSingleObject(thread->m_Handle, INFINITE);
+
+	DWORD exitCode = 0;
+	GetExitCodeThread(thread->m_Handle, &exitCode);
+	CloseHandle(thread->m_Handle);
+	CORE_FREE(s_OSContext.m_Allocator, thread);
+
+	return (int32_t)exitCode;
+}
+
+static uint32_t win32_threadGetNumHardwareThreads(void)
+{
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return (uint32_t)si.dwNumberOfProcessors;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Semaphores
+//
+static core_os_semaphore* win32_semaphoreCreate(uint32_t initialCount)
+{
+	HANDLE sem = CreateSemaphoreW(NULL, (LONG)initialCount, MAXLONG, NULL);
+	return (core_os_semaphore*)sem;
+}
+
+static void win32_semaphoreDestroy(core_os_semaphore* sem)
+{
+	if (sem) {
+		CloseHandle((HANDLE)sem);
+	}
+}
+
+static void win32_semaphoreSignal(core_os_semaphore* sem, uint32_t count)
+{
+	ReleaseSemaphore((HANDLE)sem, (LONG)count, NULL);
+}
+
+static bool win32_semaphoreWait(core_os_semaphore* sem, uint32_t duration_ms)
+{
+	const DWORD timeout = duration_ms == UINT32_MAX
+		? INFINITE
+		: (DWORD)duration_ms
+		;
+	return WaitForSingleObject((HANDLE)sem, timeout) == WAIT_OBJECT_0;
+}
+
 #endif // CORE_PLATFORM_WINDOWS
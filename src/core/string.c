@@ -19,6 +19,7 @@ static uint32_t str_utf8ToUtf16(uint16_t* dst, uint32_t dstMax, const char* src,
 static uint32_t str_utf8FromUtf16(char* dst, uint32_t dstMax, const uint16_t* src, uint32_t srcLen);
 static uint32_t str_utf8FromUtf32(char* dst, uint32_t dstMax, const uint32_t* src, uint32_t srcLen);
 static uint32_t str_utf8nlen(const char* str, uint32_t max);
+static const char* utf8ToCodepoint(const char* str, uint32_t* cp);
 
 core_str_api* str_api = &(core_str_api){
 	.snprintf = stbsp_snprintf,
@@ -35,7 +36,8 @@ core_str_api* str_api = &(core_str_api){
 	.utf8to_utf16 = str_utf8ToUtf16,
 	.utf8from_utf16 = str_utf8FromUtf16,
 	.utf8from_utf32 = str_utf8FromUtf32,
-	.utf8nlen = str_utf8nlen
+	.utf8nlen = str_utf8nlen,
+	.utf8ToCodepoint = utf8ToCodepoint
 };
 
 static uint32_t str_strnlen(const char* str, uint32_t max)
@@ -273,7 +275,7 @@ static const char* utf8ToCodepoint(const char* str, uint32_t* cp)
 		const uint32_t octet1 = (uint32_t)str[1];
 		if ((octet1 & 0xC0) == 0x80) {
 			const uint32_t val = 0
-				| ((octet0 & 0x0F) << 6)
+				| ((octet0 & 0x1F) << 6)
 				| ((octet1 & 0x3F) << 0)
 				;
 			if (val >= 0x00000080 && val <= 0x000007FF) {
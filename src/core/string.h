@@ -31,6 +31,7 @@ typedef struct core_str_api
 	uint32_t (*utf8from_utf16)(char* dst, uint32_t dstMax, const uint16_t* src, uint32_t srcLen);
 	uint32_t (*utf8from_utf32)(char* dstUtf8, uint32_t dstMaxChars, const uint32_t* srcUtf32, uint32_t srcLen);
 	uint32_t (*utf8nlen)(const char* str, uint32_t max);
+	const char* (*utf8ToCodepoint)(const char* str, uint32_t* cp);
 } core_str_api;
 
 extern core_str_api* str_api;
@@ -68,6 +69,7 @@ static uint32_t core_utf8from_utf16(char* dstUTF8, uint32_t dstMax, const uint16
 static uint32_t core_utf8from_utf32(char* dstUTF8, uint32_t dstMax, const uint32_t* srcUTF32, uint32_t srcLen);
 static uint32_t core_utf8nlen(const char* str, uint32_t max);
 static uint32_t core_utf8len(const char* str);
+static const char* core_utf8ToCodepoint(const char* str, uint32_t* cp);
 
 #ifdef __cplusplus
 }
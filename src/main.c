@@ -27,6 +27,7 @@ typedef struct mesh_t
 	uint32_t m_NumIndices;
 
 	float* m_PosBuffer;
+	uint16_t* m_PosBuffer16; // Same positions as m_PosBuffer in SWR_FORMAT_2US, NULL if they don't fit.
 	uint32_t* m_ColorBuffer;
 	uint32_t m_NumVertices;
 } mesh_t;
@@ -38,6 +39,7 @@ typedef struct drawcall_t
 	uint32_t m_NumIndices;
 	uint16_t m_MinIndex;
 	uint16_t m_MaxIndex;
+	swr_bvh* m_BVH;
 } drawcall_t;
 
 #ifdef _DEBUG
@@ -95,6 +97,20 @@ int32_t main(void)
 		return -1;
 	}
 
+	// Rasterize triangles on all available hardware threads. The main thread 
+	// participates in rasterization during flush so one less worker is needed.
+	const uint32_t numHardwareThreads = core_osThreadGetNumHardwareThreads();
+	if (numHardwareThreads > 1) {
+		swr->setNumWorkerThreads(swrCtx, numHardwareThreads - 1);
+	}
+
+	swr_command_list* cmdList = swr->createCommandList(allocator);
+	if (!cmdList) {
+		swr->destroyContext(allocator, swrCtx);
+		mfb_close(window);
+		return -1;
+	}
+
 	swr_font font = {
 		.m_CharData = kFont8x8_basic,
 		.m_CharWidth = 8,
@@ -111,6 +127,16 @@ int32_t main(void)
 		return -1;
 	}
 
+	// The layout is static. Build a BVH per draw call so that only the visible part 
+	// of each layer is transformed and rasterized when zoomed in.
+	for (uint32_t idc = 0; idc < numDrawCalls; ++idc) {
+		drawcall_t* dc = &drawCalls[idc];
+		dc->m_BVH = swr->createBVH(allocator, &mesh.m_PosBuffer[dc->m_BaseVertex * 2], &mesh.m_IndexBuffer[dc->m_BaseIndex], dc->m_NumIndices);
+		if (!dc->m_BVH) {
+			return -1;
+		}
+	}
+
 	int32_t* transformedVertices = (int32_t*)CORE_ALLOC(allocator, sizeof(int32_t) * 2 * mesh.m_NumVertices);
 	if (!transformedVertices) {
 		return -1;
@@ -149,17 +175,20 @@ int32_t main(void)
 			swrMatrix2DScale(&mtx, 1.0f / (8984.0f - 215.0f), 1.0f / (9808.0f - 180.0f));
 			swrMatrix2DTranslate(&mtx, -215.0f, -180.0f);
 
-			swr->setWorldToScreenTransform(swrCtx, &mtx);
-			swr->bindVertexBuffer(swrCtx, SWR_VERTEX_ATTRIB_POSITION, SWR_FORMAT_2F, 0, mesh.m_NumVertices, mesh.m_PosBuffer);
-			swr->bindVertexBuffer(swrCtx, SWR_VERTEX_ATTRIB_COLOR, SWR_FORMAT_4UB, 0, mesh.m_NumVertices, mesh.m_ColorBuffer);
-			swr->bindIndexBuffer(swrCtx, mesh.m_NumIndices, mesh.m_IndexBuffer);
+			swr->cmdReset(cmdList);
+			swr->cmdSetWorldToScreenTransform(cmdList, &mtx);
+			if (mesh.m_PosBuffer16 != NULL) {
+				swr->cmdBindVertexBuffer(cmdList, SWR_VERTEX_ATTRIB_POSITION, SWR_FORMAT_2US, 0, mesh.m_NumVertices, mesh.m_PosBuffer16);
+			} else {
+				swr->cmdBindVertexBuffer(cmdList, SWR_VERTEX_ATTRIB_POSITION, SWR_FORMAT_2F, 0, mesh.m_NumVertices, mesh.m_PosBuffer);
+			}
+			swr->cmdBindVertexBuffer(cmdList, SWR_VERTEX_ATTRIB_COLOR, SWR_FORMAT_4UB, 0, mesh.m_NumVertices, mesh.m_ColorBuffer);
 			for (uint32_t idc = 0; idc < numDrawCalls; ++idc) {
 				const drawcall_t* curDC = &drawCalls[idc];
-				const uint32_t numIndices = curDC->m_NumIndices;
-				const uint16_t startIndex = curDC->m_MinIndex;
-				const uint16_t endIndex = curDC->m_MaxIndex;
-				swr->drawPrimitives(swrCtx, SWR_PRIMITIVE_TYPE_TRIANGLE_LIST, startIndex, endIndex, numIndices, curDC->m_BaseIndex, curDC->m_BaseVertex);
+				swr->cmdDrawBVH(cmdList, curDC->m_BVH, curDC->m_BaseVertex);
 			}
+
+			swr->executeCommandList(swrCtx, cmdList);
 		}
 		const uint64_t tDelta = core_osTimeDiff(core_osTimeNow(), tStart);
 
@@ -170,6 +199,7 @@ int32_t main(void)
 		movAvgGetStats(&frameTimeAvg, &s);
 
 		char str[256];
+		char frameIDStr[32];
 		core_snprintf(str, CORE_COUNTOF(str), "Frame Time: %.2fms (min: %.2f, 25th: %.2f, med: %.2f, 75th: %.2f, max: %.2f, avg: %.2f, stddev: %.4f)", dt_ms
 			, s.m_Min
 			, s.m_Percent25
@@ -179,10 +209,13 @@ int32_t main(void)
 			, s.m_Average
 			, s.m_StdDev
 		);
-		swr->drawText(swrCtx, &font, 8, 8, str, NULL, SWR_COLOR_WHITE);
+		core_snprintf(frameIDStr, CORE_COUNTOF(frameIDStr), "Frame ID: %u\n", frameID);
 
-		core_snprintf(str, CORE_COUNTOF(str), "Frame ID: %u\n", frameID);
-		swr->drawText(swrCtx, &font, 8, 16, str, NULL, SWR_COLOR_WHITE);
+		const swr_text_run hud[] = {
+			{ .m_Str = str, .m_X = 8, .m_Y = 8, .m_Color = SWR_COLOR_WHITE },
+			{ .m_Str = frameIDStr, .m_X = 8, .m_Y = 16, .m_Color = SWR_COLOR_WHITE },
+		};
+		swr->drawTextBatch(swrCtx, &font, hud, CORE_COUNTOF(hud));
 		
 		if (frameID >= 2 * MOVING_AVG_NUM_SAMPLES) {
 			printf("zoom: %.1f, avg: %.2f, stddev: %.4f\n", zoomLevels[curZoomLevelID], s.m_Average, s.m_StdDev);
@@ -197,6 +230,11 @@ int32_t main(void)
 		}
 	} while (mfb_wait_sync(window));
 
+	for (uint32_t idc = 0; idc < numDrawCalls; ++idc) {
+		swr->destroyBVH(allocator, drawCalls[idc].m_BVH);
+	}
+
+	swr->destroyCommandList(allocator, cmdList);
 	swr->destroyContext(allocator, swrCtx);
 
 	core_allocatorDestroyAllocator(allocator);
@@ -295,10 +333,10 @@ static bool meshBuild6502(mesh_t* m, drawcall_t** drawCalls, uint32_t* numDrawCa
 				colors[vertexID] = meshColor;
 			}
 
-			// At this point vertex ID should be valid.
-			if ((vertexID - baseVertexID) > 65535) {
-				// TODO: Index cannot be larger than uint16_t
-				int a = 0;
+			// Each mesh is a separate draw call with its own base vertex and its BVH is built 
+			// from 16-bit indices (see createBVH), so its vertices must fit in 16 bits.
+			if ((vertexID - baseVertexID) > UINT16_MAX) {
+				return false;
 			}
 
 			// Add index to index buffer
@@ -327,23 +365,32 @@ static bool meshBuild6502(mesh_t* m, drawcall_t** drawCalls, uint32_t* numDrawCa
 			.m_BaseIndex = baseIndexID,
 			.m_NumIndices = numIndices - baseIndexID,
 			.m_MinIndex = minIndex,
-			.m_MaxIndex = maxIndex
+			.m_MaxIndex = maxIndex,
+			.m_BVH = NULL
 		};
 	}
 
-	// Convert vertices into pos buffer
+	// Convert vertices into pos buffers. The BVHs are built from the float positions and 
+	// the 16-bit ones are used for rendering.
 	{
 		m->m_PosBuffer = (float*)CORE_ALLOC(allocator, sizeof(float) * 2 * numVertices);
 		if (!m->m_PosBuffer) {
 			return false;
 		}
 
+		m->m_PosBuffer16 = (uint16_t*)CORE_ALLOC(allocator, sizeof(uint16_t) * 2 * numVertices);
+		if (!m->m_PosBuffer16) {
+			return false;
+		}
+
 		for (uint32_t i = 0; i < numVertices; ++i) {
 			const uint32_t segVertexCoord = vertices[i];
 			const uint16_t x = (uint16_t)((segVertexCoord & 0x0000FFFF) >> 0);
 			const uint16_t y = (uint16_t)((segVertexCoord & 0xFFFF0000) >> 16);
 			m->m_PosBuffer[i * 2 + 0] = (float)x;
 			m->m_PosBuffer[i * 2 + 1] = (float)y;
+			m->m_PosBuffer16[i * 2 + 0] = x;
+			m->m_PosBuffer16[i * 2 + 1] = y;
 		}
 	}
 
@@ -661,6 +708,7 @@ static bool meshLoadRenderDocBuffers(mesh_t* m, core_file_base_dir baseDir, cons
 	if (!m->m_PosBuffer) {
 		return false;
 	}
+	m->m_PosBuffer16 = NULL;
 
 	m->m_ColorBuffer = (uint32_t*)CORE_ALLOC(allocator, sizeof(uint32_t) * (maxIndex + 1));
 	if (!m->m_ColorBuffer) {
@@ -19,6 +19,12 @@ static __forceinline vec4f vec4f_fromVec4i(vec4i x)
 	return VEC4F(_mm_cvtepi32_ps(x.m_IMM));
 }
 
+// Reinterprets the bits of x as floats.
+static __forceinline vec4f vec4f_fromVec4i_bits(vec4i x)
+{
+	return VEC4F(_mm_castsi128_ps(x.m_IMM));
+}
+
 static __forceinline vec4f vec4f_fromVec8f_low(vec8f x)
 {
 	return VEC4F(_mm256_extractf128_ps(x.m_YMM, 0));
@@ -44,6 +50,16 @@ static __forceinline vec4f vec4f_fromFloat4vu(const float* arr)
 	return VEC4F(_mm_loadu_ps(arr));
 }
 
+static __forceinline void vec4f_toFloat4va(vec4f x, float* arr)
+{
+	_mm_store_ps(arr, x.m_XMM);
+}
+
+static __forceinline void vec4f_toFloat4vu(vec4f x, float* arr)
+{
+	_mm_storeu_ps(arr, x.m_XMM);
+}
+
 static __forceinline vec4f vec4f_fromRGBA8(uint32_t rgba8)
 {
 	const __m128i imm_zero = _mm_setzero_si128();
@@ -77,6 +93,16 @@ static __forceinline vec4f vec4f_mul(vec4f a, vec4f b)
 	return VEC4F(_mm_mul_ps(a.m_XMM, b.m_XMM));
 }
 
+static __forceinline vec4f vec4f_min(vec4f a, vec4f b)
+{
+	return VEC4F(_mm_min_ps(a.m_XMM, b.m_XMM));
+}
+
+static __forceinline vec4f vec4f_max(vec4f a, vec4f b)
+{
+	return VEC4F(_mm_max_ps(a.m_XMM, b.m_XMM));
+}
+
 // http://dss.stephanierct.com/DevBlog/?p=8
 static vec4f vec4f_floor(vec4f x)
 {
@@ -152,6 +178,11 @@ static __forceinline vec4i vec4i_fromVec4f(vec4f x)
 	return VEC4I(_mm_cvtps_epi32(x.m_XMM));
 }
 
+static __forceinline vec4i vec4i_fromVec4f_trunc(vec4f x)
+{
+	return VEC4I(_mm_cvttps_epi32(x.m_XMM));
+}
+
 static __forceinline vec4i vec4i_fromInt4(int32_t x0, int32_t x1, int32_t x2, int32_t x3)
 {
 	return VEC4I(_mm_set_epi32(x3, x2, x1, x0));
@@ -162,16 +193,44 @@ static __forceinline vec4i vec4i_fromInt4va(const int32_t* arr)
 	return VEC4I(_mm_load_si128((const __m128i*)arr));
 }
 
+static __forceinline vec4i vec4i_fromInt4vu(const int32_t* arr)
+{
+	return VEC4I(_mm_loadu_si128((const __m128i*)arr));
+}
+
+// Zero extends 4 unsigned 16-bit integers.
+static __forceinline vec4i vec4i_fromUint16x4vu(const uint16_t* arr)
+{
+	return VEC4I(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)arr)));
+}
+
+// Zero extends 4 unsigned 8-bit integers.
+static __forceinline vec4i vec4i_fromUint8x4vu(const uint8_t* arr)
+{
+	return VEC4I(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int32_t*)arr)));
+}
+
 static __forceinline void vec4i_toInt4vu(vec4i x, int32_t* arr)
 {
 	_mm_storeu_si128((__m128i*)arr, x.m_IMM);
 }
 
+// Stores the 8 lanes of a and b, which must be in the range [0, 65535], as unsigned 16-bit integers.
+static __forceinline void vec4i_toUint16x8vu(vec4i a, vec4i b, uint16_t* arr)
+{
+	_mm_storeu_si128((__m128i*)arr, _mm_packus_epi32(a.m_IMM, b.m_IMM));
+}
+
 static __forceinline void vec4i_toInt4va(vec4i x, int32_t* arr)
 {
 	_mm_store_si128((__m128i*)arr, x.m_IMM);
 }
 
+static __forceinline void vec4i_toInt4va_stream(vec4i x, int32_t* arr)
+{
+	_mm_stream_si128((__m128i*)arr, x.m_IMM);
+}
+
 static __forceinline void vec4i_toInt4va_masked(vec4i x, vec4i mask, int32_t* buffer)
 {
 	// TODO: _mm_maskstore_epi32?
@@ -262,6 +321,21 @@ static __forceinline vec4i vec4i_cmplt(vec4i a, vec4i b)
 	return VEC4I(_mm_cmplt_epi32(a.m_IMM, b.m_IMM));
 }
 
+static __forceinline vec4i vec4i_cmpeq(vec4i a, vec4i b)
+{
+	return VEC4I(_mm_cmpeq_epi32(a.m_IMM, b.m_IMM));
+}
+
+static __forceinline vec4i vec4i_min(vec4i a, vec4i b)
+{
+	return VEC4I(_mm_min_epi32(a.m_IMM, b.m_IMM));
+}
+
+static __forceinline vec4i vec4i_max(vec4i a, vec4i b)
+{
+	return VEC4I(_mm_max_epi32(a.m_IMM, b.m_IMM));
+}
+
 static __forceinline vec4i vec4i_packR32G32B32A32_to_RGBA8(vec4i r, vec4i g, vec4i b, vec4i a)
 {
 	const __m128i mask = _mm_set_epi8(15, 11, 7, 3, 14, 10, 6, 2, 13, 9, 5, 1, 12, 8, 4, 0);
@@ -275,6 +349,109 @@ static __forceinline vec4i vec4i_packR32G32B32A32_to_RGBA8(vec4i r, vec4i g, vec
 	return VEC4I(imm_rgba_p0123_u8);
 }
 
+// Per-channel x / 255 of 16-bit products, rounded to nearest: (t + (t >> 8)) >> 8 with t = x + 128.
+// Same as swrBlendColor().
+static __forceinline vec4i vec4i_blendSrcOverRGBA8(vec4i src, vec4i dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i imm_128_u16 = _mm_set1_epi16(128);
+	const __m128i imm_255_u16 = _mm_set1_epi16(255);
+
+	// (uint16_t){ r0, g0, b0, a0, r1, g1, b1, a1 } / (uint16_t){ r2, g2, b2, a2, r3, g3, b3, a3 }
+	const __m128i src_p01_u16 = _mm_unpacklo_epi8(src.m_IMM, zero);
+	const __m128i src_p23_u16 = _mm_unpackhi_epi8(src.m_IMM, zero);
+	const __m128i dst_p01_u16 = _mm_unpacklo_epi8(dst.m_IMM, zero);
+	const __m128i dst_p23_u16 = _mm_unpackhi_epi8(dst.m_IMM, zero);
+	const __m128i alphaMask_p01 = _mm_set_epi8(-1, 7, -1, 7, -1, 7, -1, 7, -1, 3, -1, 3, -1, 3, -1, 3);
+	const __m128i alphaMask_p23 = _mm_set_epi8(-1, 15, -1, 15, -1, 15, -1, 15, -1, 11, -1, 11, -1, 11, -1, 11);
+
+	// (uint16_t){ a0, a0, a0, a0, a1, a1, a1, a1 } / (uint16_t){ a2, a2, a2, a2, a3, a3, a3, a3 }
+	const __m128i alpha_p01_u16 = _mm_shuffle_epi8(src.m_IMM, alphaMask_p01);
+	const __m128i alpha_p23_u16 = _mm_shuffle_epi8(src.m_IMM, alphaMask_p23);
+
+	// src * a + dst * (255 - a) + 128 fits in 16 bits.
+	const __m128i t_p01_u16 = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(src_p01_u16, alpha_p01_u16), _mm_mullo_epi16(dst_p01_u16, _mm_sub_epi16(imm_255_u16, alpha_p01_u16))), imm_128_u16);
+	const __m128i t_p23_u16 = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(src_p23_u16, alpha_p23_u16), _mm_mullo_epi16(dst_p23_u16, _mm_sub_epi16(imm_255_u16, alpha_p23_u16))), imm_128_u16);
+	const __m128i res_p01_u16 = _mm_srli_epi16(_mm_add_epi16(t_p01_u16, _mm_srli_epi16(t_p01_u16, 8)), 8);
+	const __m128i res_p23_u16 = _mm_srli_epi16(_mm_add_epi16(t_p23_u16, _mm_srli_epi16(t_p23_u16, 8)), 8);
+
+	return VEC4I(_mm_packus_epi16(res_p01_u16, res_p23_u16));
+}
+
+static __forceinline vec4i vec4i_blendAddRGBA8(vec4i src, vec4i dst)
+{
+	return VEC4I(_mm_adds_epu8(src.m_IMM, dst.m_IMM));
+}
+
+static __forceinline vec4i vec4i_blendMulRGBA8(vec4i src, vec4i dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i imm_128_u16 = _mm_set1_epi16(128);
+
+	const __m128i t_p01_u16 = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(src.m_IMM, zero), _mm_unpacklo_epi8(dst.m_IMM, zero)), imm_128_u16);
+	const __m128i t_p23_u16 = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(src.m_IMM, zero), _mm_unpackhi_epi8(dst.m_IMM, zero)), imm_128_u16);
+	const __m128i res_p01_u16 = _mm_srli_epi16(_mm_add_epi16(t_p01_u16, _mm_srli_epi16(t_p01_u16, 8)), 8);
+	const __m128i res_p23_u16 = _mm_srli_epi16(_mm_add_epi16(t_p23_u16, _mm_srli_epi16(t_p23_u16, 8)), 8);
+
+	return VEC4I(_mm_packus_epi16(res_p01_u16, res_p23_u16));
+}
+
+// Bilinear filtering of 4 RGBA8 texels per lane. 'fx' and 'fy' are the fractional 
+// positions ([0, 255]) between c00/c10 and c00/c01 respectively. The 4 weights are in 
+// 1/256 units and always sum to 256 so each weighted channel sum fits in 16 bits. 
+// Even and odd channels are filtered in the low and high byte of 16-bit lanes.
+static __forceinline vec4i vec4i_bilerpRGBA8(vec4i c00, vec4i c10, vec4i c01, vec4i c11, vec4i fx, vec4i fy)
+{
+	const __m128i mask = _mm_set1_epi32(0x00FF00FF);
+
+	const __m128i w11 = _mm_srli_epi32(_mm_mullo_epi16(fx.m_IMM, fy.m_IMM), 8);
+	const __m128i w10 = _mm_sub_epi32(fx.m_IMM, w11);
+	const __m128i w01 = _mm_sub_epi32(fy.m_IMM, w11);
+	const __m128i w00 = _mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(_mm_set1_epi32(256), w11), fx.m_IMM), fy.m_IMM);
+
+	// Replicate the weights to both 16-bit halves of each lane.
+	const __m128i w00_u16 = _mm_or_si128(w00, _mm_slli_epi32(w00, 16));
+	const __m128i w10_u16 = _mm_or_si128(w10, _mm_slli_epi32(w10, 16));
+	const __m128i w01_u16 = _mm_or_si128(w01, _mm_slli_epi32(w01, 16));
+	const __m128i w11_u16 = _mm_or_si128(w11, _mm_slli_epi32(w11, 16));
+
+	const __m128i even_u16 = _mm_add_epi16(
+		_mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(c00.m_IMM, mask), w00_u16), _mm_mullo_epi16(_mm_and_si128(c10.m_IMM, mask), w10_u16)),
+		_mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(c01.m_IMM, mask), w01_u16), _mm_mullo_epi16(_mm_and_si128(c11.m_IMM, mask), w11_u16))
+	);
+	const __m128i odd_u16 = _mm_add_epi16(
+		_mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(c00.m_IMM, 8), w00_u16), _mm_mullo_epi16(_mm_srli_epi16(c10.m_IMM, 8), w10_u16)),
+		_mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(c01.m_IMM, 8), w01_u16), _mm_mullo_epi16(_mm_srli_epi16(c11.m_IMM, 8), w11_u16))
+	);
+
+	return VEC4I(_mm_or_si128(_mm_srli_epi16(even_u16, 8), _mm_andnot_si128(mask, odd_u16)));
+}
+
+static __forceinline vec4i vec4i_gather(const int32_t* base, vec4i index)
+{
+#if defined(SWR_VEC_MATH_AVX2)
+	return VEC4I(_mm_i32gather_epi32(base, index.m_IMM, 4));
+#else
+	const int32_t i0 = _mm_cvtsi128_si32(index.m_IMM);
+	const int32_t i1 = _mm_extract_epi32(index.m_IMM, 1);
+	const int32_t i2 = _mm_extract_epi32(index.m_IMM, 2);
+	const int32_t i3 = _mm_extract_epi32(index.m_IMM, 3);
+	return VEC4I(_mm_setr_epi32(base[i0], base[i1], base[i2], base[i3]));
+#endif
+}
+
+// Lanes 0 and 2 of 'a' followed by lanes 0 and 2 of 'b', i.e. the even lanes of the 
+// 8-lane vector (a, b).
+static __forceinline vec4i vec4i_evenLanes(vec4i a, vec4i b)
+{
+	return VEC4I(_mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a.m_IMM), _mm_castsi128_ps(b.m_IMM), _MM_SHUFFLE(2, 0, 2, 0))));
+}
+
+static __forceinline vec4i vec4i_oddLanes(vec4i a, vec4i b)
+{
+	return VEC4I(_mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a.m_IMM), _mm_castsi128_ps(b.m_IMM), _MM_SHUFFLE(3, 1, 3, 1))));
+}
+
 static __forceinline bool vec4i_anyNegative(vec4i x)
 {
 	return (_mm_movemask_epi8(x.m_IMM) & 0x8888) != 0;
@@ -294,6 +471,8 @@ static __forceinline uint32_t vec4i_getSignMask(vec4i x)
 	return _mm_movemask_ps(_mm_castsi128_ps(x.m_IMM));
 }
 
+#define vec4i_shuffle(a, b, mask) (vec4i){ .m_IMM = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a.m_IMM), _mm_castsi128_ps(b.m_IMM), mask)) }
+
 #define VEC4I_GET_FUNC(swizzle) \
 static __forceinline vec4i vec4i_get##swizzle(vec4i x) \
 { \
@@ -346,6 +525,30 @@ static __forceinline vec8f vec8f_fromVec8i(vec8i x)
 	return VEC8F(_mm256_cvtepi32_ps(x.m_YMM));
 }
 
+// Converts the 8 signed 16-bit integers of x to floats.
+static __forceinline vec8f vec8f_fromInt16x8(vec4i x)
+{
+	const __m128i lo = _mm_cvtepi16_epi32(x.m_IMM);
+	const __m128i hi = _mm_cvtepi16_epi32(_mm_srli_si128(x.m_IMM, 8));
+	return VEC8F(_mm256_cvtepi32_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1)));
+}
+
+// Converts the 8 unsigned 16-bit integers of x to floats.
+static __forceinline vec8f vec8f_fromUint16x8(vec4i x)
+{
+	const __m128i lo = _mm_cvtepu16_epi32(x.m_IMM);
+	const __m128i hi = _mm_cvtepu16_epi32(_mm_srli_si128(x.m_IMM, 8));
+	return VEC8F(_mm256_cvtepi32_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1)));
+}
+
+#if defined(SWR_VEC_MATH_F16C)
+// Converts the 8 half-precision floats of x to floats.
+static __forceinline vec8f vec8f_fromHalf8(vec4i x)
+{
+	return VEC8F(_mm256_cvtph_ps(x.m_IMM));
+}
+#endif
+
 static __forceinline vec8f vec8f_fromFloat8(float x0, float x1, float x2, float x3, float x4, float x5, float x6, float x7)
 {
 	return VEC8F(_mm256_set_ps(x7, x6, x5, x4, x3, x2, x1, x0));
@@ -361,6 +564,16 @@ static __forceinline vec8f vec8f_fromFloat8vu(const float* arr)
 	return VEC8F(_mm256_loadu_ps(arr));
 }
 
+static __forceinline void vec8f_toFloat8va(vec8f x, float* arr)
+{
+	_mm256_store_ps(arr, x.m_YMM);
+}
+
+static __forceinline void vec8f_toFloat8vu(vec8f x, float* arr)
+{
+	_mm256_storeu_ps(arr, x.m_YMM);
+}
+
 static __forceinline vec8f vec8f_add(vec8f a, vec8f b)
 {
 	return VEC8F(_mm256_add_ps(a.m_YMM, b.m_YMM));
@@ -376,6 +589,16 @@ static __forceinline vec8f vec8f_mul(vec8f a, vec8f b)
 	return VEC8F(_mm256_mul_ps(a.m_YMM, b.m_YMM));
 }
 
+static __forceinline vec8f vec8f_min(vec8f a, vec8f b)
+{
+	return VEC8F(_mm256_min_ps(a.m_YMM, b.m_YMM));
+}
+
+static __forceinline vec8f vec8f_max(vec8f a, vec8f b)
+{
+	return VEC8F(_mm256_max_ps(a.m_YMM, b.m_YMM));
+}
+
 static __forceinline vec8f vec8f_floor(vec8f x)
 {
 	return VEC8F(_mm256_round_ps(x.m_YMM, _MM_FROUND_FLOOR));
@@ -416,6 +639,11 @@ static __forceinline vec8i vec8i_fromVec8f(vec8f x)
 	return VEC8I(_mm256_cvtps_epi32(x.m_YMM));
 }
 
+static __forceinline vec8i vec8i_fromVec8f_trunc(vec8f x)
+{
+	return VEC8I(_mm256_cvttps_epi32(x.m_YMM));
+}
+
 static __forceinline vec8i vec8i_fromInt8(int32_t x0, int32_t x1, int32_t x2, int32_t x3, int32_t x4, int32_t x5, int32_t x6, int32_t x7)
 {
 	return VEC8I(_mm256_set_epi32(x7, x6, x5, x4, x3, x2, x1, x0));
@@ -426,6 +654,11 @@ static __forceinline vec8i vec8i_fromInt8va(const int32_t* arr)
 	return VEC8I(_mm256_load_si256((const __m256i*)arr));
 }
 
+static __forceinline vec8i vec8i_fromInt8vu(const int32_t* arr)
+{
+	return VEC8I(_mm256_loadu_si256((const __m256i*)arr));
+}
+
 static __forceinline void vec8i_toInt8vu(vec8i x, int32_t* arr)
 {
 	_mm256_storeu_si256((__m256i*)arr, x.m_YMM);
@@ -436,6 +669,11 @@ static __forceinline void vec8i_toInt8va(vec8i x, int32_t* arr)
 	_mm256_store_si256((__m256i*)arr, x.m_YMM);
 }
 
+static __forceinline void vec8i_toInt8va_stream(vec8i x, int32_t* arr)
+{
+	_mm256_stream_si256((__m256i*)arr, x.m_YMM);
+}
+
 #if defined(SWR_VEC_MATH_AVX2)
 static __forceinline void vec8i_toInt8va_masked(vec8i x, vec8i mask, int32_t* buffer)
 {
@@ -558,6 +796,16 @@ static __forceinline vec8i vec8i_cmpeq(vec8i a, vec8i b)
 	return VEC8I(_mm256_cmpeq_epi32(a.m_YMM, b.m_YMM));
 }
 
+static __forceinline vec8i vec8i_min(vec8i a, vec8i b)
+{
+	return VEC8I(_mm256_min_epi32(a.m_YMM, b.m_YMM));
+}
+
+static __forceinline vec8i vec8i_max(vec8i a, vec8i b)
+{
+	return VEC8I(_mm256_max_epi32(a.m_YMM, b.m_YMM));
+}
+
 static __forceinline vec8i vec8i_packR32G32B32A32_to_RGBA8(vec8i r, vec8i g, vec8i b, vec8i a)
 {
 #if 0
@@ -609,6 +857,100 @@ static __forceinline vec8i vec8i_packR32G32B32A32_to_RGBA8(vec8i r, vec8i g, vec
 	return VEC8I(_mm256_shuffle_epi8(r03_g03_b03_a03_r47_g47_b47_a47_u8, _mm256_load_si256((const __m256i*)mask_u8)));
 #endif
 }
+
+// See vec4i_blendSrcOverRGBA8(). Unpacking and packing stays within 128-bit lanes so 
+// the pixel order is preserved.
+static __forceinline vec8i vec8i_blendSrcOverRGBA8(vec8i src, vec8i dst)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i imm_128_u16 = _mm256_set1_epi16(128);
+	const __m256i imm_255_u16 = _mm256_set1_epi16(255);
+	const __m256i alphaMask_lo = _mm256_set_epi8(
+		-1, 7, -1, 7, -1, 7, -1, 7, -1, 3, -1, 3, -1, 3, -1, 3,
+		-1, 7, -1, 7, -1, 7, -1, 7, -1, 3, -1, 3, -1, 3, -1, 3
+	);
+	const __m256i alphaMask_hi = _mm256_set_epi8(
+		-1, 15, -1, 15, -1, 15, -1, 15, -1, 11, -1, 11, -1, 11, -1, 11,
+		-1, 15, -1, 15, -1, 15, -1, 15, -1, 11, -1, 11, -1, 11, -1, 11
+	);
+
+	const __m256i src_lo_u16 = _mm256_unpacklo_epi8(src.m_YMM, zero);
+	const __m256i src_hi_u16 = _mm256_unpackhi_epi8(src.m_YMM, zero);
+	const __m256i dst_lo_u16 = _mm256_unpacklo_epi8(dst.m_YMM, zero);
+	const __m256i dst_hi_u16 = _mm256_unpackhi_epi8(dst.m_YMM, zero);
+	const __m256i alpha_lo_u16 = _mm256_shuffle_epi8(src.m_YMM, alphaMask_lo);
+	const __m256i alpha_hi_u16 = _mm256_shuffle_epi8(src.m_YMM, alphaMask_hi);
+
+	const __m256i t_lo_u16 = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(src_lo_u16, alpha_lo_u16), _mm256_mullo_epi16(dst_lo_u16, _mm256_sub_epi16(imm_255_u16, alpha_lo_u16))), imm_128_u16);
+	const __m256i t_hi_u16 = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(src_hi_u16, alpha_hi_u16), _mm256_mullo_epi16(dst_hi_u16, _mm256_sub_epi16(imm_255_u16, alpha_hi_u16))), imm_128_u16);
+	const __m256i res_lo_u16 = _mm256_srli_epi16(_mm256_add_epi16(t_lo_u16, _mm256_srli_epi16(t_lo_u16, 8)), 8);
+	const __m256i res_hi_u16 = _mm256_srli_epi16(_mm256_add_epi16(t_hi_u16, _mm256_srli_epi16(t_hi_u16, 8)), 8);
+
+	return VEC8I(_mm256_packus_epi16(res_lo_u16, res_hi_u16));
+}
+
+static __forceinline vec8i vec8i_blendAddRGBA8(vec8i src, vec8i dst)
+{
+	return VEC8I(_mm256_adds_epu8(src.m_YMM, dst.m_YMM));
+}
+
+static __forceinline vec8i vec8i_blendMulRGBA8(vec8i src, vec8i dst)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i imm_128_u16 = _mm256_set1_epi16(128);
+
+	const __m256i t_lo_u16 = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(src.m_YMM, zero), _mm256_unpacklo_epi8(dst.m_YMM, zero)), imm_128_u16);
+	const __m256i t_hi_u16 = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(src.m_YMM, zero), _mm256_unpackhi_epi8(dst.m_YMM, zero)), imm_128_u16);
+	const __m256i res_lo_u16 = _mm256_srli_epi16(_mm256_add_epi16(t_lo_u16, _mm256_srli_epi16(t_lo_u16, 8)), 8);
+	const __m256i res_hi_u16 = _mm256_srli_epi16(_mm256_add_epi16(t_hi_u16, _mm256_srli_epi16(t_hi_u16, 8)), 8);
+
+	return VEC8I(_mm256_packus_epi16(res_lo_u16, res_hi_u16));
+}
+
+// See vec4i_bilerpRGBA8().
+static __forceinline vec8i vec8i_bilerpRGBA8(vec8i c00, vec8i c10, vec8i c01, vec8i c11, vec8i fx, vec8i fy)
+{
+	const __m256i mask = _mm256_set1_epi32(0x00FF00FF);
+
+	const __m256i w11 = _mm256_srli_epi32(_mm256_mullo_epi16(fx.m_YMM, fy.m_YMM), 8);
+	const __m256i w10 = _mm256_sub_epi32(fx.m_YMM, w11);
+	const __m256i w01 = _mm256_sub_epi32(fy.m_YMM, w11);
+	const __m256i w00 = _mm256_sub_epi32(_mm256_sub_epi32(_mm256_add_epi32(_mm256_set1_epi32(256), w11), fx.m_YMM), fy.m_YMM);
+
+	const __m256i w00_u16 = _mm256_or_si256(w00, _mm256_slli_epi32(w00, 16));
+	const __m256i w10_u16 = _mm256_or_si256(w10, _mm256_slli_epi32(w10, 16));
+	const __m256i w01_u16 = _mm256_or_si256(w01, _mm256_slli_epi32(w01, 16));
+	const __m256i w11_u16 = _mm256_or_si256(w11, _mm256_slli_epi32(w11, 16));
+
+	const __m256i even_u16 = _mm256_add_epi16(
+		_mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(c00.m_YMM, mask), w00_u16), _mm256_mullo_epi16(_mm256_and_si256(c10.m_YMM, mask), w10_u16)),
+		_mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(c01.m_YMM, mask), w01_u16), _mm256_mullo_epi16(_mm256_and_si256(c11.m_YMM, mask), w11_u16))
+	);
+	const __m256i odd_u16 = _mm256_add_epi16(
+		_mm256_add_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(c00.m_YMM, 8), w00_u16), _mm256_mullo_epi16(_mm256_srli_epi16(c10.m_YMM, 8), w10_u16)),
+		_mm256_add_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(c01.m_YMM, 8), w01_u16), _mm256_mullo_epi16(_mm256_srli_epi16(c11.m_YMM, 8), w11_u16))
+	);
+
+	return VEC8I(_mm256_or_si256(_mm256_srli_epi16(even_u16, 8), _mm256_andnot_si256(mask, odd_u16)));
+}
+
+static __forceinline vec8i vec8i_gather(const int32_t* base, vec8i index)
+{
+	return VEC8I(_mm256_i32gather_epi32(base, index.m_YMM, 4));
+}
+
+// Even lanes of the 16-lane vector (a, b). See vec4i_evenLanes().
+static __forceinline vec8i vec8i_evenLanes(vec8i a, vec8i b)
+{
+	const __m256 ab = _mm256_shuffle_ps(_mm256_castsi256_ps(a.m_YMM), _mm256_castsi256_ps(b.m_YMM), _MM_SHUFFLE(2, 0, 2, 0));
+	return VEC8I(_mm256_permute4x64_epi64(_mm256_castps_si256(ab), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+static __forceinline vec8i vec8i_oddLanes(vec8i a, vec8i b)
+{
+	const __m256 ab = _mm256_shuffle_ps(_mm256_castsi256_ps(a.m_YMM), _mm256_castsi256_ps(b.m_YMM), _MM_SHUFFLE(3, 1, 3, 1));
+	return VEC8I(_mm256_permute4x64_epi64(_mm256_castps_si256(ab), _MM_SHUFFLE(3, 1, 2, 0)));
+}
 #endif // defined(SWR_VEC_MATH_AVX2)
 
 static __forceinline bool vec8i_anyNegative(vec8i x)
@@ -19,11 +19,34 @@ static inline vec4f vec4f_fromVec4i(vec4i x)
 	return VEC4F((float)x.m_Elem[0], (float)x.m_Elem[1], (float)x.m_Elem[2], (float)x.m_Elem[3]);
 }
 
+// Reinterprets the bits of x as floats.
+static inline vec4f vec4f_fromVec4i_bits(vec4i x)
+{
+	union { int32_t i[4]; float f[4]; } bits;
+	for (uint32_t j = 0; j < 4; ++j) {
+		bits.i[j] = x.m_Elem[j];
+	}
+	return VEC4F(bits.f[0], bits.f[1], bits.f[2], bits.f[3]);
+}
+
 static inline vec4f vec4f_fromFloat4(float x0, float x1, float x2, float x3)
 {
 	return VEC4F(x0, x1, x2, x3);
 }
 
+static inline void vec4f_toFloat4va(vec4f x, float* arr)
+{
+	arr[0] = x.m_Elem[0];
+	arr[1] = x.m_Elem[1];
+	arr[2] = x.m_Elem[2];
+	arr[3] = x.m_Elem[3];
+}
+
+static inline void vec4f_toFloat4vu(vec4f x, float* arr)
+{
+	vec4f_toFloat4va(x, arr);
+}
+
 static inline vec4f vec4f_fromRGBA8(uint32_t rgba8)
 {
 	return VEC4F((float)((rgba8 & 0xFF000000u) >> 24), (float)((rgba8 & 0x00FF0000u) >> 16), (float)((rgba8 & 0x0000FF00u) >> 8), (float)((rgba8 & 0x000000FFu) >> 0));
@@ -54,6 +77,16 @@ static inline vec4f vec4f_mul(vec4f a, vec4f b)
 	return VEC4F(a.m_Elem[0] * b.m_Elem[0], a.m_Elem[1] * b.m_Elem[1], a.m_Elem[2] * b.m_Elem[2], a.m_Elem[3] * b.m_Elem[3]);
 }
 
+static inline vec4f vec4f_min(vec4f a, vec4f b)
+{
+	return VEC4F((a.m_Elem[0] < b.m_Elem[0]) ? a.m_Elem[0] : b.m_Elem[0], (a.m_Elem[1] < b.m_Elem[1]) ? a.m_Elem[1] : b.m_Elem[1], (a.m_Elem[2] < b.m_Elem[2]) ? a.m_Elem[2] : b.m_Elem[2], (a.m_Elem[3] < b.m_Elem[3]) ? a.m_Elem[3] : b.m_Elem[3]);
+}
+
+static inline vec4f vec4f_max(vec4f a, vec4f b)
+{
+	return VEC4F((a.m_Elem[0] > b.m_Elem[0]) ? a.m_Elem[0] : b.m_Elem[0], (a.m_Elem[1] > b.m_Elem[1]) ? a.m_Elem[1] : b.m_Elem[1], (a.m_Elem[2] > b.m_Elem[2]) ? a.m_Elem[2] : b.m_Elem[2], (a.m_Elem[3] > b.m_Elem[3]) ? a.m_Elem[3] : b.m_Elem[3]);
+}
+
 static vec4f vec4f_floor(vec4f x)
 {
 	return VEC4F(core_floorf(x.m_Elem[0]), core_floorf(x.m_Elem[1]), core_floorf(x.m_Elem[2]), core_floorf(x.m_Elem[3]));
@@ -130,6 +163,11 @@ static inline vec4i vec4i_fromVec4f(vec4f x)
 	return VEC4I((int32_t)x.m_Elem[0], (int32_t)x.m_Elem[1], (int32_t)x.m_Elem[2], (int32_t)x.m_Elem[3]);
 }
 
+static inline vec4i vec4i_fromVec4f_trunc(vec4f x)
+{
+	return VEC4I((int32_t)x.m_Elem[0], (int32_t)x.m_Elem[1], (int32_t)x.m_Elem[2], (int32_t)x.m_Elem[3]);
+}
+
 static inline vec4i vec4i_fromInt4(int32_t x0, int32_t x1, int32_t x2, int32_t x3)
 {
 	return VEC4I(x0, x1, x2, x3);
@@ -140,6 +178,23 @@ static inline vec4i vec4i_fromInt4va(const int32_t* arr)
 	return VEC4I(arr[0], arr[1], arr[2], arr[3]);
 }
 
+static inline vec4i vec4i_fromInt4vu(const int32_t* arr)
+{
+	return VEC4I(arr[0], arr[1], arr[2], arr[3]);
+}
+
+// Zero extends 4 unsigned 16-bit integers.
+static inline vec4i vec4i_fromUint16x4vu(const uint16_t* arr)
+{
+	return VEC4I(arr[0], arr[1], arr[2], arr[3]);
+}
+
+// Zero extends 4 unsigned 8-bit integers.
+static inline vec4i vec4i_fromUint8x4vu(const uint8_t* arr)
+{
+	return VEC4I(arr[0], arr[1], arr[2], arr[3]);
+}
+
 static inline void vec4i_toInt4vu(vec4i x, int32_t* arr)
 {
 	arr[0] = x.m_Elem[0];
@@ -148,6 +203,15 @@ static inline void vec4i_toInt4vu(vec4i x, int32_t* arr)
 	arr[3] = x.m_Elem[3];
 }
 
+// Stores the 8 lanes of a and b, which must be in the range [0, 65535], as unsigned 16-bit integers.
+static inline void vec4i_toUint16x8vu(vec4i a, vec4i b, uint16_t* arr)
+{
+	for (uint32_t i = 0; i < 4; ++i) {
+		arr[i] = (uint16_t)a.m_Elem[i];
+		arr[i + 4] = (uint16_t)b.m_Elem[i];
+	}
+}
+
 static inline void vec4i_toInt4va(vec4i x, int32_t* arr)
 {
 	arr[0] = x.m_Elem[0];
@@ -156,6 +220,11 @@ static inline void vec4i_toInt4va(vec4i x, int32_t* arr)
 	arr[3] = x.m_Elem[3];
 }
 
+static inline void vec4i_toInt4va_stream(vec4i x, int32_t* arr)
+{
+	vec4i_toInt4va(x, arr);
+}
+
 static inline void vec4i_toInt4va_masked(vec4i x, vec4i mask, int32_t* buffer)
 {
 	buffer[0] = (int32_t)((~(uint32_t)mask.m_Elem[0] & (uint32_t)buffer[0]) | ((uint32_t)mask.m_Elem[0] & (uint32_t)x.m_Elem[0]));
@@ -232,6 +301,21 @@ static inline vec4i vec4i_cmplt(vec4i a, vec4i b)
 	return VEC4I((a.m_Elem[0] < b.m_Elem[0]) ? 0xFFFFFFFF : 0, (a.m_Elem[1] < b.m_Elem[1]) ? 0xFFFFFFFF : 0, (a.m_Elem[2] < b.m_Elem[2]) ? 0xFFFFFFFF : 0, (a.m_Elem[3] < b.m_Elem[3]) ? 0xFFFFFFFF : 0);
 }
 
+static inline vec4i vec4i_cmpeq(vec4i a, vec4i b)
+{
+	return VEC4I((a.m_Elem[0] == b.m_Elem[0]) ? 0xFFFFFFFF : 0, (a.m_Elem[1] == b.m_Elem[1]) ? 0xFFFFFFFF : 0, (a.m_Elem[2] == b.m_Elem[2]) ? 0xFFFFFFFF : 0, (a.m_Elem[3] == b.m_Elem[3]) ? 0xFFFFFFFF : 0);
+}
+
+static inline vec4i vec4i_min(vec4i a, vec4i b)
+{
+	return VEC4I((a.m_Elem[0] < b.m_Elem[0]) ? a.m_Elem[0] : b.m_Elem[0], (a.m_Elem[1] < b.m_Elem[1]) ? a.m_Elem[1] : b.m_Elem[1], (a.m_Elem[2] < b.m_Elem[2]) ? a.m_Elem[2] : b.m_Elem[2], (a.m_Elem[3] < b.m_Elem[3]) ? a.m_Elem[3] : b.m_Elem[3]);
+}
+
+static inline vec4i vec4i_max(vec4i a, vec4i b)
+{
+	return VEC4I((a.m_Elem[0] > b.m_Elem[0]) ? a.m_Elem[0] : b.m_Elem[0], (a.m_Elem[1] > b.m_Elem[1]) ? a.m_Elem[1] : b.m_Elem[1], (a.m_Elem[2] > b.m_Elem[2]) ? a.m_Elem[2] : b.m_Elem[2], (a.m_Elem[3] > b.m_Elem[3]) ? a.m_Elem[3] : b.m_Elem[3]);
+}
+
 static inline vec4i vec4i_packR32G32B32A32_to_RGBA8(vec4i r, vec4i g, vec4i b, vec4i a)
 {
 	return VEC4I(
@@ -242,6 +326,101 @@ static inline vec4i vec4i_packR32G32B32A32_to_RGBA8(vec4i r, vec4i g, vec4i b, v
 	);
 }
 
+static inline vec4i vec4i_blendSrcOverRGBA8(vec4i src, vec4i dst)
+{
+	vec4i res;
+	for (uint32_t i = 0; i < 4; ++i) {
+		const uint32_t s = (uint32_t)src.m_Elem[i];
+		const uint32_t d = (uint32_t)dst.m_Elem[i];
+		const uint32_t a = s >> 24;
+
+		uint32_t r = 0;
+		for (uint32_t shift = 0; shift < 32; shift += 8) {
+			const uint32_t t = ((s >> shift) & 0xFF) * a + ((d >> shift) & 0xFF) * (255 - a) + 128;
+			r |= ((t + (t >> 8)) >> 8) << shift;
+		}
+		res.m_Elem[i] = (int32_t)r;
+	}
+
+	return res;
+}
+
+static inline vec4i vec4i_blendAddRGBA8(vec4i src, vec4i dst)
+{
+	vec4i res;
+	for (uint32_t i = 0; i < 4; ++i) {
+		const uint32_t s = (uint32_t)src.m_Elem[i];
+		const uint32_t d = (uint32_t)dst.m_Elem[i];
+
+		uint32_t r = 0;
+		for (uint32_t shift = 0; shift < 32; shift += 8) {
+			const uint32_t c = ((s >> shift) & 0xFF) + ((d >> shift) & 0xFF);
+			r |= (c > 255 ? 255 : c) << shift;
+		}
+		res.m_Elem[i] = (int32_t)r;
+	}
+
+	return res;
+}
+
+static inline vec4i vec4i_blendMulRGBA8(vec4i src, vec4i dst)
+{
+	vec4i res;
+	for (uint32_t i = 0; i < 4; ++i) {
+		const uint32_t s = (uint32_t)src.m_Elem[i];
+		const uint32_t d = (uint32_t)dst.m_Elem[i];
+
+		uint32_t r = 0;
+		for (uint32_t shift = 0; shift < 32; shift += 8) {
+			const uint32_t t = ((s >> shift) & 0xFF) * ((d >> shift) & 0xFF) + 128;
+			r |= ((t + (t >> 8)) >> 8) << shift;
+		}
+		res.m_Elem[i] = (int32_t)r;
+	}
+
+	return res;
+}
+
+static inline vec4i vec4i_bilerpRGBA8(vec4i c00, vec4i c10, vec4i c01, vec4i c11, vec4i fx, vec4i fy)
+{
+	vec4i res;
+	for (uint32_t i = 0; i < 4; ++i) {
+		const uint32_t w11 = ((uint32_t)fx.m_Elem[i] * (uint32_t)fy.m_Elem[i]) >> 8;
+		const uint32_t w10 = (uint32_t)fx.m_Elem[i] - w11;
+		const uint32_t w01 = (uint32_t)fy.m_Elem[i] - w11;
+		const uint32_t w00 = 256 - (uint32_t)fx.m_Elem[i] - (uint32_t)fy.m_Elem[i] + w11;
+
+		uint32_t r = 0;
+		for (uint32_t shift = 0; shift < 32; shift += 8) {
+			const uint32_t c = 0
+				+ (((uint32_t)c00.m_Elem[i] >> shift) & 0xFF) * w00
+				+ (((uint32_t)c10.m_Elem[i] >> shift) & 0xFF) * w10
+				+ (((uint32_t)c01.m_Elem[i] >> shift) & 0xFF) * w01
+				+ (((uint32_t)c11.m_Elem[i] >> shift) & 0xFF) * w11
+				;
+			r |= (c >> 8) << shift;
+		}
+		res.m_Elem[i] = (int32_t)r;
+	}
+
+	return res;
+}
+
+static inline vec4i vec4i_gather(const int32_t* base, vec4i index)
+{
+	return VEC4I(base[index.m_Elem[0]], base[index.m_Elem[1]], base[index.m_Elem[2]], base[index.m_Elem[3]]);
+}
+
+static inline vec4i vec4i_evenLanes(vec4i a, vec4i b)
+{
+	return VEC4I(a.m_Elem[0], a.m_Elem[2], b.m_Elem[0], b.m_Elem[2]);
+}
+
+static inline vec4i vec4i_oddLanes(vec4i a, vec4i b)
+{
+	return VEC4I(a.m_Elem[1], a.m_Elem[3], b.m_Elem[1], b.m_Elem[3]);
+}
+
 static inline bool vec4i_anyNegative(vec4i x)
 {
 	return (x.m_Elem[0] | x.m_Elem[1] | x.m_Elem[2] | x.m_Elem[3]) < 0;
@@ -19,6 +19,12 @@ static __forceinline vec4f vec4f_fromVec4i(vec4i x)
 	return VEC4F(_mm_cvtepi32_ps(x.m_IMM));
 }
 
+// Reinterprets the bits of x as floats.
+static __forceinline vec4f vec4f_fromVec4i_bits(vec4i x)
+{
+	return VEC4F(_mm_castsi128_ps(x.m_IMM));
+}
+
 static __forceinline vec4f vec4f_fromFloat4(float x0, float x1, float x2, float x3)
 {
 	return VEC4F(_mm_set_ps(x3, x2, x1, x0));
@@ -34,6 +40,16 @@ static __forceinline vec4f vec4f_fromFloat4vu(const float* arr)
 	return VEC4F(_mm_loadu_ps(arr));
 }
 
+static __forceinline void vec4f_toFloat4va(vec4f x, float* arr)
+{
+	_mm_store_ps(arr, x.m_XMM);
+}
+
+static __forceinline void vec4f_toFloat4vu(vec4f x, float* arr)
+{
+	_mm_storeu_ps(arr, x.m_XMM);
+}
+
 static __forceinline vec4f vec4f_fromRGBA8(uint32_t rgba8)
 {
 	const __m128i imm_zero = _mm_setzero_si128();
@@ -67,6 +83,16 @@ static __forceinline vec4f vec4f_mul(vec4f a, vec4f b)
 	return VEC4F(_mm_mul_ps(a.m_XMM, b.m_XMM));
 }
 
+static __forceinline vec4f vec4f_min(vec4f a, vec4f b)
+{
+	return VEC4F(_mm_min_ps(a.m_XMM, b.m_XMM));
+}
+
+static __forceinline vec4f vec4f_max(vec4f a, vec4f b)
+{
+	return VEC4F(_mm_max_ps(a.m_XMM, b.m_XMM));
+}
+
 // http://dss.stephanierct.com/DevBlog/?p=8
 static vec4f vec4f_floor(vec4f x)
 {
@@ -148,6 +174,11 @@ static __forceinline vec4i vec4i_fromVec4f(vec4f x)
 	return VEC4I(_mm_cvtps_epi32(x.m_XMM));
 }
 
+static __forceinline vec4i vec4i_fromVec4f_trunc(vec4f x)
+{
+	return VEC4I(_mm_cvttps_epi32(x.m_XMM));
+}
+
 static __forceinline vec4i vec4i_fromInt4(int32_t x0, int32_t x1, int32_t x2, int32_t x3)
 {
 	return VEC4I(_mm_set_epi32(x3, x2, x1, x0));
@@ -158,16 +189,47 @@ static __forceinline vec4i vec4i_fromInt4va(const int32_t* arr)
 	return VEC4I(_mm_load_si128((const __m128i*)arr));
 }
 
+static __forceinline vec4i vec4i_fromInt4vu(const int32_t* arr)
+{
+	return VEC4I(_mm_loadu_si128((const __m128i*)arr));
+}
+
+// Zero extends 4 unsigned 16-bit integers.
+static __forceinline vec4i vec4i_fromUint16x4vu(const uint16_t* arr)
+{
+	return VEC4I(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)arr), _mm_setzero_si128()));
+}
+
+// Zero extends 4 unsigned 8-bit integers.
+static __forceinline vec4i vec4i_fromUint8x4vu(const uint8_t* arr)
+{
+	return VEC4I(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const int32_t*)arr), _mm_setzero_si128()), _mm_setzero_si128()));
+}
+
 static __forceinline void vec4i_toInt4vu(vec4i x, int32_t* arr)
 {
 	_mm_storeu_si128((__m128i*)arr, x.m_IMM);
 }
 
+// Stores the 8 lanes of a and b, which must be in the range [0, 65535], as unsigned 16-bit integers.
+static __forceinline void vec4i_toUint16x8vu(vec4i a, vec4i b, uint16_t* arr)
+{
+	// SSE2 only has a signed saturating pack.
+	const __m128i bias32 = _mm_set1_epi32(32768);
+	const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a.m_IMM, bias32), _mm_sub_epi32(b.m_IMM, bias32));
+	_mm_storeu_si128((__m128i*)arr, _mm_xor_si128(packed, _mm_set1_epi16((int16_t)0x8000)));
+}
+
 static __forceinline void vec4i_toInt4va(vec4i x, int32_t* arr)
 {
 	_mm_store_si128((__m128i*)arr, x.m_IMM);
 }
 
+static __forceinline void vec4i_toInt4va_stream(vec4i x, int32_t* arr)
+{
+	_mm_stream_si128((__m128i*)arr, x.m_IMM);
+}
+
 static __forceinline void vec4i_toInt4va_masked(vec4i x, vec4i mask, int32_t* buffer)
 {
 #if 0
@@ -290,6 +352,23 @@ static __forceinline vec4i vec4i_cmplt(vec4i a, vec4i b)
 	return VEC4I(_mm_cmplt_epi32(a.m_IMM, b.m_IMM));
 }
 
+static __forceinline vec4i vec4i_cmpeq(vec4i a, vec4i b)
+{
+	return VEC4I(_mm_cmpeq_epi32(a.m_IMM, b.m_IMM));
+}
+
+static __forceinline vec4i vec4i_min(vec4i a, vec4i b)
+{
+	const __m128i altb = _mm_cmplt_epi32(a.m_IMM, b.m_IMM);
+	return VEC4I(_mm_or_si128(_mm_and_si128(altb, a.m_IMM), _mm_andnot_si128(altb, b.m_IMM)));
+}
+
+static __forceinline vec4i vec4i_max(vec4i a, vec4i b)
+{
+	const __m128i altb = _mm_cmplt_epi32(a.m_IMM, b.m_IMM);
+	return VEC4I(_mm_or_si128(_mm_and_si128(altb, b.m_IMM), _mm_andnot_si128(altb, a.m_IMM)));
+}
+
 static __forceinline vec4i vec4i_packR32G32B32A32_to_RGBA8(vec4i r, vec4i g, vec4i b, vec4i a)
 {
 	// Pack into uint8_t
@@ -319,6 +398,104 @@ static __forceinline vec4i vec4i_packR32G32B32A32_to_RGBA8(vec4i r, vec4i g, vec
 	return VEC4I(imm_rgba_p0123_u8);
 }
 
+// Per-channel x / 255 of 16-bit products, rounded to nearest: (t + (t >> 8)) >> 8 with t = x + 128.
+// Same as swrBlendColor().
+static __forceinline vec4i vec4i_blendSrcOverRGBA8(vec4i src, vec4i dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i imm_128_u16 = _mm_set1_epi16(128);
+	const __m128i imm_255_u16 = _mm_set1_epi16(255);
+
+	// (uint16_t){ r0, g0, b0, a0, r1, g1, b1, a1 } / (uint16_t){ r2, g2, b2, a2, r3, g3, b3, a3 }
+	const __m128i src_p01_u16 = _mm_unpacklo_epi8(src.m_IMM, zero);
+	const __m128i src_p23_u16 = _mm_unpackhi_epi8(src.m_IMM, zero);
+	const __m128i dst_p01_u16 = _mm_unpacklo_epi8(dst.m_IMM, zero);
+	const __m128i dst_p23_u16 = _mm_unpackhi_epi8(dst.m_IMM, zero);
+
+	// (uint16_t){ a0, a0, a0, a0, a1, a1, a1, a1 } / (uint16_t){ a2, a2, a2, a2, a3, a3, a3, a3 }
+	const __m128i alpha_p01_u16 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src_p01_u16, 0xFF), 0xFF);
+	const __m128i alpha_p23_u16 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src_p23_u16, 0xFF), 0xFF);
+
+	// src * a + dst * (255 - a) + 128 fits in 16 bits.
+	const __m128i t_p01_u16 = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(src_p01_u16, alpha_p01_u16), _mm_mullo_epi16(dst_p01_u16, _mm_sub_epi16(imm_255_u16, alpha_p01_u16))), imm_128_u16);
+	const __m128i t_p23_u16 = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(src_p23_u16, alpha_p23_u16), _mm_mullo_epi16(dst_p23_u16, _mm_sub_epi16(imm_255_u16, alpha_p23_u16))), imm_128_u16);
+	const __m128i res_p01_u16 = _mm_srli_epi16(_mm_add_epi16(t_p01_u16, _mm_srli_epi16(t_p01_u16, 8)), 8);
+	const __m128i res_p23_u16 = _mm_srli_epi16(_mm_add_epi16(t_p23_u16, _mm_srli_epi16(t_p23_u16, 8)), 8);
+
+	return VEC4I(_mm_packus_epi16(res_p01_u16, res_p23_u16));
+}
+
+static __forceinline vec4i vec4i_blendAddRGBA8(vec4i src, vec4i dst)
+{
+	return VEC4I(_mm_adds_epu8(src.m_IMM, dst.m_IMM));
+}
+
+static __forceinline vec4i vec4i_blendMulRGBA8(vec4i src, vec4i dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i imm_128_u16 = _mm_set1_epi16(128);
+
+	const __m128i t_p01_u16 = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(src.m_IMM, zero), _mm_unpacklo_epi8(dst.m_IMM, zero)), imm_128_u16);
+	const __m128i t_p23_u16 = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(src.m_IMM, zero), _mm_unpackhi_epi8(dst.m_IMM, zero)), imm_128_u16);
+	const __m128i res_p01_u16 = _mm_srli_epi16(_mm_add_epi16(t_p01_u16, _mm_srli_epi16(t_p01_u16, 8)), 8);
+	const __m128i res_p23_u16 = _mm_srli_epi16(_mm_add_epi16(t_p23_u16, _mm_srli_epi16(t_p23_u16, 8)), 8);
+
+	return VEC4I(_mm_packus_epi16(res_p01_u16, res_p23_u16));
+}
+
+// Bilinear filtering of 4 RGBA8 texels per lane. 'fx' and 'fy' are the fractional 
+// positions ([0, 255]) between c00/c10 and c00/c01 respectively. The 4 weights are in 
+// 1/256 units and always sum to 256 so each weighted channel sum fits in 16 bits. 
+// Even and odd channels are filtered in the low and high byte of 16-bit lanes.
+static __forceinline vec4i vec4i_bilerpRGBA8(vec4i c00, vec4i c10, vec4i c01, vec4i c11, vec4i fx, vec4i fy)
+{
+	const __m128i mask = _mm_set1_epi32(0x00FF00FF);
+
+	const __m128i w11 = _mm_srli_epi32(_mm_mullo_epi16(fx.m_IMM, fy.m_IMM), 8);
+	const __m128i w10 = _mm_sub_epi32(fx.m_IMM, w11);
+	const __m128i w01 = _mm_sub_epi32(fy.m_IMM, w11);
+	const __m128i w00 = _mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(_mm_set1_epi32(256), w11), fx.m_IMM), fy.m_IMM);
+
+	// Replicate the weights to both 16-bit halves of each lane.
+	const __m128i w00_u16 = _mm_or_si128(w00, _mm_slli_epi32(w00, 16));
+	const __m128i w10_u16 = _mm_or_si128(w10, _mm_slli_epi32(w10, 16));
+	const __m128i w01_u16 = _mm_or_si128(w01, _mm_slli_epi32(w01, 16));
+	const __m128i w11_u16 = _mm_or_si128(w11, _mm_slli_epi32(w11, 16));
+
+	const __m128i even_u16 = _mm_add_epi16(
+		_mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(c00.m_IMM, mask), w00_u16), _mm_mullo_epi16(_mm_and_si128(c10.m_IMM, mask), w10_u16)),
+		_mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(c01.m_IMM, mask), w01_u16), _mm_mullo_epi16(_mm_and_si128(c11.m_IMM, mask), w11_u16))
+	);
+	const __m128i odd_u16 = _mm_add_epi16(
+		_mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(c00.m_IMM, 8), w00_u16), _mm_mullo_epi16(_mm_srli_epi16(c10.m_IMM, 8), w10_u16)),
+		_mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(c01.m_IMM, 8), w01_u16), _mm_mullo_epi16(_mm_srli_epi16(c11.m_IMM, 8), w11_u16))
+	);
+
+	return VEC4I(_mm_or_si128(_mm_srli_epi16(even_u16, 8), _mm_andnot_si128(mask, odd_u16)));
+}
+
+// No gather instruction before AVX2. Indices are extracted one at a time.
+static __forceinline vec4i vec4i_gather(const int32_t* base, vec4i index)
+{
+	const int32_t i0 = _mm_cvtsi128_si32(index.m_IMM);
+	const int32_t i1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(index.m_IMM, VEC4_SHUFFLE_YYYY));
+	const int32_t i2 = _mm_cvtsi128_si32(_mm_shuffle_epi32(index.m_IMM, VEC4_SHUFFLE_ZZZZ));
+	const int32_t i3 = _mm_cvtsi128_si32(_mm_shuffle_epi32(index.m_IMM, VEC4_SHUFFLE_WWWW));
+	return VEC4I(_mm_setr_epi32(base[i0], base[i1], base[i2], base[i3]));
+}
+
+// Lanes 0 and 2 of 'a' followed by lanes 0 and 2 of 'b', i.e. the even lanes of the 
+// 8-lane vector (a, b).
+static __forceinline vec4i vec4i_evenLanes(vec4i a, vec4i b)
+{
+	return VEC4I(_mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a.m_IMM), _mm_castsi128_ps(b.m_IMM), _MM_SHUFFLE(2, 0, 2, 0))));
+}
+
+static __forceinline vec4i vec4i_oddLanes(vec4i a, vec4i b)
+{
+	return VEC4I(_mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a.m_IMM), _mm_castsi128_ps(b.m_IMM), _MM_SHUFFLE(3, 1, 3, 1))));
+}
+
 static __forceinline bool vec4i_anyNegative(vec4i x)
 {
 	return (_mm_movemask_epi8(x.m_IMM) & 0x8888) != 0;
@@ -339,6 +516,8 @@ static __forceinline uint32_t vec4i_getByteSignMask(vec4i x)
 	return _mm_movemask_epi8(x.m_IMM);
 }
 
+#define vec4i_shuffle(a, b, mask) (vec4i){ .m_IMM = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a.m_IMM), _mm_castsi128_ps(b.m_IMM), mask)) }
+
 #define VEC4I_GET_FUNC(swizzle) \
 static __forceinline vec4i vec4i_get##swizzle(vec4i x) \
 { \
@@ -6,43 +6,163 @@
 #include "../core/math.h"
 #include "../core/cpu.h"
 #include <stdbool.h>
+#include <float.h>
+#include <assert.h>
 
 static swr_context* swrCreateContext(core_allocator_i* allocator, uint32_t w, uint32_t h);
 static void swrDestroyContext(core_allocator_i* allocator, swr_context* ctx);
+static bool swrSetNumWorkerThreads(swr_context* ctx, uint32_t numWorkerThreads);
+static void swrFlush(swr_context* ctx);
 static const void* swrGetFrameBufferPtr(swr_context* ctx);
 static void swrClear(swr_context* ctx, uint32_t color);
+static void swrInvalidateRect(swr_context* ctx, float minX, float minY, float maxX, float maxY);
+static void swrInvalidateAll(swr_context* ctx);
+static bool swrBeginIncrementalFrame(swr_context* ctx);
+static void swrEndIncrementalFrame(swr_context* ctx, swr_rect* updateRect);
 static void swrSetWorldToScreenTransform(swr_context* ctx, const swr_matrix2d* mtx);
+static void swrSetBlendMode(swr_context* ctx, swr_blend_mode mode);
+static void swrSetLineStyle(swr_context* ctx, float width, bool antiAliased);
+static bool swrSetSampleCount(swr_context* ctx, uint32_t numSamples);
+static void swrBindTexture(swr_context* ctx, const swr_texture* tex, swr_texture_filter filter);
+static void swrUnbindTexture(swr_context* ctx);
+static void swrBindPixelShader(swr_context* ctx, swr_pixel_shader_func func, void* userData);
+static void swrUnbindPixelShader(swr_context* ctx);
 static void swrBindVertexBuffer(swr_context* ctx, swr_vertex_attrib va, swr_format format, uint32_t stride, uint32_t n, const void* ptr);
 static void swrUnbindVertexBuffer(swr_context* ctx, swr_vertex_attrib va);
-static void swrBindIndexBuffer(swr_context* ctx, uint32_t n, const uint16_t* ptr);
+static void swrBindIndexBuffer(swr_context* ctx, swr_format format, uint32_t n, const void* ptr);
 static void swrUnbindIndexBuffer(swr_context* ctx);
-static void swrDrawPrimitives(swr_context* ctx, swr_primitive_type primType, uint16_t startIndex, uint16_t endIndex, uint32_t numIndices, uint32_t baseIndex, uint32_t baseVertex);
+static void swrBindClusterBuffer(swr_context* ctx, uint32_t n, uint32_t numTrianglesPerCluster, const swr_cluster* ptr);
+static void swrUnbindClusterBuffer(swr_context* ctx);
+static void swrDrawPrimitives(swr_context* ctx, swr_primitive_type primType, uint32_t startIndex, uint32_t endIndex, uint32_t numIndices, uint32_t baseIndex, uint32_t baseVertex);
+static void swrDrawBVH(swr_context* ctx, const swr_bvh* bvh, uint32_t baseVertex);
 static void swrDrawPixel(swr_context* ctx, int32_t x, int32_t y, uint32_t color);
 static void swrDrawLine(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
 static void swrDrawTriangleDispatch(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
+static void swrDrawTriangleFlatDispatch(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+static void swrDrawTriangleTexturedDispatch(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv);
 static void swrDrawText(swr_context* ctx, const swr_font* font, int32_t x0, int32_t y0, const char* str, const char* end, uint32_t color);
+static void swrDrawTextBatch(swr_context* ctx, const swr_font* font, const swr_text_run* runs, uint32_t numRuns);
+static void swrDrawAtlasTextBatch(swr_context* ctx, const swr_atlas_font* font, float scale, const swr_text_run* runs, uint32_t numRuns);
 
 static void swrTransformPos2fTo2iDispatch(uint32_t n, const float* posf, int32_t* posi, const float* mtx);
+static void swrTransformPos2fStridedTo2iDispatch(uint32_t n, const float* pos, uint32_t stride, int32_t* posi, const float* mtx);
+static void swrTransformPos2usTo2iDispatch(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+static void swrTransformPos2sTo2iDispatch(uint32_t n, const int16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+static void swrTransformPos2hTo2iDispatch(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+static uint32_t swrSetupTrianglesDispatch(uint32_t numTriangles, const uint16_t* indices, const int32_t* posi, uint32_t w, uint32_t h, int32_t sampleExtent, uint16_t* visibleIndices, uint32_t* clipTriangles, uint32_t* numClipTriangles);
+static uint32_t swrAssembleTrianglesDispatch(swr_primitive_type primType, swr_format indexFormat, uint32_t numIndices, const void* indices, uint32_t* triangles);
+static bool swrRebaseIndicesDispatch(uint32_t numIndices, const uint32_t* indices, uint16_t* rebased, uint32_t* base);
+static void swrResolveSamplesDispatch(uint32_t numPixels, uint32_t numSamples, uint32_t sampleStride, const uint32_t* samples, uint32_t* dst);
+static void swrDownsample2x2Dispatch(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst);
+static void swrFillSpanDispatch(uint32_t* dst, uint32_t n, uint32_t color, uint32_t blendMode);
+static void swrBlendSpanCoverageDispatch(uint32_t* dst, uint32_t n, uint32_t color, float d0, float halfWidth, float alphaScale);
+static void swrBlitGlyphDispatch(uint32_t* dst, uint32_t stride, const uint8_t* rows, uint32_t numRows, int32_t shift, uint32_t columnMask, uint32_t color);
+static void swrBlendCoverageDispatch(uint32_t* dst, const uint8_t* coverage, uint32_t n, uint32_t color);
+
+static void swrSelectDrawTriangleKernels(void);
+static void swrDrawTriangleList(swr_context* ctx, const uint16_t* indices, uint32_t numTriangles, const swr_vertex_buffer* posBufferWorld, const int32_t* posBufferScreen, const float* mtx, const uint32_t* colorPtr, uint32_t color, const float* texCoordPtr, const float* varyingPtr);
+static void swrDrawTriangleList32(swr_context* ctx, const uint32_t* indices, uint32_t numTriangles, uint32_t firstVertex, const swr_vertex_buffer* posBufferWorld, const int32_t* posBufferScreen, const float* mtx, const uint32_t* colorPtr, uint32_t color, const float* texCoordPtr, const float* varyingPtr);
+static void swrDrawLines(swr_context* ctx, swr_primitive_type primType, uint32_t indexFormat, uint32_t numIndices, const void* indices, uint32_t firstVertex, const int32_t* posBufferScreen, const uint32_t* colorPtr, uint32_t color);
+static bool swrClusterIsVisible(const swr_context* ctx, const swr_cluster* cluster);
+static void swrGetSubpixelTransform(const swr_context* ctx, float* mtx);
+static bool swrGetVertexPositions(const swr_context* ctx, uint32_t baseVertex, uint32_t numVertices, swr_vertex_buffer* positions);
+static void swrGetVertexPos(const swr_vertex_buffer* positions, uint32_t id, float* pos);
+static void swrTransformVertexPositions(const swr_vertex_buffer* positions, uint32_t first, uint32_t last, int32_t* posScreen, const float* mtx);
+static const uint32_t* swrGetVertexColors(const swr_context* ctx, uint32_t baseVertex, uint32_t numVertices, uint32_t* color);
+static const float* swrGetVertexTexCoords(const swr_context* ctx, uint32_t baseVertex, uint32_t numVertices);
+static uint32_t swrSetupVaryings(swr_context* ctx, bool textured);
+static void swrFetchVaryings(const swr_context* ctx, uint32_t baseVertex, const uint16_t* vertexIDs, uint32_t first, uint32_t last, float* varyings);
+static uint32_t swrFormatNumComponents(uint32_t format);
+static uint32_t swrFormatSize(uint32_t format);
+static void swrDrawClippedTriangle(swr_context* ctx, const uint16_t* ids, const swr_vertex_buffer* posWorld, const int32_t* posScreen, const float* mtx, const uint32_t* colors, uint32_t color, const float* texCoords, const float* varyings, swr_draw_triangle_func drawTriangleFunc, swr_draw_triangle_flat_func drawTriangleFlatFunc, swr_draw_triangle_textured_func drawTriangleTexturedFunc);
+static uint32_t swrColorInterpolate(uint32_t color0, uint32_t color1, uint32_t color2, float b1, float b2);
+static void swrResolveSampleBuffer(swr_context* ctx);
+static void swrDrawTextRun(swr_context* ctx, const swr_font* font, int32_t x0, int32_t y0, const char* str, const char* end, uint32_t color);
 
 swr_api* swr = &(swr_api){
 	.createContext = swrCreateContext,
 	.destroyContext = swrDestroyContext,
+	.setNumWorkerThreads = swrSetNumWorkerThreads,
+	.flush = swrFlush,
 	.getFrameBufferPtr = swrGetFrameBufferPtr,
 	.clear = swrClear,
+	.invalidateRect = swrInvalidateRect,
+	.invalidateAll = swrInvalidateAll,
+	.beginIncrementalFrame = swrBeginIncrementalFrame,
+	.endIncrementalFrame = swrEndIncrementalFrame,
 	.setWorldToScreenTransform = swrSetWorldToScreenTransform,
+	.setBlendMode = swrSetBlendMode,
+	.setLineStyle = swrSetLineStyle,
+	.setSampleCount = swrSetSampleCount,
+	.createTexture = swrCreateTexture,
+	.destroyTexture = swrDestroyTexture,
+	.bindTexture = swrBindTexture,
+	.unbindTexture = swrUnbindTexture,
+	.bindPixelShader = swrBindPixelShader,
+	.unbindPixelShader = swrUnbindPixelShader,
 	.bindVertexBuffer = swrBindVertexBuffer,
 	.unbindVertexBuffer = swrUnbindVertexBuffer,
 	.bindIndexBuffer = swrBindIndexBuffer,
 	.unbindIndexBuffer = swrUnbindIndexBuffer,
+	.bindClusterBuffer = swrBindClusterBuffer,
+	.unbindClusterBuffer = swrUnbindClusterBuffer,
 	.drawPrimitives = swrDrawPrimitives,
+	.createBVH = swrCreateBVH,
+	.destroyBVH = swrDestroyBVH,
+	.drawBVH = swrDrawBVH,
 	.drawPixel = swrDrawPixel,
 	.drawLine = swrDrawLine,
 	.drawTriangle = swrDrawTriangleDispatch,
+	.drawTriangleFlat = swrDrawTriangleFlatDispatch,
+	.drawTriangleTextured = swrDrawTriangleTexturedDispatch,
 	.drawText = swrDrawText,
+	.drawTextBatch = swrDrawTextBatch,
+	.createAtlasFont = swrCreateAtlasFont,
+	.destroyAtlasFont = swrDestroyAtlasFont,
+	.drawAtlasTextBatch = swrDrawAtlasTextBatch,
+
+	.createCommandList = swrCreateCommandList,
+	.destroyCommandList = swrDestroyCommandList,
+	.cmdReset = swrCmdReset,
+	.cmdClear = swrCmdClear,
+	.cmdSetWorldToScreenTransform = swrCmdSetWorldToScreenTransform,
+	.cmdSetBlendMode = swrCmdSetBlendMode,
+	.cmdSetLineStyle = swrCmdSetLineStyle,
+	.cmdBindTexture = swrCmdBindTexture,
+	.cmdUnbindTexture = swrCmdUnbindTexture,
+	.cmdBindPixelShader = swrCmdBindPixelShader,
+	.cmdUnbindPixelShader = swrCmdUnbindPixelShader,
+	.cmdBindVertexBuffer = swrCmdBindVertexBuffer,
+	.cmdUnbindVertexBuffer = swrCmdUnbindVertexBuffer,
+	.cmdBindIndexBuffer = swrCmdBindIndexBuffer,
+	.cmdUnbindIndexBuffer = swrCmdUnbindIndexBuffer,
+	.cmdBindClusterBuffer = swrCmdBindClusterBuffer,
+	.cmdUnbindClusterBuffer = swrCmdUnbindClusterBuffer,
+	.cmdDrawPrimitives = swrCmdDrawPrimitives,
+	.cmdDrawBVH = swrCmdDrawBVH,
+	.executeCommandList = swrExecuteCommandList,
 
-	.transformPos2fTo2i = swrTransformPos2fTo2iDispatch
+	.transformPos2fTo2i = swrTransformPos2fTo2iDispatch,
+	.transformPos2fStridedTo2i = swrTransformPos2fStridedTo2iDispatch,
+	.transformPos2usTo2i = swrTransformPos2usTo2iDispatch,
+	.transformPos2sTo2i = swrTransformPos2sTo2iDispatch,
+	.transformPos2hTo2i = swrTransformPos2hTo2iDispatch,
+	.setupTriangles = swrSetupTrianglesDispatch,
+	.assembleTriangles = swrAssembleTrianglesDispatch,
+	.rebaseIndices = swrRebaseIndicesDispatch,
+	.resolveSamples = swrResolveSamplesDispatch,
+	.downsample2x2 = swrDownsample2x2Dispatch,
+	.fillSpan = swrFillSpanDispatch,
+	.blendSpanCoverage = swrBlendSpanCoverageDispatch,
+	.blitGlyph = swrBlitGlyphDispatch,
+	.blendCoverage = swrBlendCoverageDispatch
 };
 
+// Multisample patterns in 1/16th of a pixel, relative to the pixel's integer coordinates. 
+// No two samples of a pattern share a row or a column.
+static const int8_t kSamplePattern4x[4 * 2] = { -2, -6, 6, -2, -6, 2, 2, 6 };
+static const int8_t kSamplePattern8x[8 * 2] = { 1, -3, -1, 3, 5, 1, -3, -5, -5, 5, -7, -1, 3, 7, 7, -7 };
+
 static swr_context* swrCreateContext(core_allocator_i* allocator, uint32_t w, uint32_t h)
 {
 	swr_context* ctx = (swr_context*)CORE_ALLOC(allocator, sizeof(swr_context));
@@ -60,8 +180,19 @@ static swr_context* swrCreateContext(core_allocator_i* allocator, uint32_t w, ui
 	}
 
 	core_memSet(ctx->m_FrameBuffer, 0, sizeof(uint32_t) * (size_t)w * (size_t)h);
+	ctx->m_SampleBuffer = ctx->m_FrameBuffer;
 	ctx->m_Width = w;
 	ctx->m_Height = h;
+	ctx->m_NumSamples = 1;
+	ctx->m_SampleStride = w * h;
+	ctx->m_ScissorRect.m_MinX = 0;
+	ctx->m_ScissorRect.m_MinY = 0;
+	ctx->m_ScissorRect.m_MaxX = (int32_t)w - 1;
+	ctx->m_ScissorRect.m_MaxY = (int32_t)h - 1;
+	ctx->m_BlendMode = SWR_BLEND_MODE_OPAQUE;
+	ctx->m_LineWidth = 1.0f;
+	ctx->m_LineAntiAliased = false;
+	ctx->m_Allocator = allocator;
 
 	ctx->m_TempAllocator = core_allocatorCreateLinearAllocator(4 << 20, allocator);
 	if (!ctx->m_TempAllocator) {
@@ -85,32 +216,308 @@ static swr_context* swrCreateContext(core_allocator_i* allocator, uint32_t w, ui
 		ctx->m_TileBuffer[1] = scratchBuffer + (totalTiles * SWR_CONFIG_TILEBUF_TILE_SIZE);
 	}
 
+	{
+		ctx->m_NumFBTilesX = core_roundUp(w, SWR_CONFIG_FB_TILE_WIDTH) / SWR_CONFIG_FB_TILE_WIDTH;
+		ctx->m_NumFBTilesY = core_roundUp(h, SWR_CONFIG_FB_TILE_HEIGHT) / SWR_CONFIG_FB_TILE_HEIGHT;
+		const size_t numTiles = (size_t)ctx->m_NumFBTilesX * ctx->m_NumFBTilesY;
+		uint8_t* tileState = (uint8_t*)CORE_ALLOC(allocator, numTiles * 3);
+		if (!tileState) {
+			swrDestroyContext(allocator, ctx);
+			return NULL;
+		}
+
+		// The framebuffer starts out cleared to 0 and nothing has been drawn into it yet.
+		ctx->m_ClearTiles = tileState;
+		ctx->m_DirtyTiles = tileState + numTiles;
+		ctx->m_DrawnTiles = tileState + numTiles * 2;
+		core_memSet(ctx->m_ClearTiles, 0, numTiles);
+		core_memSet(ctx->m_DirtyTiles, 1, numTiles);
+		core_memSet(ctx->m_DrawnTiles, 0, numTiles);
+	}
+
 	return ctx;
 }
 
 static void swrDestroyContext(core_allocator_i* allocator, swr_context* ctx)
 {
+	if (ctx->m_Binner) {
+		swrBinnerDestroy(ctx->m_Binner, allocator);
+		ctx->m_Binner = NULL;
+	}
+
 	if (ctx->m_TempAllocator) {
 		core_allocatorDestroyLinearAllocator(ctx->m_TempAllocator);
 		ctx->m_TempAllocator = NULL;
 	}
 
+	if (ctx->m_SampleBuffer != ctx->m_FrameBuffer) {
+		CORE_ALIGNED_FREE(allocator, ctx->m_SampleBuffer, 32);
+	}
+
+	if (ctx->m_ClearTiles) {
+		CORE_FREE(allocator, ctx->m_ClearTiles);
+	}
+
+	CORE_ALIGNED_FREE(allocator, ctx->m_TileBuffer[0], 32);
 	CORE_ALIGNED_FREE(allocator, ctx->m_FrameBuffer, 32);
 	CORE_FREE(allocator, ctx);
 }
 
+// The current configuration is only replaced once the new one has been set up, so 
+// the context keeps working as before if this fails.
+static bool swrSetNumWorkerThreads(swr_context* ctx, uint32_t numWorkerThreads)
+{
+	swr_binner* binner = NULL;
+	if (numWorkerThreads != 0) {
+		// Bins are rasterized by the drawTriangle kernels using 8x4 blocks. Make sure 
+		// blocks at the right and bottom edges of the framebuffer never cross into 
+		// a neighboring bin.
+		if ((ctx->m_Width % 8) != 0 || (ctx->m_Height % 4) != 0) {
+			return false;
+		}
+
+		// Make sure the drawTriangle kernels have been selected before any worker 
+		// thread calls them. Same for fillSpan, which the kernels use to fill pending
+		// clear tiles.
+		swrSelectDrawTriangleKernels();
+		swr->fillSpan(NULL, 0, 0, SWR_BLEND_MODE_OPAQUE);
+
+		binner = swrBinnerCreate(ctx, ctx->m_Allocator, core_minu32(numWorkerThreads, SWR_CONFIG_MAX_WORKER_THREADS));
+		if (!binner) {
+			return false;
+		}
+	}
+
+	if (ctx->m_Binner) {
+		swrBinnerFlush(ctx);
+		swrBinnerDestroy(ctx->m_Binner, ctx->m_Allocator);
+	}
+
+	ctx->m_Binner = binner;
+
+	return true;
+}
+
+static void swrFlush(swr_context* ctx)
+{
+	if (ctx->m_Binner) {
+		swrBinnerFlush(ctx);
+	}
+}
+
 static const void* swrGetFrameBufferPtr(swr_context* ctx)
 {
+	swrFlush(ctx);
+	swrResolveSampleBuffer(ctx);
+
 	return ctx->m_FrameBuffer;
 }
 
+// Pixel rect of a framebuffer tile.
+static swr_rect swrGetTileRect(const swr_context* ctx, uint32_t tx, uint32_t ty)
+{
+	const int32_t x = (int32_t)(tx * SWR_CONFIG_FB_TILE_WIDTH);
+	const int32_t y = (int32_t)(ty * SWR_CONFIG_FB_TILE_HEIGHT);
+	return (swr_rect){
+		.m_MinX = x,
+		.m_MinY = y,
+		.m_MaxX = core_mini32(x + SWR_CONFIG_FB_TILE_WIDTH, (int32_t)ctx->m_Width) - 1,
+		.m_MaxY = core_mini32(y + SWR_CONFIG_FB_TILE_HEIGHT, (int32_t)ctx->m_Height) - 1
+	};
+}
+
+static void swrFillClearTile(swr_context* ctx, uint32_t tx, uint32_t ty)
+{
+	const uint32_t width = ctx->m_Width;
+	const swr_rect tile = swrGetTileRect(ctx, tx, ty);
+	const uint32_t tileWidth = (uint32_t)(tile.m_MaxX - tile.m_MinX + 1);
+	for (uint32_t iSample = 0; iSample < ctx->m_NumSamples; ++iSample) {
+		uint32_t* dst = &ctx->m_SampleBuffer[tile.m_MinX + tile.m_MinY * width + iSample * ctx->m_SampleStride];
+		for (int32_t y = tile.m_MinY; y <= tile.m_MaxY; ++y) {
+			swr->fillSpan(dst, tileWidth, ctx->m_ClearColor, SWR_BLEND_MODE_OPAQUE);
+			dst += width;
+		}
+	}
+
+	ctx->m_ClearTiles[tx + ty * ctx->m_NumFBTilesX] = 0;
+}
+
+// Pixels aren't written here. Tiles inside the scissor rect are filled with the clear color 
+// the first time something is drawn into them (see swrTouchTiles) and tiles which are never 
+// drawn into are only written to the framebuffer when it's resolved. The scissor rect always 
+// covers whole tiles (see swrBeginIncrementalFrame).
 static void swrClear(swr_context* ctx, uint32_t color)
 {
-	uint32_t* buffer = ctx->m_FrameBuffer;
-	const uint32_t numPixels = ctx->m_Width * ctx->m_Height;
-	for (uint32_t i = 0; i < numPixels; ++i) {
-		*buffer++ = color;
+	swrFlush(ctx);
+
+	const swr_rect* scissor = &ctx->m_ScissorRect;
+	for (uint32_t ty = 0; ty < ctx->m_NumFBTilesY; ++ty) {
+		for (uint32_t tx = 0; tx < ctx->m_NumFBTilesX; ++tx) {
+			const uint32_t tileID = tx + ty * ctx->m_NumFBTilesX;
+			const swr_rect tile = swrGetTileRect(ctx, tx, ty);
+			const bool insideScissor = true
+				&& tile.m_MinX >= scissor->m_MinX
+				&& tile.m_MinY >= scissor->m_MinY
+				&& tile.m_MaxX <= scissor->m_MaxX
+				&& tile.m_MaxY <= scissor->m_MaxY
+				;
+			if (insideScissor) {
+				ctx->m_ClearTiles[tileID] = 1;
+				if (ctx->m_IncrementalFrame) {
+					ctx->m_DrawnTiles[tileID] = 1;
+				}
+			} else if (ctx->m_ClearTiles[tileID] && color != ctx->m_ClearColor) {
+				// Pending tiles outside the scissor rect keep the old clear color.
+				swrFillClearTile(ctx, tx, ty);
+			}
+		}
+	}
+
+	ctx->m_ClearColor = color;
+	ctx->m_ClearPending = true;
+}
+
+void swrTouchTilesRect(swr_context* ctx, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY)
+{
+	minX = core_maxi32(minX, 0);
+	minY = core_maxi32(minY, 0);
+	maxX = core_mini32(maxX, (int32_t)ctx->m_Width - 1);
+	maxY = core_mini32(maxY, (int32_t)ctx->m_Height - 1);
+	if (minX > maxX || minY > maxY) {
+		return;
+	}
+
+	const uint32_t txBegin = (uint32_t)minX / SWR_CONFIG_FB_TILE_WIDTH;
+	const uint32_t txEnd = (uint32_t)maxX / SWR_CONFIG_FB_TILE_WIDTH;
+	const uint32_t tyBegin = (uint32_t)minY / SWR_CONFIG_FB_TILE_HEIGHT;
+	const uint32_t tyEnd = (uint32_t)maxY / SWR_CONFIG_FB_TILE_HEIGHT;
+	for (uint32_t ty = tyBegin; ty <= tyEnd; ++ty) {
+		for (uint32_t tx = txBegin; tx <= txEnd; ++tx) {
+			const uint32_t tileID = tx + ty * ctx->m_NumFBTilesX;
+			if (ctx->m_ClearTiles[tileID]) {
+				swrFillClearTile(ctx, tx, ty);
+			}
+
+			if (ctx->m_IncrementalFrame) {
+				ctx->m_DrawnTiles[tileID] = 1;
+			}
+		}
+	}
+}
+
+// The rect is transformed to screen space and grown by a pixel for rounding, like 
+// cluster bounds (see swrClusterIsVisible).
+static void swrInvalidateRect(swr_context* ctx, float minX, float minY, float maxX, float maxY)
+{
+	if (!(minX <= maxX && minY <= maxY)) {
+		return;
+	}
+
+	const float* mtx = ctx->m_WorldToScreenTransform.m_Elem;
+	float screenMin[2] = { FLT_MAX, FLT_MAX };
+	float screenMax[2] = { -FLT_MAX, -FLT_MAX };
+	for (uint32_t i = 0; i < 4; ++i) {
+		const float x = (i & 1) != 0 ? maxX : minX;
+		const float y = (i & 2) != 0 ? maxY : minY;
+		const float sx = mtx[0] * x + mtx[2] * y + mtx[4];
+		const float sy = mtx[1] * x + mtx[3] * y + mtx[5];
+		screenMin[0] = core_minf(screenMin[0], sx);
+		screenMin[1] = core_minf(screenMin[1], sy);
+		screenMax[0] = core_maxf(screenMax[0], sx);
+		screenMax[1] = core_maxf(screenMax[1], sy);
+	}
+
+	// Clamped to the framebuffer before the conversion. Offscreen rects (and NaNs) end up empty.
+	const float pxMin = core_maxf(core_floorf(screenMin[0]) - 1.0f, 0.0f);
+	const float pyMin = core_maxf(core_floorf(screenMin[1]) - 1.0f, 0.0f);
+	const float pxMax = core_minf(core_ceilf(screenMax[0]) + 1.0f, (float)ctx->m_Width - 1.0f);
+	const float pyMax = core_minf(core_ceilf(screenMax[1]) + 1.0f, (float)ctx->m_Height - 1.0f);
+	if (!(pxMin <= pxMax && pyMin <= pyMax)) {
+		return;
+	}
+
+	const uint32_t txBegin = (uint32_t)pxMin / SWR_CONFIG_FB_TILE_WIDTH;
+	const uint32_t txEnd = (uint32_t)pxMax / SWR_CONFIG_FB_TILE_WIDTH;
+	const uint32_t tyBegin = (uint32_t)pyMin / SWR_CONFIG_FB_TILE_HEIGHT;
+	const uint32_t tyEnd = (uint32_t)pyMax / SWR_CONFIG_FB_TILE_HEIGHT;
+	for (uint32_t ty = tyBegin; ty <= tyEnd; ++ty) {
+		core_memSet(&ctx->m_DirtyTiles[txBegin + ty * ctx->m_NumFBTilesX], 1, txEnd - txBegin + 1);
+	}
+}
+
+static void swrInvalidateAll(swr_context* ctx)
+{
+	core_memSet(ctx->m_DirtyTiles, 1, (size_t)ctx->m_NumFBTilesX * ctx->m_NumFBTilesY);
+}
+
+// Bounding rect of the tiles whose state is non-zero. Empty rects have m_MinX > m_MaxX.
+static swr_rect swrGetTileBounds(const swr_context* ctx, const uint8_t* tiles)
+{
+	uint32_t txMin = UINT32_MAX;
+	uint32_t tyMin = UINT32_MAX;
+	uint32_t txMax = 0;
+	uint32_t tyMax = 0;
+	for (uint32_t ty = 0; ty < ctx->m_NumFBTilesY; ++ty) {
+		for (uint32_t tx = 0; tx < ctx->m_NumFBTilesX; ++tx) {
+			if (tiles[tx + ty * ctx->m_NumFBTilesX]) {
+				txMin = core_minu32(txMin, tx);
+				tyMin = core_minu32(tyMin, ty);
+				txMax = core_maxu32(txMax, tx);
+				tyMax = core_maxu32(tyMax, ty);
+			}
+		}
+	}
+
+	if (txMin == UINT32_MAX) {
+		return (swr_rect){ .m_MinX = 0, .m_MinY = 0, .m_MaxX = -1, .m_MaxY = -1 };
+	}
+
+	const swr_rect tileMin = swrGetTileRect(ctx, txMin, tyMin);
+	const swr_rect tileMax = swrGetTileRect(ctx, txMax, tyMax);
+	return (swr_rect){
+		.m_MinX = tileMin.m_MinX,
+		.m_MinY = tileMin.m_MinY,
+		.m_MaxX = tileMax.m_MaxX,
+		.m_MaxY = tileMax.m_MaxY
+	};
+}
+
+// The scissor rect is set to the bounding rect of the dirty tiles so that everything 
+// drawn during the frame, including clears, stays inside it.
+static bool swrBeginIncrementalFrame(swr_context* ctx)
+{
+	swrFlush(ctx);
+
+	const swr_rect dirtyRect = swrGetTileBounds(ctx, ctx->m_DirtyTiles);
+	if (dirtyRect.m_MinX > dirtyRect.m_MaxX) {
+		return false;
+	}
+
+	const size_t numTiles = (size_t)ctx->m_NumFBTilesX * ctx->m_NumFBTilesY;
+	core_memSet(ctx->m_DirtyTiles, 0, numTiles);
+	core_memSet(ctx->m_DrawnTiles, 0, numTiles);
+	ctx->m_ScissorRect = dirtyRect;
+	ctx->m_IncrementalFrame = true;
+
+	return true;
+}
+
+static void swrEndIncrementalFrame(swr_context* ctx, swr_rect* updateRect)
+{
+	swrFlush(ctx);
+
+	if (updateRect != NULL) {
+		*updateRect = ctx->m_IncrementalFrame
+			? swrGetTileBounds(ctx, ctx->m_DrawnTiles)
+			: (swr_rect){ .m_MinX = 0, .m_MinY = 0, .m_MaxX = -1, .m_MaxY = -1 }
+			;
 	}
+
+	ctx->m_ScissorRect.m_MinX = 0;
+	ctx->m_ScissorRect.m_MinY = 0;
+	ctx->m_ScissorRect.m_MaxX = (int32_t)ctx->m_Width - 1;
+	ctx->m_ScissorRect.m_MaxY = (int32_t)ctx->m_Height - 1;
+	ctx->m_IncrementalFrame = false;
 }
 
 static void swrSetWorldToScreenTransform(swr_context* ctx, const swr_matrix2d* mtx)
@@ -118,6 +525,163 @@ static void swrSetWorldToScreenTransform(swr_context* ctx, const swr_matrix2d* m
 	core_memCopy(&ctx->m_WorldToScreenTransform, mtx, sizeof(swr_matrix2d));
 }
 
+static void swrSetBlendMode(swr_context* ctx, swr_blend_mode mode)
+{
+	ctx->m_BlendMode = (uint32_t)mode;
+}
+
+static void swrSetLineStyle(swr_context* ctx, float width, bool antiAliased)
+{
+	ctx->m_LineWidth = core_maxf(width, 0.0f);
+	ctx->m_LineAntiAliased = antiAliased;
+}
+
+static bool swrSetSampleCount(swr_context* ctx, uint32_t numSamples)
+{
+	if (numSamples != 1 && numSamples != 4 && numSamples != 8) {
+		return false;
+	}
+
+	swrFlush(ctx);
+
+	if (numSamples == ctx->m_NumSamples) {
+		return true;
+	}
+
+	// Sample planes are padded to a multiple of 8 pixels so they are all aligned 
+	// the same way as the framebuffer.
+	const uint32_t numPixels = ctx->m_Width * ctx->m_Height;
+	const uint32_t sampleStride = numSamples != 1
+		? (uint32_t)core_roundUp((int32_t)numPixels, 8)
+		: numPixels
+		;
+	uint32_t* sampleBuffer = ctx->m_FrameBuffer;
+	if (numSamples != 1) {
+		sampleBuffer = (uint32_t*)CORE_ALIGNED_ALLOC(ctx->m_Allocator, sizeof(uint32_t) * (size_t)sampleStride * numSamples, 32);
+		if (!sampleBuffer) {
+			return false;
+		}
+	}
+
+	// Keep the current image by resolving the old samples to the framebuffer and 
+	// replicating it to all the new ones. The resolved image includes the pending clear 
+	// tiles so none of them is pending anymore.
+	swrResolveSampleBuffer(ctx);
+	core_memSet(ctx->m_ClearTiles, 0, (size_t)ctx->m_NumFBTilesX * ctx->m_NumFBTilesY);
+	ctx->m_ClearPending = false;
+	if (ctx->m_SampleBuffer != ctx->m_FrameBuffer) {
+		CORE_ALIGNED_FREE(ctx->m_Allocator, ctx->m_SampleBuffer, 32);
+	}
+
+	if (numSamples != 1) {
+		for (uint32_t i = 0; i < numSamples; ++i) {
+			core_memCopy(&sampleBuffer[i * sampleStride], ctx->m_FrameBuffer, sizeof(uint32_t) * numPixels);
+		}
+	}
+
+	ctx->m_SampleBuffer = sampleBuffer;
+	ctx->m_NumSamples = numSamples;
+	ctx->m_SampleStride = sampleStride;
+	ctx->m_SampleExtent = 0;
+	core_memSet(ctx->m_SampleOffsets, 0, sizeof(ctx->m_SampleOffsets));
+
+	// Replicated samples don't match what drawing with the new sample count produces, 
+	// so the next incremental frame has to redraw everything.
+	swrInvalidateAll(ctx);
+
+	if (numSamples != 1) {
+		const int8_t* pattern = numSamples == 4
+			? kSamplePattern4x
+			: kSamplePattern8x
+			;
+		for (uint32_t i = 0; i < numSamples * 2; ++i) {
+			const int32_t offset = (int32_t)pattern[i] * (1 << (SWR_CONFIG_SUBPIXEL_BITS - 4));
+			ctx->m_SampleOffsets[i] = offset;
+			ctx->m_SampleExtent = core_maxi32(ctx->m_SampleExtent, core_absi32(offset));
+		}
+	}
+
+	return true;
+}
+
+// Averages the samples of each pixel into the framebuffer and fills the pending clear 
+// tiles with the clear color. Without multisampling the rasterizers write directly to 
+// the framebuffer so only the pending tiles have to be written, after which they're 
+// no longer pending. Pending tiles keep their stale samples with multisampling.
+static void swrResolveSampleBuffer(swr_context* ctx)
+{
+	const uint32_t width = ctx->m_Width;
+	const uint32_t height = ctx->m_Height;
+	const bool multisample = ctx->m_NumSamples != 1;
+	if (!ctx->m_ClearPending) {
+		if (multisample) {
+			swr->resolveSamples(width * height, ctx->m_NumSamples, ctx->m_SampleStride, ctx->m_SampleBuffer, ctx->m_FrameBuffer);
+		}
+
+		return;
+	}
+
+	// Runs of consecutive tiles in the same state are written one row at a time.
+	const uint32_t numTilesX = ctx->m_NumFBTilesX;
+	for (uint32_t ty = 0; ty < ctx->m_NumFBTilesY; ++ty) {
+		const uint8_t* tileRow = &ctx->m_ClearTiles[ty * numTilesX];
+		const uint32_t yBegin = ty * SWR_CONFIG_FB_TILE_HEIGHT;
+		const uint32_t yEnd = core_minu32(yBegin + SWR_CONFIG_FB_TILE_HEIGHT, height);
+
+		uint32_t txBegin = 0;
+		while (txBegin < numTilesX) {
+			const uint8_t pending = tileRow[txBegin];
+			uint32_t txEnd = txBegin + 1;
+			while (txEnd < numTilesX && tileRow[txEnd] == pending) {
+				++txEnd;
+			}
+
+			const uint32_t x = txBegin * SWR_CONFIG_FB_TILE_WIDTH;
+			const uint32_t n = core_minu32(txEnd * SWR_CONFIG_FB_TILE_WIDTH, width) - x;
+			if (pending || multisample) {
+				for (uint32_t y = yBegin; y < yEnd; ++y) {
+					const uint32_t offset = x + y * width;
+					if (pending) {
+						swr->fillSpan(&ctx->m_FrameBuffer[offset], n, ctx->m_ClearColor, SWR_BLEND_MODE_OPAQUE);
+					} else {
+						swr->resolveSamples(n, ctx->m_NumSamples, ctx->m_SampleStride, &ctx->m_SampleBuffer[offset], &ctx->m_FrameBuffer[offset]);
+					}
+				}
+			}
+
+			txBegin = txEnd;
+		}
+	}
+
+	if (!multisample) {
+		core_memSet(ctx->m_ClearTiles, 0, (size_t)numTilesX * ctx->m_NumFBTilesY);
+		ctx->m_ClearPending = false;
+	}
+}
+
+static void swrBindTexture(swr_context* ctx, const swr_texture* tex, swr_texture_filter filter)
+{
+	ctx->m_Texture = tex;
+	ctx->m_TextureFilter = filter;
+}
+
+static void swrUnbindTexture(swr_context* ctx)
+{
+	ctx->m_Texture = NULL;
+}
+
+static void swrBindPixelShader(swr_context* ctx, swr_pixel_shader_func func, void* userData)
+{
+	ctx->m_PixelShader = func;
+	ctx->m_PixelShaderUserData = userData;
+}
+
+static void swrUnbindPixelShader(swr_context* ctx)
+{
+	ctx->m_PixelShader = NULL;
+	ctx->m_PixelShaderUserData = NULL;
+}
+
 static void swrBindVertexBuffer(swr_context* ctx, swr_vertex_attrib va, swr_format format, uint32_t stride, uint32_t n, const void* ptr)
 {
 	swr_vertex_buffer* vb = &ctx->m_VertexBuffers[va];
@@ -134,11 +698,12 @@ static void swrUnbindVertexBuffer(swr_context* ctx, swr_vertex_attrib va)
 	ctx->m_BoundBuffers &= ~(1u << va);
 }
 
-static void swrBindIndexBuffer(swr_context* ctx, uint32_t n, const uint16_t* ptr)
+static void swrBindIndexBuffer(swr_context* ctx, swr_format format, uint32_t n, const void* ptr)
 {
 	swr_index_buffer* ib = &ctx->m_IndexBuffer;
 	ib->m_Ptr = ptr;
 	ib->m_Count = n;
+	ib->m_Format = format;
 
 	ctx->m_BoundBuffers |= (1u << 31);
 }
@@ -148,219 +713,1276 @@ static void swrUnbindIndexBuffer(swr_context* ctx)
 	ctx->m_BoundBuffers &= ~(1u << 31);
 }
 
-static void swrDrawPrimitives(swr_context* ctx, swr_primitive_type primType, uint16_t startIndex, uint16_t endIndex, uint32_t numIndices, uint32_t baseIndex, uint32_t baseVertex)
+static void swrBindClusterBuffer(swr_context* ctx, uint32_t n, uint32_t numTrianglesPerCluster, const swr_cluster* ptr)
+{
+	if (numTrianglesPerCluster == 0) {
+		swrUnbindClusterBuffer(ctx);
+		return;
+	}
+
+	swr_cluster_buffer* cb = &ctx->m_ClusterBuffer;
+	cb->m_Ptr = ptr;
+	cb->m_Count = n;
+	cb->m_NumTrianglesPerCluster = numTrianglesPerCluster;
+
+	ctx->m_BoundBuffers |= (1u << 30);
+}
+
+static void swrUnbindClusterBuffer(swr_context* ctx)
+{
+	ctx->m_BoundBuffers &= ~(1u << 30);
+}
+
+static void swrDrawPrimitives(swr_context* ctx, swr_primitive_type primType, uint32_t startIndex, uint32_t endIndex, uint32_t numIndices, uint32_t baseIndex, uint32_t baseVertex)
 {
-	if (primType != SWR_PRIMITIVE_TYPE_TRIANGLE_LIST || numIndices == 0 || startIndex >= endIndex) {
+	if (numIndices == 0 || startIndex >= endIndex) {
 		return;
 	}
 
 	const uint32_t boundBuffers = ctx->m_BoundBuffers;
 	const bool hasPos = (boundBuffers & (1u << SWR_VERTEX_ATTRIB_POSITION)) != 0;
-	const bool hasColor = (boundBuffers & (1u << SWR_VERTEX_ATTRIB_COLOR)) != 0;
 	const bool hasIndex = (boundBuffers & (1u << 31)) != 0;
+	const bool hasClusters = (boundBuffers & (1u << 30)) != 0;
 	if (!hasPos || !hasIndex) {
 		return;
 	}
 
+	const swr_index_buffer* indexBuffer = &ctx->m_IndexBuffer;
+	const uint32_t indexFormat = indexBuffer->m_Format;
+	if (indexFormat != SWR_FORMAT_1US && indexFormat != SWR_FORMAT_1UI) {
+		return;
+	}
+
 	core_allocatorResetLinearAllocator(ctx->m_TempAllocator);
 
-	// Transform vertex position to screen space
-	const swr_vertex_buffer* posBuffer = &ctx->m_VertexBuffers[SWR_VERTEX_ATTRIB_POSITION];
-	const uint32_t maxVertices = (uint32_t)(endIndex - startIndex) + 1;
-	if ((baseVertex + maxVertices) > posBuffer->m_Count) {
+	// 16-bit triangle lists index the vertex arrays directly, so those start at baseVertex. 
+	// Everything else is drawn as a 32-bit triangle list (see swrDrawTriangleList32) and 
+	// the vertex arrays start at the first vertex in range.
+	const bool isTriangleList16 = primType == SWR_PRIMITIVE_TYPE_TRIANGLE_LIST && indexFormat == SWR_FORMAT_1US;
+	const uint32_t firstVertex = isTriangleList16 ? 0 : startIndex;
+	const uint32_t numVertices = endIndex - firstVertex + 1;
+	swr_vertex_buffer posBufferWorld;
+	if (!swrGetVertexPositions(ctx, baseVertex + firstVertex, numVertices, &posBufferWorld)) {
 		return;
 	}
 
-	int32_t* posBufferScreen = (int32_t*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(int32_t) * 2 * maxVertices);
-	if (posBuffer->m_Format == SWR_FORMAT_2F && posBuffer->m_Stride == 0) {
-		const float* posBufferPtr = (float*)posBuffer->m_Ptr;
-		const float* posBufferWorld = &posBufferPtr[baseVertex * 2];
-		swr->transformPos2fTo2i(maxVertices, posBufferWorld, posBufferScreen, ctx->m_WorldToScreenTransform.m_Elem);
-	} else {
-		// TODO: Combination not implemented yet.
-	}
+	int32_t* posBufferScreen = (int32_t*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(int32_t) * 2 * numVertices);
 
-	// Rasterize all primitives
-	if (primType == SWR_PRIMITIVE_TYPE_TRIANGLE_LIST) {
-		const uint32_t numTriangles = numIndices / 3;
+	float mtx[6];
+	swrGetSubpixelTransform(ctx, mtx);
 
-		const swr_vertex_buffer* colorBuffer = &ctx->m_VertexBuffers[SWR_VERTEX_ATTRIB_COLOR];
-		const bool colorBufferIsValid = colorBuffer->m_Stride == 0
-			&& (colorBuffer->m_Format == SWR_FORMAT_1UI || colorBuffer->m_Format == SWR_FORMAT_4UB)
+	uint32_t color;
+	const uint32_t* colorPtr = swrGetVertexColors(ctx, baseVertex + firstVertex, numVertices, &color);
+	if (primType == SWR_PRIMITIVE_TYPE_LINE_LIST || primType == SWR_PRIMITIVE_TYPE_LINE_STRIP) {
+		const void* indices = indexFormat == SWR_FORMAT_1UI
+			? (const void*)&((const uint32_t*)indexBuffer->m_Ptr)[baseIndex]
+			: (const void*)&((const uint16_t*)indexBuffer->m_Ptr)[baseIndex]
 			;
 
-		if (hasColor && colorBufferIsValid && colorBuffer->m_Count == posBuffer->m_Count) {
-			// Per-vertex color triangle rasterization
-			const uint32_t* colorBufferPtr = (uint32_t*)colorBuffer->m_Ptr;
-			const uint32_t* colorPtr = &colorBufferPtr[baseVertex];
-			const uint16_t* indexPtr = &ctx->m_IndexBuffer.m_Ptr[baseIndex];
-			for (uint32_t iTri = 0; iTri < numTriangles; ++iTri) {
-				const uint16_t id0 = indexPtr[0];
-				const uint16_t id1 = indexPtr[1];
-				const uint16_t id2 = indexPtr[2];
+		swrTransformVertexPositions(&posBufferWorld, 0, numVertices - 1, posBufferScreen, mtx);
+		swrDrawLines(ctx, primType, indexFormat, numIndices, indices, firstVertex, posBufferScreen, colorPtr, color);
+		return;
+	}
 
-				// TODO: Check if indices are in bounds.
+	const float* texCoordPtr = swrGetVertexTexCoords(ctx, baseVertex + firstVertex, numVertices);
+	const uint32_t numVaryings = swrSetupVaryings(ctx, texCoordPtr != NULL);
+	float* varyingPtr = numVaryings != 0
+		? (float*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(float) * numVaryings * numVertices)
+		: NULL
+		;
 
-				swr->drawTriangle(ctx
-					, posBufferScreen[id0 * 2 + 0], posBufferScreen[id0 * 2 + 1]
-					, posBufferScreen[id1 * 2 + 0], posBufferScreen[id1 * 2 + 1]
-					, posBufferScreen[id2 * 2 + 0], posBufferScreen[id2 * 2 + 1]
-					, colorPtr[id0]
-					, colorPtr[id1]
-					, colorPtr[id2]
-				);
+	if (!isTriangleList16) {
+		const void* indices = indexFormat == SWR_FORMAT_1UI
+			? (const void*)&((const uint32_t*)indexBuffer->m_Ptr)[baseIndex]
+			: (const void*)&((const uint16_t*)indexBuffer->m_Ptr)[baseIndex]
+			;
 
-				indexPtr += 3;
-			}
+		const uint32_t* triangles;
+		uint32_t numTriangles;
+		if (primType == SWR_PRIMITIVE_TYPE_TRIANGLE_LIST) {
+			triangles = (const uint32_t*)indices;
+			numTriangles = numIndices / 3;
 		} else {
-			// Constant color triangle rasterization.
-			const uint32_t color = colorBufferIsValid
-				? ((uint32_t*)colorBuffer->m_Ptr)[0]
-				: SWR_COLOR_WHITE
-				;
+			uint32_t* assembledTriangles = (uint32_t*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(uint32_t) * numIndices * 3);
+			numTriangles = swr->assembleTriangles(primType, (swr_format)indexFormat, numIndices, indices, assembledTriangles);
+			triangles = assembledTriangles;
+		}
 
-			const uint16_t* indexPtr = &ctx->m_IndexBuffer.m_Ptr[baseIndex];
-			for (uint32_t iTri = 0; iTri < numTriangles; ++iTri) {
-				const uint16_t id0 = indexPtr[0];
-				const uint16_t id1 = indexPtr[1];
-				const uint16_t id2 = indexPtr[2];
+		if (numTriangles == 0) {
+			return;
+		}
 
-				// TODO: Check if indices are in bounds.
+		swrTransformVertexPositions(&posBufferWorld, 0, numVertices - 1, posBufferScreen, mtx);
+		if (varyingPtr != NULL) {
+			swrFetchVaryings(ctx, baseVertex + firstVertex, NULL, 0, numVertices - 1, varyingPtr);
+		}
+		swrDrawTriangleList32(ctx, triangles, numTriangles, firstVertex, &posBufferWorld, posBufferScreen, mtx, colorPtr, color, texCoordPtr, varyingPtr);
+		return;
+	}
 
-				// TODO: Optimized drawTriangle without color interpolation
-				swr->drawTriangle(ctx
-					, posBufferScreen[id0 * 2 + 0], posBufferScreen[id0 * 2 + 1]
-					, posBufferScreen[id1 * 2 + 0], posBufferScreen[id1 * 2 + 1]
-					, posBufferScreen[id2 * 2 + 0], posBufferScreen[id2 * 2 + 1]
-					, color
-					, color
-					, color
-				);
+	const uint16_t* indices = &((const uint16_t*)indexBuffer->m_Ptr)[baseIndex];
+	const uint32_t numTriangles = numIndices / 3;
+	if (!hasClusters || (baseIndex % 3) != 0) {
+		// Transform vertex position to screen space and rasterize all primitives.
+		swrTransformVertexPositions(&posBufferWorld, startIndex, endIndex, posBufferScreen, mtx);
+		if (varyingPtr != NULL) {
+			swrFetchVaryings(ctx, baseVertex, NULL, startIndex, endIndex, varyingPtr);
+		}
+		swrDrawTriangleList(ctx, indices, numTriangles, &posBufferWorld, posBufferScreen, mtx, colorPtr, color, texCoordPtr, varyingPtr);
+		return;
+	}
 
-				indexPtr += 3;
+	// Cluster culling. Only the vertices of visible clusters are transformed. Runs of 
+	// consecutive visible clusters are rasterized together to keep setup batches large.
+	const swr_cluster_buffer* clusterBuffer = &ctx->m_ClusterBuffer;
+	const uint32_t numTrianglesPerCluster = clusterBuffer->m_NumTrianglesPerCluster;
+	const uint32_t firstTriangle = baseIndex / 3;
+	const uint32_t lastTriangle = firstTriangle + numTriangles;
+
+	uint32_t runFirstTriangle = firstTriangle;
+	uint32_t runNumTriangles = 0;
+	uint32_t iTri = firstTriangle;
+	while (iTri < lastTriangle) {
+		const uint32_t clusterID = iTri / numTrianglesPerCluster;
+		const uint32_t clusterEnd = core_minu32((clusterID + 1) * numTrianglesPerCluster, lastTriangle);
+
+		// Triangles past the last cluster are always drawn.
+		const swr_cluster* cluster = clusterID < clusterBuffer->m_Count
+			? &clusterBuffer->m_Ptr[clusterID]
+			: NULL
+			;
+		if (cluster == NULL || swrClusterIsVisible(ctx, cluster)) {
+			const uint32_t minVertex = cluster != NULL ? core_maxu32(cluster->m_MinVertex, startIndex) : startIndex;
+			const uint32_t maxVertex = cluster != NULL ? core_minu32(cluster->m_MaxVertex, endIndex) : endIndex;
+			if (minVertex <= maxVertex) {
+				swrTransformVertexPositions(&posBufferWorld, minVertex, maxVertex, posBufferScreen, mtx);
+				if (varyingPtr != NULL) {
+					swrFetchVaryings(ctx, baseVertex, NULL, minVertex, maxVertex, varyingPtr);
+				}
+			}
+
+			if (runNumTriangles == 0) {
+				runFirstTriangle = iTri;
 			}
+			runNumTriangles += clusterEnd - iTri;
+		} else if (runNumTriangles != 0) {
+			swrDrawTriangleList(ctx, &indices[(runFirstTriangle - firstTriangle) * 3], runNumTriangles, &posBufferWorld, posBufferScreen, mtx, colorPtr, color, texCoordPtr, varyingPtr);
+			runNumTriangles = 0;
 		}
-	}
-}
 
-static void swrDrawPixel(swr_context* ctx, int32_t x, int32_t y, uint32_t color)
-{
-	if (x < 0 || x >= (int32_t)ctx->m_Width || y < 0 || y >= (int32_t)ctx->m_Height) {
-		return;
+		iTri = clusterEnd;
 	}
 
-	ctx->m_FrameBuffer[x + y * ctx->m_Width] = color;
+	if (runNumTriangles != 0) {
+		swrDrawTriangleList(ctx, &indices[(runFirstTriangle - firstTriangle) * 3], runNumTriangles, &posBufferWorld, posBufferScreen, mtx, colorPtr, color, texCoordPtr, varyingPtr);
+	}
 }
 
-static void swrDrawLine(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+static void swrDrawBVH(swr_context* ctx, const swr_bvh* bvh, uint32_t baseVertex)
 {
-	bool steep = false;
-	if (core_absi32(x0 - x1) < core_absi32(y0 - y1)) {
-		{ int32_t tmp = x0; x0 = y0; y0 = tmp; }
-		{ int32_t tmp = x1; x1 = y1; y1 = tmp; }
-		steep = true;
+	if (bvh->m_NumTriangles == 0) {
+		return;
 	}
 
-	if (x0 > x1) {
-		{ int32_t tmp = x0; x0 = x1; x1 = tmp; }
-		{ int32_t tmp = y0; y0 = y1; y1 = tmp; }
+	const bool hasPos = (ctx->m_BoundBuffers & (1u << SWR_VERTEX_ATTRIB_POSITION)) != 0;
+	if (!hasPos) {
+		return;
 	}
 
-	const int32_t dx = x1 - x0;
-	const int32_t derror2 = core_absi32(y1 - y0) * 2;
-	const int32_t yinc = y1 > y0 ? 1 : -1;
-
-	int32_t error2 = 0;
-	int32_t y = y0;
+	core_allocatorResetLinearAllocator(ctx->m_TempAllocator);
 
-	if (steep) {
-		for (int32_t x = x0; x <= x1; x++) {
-			swrDrawPixel(ctx, y, x, color);
+	const uint32_t numSrcVertices = (uint32_t)bvh->m_MaxVertexID + 1;
+	swr_vertex_buffer srcPos;
+	if (!swrGetVertexPositions(ctx, baseVertex, numSrcVertices, &srcPos)) {
+		return;
+	}
 
-			error2 += derror2;
-			if (error2 > dx) {
-				y += yinc;
-				error2 -= dx * 2;
-			}
-		}
-	} else {
-		for (int32_t x = x0; x <= x1; x++) {
-			swrDrawPixel(ctx, x, y, color);
+	// World space bounding box of the scissor rect (with a 1 pixel margin for rounding).
+	const float* m = ctx->m_WorldToScreenTransform.m_Elem;
+	const float det = m[0] * m[3] - m[1] * m[2];
+	if (det == 0.0f) {
+		return;
+	}
 
-			error2 += derror2;
-			if (error2 > dx) {
-				y += yinc;
-				error2 -= dx * 2;
-			}
-		}
+	const float invDet = 1.0f / det;
+	const swr_rect* scissor = &ctx->m_ScissorRect;
+	const float screenRect[4] = { (float)scissor->m_MinX - 1.0f, (float)scissor->m_MinY - 1.0f, (float)scissor->m_MaxX + 2.0f, (float)scissor->m_MaxY + 2.0f };
+	float queryMin[2] = { FLT_MAX, FLT_MAX };
+	float queryMax[2] = { -FLT_MAX, -FLT_MAX };
+	for (uint32_t i = 0; i < 4; ++i) {
+		const float dx = screenRect[(i & 1) << 1] - m[4];
+		const float dy = screenRect[(i & 2) | 1] - m[5];
+		const float wx = (m[3] * dx - m[2] * dy) * invDet;
+		const float wy = (m[0] * dy - m[1] * dx) * invDet;
+		queryMin[0] = core_minf(queryMin[0], wx);
+		queryMin[1] = core_minf(queryMin[1], wy);
+		queryMax[0] = core_maxf(queryMax[0], wx);
+		queryMax[1] = core_maxf(queryMax[1], wy);
 	}
-}
 
-static void swrDrawText(swr_context* ctx, const swr_font* font, int32_t x0, int32_t y0, const char* str, const char* end, uint32_t color)
-{
-	end = end != NULL
-		? end
-		: str + core_strlen(str)
-		;
+	float mtx[6];
+	swrGetSubpixelTransform(ctx, mtx);
 
-	const int32_t chw = (int32_t)font->m_CharWidth;
-	const int32_t chh = (int32_t)font->m_CharHeight;
-	const uint8_t* chdata = font->m_CharData;
+	uint32_t color;
+	const uint32_t* colorPtr = swrGetVertexColors(ctx, baseVertex, numSrcVertices, &color);
+	const float* texCoordPtr = swrGetVertexTexCoords(ctx, baseVertex, numSrcVertices);
+	const uint32_t numVaryings = swrSetupVaryings(ctx, texCoordPtr != NULL);
 
-	int32_t x = x0;
-	int32_t y = y0;
-	while (str != end) {
-		char ch = *str;
-		if (ch < font->m_CharMin || ch > font->m_CharMax) {
-			ch = font->m_MissingCharFallbackID;
+	// BVH vertices are gathered into local arrays on demand, per visible leaf. Positions 
+	// are converted to floats on the way.
+	const uint32_t numVertices = bvh->m_NumVertices;
+	const uint16_t* vertexIDs = bvh->m_VertexIDs;
+	float* posBufferWorldPtr = (float*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(float) * 2 * numVertices);
+	const swr_vertex_buffer posBufferWorld = {
+		.m_Ptr = posBufferWorldPtr,
+		.m_Count = numVertices,
+		.m_Format = SWR_FORMAT_2F,
+		.m_Stride = sizeof(float) * 2
+	};
+	int32_t* posBufferScreen = (int32_t*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(int32_t) * 2 * numVertices);
+	uint32_t* colorBuffer = colorPtr != NULL
+		? (uint32_t*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(uint32_t) * numVertices)
+		: NULL
+		;
+	float* texCoordBuffer = texCoordPtr != NULL
+		? (float*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(float) * 2 * numVertices)
+		: NULL
+		;
+	float* varyingBuffer = numVaryings != 0
+		? (float*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(float) * numVaryings * numVertices)
+		: NULL
+		;
+
+	// Stackless traversal. Visible leaves which are adjacent in the index buffer 
+	// are rasterized as a single batch.
+	const swr_bvh_node* nodes = bvh->m_Nodes;
+	const uint32_t numNodes = bvh->m_NumNodes;
+	uint32_t runFirstTriangle = 0;
+	uint32_t runNumTriangles = 0;
+	uint32_t nodeID = 0;
+	while (nodeID < numNodes) {
+		const swr_bvh_node* node = &nodes[nodeID];
+		const bool isVisible = true
+			&& node->m_BoundsMax[0] >= queryMin[0]
+			&& node->m_BoundsMax[1] >= queryMin[1]
+			&& node->m_BoundsMin[0] <= queryMax[0]
+			&& node->m_BoundsMin[1] <= queryMax[1]
+			;
+		if (!isVisible) {
+			nodeID = node->m_SkipNodeID;
+			continue;
 		}
 
-		const uint8_t chID = (uint8_t)ch - font->m_CharMin;
-		const uint8_t* charData = &chdata[chID * chh];
-		for (int32_t chy = 0; chy < chh; ++chy) {
-			const uint8_t chrow = charData[chy];
-			for (int32_t chx = 0; chx < chw; ++chx) {
-				if ((chrow & (1u << chx)) != 0) {
-					swrDrawPixel(ctx, x + chx, y + chy, color);
+		if (node->m_NumTriangles != 0) {
+			const uint32_t minVertex = node->m_MinVertex;
+			const uint32_t maxVertex = node->m_MaxVertex;
+			for (uint32_t i = minVertex; i <= maxVertex; ++i) {
+				swrGetVertexPos(&srcPos, vertexIDs[i], &posBufferWorldPtr[i * 2]);
+			}
+			if (colorBuffer != NULL) {
+				for (uint32_t i = minVertex; i <= maxVertex; ++i) {
+					colorBuffer[i] = colorPtr[vertexIDs[i]];
 				}
 			}
+			if (texCoordBuffer != NULL) {
+				for (uint32_t i = minVertex; i <= maxVertex; ++i) {
+					const uint32_t srcID = vertexIDs[i];
+					texCoordBuffer[i * 2 + 0] = texCoordPtr[srcID * 2 + 0];
+					texCoordBuffer[i * 2 + 1] = texCoordPtr[srcID * 2 + 1];
+				}
+			}
+			if (varyingBuffer != NULL) {
+				swrFetchVaryings(ctx, baseVertex, vertexIDs, minVertex, maxVertex, varyingBuffer);
+			}
+			swr->transformPos2fTo2i(maxVertex - minVertex + 1, &posBufferWorldPtr[minVertex * 2], &posBufferScreen[minVertex * 2], mtx);
+
+			if (runNumTriangles != 0 && runFirstTriangle + runNumTriangles != node->m_FirstTriangle) {
+				swrDrawTriangleList(ctx, &bvh->m_Indices[runFirstTriangle * 3], runNumTriangles, &posBufferWorld, posBufferScreen, mtx, colorBuffer, color, texCoordBuffer, varyingBuffer);
+				runNumTriangles = 0;
+			}
+
+			if (runNumTriangles == 0) {
+				runFirstTriangle = node->m_FirstTriangle;
+			}
+			runNumTriangles += node->m_NumTriangles;
 		}
 
-		x += chw;
+		++nodeID;
+	}
 
-		++str;
+	if (runNumTriangles != 0) {
+		swrDrawTriangleList(ctx, &bvh->m_Indices[runFirstTriangle * 3], runNumTriangles, &posBufferWorld, posBufferScreen, mtx, colorBuffer, color, texCoordBuffer, varyingBuffer);
 	}
 }
 
-extern void swrDrawTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
-extern void swrDrawTriangleSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
-extern void swrDrawTriangleSSSE3(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
-extern void swrDrawTriangleSSE41(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
+// The rasterizer expects vertex positions in fixed point.
+static void swrGetSubpixelTransform(const swr_context* ctx, float* mtx)
+{
+	const float subpixelScale = (float)(1 << SWR_CONFIG_SUBPIXEL_BITS);
+	for (uint32_t i = 0; i < 6; ++i) {
+		mtx[i] = ctx->m_WorldToScreenTransform.m_Elem[i] * subpixelScale;
+	}
+}
+
+// The bound position buffer, starting at vertex 'baseVertex' and with the stride resolved. 
+// Returns false if it doesn't hold 'numVertices' vertices from there or if it isn't in one 
+// of the position formats.
+static bool swrGetVertexPositions(const swr_context* ctx, uint32_t baseVertex, uint32_t numVertices, swr_vertex_buffer* positions)
+{
+	const swr_vertex_buffer* posBuffer = &ctx->m_VertexBuffers[SWR_VERTEX_ATTRIB_POSITION];
+	const uint32_t format = posBuffer->m_Format;
+	const bool isPosFormat = false
+		|| format == SWR_FORMAT_2F
+		|| format == SWR_FORMAT_2US
+		|| format == SWR_FORMAT_2S
+		|| format == SWR_FORMAT_2H
+		;
+	if (!isPosFormat || (baseVertex + numVertices) > posBuffer->m_Count) {
+		return false;
+	}
+
+	const uint32_t stride = posBuffer->m_Stride != 0 ? posBuffer->m_Stride : swrFormatSize(format);
+	positions->m_Ptr = (const uint8_t*)posBuffer->m_Ptr + baseVertex * stride;
+	positions->m_Count = numVertices;
+	positions->m_Format = (uint16_t)format;
+	positions->m_Stride = (uint16_t)stride;
+
+	return true;
+}
+
+// World space position of vertex 'id' (see swrGetVertexPositions).
+static void swrGetVertexPos(const swr_vertex_buffer* positions, uint32_t id, float* pos)
+{
+	const uint8_t* v = (const uint8_t*)positions->m_Ptr + id * positions->m_Stride;
+	switch (positions->m_Format) {
+	case SWR_FORMAT_2F:
+		pos[0] = ((const float*)v)[0];
+		pos[1] = ((const float*)v)[1];
+		break;
+	case SWR_FORMAT_2US:
+		pos[0] = (float)((const uint16_t*)v)[0];
+		pos[1] = (float)((const uint16_t*)v)[1];
+		break;
+	case SWR_FORMAT_2S:
+		pos[0] = (float)((const int16_t*)v)[0];
+		pos[1] = (float)((const int16_t*)v)[1];
+		break;
+	case SWR_FORMAT_2H:
+		pos[0] = swrHalfToFloat(((const uint16_t*)v)[0]);
+		pos[1] = swrHalfToFloat(((const uint16_t*)v)[1]);
+		break;
+	}
+}
+
+// Transforms the positions of vertices [first, last] to sub-pixel screen coordinates, 
+// using the kernel of their format.
+static void swrTransformVertexPositions(const swr_vertex_buffer* positions, uint32_t first, uint32_t last, int32_t* posScreen, const float* mtx)
+{
+	const uint32_t n = last - first + 1;
+	const uint32_t stride = positions->m_Stride;
+	const uint8_t* src = (const uint8_t*)positions->m_Ptr + first * stride;
+	int32_t* dst = &posScreen[first * 2];
+	switch (positions->m_Format) {
+	case SWR_FORMAT_2F:
+		if (stride == sizeof(float) * 2) {
+			swr->transformPos2fTo2i(n, (const float*)src, dst, mtx);
+		} else {
+			swr->transformPos2fStridedTo2i(n, (const float*)src, stride, dst, mtx);
+		}
+		break;
+	case SWR_FORMAT_2US:
+		swr->transformPos2usTo2i(n, (const uint16_t*)src, stride, dst, mtx);
+		break;
+	case SWR_FORMAT_2S:
+		swr->transformPos2sTo2i(n, (const int16_t*)src, stride, dst, mtx);
+		break;
+	case SWR_FORMAT_2H:
+		swr->transformPos2hTo2i(n, (const uint16_t*)src, stride, dst, mtx);
+		break;
+	}
+}
+
+// Either per-vertex colors or a single color for all triangles. Returns NULL 
+// and writes the color to 'color' in the latter case. Interleaved colors are 
+// gathered into a temporary array of 'numVertices' colors.
+static const uint32_t* swrGetVertexColors(const swr_context* ctx, uint32_t baseVertex, uint32_t numVertices, uint32_t* color)
+{
+	const bool hasColor = (ctx->m_BoundBuffers & (1u << SWR_VERTEX_ATTRIB_COLOR)) != 0;
+	const swr_vertex_buffer* posBuffer = &ctx->m_VertexBuffers[SWR_VERTEX_ATTRIB_POSITION];
+	const swr_vertex_buffer* colorBuffer = &ctx->m_VertexBuffers[SWR_VERTEX_ATTRIB_COLOR];
+	const bool colorBufferIsValid = false
+		|| colorBuffer->m_Format == SWR_FORMAT_1UI 
+		|| colorBuffer->m_Format == SWR_FORMAT_4UB
+		;
+
+	*color = SWR_COLOR_WHITE;
+	if (hasColor && colorBufferIsValid && colorBuffer->m_Count == posBuffer->m_Count) {
+		const uint32_t stride = colorBuffer->m_Stride;
+		if (stride == 0 || stride == sizeof(uint32_t)) {
+			const uint32_t* colorBufferPtr = (uint32_t*)colorBuffer->m_Ptr;
+			return &colorBufferPtr[baseVertex];
+		}
+
+		const uint8_t* src = (const uint8_t*)colorBuffer->m_Ptr + baseVertex * stride;
+		uint32_t* colors = (uint32_t*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(uint32_t) * numVertices);
+		for (uint32_t i = 0; i < numVertices; ++i) {
+			colors[i] = *(const uint32_t*)&src[i * stride];
+		}
+		return colors;
+	} else if (colorBufferIsValid) {
+		*color = ((uint32_t*)colorBuffer->m_Ptr)[0];
+	}
+
+	return NULL;
+}
+
+// Per-vertex texture coordinates if both a texture and a matching texture coordinate 
+// buffer are bound, NULL otherwise. Interleaved texture coordinates are gathered into 
+// a temporary array of 'numVertices' coordinate pairs.
+static const float* swrGetVertexTexCoords(const swr_context* ctx, uint32_t baseVertex, uint32_t numVertices)
+{
+	const bool hasTexCoord = (ctx->m_BoundBuffers & (1u << SWR_VERTEX_ATTRIB_TEXCOORD)) != 0;
+	const swr_vertex_buffer* posBuffer = &ctx->m_VertexBuffers[SWR_VERTEX_ATTRIB_POSITION];
+	const swr_vertex_buffer* texCoordBuffer = &ctx->m_VertexBuffers[SWR_VERTEX_ATTRIB_TEXCOORD];
+	const bool texCoordBufferIsValid = true
+		&& texCoordBuffer->m_Format == SWR_FORMAT_2F
+		&& texCoordBuffer->m_Count == posBuffer->m_Count
+		;
+	if (ctx->m_Texture == NULL || !hasTexCoord || !texCoordBufferIsValid) {
+		return NULL;
+	}
+
+	const uint32_t stride = texCoordBuffer->m_Stride;
+	if (stride == 0 || stride == sizeof(float) * 2) {
+		const float* texCoordBufferPtr = (const float*)texCoordBuffer->m_Ptr;
+		return &texCoordBufferPtr[baseVertex * 2];
+	}
+
+	const uint8_t* src = (const uint8_t*)texCoordBuffer->m_Ptr + baseVertex * stride;
+	float* texCoords = (float*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(float) * 2 * numVertices);
+	for (uint32_t i = 0; i < numVertices; ++i) {
+		const float* uv = (const float*)&src[i * stride];
+		texCoords[i * 2 + 0] = uv[0];
+		texCoords[i * 2 + 1] = uv[1];
+	}
+	return texCoords;
+}
+
+// Varyings of custom pixel shaders (see bindPixelShader). Sets up ctx->m_VaryingLayout 
+// from the bound vertex buffers and returns the number of varyings per vertex. Returns 
+// 0 if there's no pixel shader, if triangles are textured or if there's nothing to 
+// interpolate. Attributes which break the constraints documented in swr.h are asserted 
+// on and left out of the layout (their swr_pixel_shader_tile::m_Attribs are NULL).
+static uint32_t swrSetupVaryings(swr_context* ctx, bool textured)
+{
+	swr_varying_layout* layout = &ctx->m_VaryingLayout;
+	core_memSet(layout, 0, sizeof(swr_varying_layout));
+	if (ctx->m_PixelShader == NULL || textured) {
+		return 0;
+	}
+
+	const swr_vertex_buffer* posBuffer = &ctx->m_VertexBuffers[SWR_VERTEX_ATTRIB_POSITION];
+	uint32_t numVaryings = 0;
+	for (uint32_t va = SWR_VERTEX_ATTRIB_POSITION + 1; va < SWR_VERTEX_ATTRIB_COUNT; ++va) {
+		if ((ctx->m_BoundBuffers & (1u << va)) == 0) {
+			continue;
+		}
+
+		const swr_vertex_buffer* vb = &ctx->m_VertexBuffers[va];
+		const uint32_t numComponents = swrFormatNumComponents(vb->m_Format);
+		assert(vb->m_Count == posBuffer->m_Count && "Vertex attributes must have one entry per vertex.");
+		assert(numComponents != 0 && "Vertex attribute format can't be interpolated.");
+		assert(numVaryings + numComponents <= SWR_CONFIG_MAX_VARYINGS && "Too many vertex attribute components.");
+		const bool isValid = true
+			&& vb->m_Count == posBuffer->m_Count
+			&& numComponents != 0
+			&& numVaryings + numComponents <= SWR_CONFIG_MAX_VARYINGS
+			;
+		if (!isValid) {
+			continue;
+		}
+
+		layout->m_FirstVarying[va] = (uint8_t)numVaryings;
+		layout->m_NumComponents[va] = (uint8_t)numComponents;
+		numVaryings += numComponents;
+	}
+
+	layout->m_NumVaryings = numVaryings;
+
+	return numVaryings;
+}
+
+// Converts the varyings of vertices [first, last] to floats, m_NumVaryings per vertex. 
+// Vertex i is read from vertex baseVertex + vertexIDs[i] of the vertex buffers, or 
+// baseVertex + i if 'vertexIDs' is NULL.
+static void swrFetchVaryings(const swr_context* ctx, uint32_t baseVertex, const uint16_t* vertexIDs, uint32_t first, uint32_t last, float* varyings)
+{
+	const swr_varying_layout* layout = &ctx->m_VaryingLayout;
+	const uint32_t numVaryings = layout->m_NumVaryings;
+	for (uint32_t va = SWR_VERTEX_ATTRIB_POSITION + 1; va < SWR_VERTEX_ATTRIB_COUNT; ++va) {
+		const uint32_t numComponents = layout->m_NumComponents[va];
+		if (numComponents == 0) {
+			continue;
+		}
+
+		const swr_vertex_buffer* vb = &ctx->m_VertexBuffers[va];
+		const uint32_t format = vb->m_Format;
+		const size_t stride = vb->m_Stride != 0 ? vb->m_Stride : swrFormatSize(format);
+		const uint8_t* src = (const uint8_t*)vb->m_Ptr + baseVertex * stride;
+		float* dst = &varyings[layout->m_FirstVarying[va]];
+		for (uint32_t i = first; i <= last; ++i) {
+			const uint8_t* v = &src[(vertexIDs != NULL ? vertexIDs[i] : i) * stride];
+			float* d = &dst[i * numVaryings];
+			if (format == SWR_FORMAT_1UB || format == SWR_FORMAT_2UB || format == SWR_FORMAT_4UB) {
+				for (uint32_t c = 0; c < numComponents; ++c) {
+					d[c] = (float)v[c] / 255.0f;
+				}
+			} else if (format == SWR_FORMAT_1UI) {
+				d[0] = (float)*(const uint32_t*)v;
+			} else if (format == SWR_FORMAT_1US) {
+				d[0] = (float)*(const uint16_t*)v;
+			} else if (format == SWR_FORMAT_2US) {
+				d[0] = (float)((const uint16_t*)v)[0];
+				d[1] = (float)((const uint16_t*)v)[1];
+			} else if (format == SWR_FORMAT_2S) {
+				d[0] = (float)((const int16_t*)v)[0];
+				d[1] = (float)((const int16_t*)v)[1];
+			} else if (format == SWR_FORMAT_2H) {
+				d[0] = swrHalfToFloat(((const uint16_t*)v)[0]);
+				d[1] = swrHalfToFloat(((const uint16_t*)v)[1]);
+			} else {
+				for (uint32_t c = 0; c < numComponents; ++c) {
+					d[c] = ((const float*)v)[c];
+				}
+			}
+		}
+	}
+}
+
+static uint32_t swrFormatNumComponents(uint32_t format)
+{
+	switch (format) {
+	case SWR_FORMAT_1F:
+	case SWR_FORMAT_1UB:
+	case SWR_FORMAT_1US:
+	case SWR_FORMAT_1UI:
+		return 1;
+	case SWR_FORMAT_2F:
+	case SWR_FORMAT_2UB:
+	case SWR_FORMAT_2US:
+	case SWR_FORMAT_2S:
+	case SWR_FORMAT_2H:
+		return 2;
+	case SWR_FORMAT_3F:
+		return 3;
+	case SWR_FORMAT_4F:
+	case SWR_FORMAT_4UB:
+		return 4;
+	}
+
+	return 0;
+}
+
+static uint32_t swrFormatSize(uint32_t format)
+{
+	switch (format) {
+	case SWR_FORMAT_1UB:
+		return 1;
+	case SWR_FORMAT_2UB:
+	case SWR_FORMAT_1US:
+		return 2;
+	case SWR_FORMAT_4UB:
+	case SWR_FORMAT_1UI:
+	case SWR_FORMAT_1F:
+	case SWR_FORMAT_2US:
+	case SWR_FORMAT_2S:
+	case SWR_FORMAT_2H:
+		return 4;
+	case SWR_FORMAT_2F:
+		return 8;
+	case SWR_FORMAT_3F:
+		return 12;
+	case SWR_FORMAT_4F:
+		return 16;
+	}
+
+	return 0;
+}
+
+// 32-bit triangle lists. 'indices' are relative to the vertex arrays' first vertex plus 
+// 'firstVertex'. Triangles are rebased to 16-bit indices in batches of up to 
+// SWR_CONFIG_INDEX_BATCH_SIZE triangles and each batch is drawn by swrDrawTriangleList with 
+// the vertex arrays offset to its smallest index. Batches spanning more than 65536 vertices 
+// are split in half. Single triangles which do are drawn from a copy of their 3 vertices.
+static void swrDrawTriangleList32(swr_context* ctx, const uint32_t* indices, uint32_t numTriangles, uint32_t firstVertex, const swr_vertex_buffer* posBufferWorld, const int32_t* posBufferScreen, const float* mtx, const uint32_t* colorPtr, uint32_t color, const float* texCoordPtr, const float* varyingPtr)
+{
+	const uint32_t numVaryings = varyingPtr != NULL ? ctx->m_VaryingLayout.m_NumVaryings : 0;
+	uint16_t* batchIndices = (uint16_t*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(uint16_t) * 3 * SWR_CONFIG_INDEX_BATCH_SIZE);
+
+	uint32_t batchSize = SWR_CONFIG_INDEX_BATCH_SIZE;
+	uint32_t iTri = 0;
+	while (iTri < numTriangles) {
+		const uint32_t n = core_minu32(batchSize, numTriangles - iTri);
+		const uint32_t* triIndices = &indices[iTri * 3];
+
+		uint32_t base;
+		if (swr->rebaseIndices(n * 3, triIndices, batchIndices, &base)) {
+			const uint32_t offset = base - firstVertex;
+			swr_vertex_buffer batchPosWorld = *posBufferWorld;
+			batchPosWorld.m_Ptr = (const uint8_t*)posBufferWorld->m_Ptr + offset * posBufferWorld->m_Stride;
+			batchPosWorld.m_Count -= offset;
+
+			swrDrawTriangleList(ctx, batchIndices, n, &batchPosWorld, &posBufferScreen[offset * 2], mtx
+				, colorPtr != NULL ? &colorPtr[offset] : NULL
+				, color
+				, texCoordPtr != NULL ? &texCoordPtr[offset * 2] : NULL
+				, varyingPtr != NULL ? &varyingPtr[offset * numVaryings] : NULL
+			);
+
+			iTri += n;
+			batchSize = core_minu32(batchSize * 2, SWR_CONFIG_INDEX_BATCH_SIZE);
+		} else if (n > 1) {
+			batchSize = n / 2;
+		} else {
+			float pos[6];
+			int32_t posi[6];
+			uint32_t colors[3];
+			float uv[6];
+			float varyings[SWR_CONFIG_MAX_VARYINGS * 3];
+			for (uint32_t i = 0; i < 3; ++i) {
+				const uint32_t id = triIndices[i] - firstVertex;
+				swrGetVertexPos(posBufferWorld, id, &pos[i * 2]);
+				posi[i * 2 + 0] = posBufferScreen[id * 2 + 0];
+				posi[i * 2 + 1] = posBufferScreen[id * 2 + 1];
+				if (colorPtr != NULL) {
+					colors[i] = colorPtr[id];
+				}
+				if (texCoordPtr != NULL) {
+					uv[i * 2 + 0] = texCoordPtr[id * 2 + 0];
+					uv[i * 2 + 1] = texCoordPtr[id * 2 + 1];
+				}
+				for (uint32_t j = 0; j < numVaryings; ++j) {
+					varyings[i * numVaryings + j] = varyingPtr[id * numVaryings + j];
+				}
+			}
+
+			static const uint16_t triangleIndices[3] = { 0, 1, 2 };
+			const swr_vertex_buffer trianglePosWorld = {
+				.m_Ptr = pos,
+				.m_Count = 3,
+				.m_Format = SWR_FORMAT_2F,
+				.m_Stride = sizeof(float) * 2
+			};
+			swrDrawTriangleList(ctx, triangleIndices, 1, &trianglePosWorld, posi, mtx
+				, colorPtr != NULL ? colors : NULL
+				, color
+				, texCoordPtr != NULL ? uv : NULL
+				, varyingPtr != NULL ? varyings : NULL
+			);
+
+			++iTri;
+		}
+	}
+}
+
+// Line lists and strips. Index values are relative to the vertex arrays' first vertex 
+// plus 'firstVertex'. Lines aren't binned. Pending binned triangles are flushed and the 
+// lines are rasterized immediately.
+static void swrDrawLines(swr_context* ctx, swr_primitive_type primType, uint32_t indexFormat, uint32_t numIndices, const void* indices, uint32_t firstVertex, const int32_t* posBufferScreen, const uint32_t* colorPtr, uint32_t color)
+{
+	swrFlush(ctx);
+
+	const bool is32Bit = indexFormat == SWR_FORMAT_1UI;
+	const uint32_t restartIndex = is32Bit
+		? SWR_PRIMITIVE_RESTART_INDEX_32
+		: SWR_PRIMITIVE_RESTART_INDEX_16
+		;
+	const bool isStrip = primType == SWR_PRIMITIVE_TYPE_LINE_STRIP;
+	const uint32_t step = isStrip ? 1 : 2;
+
+	// Thin lines snap their endpoints to pixels. Wide and anti-aliased lines keep the 
+	// sub-pixel positions.
+	const bool isThin = !ctx->m_LineAntiAliased && ctx->m_LineWidth <= 1.0f;
+	const double kSubpixelToPixel = 1.0 / (double)(1 << SWR_CONFIG_SUBPIXEL_BITS);
+	for (uint32_t i = 0; i + 1 < numIndices; i += step) {
+		const uint32_t id0 = is32Bit ? ((const uint32_t*)indices)[i] : ((const uint16_t*)indices)[i];
+		const uint32_t id1 = is32Bit ? ((const uint32_t*)indices)[i + 1] : ((const uint16_t*)indices)[i + 1];
+		if (isStrip && (id0 == restartIndex || id1 == restartIndex)) {
+			continue;
+		}
+
+		const uint32_t v0 = id0 - firstVertex;
+		const uint32_t v1 = id1 - firstVertex;
+		const int32_t* p0 = &posBufferScreen[v0 * 2];
+		const int32_t* p1 = &posBufferScreen[v1 * 2];
+		const uint32_t lineColor = colorPtr != NULL ? colorPtr[v0] : color;
+		if (isThin) {
+			swrRasterizeLine(ctx, swrSubpixelRound(p0[0]), swrSubpixelRound(p0[1]), swrSubpixelRound(p1[0]), swrSubpixelRound(p1[1]), lineColor);
+		} else {
+			swrRasterizeWideLine(ctx
+				, (double)p0[0] * kSubpixelToPixel, (double)p0[1] * kSubpixelToPixel
+				, (double)p1[0] * kSubpixelToPixel, (double)p1[1] * kSubpixelToPixel
+				, ctx->m_LineWidth, ctx->m_LineAntiAliased, lineColor
+			);
+		}
+	}
+}
+
+// Conservative test of a cluster's world space bounding box against the screen.
+static bool swrClusterIsVisible(const swr_context* ctx, const swr_cluster* cluster)
+{
+	const float* mtx = ctx->m_WorldToScreenTransform.m_Elem;
+
+	// The screen space extents of an affine transformed box are |M| * extents.
+	const float cx = (cluster->m_BoundsMin[0] + cluster->m_BoundsMax[0]) * 0.5f;
+	const float cy = (cluster->m_BoundsMin[1] + cluster->m_BoundsMax[1]) * 0.5f;
+	const float ex = (cluster->m_BoundsMax[0] - cluster->m_BoundsMin[0]) * 0.5f;
+	const float ey = (cluster->m_BoundsMax[1] - cluster->m_BoundsMin[1]) * 0.5f;
+
+	const float screenCenterX = mtx[0] * cx + mtx[2] * cy + mtx[4];
+	const float screenCenterY = mtx[1] * cx + mtx[3] * cy + mtx[5];
+	const float screenExtentX = (mtx[0] < 0.0f ? -mtx[0] : mtx[0]) * ex + (mtx[2] < 0.0f ? -mtx[2] : mtx[2]) * ey;
+	const float screenExtentY = (mtx[1] < 0.0f ? -mtx[1] : mtx[1]) * ex + (mtx[3] < 0.0f ? -mtx[3] : mtx[3]) * ey;
+
+	// Pixel sample points are at integer coordinates. Keep a 1 pixel margin for rounding.
+	const swr_rect* scissor = &ctx->m_ScissorRect;
+	return true
+		&& screenCenterX + screenExtentX >= (float)scissor->m_MinX - 1.0f
+		&& screenCenterY + screenExtentY >= (float)scissor->m_MinY - 1.0f
+		&& screenCenterX - screenExtentX <= (float)scissor->m_MaxX + 1.0f
+		&& screenCenterY - screenExtentY <= (float)scissor->m_MaxY + 1.0f
+		;
+}
+
+// Batched setup: reject degenerate and offscreen triangles up front and only 
+// rasterize the survivors. Their indices are already in CCW order. Triangles 
+// which don't fit in the guard band are clipped on the fly. In binned mode 
+// triangles are only sorted into screen bins here; rasterization happens on 
+// the next flush. 'colorPtr' is NULL for constant color triangles. Textured triangles 
+// ('texCoordPtr' != NULL) ignore the vertex colors. 'varyingPtr' holds the varyings of 
+// each vertex (see swrSetupVaryings) and is NULL if there are none.
+static void swrDrawTriangleList(swr_context* ctx, const uint16_t* indices, uint32_t numTriangles, const swr_vertex_buffer* posBufferWorld, const int32_t* posBufferScreen, const float* mtx, const uint32_t* colorPtr, uint32_t color, const float* texCoordPtr, const float* varyingPtr)
+{
+	const swr_draw_triangle_func drawTriangleFunc = ctx->m_Binner != NULL
+		? swrBinnerAddTriangle
+		: swr->drawTriangle
+		;
+	const swr_draw_triangle_flat_func drawTriangleFlatFunc = ctx->m_Binner != NULL
+		? swrBinnerAddTriangleFlat
+		: swr->drawTriangleFlat
+		;
+	const swr_draw_triangle_textured_func drawTriangleTexturedFunc = ctx->m_Binner != NULL
+		? swrBinnerAddTriangleTextured
+		: swr->drawTriangleTextured
+		;
+
+	uint16_t* visibleIndices = (uint16_t*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(uint16_t) * numTriangles * 3);
+	uint32_t* clipTriangles = (uint32_t*)CORE_ALLOC(ctx->m_TempAllocator, sizeof(uint32_t) * (numTriangles + 1));
+	uint32_t numClipTriangles = 0;
+	const uint32_t numVisibleTriangles = swr->setupTriangles(numTriangles, indices, posBufferScreen, ctx->m_Width, ctx->m_Height, ctx->m_SampleExtent, visibleIndices, clipTriangles, &numClipTriangles);
+
+	// Sentinel which is never reached by the triangle loops below.
+	clipTriangles[numClipTriangles] = UINT32_MAX;
+	const uint32_t* nextClipTriangle = clipTriangles;
+
+	if (texCoordPtr != NULL) {
+		// Textured triangle rasterization
+		const uint16_t* indexPtr = visibleIndices;
+		for (uint32_t iTri = 0; iTri < numVisibleTriangles; ++iTri) {
+			if (iTri == *nextClipTriangle) {
+				swrDrawClippedTriangle(ctx, indexPtr, posBufferWorld, posBufferScreen, mtx, NULL, 0, texCoordPtr, NULL, drawTriangleFunc, drawTriangleFlatFunc, drawTriangleTexturedFunc);
+				++nextClipTriangle;
+				indexPtr += 3;
+				continue;
+			}
+
+			const uint16_t id0 = indexPtr[0];
+			const uint16_t id1 = indexPtr[1];
+			const uint16_t id2 = indexPtr[2];
+
+			const float uv[6] = {
+				texCoordPtr[id0 * 2 + 0], texCoordPtr[id0 * 2 + 1],
+				texCoordPtr[id1 * 2 + 0], texCoordPtr[id1 * 2 + 1],
+				texCoordPtr[id2 * 2 + 0], texCoordPtr[id2 * 2 + 1]
+			};
+			drawTriangleTexturedFunc(ctx
+				, posBufferScreen[id0 * 2 + 0], posBufferScreen[id0 * 2 + 1]
+				, posBufferScreen[id1 * 2 + 0], posBufferScreen[id1 * 2 + 1]
+				, posBufferScreen[id2 * 2 + 0], posBufferScreen[id2 * 2 + 1]
+				, uv
+			);
+
+			indexPtr += 3;
+		}
+	} else if (varyingPtr != NULL) {
+		// Pixel shader with varyings. The kernels (or the binner) read each triangle's 
+		// varyings from the context.
+		const uint32_t numVaryings = ctx->m_VaryingLayout.m_NumVaryings;
+		float varyings[SWR_CONFIG_MAX_VARYINGS * 3];
+		const uint16_t* indexPtr = visibleIndices;
+		for (uint32_t iTri = 0; iTri < numVisibleTriangles; ++iTri) {
+			if (iTri == *nextClipTriangle) {
+				swrDrawClippedTriangle(ctx, indexPtr, posBufferWorld, posBufferScreen, mtx, colorPtr, color, NULL, varyingPtr, drawTriangleFunc, drawTriangleFlatFunc, drawTriangleTexturedFunc);
+				++nextClipTriangle;
+				indexPtr += 3;
+				continue;
+			}
+
+			const uint16_t id0 = indexPtr[0];
+			const uint16_t id1 = indexPtr[1];
+			const uint16_t id2 = indexPtr[2];
+
+			for (uint32_t i = 0; i < numVaryings; ++i) {
+				varyings[i] = varyingPtr[id0 * numVaryings + i];
+				varyings[numVaryings + i] = varyingPtr[id1 * numVaryings + i];
+				varyings[numVaryings * 2 + i] = varyingPtr[id2 * numVaryings + i];
+			}
+
+			ctx->m_Varyings = varyings;
+			drawTriangleFunc(ctx
+				, posBufferScreen[id0 * 2 + 0], posBufferScreen[id0 * 2 + 1]
+				, posBufferScreen[id1 * 2 + 0], posBufferScreen[id1 * 2 + 1]
+				, posBufferScreen[id2 * 2 + 0], posBufferScreen[id2 * 2 + 1]
+				, colorPtr != NULL ? colorPtr[id0] : color
+				, colorPtr != NULL ? colorPtr[id1] : color
+				, colorPtr != NULL ? colorPtr[id2] : color
+			);
+
+			indexPtr += 3;
+		}
+
+		ctx->m_Varyings = NULL;
+	} else if (colorPtr != NULL) {
+		// Per-vertex color triangle rasterization
+		const uint16_t* indexPtr = visibleIndices;
+		for (uint32_t iTri = 0; iTri < numVisibleTriangles; ++iTri) {
+			if (iTri == *nextClipTriangle) {
+				swrDrawClippedTriangle(ctx, indexPtr, posBufferWorld, posBufferScreen, mtx, colorPtr, 0, NULL, NULL, drawTriangleFunc, drawTriangleFlatFunc, drawTriangleTexturedFunc);
+				++nextClipTriangle;
+				indexPtr += 3;
+				continue;
+			}
+
+			const uint16_t id0 = indexPtr[0];
+			const uint16_t id1 = indexPtr[1];
+			const uint16_t id2 = indexPtr[2];
+
+			// TODO: Check if indices are in bounds.
+
+			const uint32_t color0 = colorPtr[id0];
+			const uint32_t color1 = colorPtr[id1];
+			const uint32_t color2 = colorPtr[id2];
+			if (color0 == color1 && color0 == color2) {
+				// All 3 vertices have the same color. Skip interpolation.
+				drawTriangleFlatFunc(ctx
+					, posBufferScreen[id0 * 2 + 0], posBufferScreen[id0 * 2 + 1]
+					, posBufferScreen[id1 * 2 + 0], posBufferScreen[id1 * 2 + 1]
+					, posBufferScreen[id2 * 2 + 0], posBufferScreen[id2 * 2 + 1]
+					, color0
+				);
+			} else {
+				drawTriangleFunc(ctx
+					, posBufferScreen[id0 * 2 + 0], posBufferScreen[id0 * 2 + 1]
+					, posBufferScreen[id1 * 2 + 0], posBufferScreen[id1 * 2 + 1]
+					, posBufferScreen[id2 * 2 + 0], posBufferScreen[id2 * 2 + 1]
+					, color0
+					, color1
+					, color2
+				);
+			}
+
+			indexPtr += 3;
+		}
+	} else {
+		// Constant color triangle rasterization.
+		const uint16_t* indexPtr = visibleIndices;
+		for (uint32_t iTri = 0; iTri < numVisibleTriangles; ++iTri) {
+			if (iTri == *nextClipTriangle) {
+				swrDrawClippedTriangle(ctx, indexPtr, posBufferWorld, posBufferScreen, mtx, NULL, color, NULL, NULL, drawTriangleFunc, drawTriangleFlatFunc, drawTriangleTexturedFunc);
+				++nextClipTriangle;
+				indexPtr += 3;
+				continue;
+			}
+
+			const uint16_t id0 = indexPtr[0];
+			const uint16_t id1 = indexPtr[1];
+			const uint16_t id2 = indexPtr[2];
+
+			// TODO: Check if indices are in bounds.
+
+			drawTriangleFlatFunc(ctx
+				, posBufferScreen[id0 * 2 + 0], posBufferScreen[id0 * 2 + 1]
+				, posBufferScreen[id1 * 2 + 0], posBufferScreen[id1 * 2 + 1]
+				, posBufferScreen[id2 * 2 + 0], posBufferScreen[id2 * 2 + 1]
+				, color
+			);
+
+			indexPtr += 3;
+		}
+	}
+}
+
+static uint32_t swrColorInterpolate(uint32_t color0, uint32_t color1, uint32_t color2, float b1, float b2)
+{
+	uint32_t res = 0;
+	for (uint32_t shift = 0; shift < 32; shift += 8) {
+		const float c0 = (float)((color0 >> shift) & 0xFF);
+		const float c1 = (float)((color1 >> shift) & 0xFF);
+		const float c2 = (float)((color2 >> shift) & 0xFF);
+		const int32_t c = (int32_t)(c0 + (c1 - c0) * b1 + (c2 - c0) * b2 + 0.5f);
+		res |= (uint32_t)core_maxi32(core_mini32(c, 255), 0) << shift;
+	}
+
+	return res;
+}
+
+// Clips a triangle against the guard band, using the original floating point vertex 
+// positions, and rasterizes the resulting polygon as a triangle fan. Vertices which 
+// survive clipping keep their transformed fixed-point positions so that edges shared 
+// with unclipped triangles are rasterized identically. 'colors' is NULL for constant 
+// color triangles. 'texCoords' is NULL for untextured triangles. 'varyings' is NULL 
+// for triangles without varyings. Otherwise each triangle of the fan is drawn with 
+// its interpolated varyings in ctx->m_Varyings, which is reset to NULL at the end.
+static void swrDrawClippedTriangle(swr_context* ctx, const uint16_t* ids, const swr_vertex_buffer* posWorld, const int32_t* posScreen, const float* mtx, const uint32_t* colors, uint32_t color, const float* texCoords, const float* varyings, swr_draw_triangle_func drawTriangleFunc, swr_draw_triangle_flat_func drawTriangleFlatFunc, swr_draw_triangle_textured_func drawTriangleTexturedFunc)
+{
+	swr_clip_vertex vertices[SWR_CLIP_MAX_VERTICES];
+	for (uint32_t i = 0; i < 3; ++i) {
+		float p[2];
+		swrGetVertexPos(posWorld, ids[i], p);
+		const float px = p[0];
+		const float py = p[1];
+
+		swr_clip_vertex* v = &vertices[i];
+		v->m_Pos[0] = mtx[0] * px + mtx[2] * py + mtx[4];
+		v->m_Pos[1] = mtx[1] * px + mtx[3] * py + mtx[5];
+		v->m_Bary[0] = i == 1 ? 1.0f : 0.0f;
+		v->m_Bary[1] = i == 2 ? 1.0f : 0.0f;
+		v->m_Src = (int32_t)i;
+	}
+
+	const float guardBand = (float)(SWR_CONFIG_GUARD_BAND_SIZE << SWR_CONFIG_SUBPIXEL_BITS);
+	const float subpixelScale = (float)(1 << SWR_CONFIG_SUBPIXEL_BITS);
+	const uint32_t numVertices = swrClipPolygon(vertices
+		, 3
+		, -guardBand
+		, -guardBand
+		, (float)ctx->m_Width * subpixelScale + guardBand
+		, (float)ctx->m_Height * subpixelScale + guardBand
+	);
+	if (numVertices < 3) {
+		return;
+	}
+
+	const uint32_t numVaryings = varyings != NULL ? ctx->m_VaryingLayout.m_NumVaryings : 0;
+	int32_t pos[SWR_CLIP_MAX_VERTICES * 2];
+	uint32_t vertexColor[SWR_CLIP_MAX_VERTICES];
+	float vertexTexCoord[SWR_CLIP_MAX_VERTICES * 2];
+	float vertexVaryings[SWR_CLIP_MAX_VERTICES * SWR_CONFIG_MAX_VARYINGS];
+	for (uint32_t i = 0; i < numVertices; ++i) {
+		const swr_clip_vertex* v = &vertices[i];
+		for (uint32_t j = 0; j < numVaryings; ++j) {
+			const float a0 = varyings[ids[0] * numVaryings + j];
+			const float a1 = varyings[ids[1] * numVaryings + j];
+			const float a2 = varyings[ids[2] * numVaryings + j];
+			vertexVaryings[i * numVaryings + j] = v->m_Src >= 0
+				? varyings[ids[v->m_Src] * numVaryings + j]
+				: a0 + (a1 - a0) * v->m_Bary[0] + (a2 - a0) * v->m_Bary[1]
+				;
+		}
+
+		if (texCoords != NULL) {
+			const float* uv0 = &texCoords[ids[0] * 2];
+			const float* uv1 = &texCoords[ids[1] * 2];
+			const float* uv2 = &texCoords[ids[2] * 2];
+			vertexTexCoord[i * 2 + 0] = uv0[0] + (uv1[0] - uv0[0]) * v->m_Bary[0] + (uv2[0] - uv0[0]) * v->m_Bary[1];
+			vertexTexCoord[i * 2 + 1] = uv0[1] + (uv1[1] - uv0[1]) * v->m_Bary[0] + (uv2[1] - uv0[1]) * v->m_Bary[1];
+		}
+
+		if (v->m_Src >= 0) {
+			const uint16_t id = ids[v->m_Src];
+			pos[i * 2 + 0] = posScreen[id * 2 + 0];
+			pos[i * 2 + 1] = posScreen[id * 2 + 1];
+			vertexColor[i] = colors != NULL ? colors[id] : color;
+		} else {
+			pos[i * 2 + 0] = swrVertexCoordFromFloat(v->m_Pos[0]);
+			pos[i * 2 + 1] = swrVertexCoordFromFloat(v->m_Pos[1]);
+			vertexColor[i] = colors != NULL
+				? swrColorInterpolate(colors[ids[0]], colors[ids[1]], colors[ids[2]], v->m_Bary[0], v->m_Bary[1])
+				: color
+				;
+		}
+	}
+
+	for (uint32_t i = 1; i < numVertices - 1; ++i) {
+		if (texCoords != NULL) {
+			const float uv[6] = {
+				vertexTexCoord[0], vertexTexCoord[1],
+				vertexTexCoord[i * 2 + 0], vertexTexCoord[i * 2 + 1],
+				vertexTexCoord[i * 2 + 2], vertexTexCoord[i * 2 + 3]
+			};
+			drawTriangleTexturedFunc(ctx
+				, pos[0], pos[1]
+				, pos[i * 2 + 0], pos[i * 2 + 1]
+				, pos[i * 2 + 2], pos[i * 2 + 3]
+				, uv
+			);
+			continue;
+		}
+
+		const uint32_t color0 = vertexColor[0];
+		const uint32_t color1 = vertexColor[i];
+		const uint32_t color2 = vertexColor[i + 1];
+		if (varyings != NULL) {
+			float triVaryings[SWR_CONFIG_MAX_VARYINGS * 3];
+			for (uint32_t j = 0; j < numVaryings; ++j) {
+				triVaryings[j] = vertexVaryings[j];
+				triVaryings[numVaryings + j] = vertexVaryings[i * numVaryings + j];
+				triVaryings[numVaryings * 2 + j] = vertexVaryings[(i + 1) * numVaryings + j];
+			}
+
+			ctx->m_Varyings = triVaryings;
+			drawTriangleFunc(ctx
+				, pos[0], pos[1]
+				, pos[i * 2 + 0], pos[i * 2 + 1]
+				, pos[i * 2 + 2], pos[i * 2 + 3]
+				, color0
+				, color1
+				, color2
+			);
+			ctx->m_Varyings = NULL;
+		} else if (color0 == color1 && color0 == color2) {
+			drawTriangleFlatFunc(ctx
+				, pos[0], pos[1]
+				, pos[i * 2 + 0], pos[i * 2 + 1]
+				, pos[i * 2 + 2], pos[i * 2 + 3]
+				, color0
+			);
+		} else {
+			drawTriangleFunc(ctx
+				, pos[0], pos[1]
+				, pos[i * 2 + 0], pos[i * 2 + 1]
+				, pos[i * 2 + 2], pos[i * 2 + 3]
+				, color0
+				, color1
+				, color2
+			);
+		}
+	}
+}
+
+static void swrDrawPixel(swr_context* ctx, int32_t x, int32_t y, uint32_t color)
+{
+	swrFlush(ctx);
+
+	const swr_rect* scissor = &ctx->m_ScissorRect;
+	if (x < scissor->m_MinX || x > scissor->m_MaxX || y < scissor->m_MinY || y > scissor->m_MaxY) {
+		return;
+	}
+
+	swrTouchTiles(ctx, x, y, x, y);
+
+	uint32_t* sample = &ctx->m_SampleBuffer[x + y * ctx->m_Width];
+	for (uint32_t i = 0; i < ctx->m_NumSamples; ++i) {
+		*sample = color;
+		sample += ctx->m_SampleStride;
+	}
+}
+
+static void swrDrawLine(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+	swrFlush(ctx);
+
+	if (!ctx->m_LineAntiAliased && ctx->m_LineWidth <= 1.0f) {
+		swrRasterizeLine(ctx, x0, y0, x1, y1, color);
+	} else {
+		swrRasterizeWideLine(ctx, (double)x0, (double)y0, (double)x1, (double)y1, ctx->m_LineWidth, ctx->m_LineAntiAliased, color);
+	}
+}
+
+static void swrDrawText(swr_context* ctx, const swr_font* font, int32_t x0, int32_t y0, const char* str, const char* end, uint32_t color)
+{
+	swrFlush(ctx);
+	swrDrawTextRun(ctx, font, x0, y0, str, end, color);
+}
+
+static void swrDrawTextBatch(swr_context* ctx, const swr_font* font, const swr_text_run* runs, uint32_t numRuns)
+{
+	swrFlush(ctx);
+	for (uint32_t i = 0; i < numRuns; ++i) {
+		const swr_text_run* run = &runs[i];
+		swrDrawTextRun(ctx, font, run->m_X, run->m_Y, run->m_Str, run->m_End, run->m_Color);
+	}
+}
+
+static void swrDrawAtlasTextBatch(swr_context* ctx, const swr_atlas_font* font, float scale, const swr_text_run* runs, uint32_t numRuns)
+{
+	swrFlush(ctx);
+	for (uint32_t i = 0; i < numRuns; ++i) {
+		const swr_text_run* run = &runs[i];
+		swrDrawAtlasTextRun(ctx, font, scale, run->m_X, run->m_Y, run->m_Str, run->m_End, run->m_Color);
+	}
+}
+
+extern void swrBlitGlyphRef(uint32_t* dst, uint32_t stride, const uint8_t* rows, uint32_t numRows, int32_t shift, uint32_t columnMask, uint32_t color);
+
+// The visible glyphs and glyph rows are found once per string. Each glyph is then blitted 
+// through an 8-pixel window which starts at its first visible column, moved left if needed 
+// to stay inside the framebuffer, with the clipped columns masked out.
+static void swrDrawTextRun(swr_context* ctx, const swr_font* font, int32_t x0, int32_t y0, const char* str, const char* end, uint32_t color)
+{
+	end = end != NULL
+		? end
+		: str + core_strlen(str)
+		;
+
+	const int32_t chw = (int32_t)font->m_CharWidth;
+	const int32_t chh = (int32_t)font->m_CharHeight;
+	const int32_t glyphWidth = core_mini32(chw, 8); // Glyph rows are 8 bits wide
+	const int64_t numChars = (int64_t)(end - str);
+	if (chw == 0 || numChars <= 0) {
+		return;
+	}
+
+	const swr_rect* scissor = &ctx->m_ScissorRect;
+	const int32_t rowBegin = core_maxi32(scissor->m_MinY - y0, 0);
+	const int32_t rowEnd = (int32_t)core_mini64((int64_t)scissor->m_MaxY - y0 + 1, chh);
+	if (rowBegin >= rowEnd || (int64_t)x0 > scissor->m_MaxX) {
+		return;
+	}
+
+	// Glyph i covers columns [x0 + i * chw, x0 + (i + 1) * chw - 1].
+	const int64_t firstChar = (int64_t)x0 < scissor->m_MinX
+		? ((int64_t)scissor->m_MinX - x0) / chw
+		: 0
+		;
+	const int64_t lastChar = core_mini64(((int64_t)scissor->m_MaxX - x0) / chw, numChars - 1);
+
+	// Narrow framebuffers can't hold a whole window.
+	const int32_t fbWidth = (int32_t)ctx->m_Width;
+	const int32_t windowMaxX = fbWidth - 8;
+	swr_blit_glyph_func blitGlyph = fbWidth >= 8
+		? swr->blitGlyph
+		: swrBlitGlyphRef
+		;
+
+	if (firstChar > lastChar) {
+		return;
+	}
+
+	swrTouchTiles(ctx
+		, (int32_t)core_maxi64((int64_t)x0 + firstChar * chw, scissor->m_MinX)
+		, y0 + rowBegin
+		, (int32_t)core_mini64((int64_t)x0 + lastChar * chw + glyphWidth - 1, scissor->m_MaxX)
+		, y0 + rowEnd - 1
+	);
+
+	const uint8_t* chdata = font->m_CharData;
+	for (int64_t i = firstChar; i <= lastChar; ++i) {
+		char ch = str[i];
+		if (ch < font->m_CharMin || ch > font->m_CharMax) {
+			ch = font->m_MissingCharFallbackID;
+		}
+
+		const uint8_t chID = (uint8_t)ch - font->m_CharMin;
+		const uint8_t* rows = &chdata[chID * chh + rowBegin];
+		const int32_t x = (int32_t)((int64_t)x0 + i * chw);
+		const int32_t visibleMinX = core_maxi32(x, scissor->m_MinX);
+		const int32_t visibleMaxX = core_mini32(x + glyphWidth - 1, scissor->m_MaxX);
+		if (visibleMinX > visibleMaxX) {
+			continue;
+		}
+
+		const int32_t windowX = fbWidth >= 8
+			? core_mini32(visibleMinX, windowMaxX)
+			: visibleMinX
+			;
+		const uint32_t columnMask = (0xFFu >> (7 - (visibleMaxX - windowX))) & (0xFFu << (visibleMinX - windowX));
+
+		uint32_t* dst = &ctx->m_SampleBuffer[windowX + (y0 + rowBegin) * fbWidth];
+		for (uint32_t iSample = 0; iSample < ctx->m_NumSamples; ++iSample) {
+			blitGlyph(dst + iSample * ctx->m_SampleStride, (uint32_t)fbWidth, rows, (uint32_t)(rowEnd - rowBegin), windowX - x, columnMask, color);
+		}
+	}
+}
+
+extern void swrDrawTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
+extern void swrDrawTriangleSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
+extern void swrDrawTriangleSSSE3(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
+extern void swrDrawTriangleSSE41(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
 extern void swrDrawTriangleAVX2_FMA(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
+extern void swrDrawTriangleFlatRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+extern void swrDrawTriangleFlatSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+extern void swrDrawTriangleFlatSSSE3(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+extern void swrDrawTriangleFlatSSE41(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+extern void swrDrawTriangleFlatAVX2_FMA(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+extern void swrDrawTriangleTexturedRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv);
+extern void swrDrawTriangleTexturedSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv);
+extern void swrDrawTriangleTexturedSSSE3(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv);
+extern void swrDrawTriangleTexturedSSE41(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv);
+extern void swrDrawTriangleTexturedAVX2_FMA(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv);
 
-static void swrDrawTriangleDispatch(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2)
+static void swrSelectDrawTriangleKernels(void)
 {
+	swr_draw_triangle_func drawTriangle = swrDrawTriangleRef;
+	swr_draw_triangle_flat_func drawTriangleFlat = swrDrawTriangleFlatRef;
+	swr_draw_triangle_textured_func drawTriangleTextured = swrDrawTriangleTexturedRef;
 #if 1
 	const uint64_t cpuFeatures = core_cpuGetFeatures();
 	if ((cpuFeatures & (CORE_CPU_FEATURE_AVX2 | CORE_CPU_FEATURE_FMA)) == (CORE_CPU_FEATURE_AVX2 | CORE_CPU_FEATURE_FMA)) {
-		swr->drawTriangle = swrDrawTriangleAVX2_FMA;
+		drawTriangle = swrDrawTriangleAVX2_FMA;
+		drawTriangleFlat = swrDrawTriangleFlatAVX2_FMA;
+		drawTriangleTextured = swrDrawTriangleTexturedAVX2_FMA;
 	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSE4_1) != 0) {
-		swr->drawTriangle = swrDrawTriangleSSE41;
+		drawTriangle = swrDrawTriangleSSE41;
+		drawTriangleFlat = swrDrawTriangleFlatSSE41;
+		drawTriangleTextured = swrDrawTriangleTexturedSSE41;
 	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSSE3) != 0) {
-		swr->drawTriangle = swrDrawTriangleSSSE3;
+		drawTriangle = swrDrawTriangleSSSE3;
+		drawTriangleFlat = swrDrawTriangleFlatSSSE3;
+		drawTriangleTextured = swrDrawTriangleTexturedSSSE3;
 	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
-		swr->drawTriangle = swrDrawTriangleSSE2;
-	} else {
-		swr->drawTriangle = swrDrawTriangleRef;
+		drawTriangle = swrDrawTriangleSSE2;
+		drawTriangleFlat = swrDrawTriangleFlatSSE2;
+		drawTriangleTextured = swrDrawTriangleTexturedSSE2;
 	}
-#else
-	swr->drawTriangle = swrDrawTriangleRef;
 #endif
 
+	// Only replace the dispatch functions. Kernels set explicitly by the user are kept.
+	if (swr->drawTriangle == swrDrawTriangleDispatch) {
+		swr->drawTriangle = drawTriangle;
+	}
+	if (swr->drawTriangleFlat == swrDrawTriangleFlatDispatch) {
+		swr->drawTriangleFlat = drawTriangleFlat;
+	}
+	if (swr->drawTriangleTextured == swrDrawTriangleTexturedDispatch) {
+		swr->drawTriangleTextured = drawTriangleTextured;
+	}
+}
+
+static void swrDrawTriangleDispatch(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2)
+{
+	swrSelectDrawTriangleKernels();
+
 	// Call the new function
 	swr->drawTriangle(ctx, x0, y0, x1, y1, x2, y2, color0, color1, color2);
 }
 
+static void swrDrawTriangleFlatDispatch(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+{
+	swrSelectDrawTriangleKernels();
+
+	// Call the new function
+	swr->drawTriangleFlat(ctx, x0, y0, x1, y1, x2, y2, color);
+}
+
+static void swrDrawTriangleTexturedDispatch(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv)
+{
+	swrSelectDrawTriangleKernels();
+
+	// Call the new function
+	swr->drawTriangleTextured(ctx, x0, y0, x1, y1, x2, y2, uv);
+}
+
 extern void swrTransformPos2fTo2iRef(uint32_t n, const float* posf, int32_t* posi, const float* mtx);
 extern void swrTransformPos2fTo2iSSE2(uint32_t n, const float* posf, int32_t* posi, const float* mtx);
 extern void swrTransformPos2fTo2iAVX_FMA(uint32_t n, const float* posf, int32_t* posi, const float* mtx);
@@ -382,3 +2004,274 @@ static void swrTransformPos2fTo2iDispatch(uint32_t n, const float* posf, int32_t
 
 	swr->transformPos2fTo2i(n, posf, posi, mtx);
 }
+
+extern void swrTransformPos2fStridedTo2iRef(uint32_t n, const float* pos, uint32_t stride, int32_t* posi, const float* mtx);
+extern void swrTransformPos2fStridedTo2iSSE2(uint32_t n, const float* pos, uint32_t stride, int32_t* posi, const float* mtx);
+extern void swrTransformPos2fStridedTo2iAVX_FMA(uint32_t n, const float* pos, uint32_t stride, int32_t* posi, const float* mtx);
+
+static void swrTransformPos2fStridedTo2iDispatch(uint32_t n, const float* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & (CORE_CPU_FEATURE_AVX2 | CORE_CPU_FEATURE_FMA)) == (CORE_CPU_FEATURE_AVX2 | CORE_CPU_FEATURE_FMA)) {
+		swr->transformPos2fStridedTo2i = swrTransformPos2fStridedTo2iAVX_FMA;
+	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->transformPos2fStridedTo2i = swrTransformPos2fStridedTo2iSSE2;
+	} else {
+		swr->transformPos2fStridedTo2i = swrTransformPos2fStridedTo2iRef;
+	}
+#else
+	swr->transformPos2fStridedTo2i = swrTransformPos2fStridedTo2iRef;
+#endif
+
+	swr->transformPos2fStridedTo2i(n, pos, stride, posi, mtx);
+}
+
+extern void swrTransformPos2usTo2iRef(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+extern void swrTransformPos2usTo2iSSE2(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+extern void swrTransformPos2usTo2iAVX_FMA(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+
+static void swrTransformPos2usTo2iDispatch(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & (CORE_CPU_FEATURE_AVX2 | CORE_CPU_FEATURE_FMA)) == (CORE_CPU_FEATURE_AVX2 | CORE_CPU_FEATURE_FMA)) {
+		swr->transformPos2usTo2i = swrTransformPos2usTo2iAVX_FMA;
+	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->transformPos2usTo2i = swrTransformPos2usTo2iSSE2;
+	} else {
+		swr->transformPos2usTo2i = swrTransformPos2usTo2iRef;
+	}
+#else
+	swr->transformPos2usTo2i = swrTransformPos2usTo2iRef;
+#endif
+
+	swr->transformPos2usTo2i(n, pos, stride, posi, mtx);
+}
+
+extern void swrTransformPos2sTo2iRef(uint32_t n, const int16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+extern void swrTransformPos2sTo2iSSE2(uint32_t n, const int16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+extern void swrTransformPos2sTo2iAVX_FMA(uint32_t n, const int16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+
+static void swrTransformPos2sTo2iDispatch(uint32_t n, const int16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & (CORE_CPU_FEATURE_AVX2 | CORE_CPU_FEATURE_FMA)) == (CORE_CPU_FEATURE_AVX2 | CORE_CPU_FEATURE_FMA)) {
+		swr->transformPos2sTo2i = swrTransformPos2sTo2iAVX_FMA;
+	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->transformPos2sTo2i = swrTransformPos2sTo2iSSE2;
+	} else {
+		swr->transformPos2sTo2i = swrTransformPos2sTo2iRef;
+	}
+#else
+	swr->transformPos2sTo2i = swrTransformPos2sTo2iRef;
+#endif
+
+	swr->transformPos2sTo2i(n, pos, stride, posi, mtx);
+}
+
+extern void swrTransformPos2hTo2iRef(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+extern void swrTransformPos2hTo2iSSE2(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+extern void swrTransformPos2hTo2iAVX_FMA_F16C(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+
+static void swrTransformPos2hTo2iDispatch(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	const uint64_t avxFeatures = CORE_CPU_FEATURE_AVX2 | CORE_CPU_FEATURE_FMA | CORE_CPU_FEATURE_F16C;
+	if ((cpuFeatures & avxFeatures) == avxFeatures) {
+		swr->transformPos2hTo2i = swrTransformPos2hTo2iAVX_FMA_F16C;
+	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->transformPos2hTo2i = swrTransformPos2hTo2iSSE2;
+	} else {
+		swr->transformPos2hTo2i = swrTransformPos2hTo2iRef;
+	}
+#else
+	swr->transformPos2hTo2i = swrTransformPos2hTo2iRef;
+#endif
+
+	swr->transformPos2hTo2i(n, pos, stride, posi, mtx);
+}
+
+extern uint32_t swrSetupTrianglesRef(uint32_t numTriangles, const uint16_t* indices, const int32_t* posi, uint32_t w, uint32_t h, int32_t sampleExtent, uint16_t* visibleIndices, uint32_t* clipTriangles, uint32_t* numClipTriangles);
+extern uint32_t swrSetupTrianglesSSE2(uint32_t numTriangles, const uint16_t* indices, const int32_t* posi, uint32_t w, uint32_t h, int32_t sampleExtent, uint16_t* visibleIndices, uint32_t* clipTriangles, uint32_t* numClipTriangles);
+extern uint32_t swrSetupTrianglesAVX2(uint32_t numTriangles, const uint16_t* indices, const int32_t* posi, uint32_t w, uint32_t h, int32_t sampleExtent, uint16_t* visibleIndices, uint32_t* clipTriangles, uint32_t* numClipTriangles);
+
+static uint32_t swrSetupTrianglesDispatch(uint32_t numTriangles, const uint16_t* indices, const int32_t* posi, uint32_t w, uint32_t h, int32_t sampleExtent, uint16_t* visibleIndices, uint32_t* clipTriangles, uint32_t* numClipTriangles)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & CORE_CPU_FEATURE_AVX2) != 0) {
+		swr->setupTriangles = swrSetupTrianglesAVX2;
+	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->setupTriangles = swrSetupTrianglesSSE2;
+	} else {
+		swr->setupTriangles = swrSetupTrianglesRef;
+	}
+#else
+	swr->setupTriangles = swrSetupTrianglesRef;
+#endif
+
+	return swr->setupTriangles(numTriangles, indices, posi, w, h, sampleExtent, visibleIndices, clipTriangles, numClipTriangles);
+}
+
+extern uint32_t swrAssembleTrianglesRef(swr_primitive_type primType, swr_format indexFormat, uint32_t numIndices, const void* indices, uint32_t* triangles);
+extern uint32_t swrAssembleTrianglesSSE2(swr_primitive_type primType, swr_format indexFormat, uint32_t numIndices, const void* indices, uint32_t* triangles);
+
+static uint32_t swrAssembleTrianglesDispatch(swr_primitive_type primType, swr_format indexFormat, uint32_t numIndices, const void* indices, uint32_t* triangles)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->assembleTriangles = swrAssembleTrianglesSSE2;
+	} else {
+		swr->assembleTriangles = swrAssembleTrianglesRef;
+	}
+#else
+	swr->assembleTriangles = swrAssembleTrianglesRef;
+#endif
+
+	return swr->assembleTriangles(primType, indexFormat, numIndices, indices, triangles);
+}
+
+extern bool swrRebaseIndicesRef(uint32_t numIndices, const uint32_t* indices, uint16_t* rebased, uint32_t* base);
+extern bool swrRebaseIndicesSSE2(uint32_t numIndices, const uint32_t* indices, uint16_t* rebased, uint32_t* base);
+
+static bool swrRebaseIndicesDispatch(uint32_t numIndices, const uint32_t* indices, uint16_t* rebased, uint32_t* base)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->rebaseIndices = swrRebaseIndicesSSE2;
+	} else {
+		swr->rebaseIndices = swrRebaseIndicesRef;
+	}
+#else
+	swr->rebaseIndices = swrRebaseIndicesRef;
+#endif
+
+	return swr->rebaseIndices(numIndices, indices, rebased, base);
+}
+
+extern void swrResolveSamplesRef(uint32_t numPixels, uint32_t numSamples, uint32_t sampleStride, const uint32_t* samples, uint32_t* dst);
+extern void swrResolveSamplesSSE2(uint32_t numPixels, uint32_t numSamples, uint32_t sampleStride, const uint32_t* samples, uint32_t* dst);
+extern void swrResolveSamplesAVX2(uint32_t numPixels, uint32_t numSamples, uint32_t sampleStride, const uint32_t* samples, uint32_t* dst);
+
+static void swrResolveSamplesDispatch(uint32_t numPixels, uint32_t numSamples, uint32_t sampleStride, const uint32_t* samples, uint32_t* dst)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & CORE_CPU_FEATURE_AVX2) != 0) {
+		swr->resolveSamples = swrResolveSamplesAVX2;
+	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->resolveSamples = swrResolveSamplesSSE2;
+	} else {
+		swr->resolveSamples = swrResolveSamplesRef;
+	}
+#else
+	swr->resolveSamples = swrResolveSamplesRef;
+#endif
+
+	swr->resolveSamples(numPixels, numSamples, sampleStride, samples, dst);
+}
+
+extern void swrDownsample2x2Ref(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst);
+extern void swrDownsample2x2SSE2(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst);
+extern void swrDownsample2x2AVX2(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst);
+
+static void swrDownsample2x2Dispatch(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & CORE_CPU_FEATURE_AVX2) != 0) {
+		swr->downsample2x2 = swrDownsample2x2AVX2;
+	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->downsample2x2 = swrDownsample2x2SSE2;
+	} else {
+		swr->downsample2x2 = swrDownsample2x2Ref;
+	}
+#else
+	swr->downsample2x2 = swrDownsample2x2Ref;
+#endif
+
+	swr->downsample2x2(numPixels, row0, row1, dst);
+}
+
+extern void swrFillSpanRef(uint32_t* dst, uint32_t n, uint32_t color, uint32_t blendMode);
+extern void swrFillSpanSSE2(uint32_t* dst, uint32_t n, uint32_t color, uint32_t blendMode);
+
+static void swrFillSpanDispatch(uint32_t* dst, uint32_t n, uint32_t color, uint32_t blendMode)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->fillSpan = swrFillSpanSSE2;
+	} else {
+		swr->fillSpan = swrFillSpanRef;
+	}
+#else
+	swr->fillSpan = swrFillSpanRef;
+#endif
+
+	swr->fillSpan(dst, n, color, blendMode);
+}
+
+extern void swrBlendSpanCoverageRef(uint32_t* dst, uint32_t n, uint32_t color, float d0, float halfWidth, float alphaScale);
+extern void swrBlendSpanCoverageSSE2(uint32_t* dst, uint32_t n, uint32_t color, float d0, float halfWidth, float alphaScale);
+
+static void swrBlendSpanCoverageDispatch(uint32_t* dst, uint32_t n, uint32_t color, float d0, float halfWidth, float alphaScale)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->blendSpanCoverage = swrBlendSpanCoverageSSE2;
+	} else {
+		swr->blendSpanCoverage = swrBlendSpanCoverageRef;
+	}
+#else
+	swr->blendSpanCoverage = swrBlendSpanCoverageRef;
+#endif
+
+	swr->blendSpanCoverage(dst, n, color, d0, halfWidth, alphaScale);
+}
+
+extern void swrBlitGlyphSSE2(uint32_t* dst, uint32_t stride, const uint8_t* rows, uint32_t numRows, int32_t shift, uint32_t columnMask, uint32_t color);
+extern void swrBlitGlyphAVX2(uint32_t* dst, uint32_t stride, const uint8_t* rows, uint32_t numRows, int32_t shift, uint32_t columnMask, uint32_t color);
+
+static void swrBlitGlyphDispatch(uint32_t* dst, uint32_t stride, const uint8_t* rows, uint32_t numRows, int32_t shift, uint32_t columnMask, uint32_t color)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & CORE_CPU_FEATURE_AVX2) != 0) {
+		swr->blitGlyph = swrBlitGlyphAVX2;
+	} else if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->blitGlyph = swrBlitGlyphSSE2;
+	} else {
+		swr->blitGlyph = swrBlitGlyphRef;
+	}
+#else
+	swr->blitGlyph = swrBlitGlyphRef;
+#endif
+
+	swr->blitGlyph(dst, stride, rows, numRows, shift, columnMask, color);
+}
+
+extern void swrBlendCoverageRef(uint32_t* dst, const uint8_t* coverage, uint32_t n, uint32_t color);
+extern void swrBlendCoverageSSE2(uint32_t* dst, const uint8_t* coverage, uint32_t n, uint32_t color);
+
+static void swrBlendCoverageDispatch(uint32_t* dst, const uint8_t* coverage, uint32_t n, uint32_t color)
+{
+#if 1
+	const uint64_t cpuFeatures = core_cpuGetFeatures();
+	if ((cpuFeatures & CORE_CPU_FEATURE_SSE2) != 0) {
+		swr->blendCoverage = swrBlendCoverageSSE2;
+	} else {
+		swr->blendCoverage = swrBlendCoverageRef;
+	}
+#else
+	swr->blendCoverage = swrBlendCoverageRef;
+#endif
+
+	swr->blendCoverage(dst, coverage, n, color);
+}
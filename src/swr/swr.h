@@ -2,6 +2,7 @@
 #define SWR_SWR_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "../core/math.h"
 
 typedef struct core_allocator_i core_allocator_i;
@@ -10,6 +11,26 @@ typedef struct core_allocator_i core_allocator_i;
 #define SWR_CONFIG_DISABLE_PIXEL_SHADERS 0
 #endif
 
+// Lossy level of detail for zoomed out views. When enabled, triangles which cover only 
+// a couple of pixels (see SWR_CONFIG_SMALL_TRIANGLE_SIZE) are drawn as a single pixel 
+// at their centroid, without testing coverage.
+#ifndef SWR_CONFIG_SMALL_TRIANGLE_LOD
+#define SWR_CONFIG_SMALL_TRIANGLE_LOD 0
+#endif
+
+// Number of fractional bits in the fixed-point vertex positions passed to drawTriangle 
+// and drawTriangleFlat. The edge function overflow checks in the rasterizer assume 
+// this is at most 8.
+#define SWR_CONFIG_SUBPIXEL_BITS 8
+
+// Largest texture width/height. Texture coordinates are interpolated in texels with 8 
+// fractional bits and must be exactly representable as floats.
+#define SWR_CONFIG_MAX_TEXTURE_SIZE 32768
+
+// Maximum number of vertex attribute components interpolated for pixel shaders (see 
+// swr_pixel_shader_tile::m_Attribs).
+#define SWR_CONFIG_MAX_VARYINGS 16
+
 #define SWR_COLOR_FORMAT_RGBA 0
 #define SWR_COLOR_FORMAT_BGRA 1
 
@@ -50,21 +71,74 @@ typedef struct core_allocator_i core_allocator_i;
 typedef enum swr_vertex_attrib
 {
 	SWR_VERTEX_ATTRIB_POSITION = 0,
-	SWR_VERTEX_ATTRIB_COLOR
+	SWR_VERTEX_ATTRIB_COLOR,
+	SWR_VERTEX_ATTRIB_TEXCOORD,
+	SWR_VERTEX_ATTRIB_GENERIC0, // Generic attributes are only used by pixel shaders (see bindPixelShader)
+	SWR_VERTEX_ATTRIB_GENERIC1,
+	SWR_VERTEX_ATTRIB_GENERIC2,
+	SWR_VERTEX_ATTRIB_GENERIC3,
+	SWR_VERTEX_ATTRIB_GENERIC4,
+
+	SWR_VERTEX_ATTRIB_COUNT
 } swr_vertex_attrib;
 
+// Blending of triangle colors with the framebuffer. Colors are 8-bit per channel and 
+// all 4 channels, including alpha, are blended the same way.
+typedef enum swr_blend_mode
+{
+	SWR_BLEND_MODE_OPAQUE = 0, // dst = src
+	SWR_BLEND_MODE_SRC_OVER,   // dst = src * src.a + dst * (1 - src.a)
+	SWR_BLEND_MODE_ADDITIVE,   // dst = min(src + dst, 1)
+	SWR_BLEND_MODE_MULTIPLY    // dst = src * dst
+} swr_blend_mode;
+
+// Texture filtering. Texture coordinates are normalized, i.e. (0, 0) is the top-left 
+// corner of the first texel and (1, 1) the bottom-right corner of the last one. 
+// Coordinates outside this range are clamped to the edge texels.
+typedef enum swr_texture_filter
+{
+	SWR_TEXTURE_FILTER_NEAREST = 0, // Texel containing the sample point
+	SWR_TEXTURE_FILTER_BILINEAR     // Weighted average of the 2x2 texels whose centers surround the sample point
+} swr_texture_filter;
+
+// Vertex buffer formats. When interpolated for pixel shaders, F formats are used as is, 
+// UB formats are unsigned normalized (0 to 1), 1UI is converted to a single float 
+// (exact up to 2^24), US/S formats are converted to floats as integers and H formats are 
+// half-precision floats. Colors can be either 4UB or 1UI. Positions can be 2F, 2US, 2S 
+// or 2H. Indices can be 1US or 1UI.
 typedef enum swr_format
 {
 	SWR_FORMAT_2F,
 	SWR_FORMAT_4UB,
-	SWR_FORMAT_1UI
+	SWR_FORMAT_1UI,
+	SWR_FORMAT_1F,
+	SWR_FORMAT_3F,
+	SWR_FORMAT_4F,
+	SWR_FORMAT_1UB,
+	SWR_FORMAT_2UB,
+	SWR_FORMAT_2US,
+	SWR_FORMAT_2S,
+	SWR_FORMAT_2H,
+	SWR_FORMAT_1US
 } swr_format;
 
+// Strips and fans start over after each primitive restart index (see below). Lines use the 
+// context's line style (see setLineStyle) and have the color of their first vertex. Thin 
+// lines have both endpoints rounded to the nearest pixel and drawn. They aren't textured 
+// or shaded.
 typedef enum swr_primitive_type
 {
-	SWR_PRIMITIVE_TYPE_TRIANGLE_LIST
+	SWR_PRIMITIVE_TYPE_TRIANGLE_LIST,
+	SWR_PRIMITIVE_TYPE_TRIANGLE_STRIP,
+	SWR_PRIMITIVE_TYPE_TRIANGLE_FAN,
+	SWR_PRIMITIVE_TYPE_LINE_LIST,
+	SWR_PRIMITIVE_TYPE_LINE_STRIP
 } swr_primitive_type;
 
+// Primitive restart index of 1US and 1UI index buffers respectively.
+#define SWR_PRIMITIVE_RESTART_INDEX_16 0xFFFFu
+#define SWR_PRIMITIVE_RESTART_INDEX_32 0xFFFFFFFFu
+
 typedef struct swr_font
 {
 	const uint8_t* m_CharData;
@@ -75,34 +149,341 @@ typedef struct swr_font
 	uint8_t m_MissingCharFallbackID;
 } swr_font;
 
+// A string drawn by drawTextBatch. 'm_End' can be NULL for null-terminated strings.
+typedef struct swr_text_run
+{
+	const char* m_Str;
+	const char* m_End;
+	int32_t m_X;
+	int32_t m_Y;
+	uint32_t m_Color;
+} swr_text_run;
+
+// Glyph of an atlas font. The glyph's pixels are the m_Width x m_Height rectangle at 
+// (m_AtlasX, m_AtlasY) in the atlas, drawn with its top-left corner at (m_OffsetX, m_OffsetY) 
+// relative to the pen position on the baseline. The pen then moves right by m_Advance. 
+// All values are in atlas pixels.
+typedef struct swr_atlas_glyph
+{
+	uint32_t m_Codepoint;
+	uint16_t m_AtlasX;
+	uint16_t m_AtlasY;
+	uint16_t m_Width;
+	uint16_t m_Height;
+	int16_t m_OffsetX;
+	int16_t m_OffsetY;
+	float m_Advance;
+} swr_atlas_glyph;
+
+typedef enum swr_atlas_font_type
+{
+	SWR_ATLAS_FONT_TYPE_COVERAGE = 0, // Atlas texels are 8-bit pixel coverage
+	SWR_ATLAS_FONT_TYPE_SDF           // Atlas texels are 128 + 127 * d / m_SDFRange, with d the signed distance (in atlas pixels) to the glyph outline, positive inside
+} swr_atlas_font_type;
+
+// 'm_Atlas' holds m_AtlasWidth x m_AtlasHeight 8-bit texels. 'm_Glyphs' must be sorted by 
+// codepoint, without duplicates. Codepoints without a glyph are drawn as m_FallbackCodepoint, 
+// or skipped if there's no glyph for it either.
+typedef struct swr_atlas_font_desc
+{
+	const uint8_t* m_Atlas;
+	const swr_atlas_glyph* m_Glyphs;
+	uint32_t m_AtlasWidth;
+	uint32_t m_AtlasHeight;
+	uint32_t m_NumGlyphs;
+	uint32_t m_FallbackCodepoint;
+	swr_atlas_font_type m_Type;
+	float m_SDFRange;
+} swr_atlas_font_desc;
+
+// Pixel rect. Max coordinates are inclusive.
+typedef struct swr_rect
+{
+	int32_t m_MinX;
+	int32_t m_MinY;
+	int32_t m_MaxX;
+	int32_t m_MaxY;
+} swr_rect;
+
 typedef struct swr_matrix2d
 {
 	float m_Elem[6];
 } swr_matrix2d;
 
+// Bounds of a group of consecutive triangles in an index buffer (see bindClusterBuffer).
+typedef struct swr_cluster
+{
+	float m_BoundsMin[2];  // World space bounding box of the cluster's vertices
+	float m_BoundsMax[2];
+	uint16_t m_MinVertex;  // Range of vertex indices referenced by the cluster's triangles (inclusive)
+	uint16_t m_MaxVertex;
+} swr_cluster;
+
+// Input of a pixel shader (see bindPixelShader). Describes a tile of m_Width x m_Height 
+// pixels. Per-pixel values are stored row-major.
+typedef struct swr_pixel_shader_tile
+{
+	const float* m_Bary0;           // Barycentric coordinates of each pixel's sample point relative to vertex 0...
+	const float* m_Bary1;           // ...and vertex 1. Vertex 2's is 1 - m_Bary0 - m_Bary1.
+	const uint32_t* m_VertexColors; // The triangle's 3 vertex colors, in the same order as the barycentric coordinates
+	int32_t m_X;                    // Top-left pixel of the tile
+	int32_t m_Y;
+	uint32_t m_Width;
+	uint32_t m_Height;
+	uint32_t m_CoverageMask;        // Bit (x + y * m_Width) is set if any sample of pixel (x, y) is covered
+	const float* m_Attribs[SWR_VERTEX_ATTRIB_COUNT]; // Interpolated vertex attributes, one array per component: component c of pixel i is m_Attribs[va][c * m_Width * m_Height + i]. NULL if not available.
+} swr_pixel_shader_tile;
+
+// Writes the colors of all m_Width x m_Height pixels of the tile to 'colors', row-major. 
+// Colors of uncovered pixels are ignored.
+typedef void (*swr_pixel_shader_func)(const swr_pixel_shader_tile* tile, uint32_t* colors, void* userData);
+
 typedef struct swr_context swr_context;
+typedef struct swr_command_list swr_command_list;
+typedef struct swr_bvh swr_bvh;
+typedef struct swr_texture swr_texture;
+typedef struct swr_atlas_font swr_atlas_font;
 
 typedef struct swr_api
 {
 	swr_context* (*createContext)(core_allocator_i* allocator, uint32_t w, uint32_t h);
 	void (*destroyContext)(core_allocator_i* allocator, swr_context* ctx);
 
+	// Binned multithreaded rasterization. 0 worker threads (default) means immediate mode, 
+	// i.e. drawPrimitives rasterizes each triangle as soon as it's submitted. Otherwise
+	// drawPrimitives sorts triangles into SWR_CONFIG_BIN_WIDTHxSWR_CONFIG_BIN_HEIGHT screen 
+	// bins and rasterization is deferred until flush, where bins are processed in parallel 
+	// by the worker threads and the calling thread. Triangles are always rasterized in 
+	// submission order within each bin. Requires the framebuffer width to be a multiple 
+	// of 8 and its height a multiple of 4. Returns false, and keeps the current number 
+	// of worker threads, if that's not the case or if the workers can't be created.
+	// Everything else (clear, getFrameBufferPtr, drawPixel, drawLine, drawText) implicitly 
+	// flushes pending triangles first. drawTriangle, drawTriangleFlat and drawTriangleTextured 
+	// are never binned.
+	bool (*setNumWorkerThreads)(swr_context* ctx, uint32_t numWorkerThreads);
+	void (*flush)(swr_context* ctx);
+
+	// clear doesn't write any pixels. The framebuffer is split into SWR_CONFIG_BIN_WIDTHx
+	// SWR_CONFIG_BIN_HEIGHT tiles which are filled with the clear color the first time 
+	// something is drawn into them, and getFrameBufferPtr fills the ones nothing has been 
+	// drawn into, so clearing costs close to nothing when most of the screen stays empty.
 	const void* (*getFrameBufferPtr)(swr_context* ctx);
 	void (*clear)(swr_context* ctx, uint32_t color);
 	void (*setWorldToScreenTransform)(swr_context* ctx, const swr_matrix2d* mtx);
 
+	// Dirty region tracking. invalidateRect marks the tiles covered by a world space rect, 
+	// transformed by the current world to screen transform, as dirty and invalidateAll 
+	// marks all of them (as does setSampleCount). Everything starts out dirty. 
+	// beginIncrementalFrame returns false if nothing is dirty. Otherwise it sets the 
+	// scissor rect to the bounding rect of the dirty tiles and clears their dirty flags, 
+	// so the caller can clear and redraw the whole scene as usual while only the pixels 
+	// inside the scissor rect are rasterized and the rest of the framebuffer is kept. 
+	// drawBVH and cluster culling also skip nodes and clusters outside the scissor rect. 
+	// endIncrementalFrame restores the full scissor rect and, if 'updateRect' isn't NULL, 
+	// returns the bounding rect of the tiles drawn into since beginIncrementalFrame 
+	// (m_MinX > m_MaxX if none) which is the only part of the framebuffer that changed.
+	void (*invalidateRect)(swr_context* ctx, float minX, float minY, float maxX, float maxY);
+	void (*invalidateAll)(swr_context* ctx);
+	bool (*beginIncrementalFrame)(swr_context* ctx);
+	void (*endIncrementalFrame)(swr_context* ctx, swr_rect* updateRect);
+
+	// Blend mode used by all triangle and line draws (drawPrimitives, drawBVH, drawLine, 
+	// drawTriangle, drawTriangleFlat and drawTriangleTextured). drawPixel and drawText always 
+	// overwrite the framebuffer. Opaque (default) triangles never read the framebuffer.
+	void (*setBlendMode)(swr_context* ctx, swr_blend_mode mode);
+
+	// Line style used by drawLine and by line primitives. Lines are 'width' pixels thick, 
+	// perpendicular to their direction, with their ends cut along the minor axis half a pixel 
+	// past both endpoints. Aliased lines up to 1 pixel wide (default) are Bresenham lines. 
+	// Anti-aliased lines scale their color's alpha (255 with SWR_BLEND_MODE_OPAQUE) by each 
+	// pixel's coverage and are always blended with SWR_BLEND_MODE_SRC_OVER.
+	void (*setLineStyle)(swr_context* ctx, float width, bool antiAliased);
+
+	// Multisample anti-aliasing. With 4 or 8 samples per pixel, triangle coverage is 
+	// evaluated at that many points inside each pixel while colors are still computed 
+	// once per pixel. Samples are kept in separate planes and averaged into the framebuffer 
+	// by getFrameBufferPtr. clear, drawPixel, drawLine and drawText write all the samples 
+	// of a pixel. Changing the sample count keeps the current image. Returns false if 
+	// 'numSamples' isn't 1 (default), 4 or 8 or if the sample planes can't be allocated.
+	bool (*setSampleCount)(swr_context* ctx, uint32_t numSamples);
+
+	// Textures hold 'w' x 'h' 32-bit pixels, in the framebuffer's color format, which are 
+	// copied at creation. While a texture is bound, drawPrimitives and drawBVH sample it 
+	// instead of using vertex colors if a 2F texture coordinate buffer (SWR_VERTEX_ATTRIB_TEXCOORD) 
+	// with one entry per vertex is bound as well. The texture must stay alive while bound. 
+	// A full mip chain (down to 1x1, about a third more memory) is generated at creation 
+	// and each triangle samples the level matching its texture coordinate derivatives. 
+	// createTexture returns NULL if either dimension is 0 or larger than SWR_CONFIG_MAX_TEXTURE_SIZE.
+	swr_texture* (*createTexture)(core_allocator_i* allocator, uint32_t w, uint32_t h, const uint32_t* pixels);
+	void (*destroyTexture)(core_allocator_i* allocator, swr_texture* tex);
+	void (*bindTexture)(swr_context* ctx, const swr_texture* tex, swr_texture_filter filter);
+	void (*unbindTexture)(swr_context* ctx);
+
+	// Custom pixel shading. While a pixel shader is bound it computes the colors of all 
+	// untextured triangles (drawPrimitives, drawBVH, drawTriangle and drawTriangleFlat) 
+	// instead of the interpolated vertex colors. It's called once per tile of up to 8x4 
+	// pixels, with the results blended and stored like the built-in colors. In binned mode 
+	// it's called from the worker threads, possibly concurrently, and 'userData' must stay 
+	// valid until the next flush.
+	// Triangles drawn by drawPrimitives and drawBVH also get the bound vertex attributes, 
+	// except the position, interpolated over the tile (see swr_pixel_shader_tile::m_Attribs). 
+	// Attributes which are the same on all 3 vertices (e.g. IDs) are interpolated exactly. 
+	// While a pixel shader is bound, every bound attribute must have as many entries as the 
+	// position buffer and all of them together at most SWR_CONFIG_MAX_VARYINGS components. 
+	// Draws assert on this; in release builds the attributes which break it are NULL.
+	void (*bindPixelShader)(swr_context* ctx, swr_pixel_shader_func func, void* userData);
+	void (*unbindPixelShader)(swr_context* ctx);
+
+	// 'stride' is the distance in bytes between consecutive vertices, or 0 for tightly packed 
+	// vertices. Attributes can be interleaved by binding the same memory with the same stride 
+	// and different offsets.
 	void (*bindVertexBuffer)(swr_context* ctx, swr_vertex_attrib va, swr_format format, uint32_t stride, uint32_t n, const void* ptr);
 	void (*unbindVertexBuffer)(swr_context* ctx, swr_vertex_attrib va);
-	void (*bindIndexBuffer)(swr_context* ctx, uint32_t n, const uint16_t* ptr);
+	void (*bindIndexBuffer)(swr_context* ctx, swr_format format, uint32_t n, const void* ptr);
 	void (*unbindIndexBuffer)(swr_context* ctx);
-	void (*drawPrimitives)(swr_context* ctx, swr_primitive_type primType, uint16_t startIndex, uint16_t endIndex, uint32_t numIndices, uint32_t baseIndex, uint32_t baseVertex);
+
+	// Cluster culling. Cluster i describes triangles [i * numTrianglesPerCluster, (i + 1) * numTrianglesPerCluster) 
+	// of the bound index buffer. drawPrimitives skips clusters whose bounding box is outside 
+	// the screen before transforming any of their vertices. Triangles past the last cluster 
+	// are always drawn. Only used by 1US triangle lists whose baseIndex is a multiple of 3.
+	void (*bindClusterBuffer)(swr_context* ctx, uint32_t n, uint32_t numTrianglesPerCluster, const swr_cluster* ptr);
+	void (*unbindClusterBuffer)(swr_context* ctx);
+
+	// Draws 'numIndices' indices of the bound index buffer, starting at 'baseIndex'. Index 
+	// values are relative to 'baseVertex' and must be in the range [startIndex, endIndex], 
+	// excluding restart indices. Only the vertices in this range are transformed.
+	void (*drawPrimitives)(swr_context* ctx, swr_primitive_type primType, uint32_t startIndex, uint32_t endIndex, uint32_t numIndices, uint32_t baseIndex, uint32_t baseVertex);
+
+	// Spatial index for static meshes. createBVH builds a bounding volume hierarchy over 
+	// the indexed triangle list 'indices' with 2F vertex positions 'pos'. The BVH keeps its 
+	// own, spatially sorted, copy of the indices so the index buffer can be released 
+	// afterwards; the original triangle order isn't preserved. drawBVH draws the mesh 
+	// using the bound vertex buffers, which must be laid out the same way as 'pos' starting 
+	// at 'baseVertex', and only transforms and rasterizes the triangles of leaves which are 
+	// visible with the current world to screen transform. The bound index and cluster 
+	// buffers are ignored.
+	swr_bvh* (*createBVH)(core_allocator_i* allocator, const float* pos, const uint16_t* indices, uint32_t numIndices);
+	void (*destroyBVH)(core_allocator_i* allocator, swr_bvh* bvh);
+	void (*drawBVH)(swr_context* ctx, const swr_bvh* bvh, uint32_t baseVertex);
 
 	void (*drawPixel)(swr_context* ctx, int32_t x, int32_t y, uint32_t color);
 	void (*drawLine)(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+
+	// drawTriangle and drawTriangleFlat take vertex positions in fixed point, with 
+	// SWR_CONFIG_SUBPIXEL_BITS fractional bits. Coordinates must be in the range (-2^30, 2^30).
+	// A pixel is covered if its sample point, at its integer coordinates, is inside the 
+	// triangle. Sample points exactly on an edge follow the top-left rule so triangles 
+	// sharing an edge never touch the same pixel twice. With multisampling each of the 
+	// pixel's sample points is tested the same way.
 	void (*drawTriangle)(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
+	void (*drawTriangleFlat)(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+
+	// Same as drawTriangle but colors are sampled from the bound texture. 'uv' holds the 
+	// 3 vertices' (u, v) texture coordinates. Nothing is drawn if no texture is bound.
+	void (*drawTriangleTextured)(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv);
+
+	// Text is drawn with fixed width glyphs, up to 8 pixels wide, with (x, y) at the top-left 
+	// corner of the first one. Each string is clipped to the screen once and each glyph row 
+	// is written with a single masked store. drawTextBatch draws 'numRuns' strings, in order, 
+	// with a single flush.
 	void (*drawText)(swr_context* ctx, const swr_font* font, int32_t x, int32_t y, const char* str, const char* end, uint32_t color);
+	void (*drawTextBatch)(swr_context* ctx, const swr_font* font, const swr_text_run* runs, uint32_t numRuns);
+
+	// Atlas fonts. createAtlasFont copies the atlas and the glyphs, and returns NULL if a glyph 
+	// is outside the atlas, the glyphs aren't sorted or an SDF font's m_SDFRange isn't positive. 
+	// drawAtlasTextBatch draws 'numRuns' UTF-8 strings with a single flush. Each run's (x, y) 
+	// is the starting pen position on the baseline and glyphs are scaled by 'scale'. Glyphs 
+	// are blended with SWR_BLEND_MODE_SRC_OVER, using the color's alpha unless the blend mode 
+	// is SWR_BLEND_MODE_OPAQUE. Coverage fonts are meant to be drawn at scale 1, where glyphs 
+	// are blitted straight from the atlas; SDF fonts stay sharp at any scale.
+	swr_atlas_font* (*createAtlasFont)(core_allocator_i* allocator, const swr_atlas_font_desc* desc);
+	void (*destroyAtlasFont)(core_allocator_i* allocator, swr_atlas_font* font);
+	void (*drawAtlasTextBatch)(swr_context* ctx, const swr_atlas_font* font, float scale, const swr_text_run* runs, uint32_t numRuns);
+
+	// Command lists record clear, state changes and draw calls for later execution.
+	// Redundant state changes are dropped while recording and commands before a clear are 
+	// discarded. Buffers referenced by a command list must remain valid until it's executed. 
+	// executeCommandList leaves the context in the same state as if the commands were 
+	// issued directly and flushes at the end.
+	swr_command_list* (*createCommandList)(core_allocator_i* allocator);
+	void (*destroyCommandList)(core_allocator_i* allocator, swr_command_list* cmdList);
+	void (*cmdReset)(swr_command_list* cmdList);
+	void (*cmdClear)(swr_command_list* cmdList, uint32_t color);
+	void (*cmdSetWorldToScreenTransform)(swr_command_list* cmdList, const swr_matrix2d* mtx);
+	void (*cmdSetBlendMode)(swr_command_list* cmdList, swr_blend_mode mode);
+	void (*cmdSetLineStyle)(swr_command_list* cmdList, float width, bool antiAliased);
+	void (*cmdBindTexture)(swr_command_list* cmdList, const swr_texture* tex, swr_texture_filter filter);
+	void (*cmdUnbindTexture)(swr_command_list* cmdList);
+	void (*cmdBindPixelShader)(swr_command_list* cmdList, swr_pixel_shader_func func, void* userData);
+	void (*cmdUnbindPixelShader)(swr_command_list* cmdList);
+	void (*cmdBindVertexBuffer)(swr_command_list* cmdList, swr_vertex_attrib va, swr_format format, uint32_t stride, uint32_t n, const void* ptr);
+	void (*cmdUnbindVertexBuffer)(swr_command_list* cmdList, swr_vertex_attrib va);
+	void (*cmdBindIndexBuffer)(swr_command_list* cmdList, swr_format format, uint32_t n, const void* ptr);
+	void (*cmdUnbindIndexBuffer)(swr_command_list* cmdList);
+	void (*cmdBindClusterBuffer)(swr_command_list* cmdList, uint32_t n, uint32_t numTrianglesPerCluster, const swr_cluster* ptr);
+	void (*cmdUnbindClusterBuffer)(swr_command_list* cmdList);
+	void (*cmdDrawPrimitives)(swr_command_list* cmdList, swr_primitive_type primType, uint32_t startIndex, uint32_t endIndex, uint32_t numIndices, uint32_t baseIndex, uint32_t baseVertex);
+	void (*cmdDrawBVH)(swr_command_list* cmdList, const swr_bvh* bvh, uint32_t baseVertex);
+	void (*executeCommandList)(swr_context* ctx, const swr_command_list* cmdList);
 
 	void (*transformPos2fTo2i)(uint32_t n, const float* posf, int32_t* posi, const float* mtx);
+
+	// Same as transformPos2fTo2i for the other position formats (see swr_format). 'stride' 
+	// is the distance in bytes between consecutive input positions and can't be 0.
+	void (*transformPos2fStridedTo2i)(uint32_t n, const float* pos, uint32_t stride, int32_t* posi, const float* mtx);
+	void (*transformPos2usTo2i)(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+	void (*transformPos2sTo2i)(uint32_t n, const int16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+	void (*transformPos2hTo2i)(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx);
+
+	// Batched triangle setup. Processes 'numTriangles' indexed triangles several at a time, 
+	// rejects degenerate triangles and triangles whose bounding box doesn't overlap the 
+	// w x h screen, and writes the indices of the surviving ones, in CCW order, to 
+	// 'visibleIndices' (which must have room for numTriangles * 3 indices). Returns the 
+	// number of surviving triangles. 'posi' holds sub-pixel fixed-point coordinates (see 
+	// SWR_CONFIG_SUBPIXEL_BITS). 'sampleExtent' is the largest distance, in sub-pixels, 
+	// of a multisample sample point from its pixel's integer coordinates (0 without 
+	// multisampling) and grows the bounding boxes accordingly. Visible triangles which 
+	// extend past the guard band are emitted in their original order and must be clipped 
+	// before rasterization. Their positions in 'visibleIndices' (in triangles) are written 
+	// in increasing order to 'clipTriangles' (which must have room for numTriangles 
+	// entries) and their number to 'numClipTriangles'.
+	uint32_t (*setupTriangles)(uint32_t numTriangles, const uint16_t* indices, const int32_t* posi, uint32_t w, uint32_t h, int32_t sampleExtent, uint16_t* visibleIndices, uint32_t* clipTriangles, uint32_t* numClipTriangles);
+
+	// Index expansion. assembleTriangles converts 'numIndices' 1US or 1UI ('indexFormat') 
+	// strip or fan indices to an indexed triangle list, skipping primitive restart indices, 
+	// and returns the number of triangles written to 'triangles' (which must have room for 
+	// numIndices * 3 indices). Odd strip triangles have their first two vertices swapped 
+	// so that all triangles have the same winding. rebaseIndices converts 'numIndices' 
+	// indices to 16-bit ones relative to the smallest of them, which is written to 'base'. 
+	// Returns false, and writes nothing to 'rebased', if they span more than 65536 vertices.
+	uint32_t (*assembleTriangles)(swr_primitive_type primType, swr_format indexFormat, uint32_t numIndices, const void* indices, uint32_t* triangles);
+	bool (*rebaseIndices)(uint32_t numIndices, const uint32_t* indices, uint16_t* rebased, uint32_t* base);
+
+	// Multisample resolve. Averages 'numSamples' (4 or 8) sample planes, 'sampleStride' 
+	// pixels apart, into 'dst'. All 4 channels are rounded to nearest.
+	void (*resolveSamples)(uint32_t numPixels, uint32_t numSamples, uint32_t sampleStride, const uint32_t* samples, uint32_t* dst);
+
+	// Mip generation. Averages each 2x2 block of pixels from the two rows 'row0' and 'row1' 
+	// (2 * numPixels pixels each) into 'dst'. All 4 channels are rounded to nearest.
+	void (*downsample2x2)(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst);
+
+	// Line spans. fillSpan writes 'n' consecutive pixels using one of the swr_blend_mode 
+	// equations. blendSpanCoverage blends 'n' anti-aliased line pixels with SWR_BLEND_MODE_SRC_OVER. 
+	// The first pixel's center is at distance 'd0' from the line's center along the span, 
+	// the line extends 'halfWidth' pixels on both sides of it and each pixel's alpha is 
+	// its coverage times 'alphaScale' (at most 255). The color's alpha is ignored.
+	void (*fillSpan)(uint32_t* dst, uint32_t n, uint32_t color, uint32_t blendMode);
+	void (*blendSpanCoverage)(uint32_t* dst, uint32_t n, uint32_t color, float d0, float halfWidth, float alphaScale);
+
+	// Glyph blitting. Writes 'color' to the pixels of 'numRows' rows of 8 pixels, 'stride' 
+	// pixels apart, starting at 'dst'. Pixel x of row y is written if bit x of 'rows[y]', 
+	// shifted right by 'shift' (left if negative) and ANDed with 'columnMask', is set. 
+	// All 8 pixels of each row must be valid memory. Other pixels aren't modified.
+	void (*blitGlyph)(uint32_t* dst, uint32_t stride, const uint8_t* rows, uint32_t numRows, int32_t shift, uint32_t columnMask, uint32_t color);
+
+	// Coverage blending. Blends 'color' with SWR_BLEND_MODE_SRC_OVER into 'n' consecutive 
+	// pixels, with pixel i's alpha being the color's alpha times 'coverage[i]' / 255.
+	void (*blendCoverage)(uint32_t* dst, const uint8_t* coverage, uint32_t n, uint32_t color);
 } swr_api;
 
 extern swr_api* swr;
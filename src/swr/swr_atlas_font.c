@@ -0,0 +1,270 @@
+#include "swr.h"
+#include "swr_p.h"
+#include "../core/allocator.h"
+#include "../core/memory.h"
+#include "../core/string.h"
+#include "../core/math.h"
+
+// Maximum number of pixels of a scaled glyph row sampled before blending them.
+#define SWR_ATLAS_FONT_SPAN_SIZE 256
+
+static int32_t swrAtlasFontSearchGlyph(const swr_atlas_glyph* glyphs, uint32_t numGlyphs, uint32_t cp);
+static int32_t swrAtlasFontFindGlyph(const swr_atlas_font* font, uint32_t cp);
+static const char* swrAtlasFontNextCodepoint(const char* str, const char* end, uint32_t* cp);
+static void swrAtlasFontBlitGlyph(swr_context* ctx, const swr_atlas_font* font, const swr_atlas_glyph* glyph, float x, float y, uint32_t color);
+static void swrAtlasFontDrawScaledGlyph(swr_context* ctx, const swr_atlas_font* font, const swr_atlas_glyph* glyph, float x, float y, float scale, uint32_t color);
+
+swr_atlas_font* swrCreateAtlasFont(core_allocator_i* allocator, const swr_atlas_font_desc* desc)
+{
+	if (desc->m_Atlas == NULL || desc->m_AtlasWidth == 0 || desc->m_AtlasHeight == 0 || desc->m_NumGlyphs == 0) {
+		return NULL;
+	}
+
+	if (desc->m_Type == SWR_ATLAS_FONT_TYPE_SDF && !(desc->m_SDFRange > 0.0f)) {
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < desc->m_NumGlyphs; ++i) {
+		const swr_atlas_glyph* glyph = &desc->m_Glyphs[i];
+		if ((uint32_t)glyph->m_AtlasX + glyph->m_Width > desc->m_AtlasWidth || (uint32_t)glyph->m_AtlasY + glyph->m_Height > desc->m_AtlasHeight) {
+			return NULL;
+		}
+
+		if (i != 0 && glyph->m_Codepoint <= desc->m_Glyphs[i - 1].m_Codepoint) {
+			return NULL;
+		}
+	}
+
+	// The font, its glyphs and the atlas are kept in a single allocation.
+	const size_t glyphsSize = sizeof(swr_atlas_glyph) * (size_t)desc->m_NumGlyphs;
+	const size_t atlasSize = (size_t)desc->m_AtlasWidth * desc->m_AtlasHeight;
+	uint8_t* mem = (uint8_t*)CORE_ALLOC(allocator, sizeof(swr_atlas_font) + glyphsSize + atlasSize);
+	if (!mem) {
+		return NULL;
+	}
+
+	swr_atlas_font* font = (swr_atlas_font*)mem;
+	core_memSet(font, 0, sizeof(swr_atlas_font));
+	font->m_Glyphs = (swr_atlas_glyph*)(mem + sizeof(swr_atlas_font));
+	font->m_Atlas = mem + sizeof(swr_atlas_font) + glyphsSize;
+	font->m_AtlasWidth = desc->m_AtlasWidth;
+	font->m_AtlasHeight = desc->m_AtlasHeight;
+	font->m_NumGlyphs = desc->m_NumGlyphs;
+	font->m_Type = desc->m_Type;
+	font->m_SDFRange = desc->m_SDFRange;
+	core_memCopy(font->m_Glyphs, desc->m_Glyphs, glyphsSize);
+	core_memCopy(font->m_Atlas, desc->m_Atlas, atlasSize);
+
+	for (uint32_t cp = 0; cp < 128; ++cp) {
+		font->m_ASCIIGlyphs[cp] = swrAtlasFontSearchGlyph(font->m_Glyphs, font->m_NumGlyphs, cp);
+	}
+	font->m_FallbackGlyph = swrAtlasFontSearchGlyph(font->m_Glyphs, font->m_NumGlyphs, desc->m_FallbackCodepoint);
+
+	return font;
+}
+
+void swrDestroyAtlasFont(core_allocator_i* allocator, swr_atlas_font* font)
+{
+	CORE_FREE(allocator, font);
+}
+
+// Unscaled coverage glyphs are blended straight from the atlas, one row at a time.
+// Everything else is resampled into a row of coverage values first.
+void swrDrawAtlasTextRun(swr_context* ctx, const swr_atlas_font* font, float scale, int32_t x0, int32_t y0, const char* str, const char* end, uint32_t color)
+{
+	end = end != NULL
+		? end
+		: str + core_strlen(str)
+		;
+
+	if (!(scale > 0.0f)) {
+		return;
+	}
+
+	if (ctx->m_BlendMode == SWR_BLEND_MODE_OPAQUE) {
+		color |= 0xFF000000u;
+	}
+
+	const bool blitUnscaled = font->m_Type == SWR_ATLAS_FONT_TYPE_COVERAGE && scale == 1.0f;
+	float penX = (float)x0;
+	while (str < end) {
+		uint32_t cp;
+		str = swrAtlasFontNextCodepoint(str, end, &cp);
+
+		const int32_t glyphID = swrAtlasFontFindGlyph(font, cp);
+		if (glyphID < 0) {
+			continue;
+		}
+
+		const swr_atlas_glyph* glyph = &font->m_Glyphs[glyphID];
+		if (glyph->m_Width != 0 && glyph->m_Height != 0) {
+			if (blitUnscaled) {
+				swrAtlasFontBlitGlyph(ctx, font, glyph, core_floorf(penX + 0.5f) + (float)glyph->m_OffsetX, (float)y0 + (float)glyph->m_OffsetY, color);
+			} else {
+				swrAtlasFontDrawScaledGlyph(ctx, font, glyph, penX + (float)glyph->m_OffsetX * scale, (float)y0 + (float)glyph->m_OffsetY * scale, scale, color);
+			}
+		}
+
+		penX += glyph->m_Advance * scale;
+	}
+}
+
+static int32_t swrAtlasFontSearchGlyph(const swr_atlas_glyph* glyphs, uint32_t numGlyphs, uint32_t cp)
+{
+	uint32_t first = 0;
+	uint32_t last = numGlyphs;
+	while (first < last) {
+		const uint32_t mid = first + ((last - first) >> 1);
+		if (glyphs[mid].m_Codepoint < cp) {
+			first = mid + 1;
+		} else {
+			last = mid;
+		}
+	}
+
+	return (first < numGlyphs && glyphs[first].m_Codepoint == cp)
+		? (int32_t)first
+		: -1
+		;
+}
+
+static int32_t swrAtlasFontFindGlyph(const swr_atlas_font* font, uint32_t cp)
+{
+	const int32_t glyphID = cp < 128
+		? font->m_ASCIIGlyphs[cp]
+		: swrAtlasFontSearchGlyph(font->m_Glyphs, font->m_NumGlyphs, cp)
+		;
+	return glyphID >= 0
+		? glyphID
+		: font->m_FallbackGlyph
+		;
+}
+
+// core_utf8ToCodepoint reads up to 4 bytes, so sequences close to 'end' are decoded from
+// a null padded copy. Null characters inside the string are skipped like any other codepoint.
+static const char* swrAtlasFontNextCodepoint(const char* str, const char* end, uint32_t* cp)
+{
+	const char* next;
+	if (end - str >= 4) {
+		next = core_utf8ToCodepoint(str, cp);
+	} else {
+		char seq[5] = { 0, 0, 0, 0, 0 };
+		core_memCopy(seq, str, (size_t)(end - str));
+		next = str + (core_utf8ToCodepoint(seq, cp) - seq);
+	}
+
+	return next != str
+		? next
+		: str + 1
+		;
+}
+
+// (x, y) is the glyph's top-left corner, in whole pixels.
+static void swrAtlasFontBlitGlyph(swr_context* ctx, const swr_atlas_font* font, const swr_atlas_glyph* glyph, float x, float y, uint32_t color)
+{
+	const swr_rect* scissor = &ctx->m_ScissorRect;
+	if (!(x <= (float)scissor->m_MaxX && y <= (float)scissor->m_MaxY && x + (float)glyph->m_Width > (float)scissor->m_MinX && y + (float)glyph->m_Height > (float)scissor->m_MinY)) {
+		return;
+	}
+
+	// The glyph overlaps the scissor rect so its corner is a valid int32_t.
+	const int32_t gx = (int32_t)x;
+	const int32_t gy = (int32_t)y;
+	const int32_t colBegin = core_maxi32(scissor->m_MinX - gx, 0);
+	const int32_t colEnd = core_mini32(scissor->m_MaxX - gx + 1, (int32_t)glyph->m_Width);
+	const int32_t rowBegin = core_maxi32(scissor->m_MinY - gy, 0);
+	const int32_t rowEnd = core_mini32(scissor->m_MaxY - gy + 1, (int32_t)glyph->m_Height);
+	swrTouchTiles(ctx, gx + colBegin, gy + rowBegin, gx + colEnd - 1, gy + rowEnd - 1);
+
+	const uint32_t fbWidth = ctx->m_Width;
+	const uint32_t atlasWidth = font->m_AtlasWidth;
+	const uint8_t* src = &font->m_Atlas[(glyph->m_AtlasX + colBegin) + (glyph->m_AtlasY + rowBegin) * atlasWidth];
+	uint32_t* dst = &ctx->m_SampleBuffer[(gx + colBegin) + (gy + rowBegin) * fbWidth];
+	for (int32_t row = rowBegin; row < rowEnd; ++row) {
+		for (uint32_t iSample = 0; iSample < ctx->m_NumSamples; ++iSample) {
+			swr->blendCoverage(dst + iSample * ctx->m_SampleStride, src, (uint32_t)(colEnd - colBegin), color);
+		}
+
+		src += atlasWidth;
+		dst += fbWidth;
+	}
+}
+
+// Texel (i, j) of the glyph is centered at (x + (i + 0.5) * scale, y + (j + 0.5) * scale).
+// Pixels are bilinearly sampled at their centers, with texels outside the glyph being 0,
+// so the glyph reaches half a texel past its edges. SDF values are converted to the
+// coverage of the pixel by the glyph's outline, as a 1 pixel wide linear ramp.
+static void swrAtlasFontDrawScaledGlyph(swr_context* ctx, const swr_atlas_font* font, const swr_atlas_glyph* glyph, float x, float y, float scale, uint32_t color)
+{
+	const swr_rect* scissor = &ctx->m_ScissorRect;
+	const float margin = 0.5f * scale;
+	const float pxBegin = core_maxf(core_floorf(x - margin), (float)scissor->m_MinX);
+	const float pxEnd = core_minf(core_ceilf(x + (float)glyph->m_Width * scale + margin), (float)scissor->m_MaxX + 1.0f);
+	const float pyBegin = core_maxf(core_floorf(y - margin), (float)scissor->m_MinY);
+	const float pyEnd = core_minf(core_ceilf(y + (float)glyph->m_Height * scale + margin), (float)scissor->m_MaxY + 1.0f);
+	if (!(pxBegin < pxEnd && pyBegin < pyEnd)) {
+		return;
+	}
+
+	const int32_t xBegin = (int32_t)pxBegin;
+	const int32_t xEnd = (int32_t)pxEnd;
+	const int32_t yBegin = (int32_t)pyBegin;
+	const int32_t yEnd = (int32_t)pyEnd;
+	swrTouchTiles(ctx, xBegin, yBegin, xEnd - 1, yEnd - 1);
+
+	const bool sdf = font->m_Type == SWR_ATLAS_FONT_TYPE_SDF;
+	const float sdfScale = font->m_SDFRange * scale / 127.0f; // Screen pixels per SDF step
+	const float invScale = 1.0f / scale;
+	const int32_t glyphWidth = (int32_t)glyph->m_Width;
+	const int32_t glyphHeight = (int32_t)glyph->m_Height;
+	const uint32_t atlasWidth = font->m_AtlasWidth;
+	const uint8_t* glyphTexels = &font->m_Atlas[glyph->m_AtlasX + glyph->m_AtlasY * atlasWidth];
+	const uint32_t fbWidth = ctx->m_Width;
+
+	int32_t colTexel[SWR_ATLAS_FONT_SPAN_SIZE];
+	float colWeight[SWR_ATLAS_FONT_SPAN_SIZE];
+	uint8_t coverage[SWR_ATLAS_FONT_SPAN_SIZE];
+	for (int32_t spanBegin = xBegin; spanBegin < xEnd; spanBegin += SWR_ATLAS_FONT_SPAN_SIZE) {
+		const int32_t spanLen = core_mini32(xEnd - spanBegin, SWR_ATLAS_FONT_SPAN_SIZE);
+		for (int32_t i = 0; i < spanLen; ++i) {
+			const float u = ((float)(spanBegin + i) + 0.5f - x) * invScale - 0.5f;
+			const float u0 = core_floorf(u);
+			colTexel[i] = (int32_t)core_maxf(core_minf(u0, (float)glyphWidth), -2.0f);
+			colWeight[i] = u - u0;
+		}
+
+		for (int32_t py = yBegin; py < yEnd; ++py) {
+			const float v = ((float)py + 0.5f - y) * invScale - 0.5f;
+			const float v0 = core_floorf(v);
+			const int32_t j0 = (int32_t)core_maxf(core_minf(v0, (float)glyphHeight), -2.0f);
+			const float fv = v - v0;
+			const uint8_t* row0 = (j0 >= 0 && j0 < glyphHeight) ? &glyphTexels[j0 * atlasWidth] : NULL;
+			const uint8_t* row1 = (j0 + 1 >= 0 && j0 + 1 < glyphHeight) ? &glyphTexels[(j0 + 1) * atlasWidth] : NULL;
+
+			for (int32_t i = 0; i < spanLen; ++i) {
+				const int32_t i0 = colTexel[i];
+				const bool valid0 = i0 >= 0 && i0 < glyphWidth;
+				const bool valid1 = i0 + 1 >= 0 && i0 + 1 < glyphWidth;
+				const float t00 = (row0 && valid0) ? (float)row0[i0] : 0.0f;
+				const float t10 = (row0 && valid1) ? (float)row0[i0 + 1] : 0.0f;
+				const float t01 = (row1 && valid0) ? (float)row1[i0] : 0.0f;
+				const float t11 = (row1 && valid1) ? (float)row1[i0 + 1] : 0.0f;
+				const float fu = colWeight[i];
+				const float top = t00 + (t10 - t00) * fu;
+				const float bottom = t01 + (t11 - t01) * fu;
+				const float val = top + (bottom - top) * fv;
+
+				const float cov = sdf
+					? core_maxf(core_minf((val - 128.0f) * sdfScale + 0.5f, 1.0f), 0.0f) * 255.0f
+					: val
+					;
+				coverage[i] = (uint8_t)(cov + 0.5f);
+			}
+
+			uint32_t* dst = &ctx->m_SampleBuffer[spanBegin + py * fbWidth];
+			for (uint32_t iSample = 0; iSample < ctx->m_NumSamples; ++iSample) {
+				swr->blendCoverage(dst + iSample * ctx->m_SampleStride, coverage, (uint32_t)spanLen, color);
+			}
+		}
+	}
+}
@@ -0,0 +1,381 @@
+#include "swr.h"
+#include "swr_p.h"
+#include "../core/allocator.h"
+#include "../core/memory.h"
+#include "../core/math.h"
+#include "../core/os.h"
+#include "../core/atomic.h"
+
+static void swrBinnerRasterizeBins(swr_worker* worker);
+static int32_t swrBinnerWorkerThread(void* userData);
+static void swrBinnerResetBins(swr_binner* binner);
+static void swrBinnerAddTriangle_internal(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2, const float* uv);
+
+swr_binner* swrBinnerCreate(swr_context* ctx, core_allocator_i* allocator, uint32_t numWorkerThreads)
+{
+	swr_binner* binner = (swr_binner*)CORE_ALLOC(allocator, sizeof(swr_binner));
+	if (!binner) {
+		return NULL;
+	}
+
+	core_memSet(binner, 0, sizeof(swr_binner));
+	binner->m_NumBinsX = core_roundUp(ctx->m_Width, SWR_CONFIG_BIN_WIDTH) / SWR_CONFIG_BIN_WIDTH;
+	binner->m_NumBinsY = core_roundUp(ctx->m_Height, SWR_CONFIG_BIN_HEIGHT) / SWR_CONFIG_BIN_HEIGHT;
+	binner->m_NumWorkers = numWorkerThreads + 1;
+
+	binner->m_FrameAllocator = core_allocatorCreateLinearAllocator(4 << 20, allocator);
+	if (!binner->m_FrameAllocator) {
+		swrBinnerDestroy(binner, allocator);
+		return NULL;
+	}
+
+	const uint32_t numBins = binner->m_NumBinsX * binner->m_NumBinsY;
+	binner->m_Bins = (swr_bin*)CORE_ALLOC(allocator, sizeof(swr_bin) * numBins);
+	if (!binner->m_Bins) {
+		swrBinnerDestroy(binner, allocator);
+		return NULL;
+	}
+
+	swrBinnerResetBins(binner);
+
+	binner->m_Workers = (swr_worker*)CORE_ALLOC(allocator, sizeof(swr_worker) * binner->m_NumWorkers);
+	if (!binner->m_Workers) {
+		swrBinnerDestroy(binner, allocator);
+		return NULL;
+	}
+
+	core_memSet(binner->m_Workers, 0, sizeof(swr_worker) * binner->m_NumWorkers);
+
+	// Each worker needs its own tile buffers. Since a worker only rasterizes one bin
+	// at a time they only need to be large enough to hold all the tiles of a single bin.
+	const uint32_t numTilesPerBin = (SWR_CONFIG_BIN_WIDTH / SWR_CONFIG_TILEBUF_TILE_WIDTH) * (SWR_CONFIG_BIN_HEIGHT / SWR_CONFIG_TILEBUF_TILE_HEIGHT);
+	const uint32_t tileBufferSize = numTilesPerBin * SWR_CONFIG_TILEBUF_TILE_SIZE;
+	binner->m_TileBuffer = (uint8_t*)CORE_ALIGNED_ALLOC(allocator, tileBufferSize * 2 * binner->m_NumWorkers, 32);
+	if (!binner->m_TileBuffer) {
+		swrBinnerDestroy(binner, allocator);
+		return NULL;
+	}
+
+	for (uint32_t iWorker = 0; iWorker < binner->m_NumWorkers; ++iWorker) {
+		swr_worker* worker = &binner->m_Workers[iWorker];
+		worker->m_Binner = binner;
+		worker->m_Ctx.m_TileBuffer[0] = &binner->m_TileBuffer[tileBufferSize * (iWorker * 2 + 0)];
+		worker->m_Ctx.m_TileBuffer[1] = &binner->m_TileBuffer[tileBufferSize * (iWorker * 2 + 1)];
+	}
+
+	binner->m_WorkSemaphore = core_osSemaphoreCreate(0);
+	binner->m_DoneSemaphore = core_osSemaphoreCreate(0);
+	if (!binner->m_WorkSemaphore || !binner->m_DoneSemaphore) {
+		swrBinnerDestroy(binner, allocator);
+		return NULL;
+	}
+
+	// Worker 0 is the thread calling flush.
+	for (uint32_t iWorker = 1; iWorker < binner->m_NumWorkers; ++iWorker) {
+		swr_worker* worker = &binner->m_Workers[iWorker];
+		worker->m_Thread = core_osThreadCreate(swrBinnerWorkerThread, worker, 0, "swr worker");
+		if (!worker->m_Thread) {
+			swrBinnerDestroy(binner, allocator);
+			return NULL;
+		}
+	}
+
+	return binner;
+}
+
+void swrBinnerDestroy(swr_binner* binner, core_allocator_i* allocator)
+{
+	if (binner->m_Workers) {
+		// Wake up all running threads and wait for them to exit.
+		core_atomicStorei32(&binner->m_Quit, 1);
+		if (binner->m_WorkSemaphore) {
+			core_osSemaphoreSignal(binner->m_WorkSemaphore, binner->m_NumWorkers - 1);
+		}
+
+		for (uint32_t iWorker = 1; iWorker < binner->m_NumWorkers; ++iWorker) {
+			swr_worker* worker = &binner->m_Workers[iWorker];
+			if (worker->m_Thread) {
+				core_osThreadShutdown(worker->m_Thread);
+				worker->m_Thread = NULL;
+			}
+		}
+
+		CORE_FREE(allocator, binner->m_Workers);
+		binner->m_Workers = NULL;
+	}
+
+	if (binner->m_WorkSemaphore) {
+		core_osSemaphoreDestroy(binner->m_WorkSemaphore);
+		binner->m_WorkSemaphore = NULL;
+	}
+
+	if (binner->m_DoneSemaphore) {
+		core_osSemaphoreDestroy(binner->m_DoneSemaphore);
+		binner->m_DoneSemaphore = NULL;
+	}
+
+	if (binner->m_FrameAllocator) {
+		core_allocatorDestroyLinearAllocator(binner->m_FrameAllocator);
+		binner->m_FrameAllocator = NULL;
+	}
+
+	CORE_ALIGNED_FREE(allocator, binner->m_TileBuffer, 32);
+	CORE_FREE(allocator, binner->m_Bins);
+	CORE_FREE(allocator, binner);
+}
+
+void swrBinnerAddTriangle(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2)
+{
+	swrBinnerAddTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color0, color1, color2, NULL);
+}
+
+void swrBinnerAddTriangleFlat(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+{
+	swrBinnerAddTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color, color, color, NULL);
+}
+
+void swrBinnerAddTriangleTextured(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv)
+{
+	if (ctx->m_Texture == NULL) {
+		return;
+	}
+
+	swrBinnerAddTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, 0, 0, 0, uv);
+}
+
+// Textured triangles ('uv' != NULL) keep a reference to the currently bound texture, 
+// all others to the currently bound pixel shader. Varyings (ctx->m_Varyings) are copied.
+static void swrBinnerAddTriangle_internal(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2, const float* uv)
+{
+	swr_binner* binner = ctx->m_Binner;
+
+	// Same bounding box rejection test as in the drawTriangle kernels.
+	const swr_rect* scissor = &ctx->m_ScissorRect;
+	const int32_t sampleExtent = ctx->m_SampleExtent;
+	const int32_t bboxMinX = core_maxi32(swrSubpixelCeil(core_min3i32(x0, x1, x2) - sampleExtent), scissor->m_MinX);
+	const int32_t bboxMinY = core_maxi32(swrSubpixelCeil(core_min3i32(y0, y1, y2) - sampleExtent), scissor->m_MinY);
+	const int32_t bboxMaxX = core_mini32(swrSubpixelFloor(core_max3i32(x0, x1, x2) + sampleExtent), scissor->m_MaxX);
+	const int32_t bboxMaxY = core_mini32(swrSubpixelFloor(core_max3i32(y0, y1, y2) + sampleExtent), scissor->m_MaxY);
+	if (bboxMinX > bboxMaxX || bboxMinY > bboxMaxY) {
+		return;
+	}
+
+	core_allocator_i* allocator = binner->m_FrameAllocator;
+	swr_bin_triangle* tri = (swr_bin_triangle*)CORE_ALLOC(allocator, sizeof(swr_bin_triangle));
+	if (!tri) {
+		return;
+	}
+
+	tri->m_Pos[0] = x0;
+	tri->m_Pos[1] = y0;
+	tri->m_Pos[2] = x1;
+	tri->m_Pos[3] = y1;
+	tri->m_Pos[4] = x2;
+	tri->m_Pos[5] = y2;
+	tri->m_Color[0] = color0;
+	tri->m_Color[1] = color1;
+	tri->m_Color[2] = color2;
+	tri->m_BlendMode = ctx->m_BlendMode;
+	tri->m_Texture = uv != NULL ? ctx->m_Texture : NULL;
+	tri->m_TextureFilter = ctx->m_TextureFilter;
+	if (uv != NULL) {
+		for (uint32_t i = 0; i < 6; ++i) {
+			tri->m_TexCoord[i] = uv[i];
+		}
+	}
+	tri->m_PixelShader = uv == NULL ? ctx->m_PixelShader : NULL;
+	tri->m_PixelShaderUserData = ctx->m_PixelShaderUserData;
+	tri->m_Varyings = NULL;
+	if (tri->m_PixelShader != NULL && ctx->m_Varyings != NULL) {
+		const uint32_t numVaryings = ctx->m_VaryingLayout.m_NumVaryings;
+		float* varyings = (float*)CORE_ALLOC(allocator, sizeof(float) * numVaryings * 3);
+		if (!varyings) {
+			return;
+		}
+
+		core_memCopy(varyings, ctx->m_Varyings, sizeof(float) * numVaryings * 3);
+		tri->m_Varyings = varyings;
+		tri->m_VaryingLayout = ctx->m_VaryingLayout;
+	}
+
+	const uint32_t binMinX = (uint32_t)bboxMinX / SWR_CONFIG_BIN_WIDTH;
+	const uint32_t binMinY = (uint32_t)bboxMinY / SWR_CONFIG_BIN_HEIGHT;
+	const uint32_t binMaxX = (uint32_t)bboxMaxX / SWR_CONFIG_BIN_WIDTH;
+	const uint32_t binMaxY = (uint32_t)bboxMaxY / SWR_CONFIG_BIN_HEIGHT;
+
+	// Reserve all the chunks the triangle needs before linking it into any bin. Otherwise 
+	// an allocation failure halfway through would leave it in only some of its bins.
+	uint32_t numNewChunks = 0;
+	for (uint32_t by = binMinY; by <= binMaxY; ++by) {
+		const swr_bin* bin = &binner->m_Bins[binMinX + by * binner->m_NumBinsX];
+		for (uint32_t bx = binMinX; bx <= binMaxX; ++bx) {
+			const swr_bin_chunk* chunk = bin->m_LastChunk;
+			if (!chunk || chunk->m_NumTriangles == SWR_CONFIG_BIN_CHUNK_CAPACITY) {
+				++numNewChunks;
+			}
+			++bin;
+		}
+	}
+
+	swr_bin_chunk* newChunks = NULL;
+	if (numNewChunks != 0) {
+		newChunks = (swr_bin_chunk*)CORE_ALLOC(allocator, sizeof(swr_bin_chunk) * numNewChunks);
+		if (!newChunks) {
+			return;
+		}
+	}
+
+	for (uint32_t by = binMinY; by <= binMaxY; ++by) {
+		swr_bin* bin = &binner->m_Bins[binMinX + by * binner->m_NumBinsX];
+		for (uint32_t bx = binMinX; bx <= binMaxX; ++bx) {
+			swr_bin_chunk* chunk = bin->m_LastChunk;
+			if (!chunk || chunk->m_NumTriangles == SWR_CONFIG_BIN_CHUNK_CAPACITY) {
+				swr_bin_chunk* newChunk = newChunks++;
+				newChunk->m_Next = NULL;
+				newChunk->m_NumTriangles = 0;
+				if (chunk) {
+					chunk->m_Next = newChunk;
+				} else {
+					bin->m_FirstChunk = newChunk;
+				}
+				bin->m_LastChunk = newChunk;
+				chunk = newChunk;
+			}
+
+			chunk->m_Triangles[chunk->m_NumTriangles++] = tri;
+			++bin;
+		}
+	}
+
+	binner->m_NumTriangles++;
+}
+
+void swrBinnerFlush(swr_context* ctx)
+{
+	swr_binner* binner = ctx->m_Binner;
+	if (binner->m_NumTriangles == 0) {
+		return;
+	}
+
+	// Workers rasterize into a copy of the main context because each one of them
+	// needs its own scissor rect and tile buffers.
+	for (uint32_t iWorker = 0; iWorker < binner->m_NumWorkers; ++iWorker) {
+		swr_context* workerCtx = &binner->m_Workers[iWorker].m_Ctx;
+		uint8_t* tileBuffer0 = workerCtx->m_TileBuffer[0];
+		uint8_t* tileBuffer1 = workerCtx->m_TileBuffer[1];
+		core_memCopy(workerCtx, ctx, sizeof(swr_context));
+		workerCtx->m_TileBuffer[0] = tileBuffer0;
+		workerCtx->m_TileBuffer[1] = tileBuffer1;
+		workerCtx->m_Binner = NULL;
+	}
+
+	core_atomicStorei32(&binner->m_NextBinID, 0);
+
+	const uint32_t numThreads = binner->m_NumWorkers - 1;
+	core_osSemaphoreSignal(binner->m_WorkSemaphore, numThreads);
+	swrBinnerRasterizeBins(&binner->m_Workers[0]);
+	for (uint32_t i = 0; i < numThreads; ++i) {
+		core_osSemaphoreWait(binner->m_DoneSemaphore, UINT32_MAX);
+	}
+
+	swrBinnerResetBins(binner);
+	core_allocatorResetLinearAllocator(binner->m_FrameAllocator);
+	binner->m_NumTriangles = 0;
+}
+
+static void swrBinnerRasterizeBins(swr_worker* worker)
+{
+	swr_binner* binner = worker->m_Binner;
+	swr_context* ctx = &worker->m_Ctx;
+	const int32_t numBins = (int32_t)(binner->m_NumBinsX * binner->m_NumBinsY);
+
+	// The worker's context is a copy of the main one so this is the scissor rect 
+	// the triangles have been binned with.
+	const swr_rect scissor = ctx->m_ScissorRect;
+
+	while (true) {
+		const int32_t binID = core_atomicFetchAddi32(&binner->m_NextBinID, 1);
+		if (binID >= numBins) {
+			break;
+		}
+
+		const swr_bin* bin = &binner->m_Bins[binID];
+		const swr_bin_chunk* chunk = bin->m_FirstChunk;
+		if (!chunk) {
+			continue;
+		}
+
+		const int32_t binX = (binID % (int32_t)binner->m_NumBinsX) * SWR_CONFIG_BIN_WIDTH;
+		const int32_t binY = (binID / (int32_t)binner->m_NumBinsX) * SWR_CONFIG_BIN_HEIGHT;
+		ctx->m_ScissorRect.m_MinX = core_maxi32(binX, scissor.m_MinX);
+		ctx->m_ScissorRect.m_MinY = core_maxi32(binY, scissor.m_MinY);
+		ctx->m_ScissorRect.m_MaxX = core_mini32(binX + SWR_CONFIG_BIN_WIDTH - 1, scissor.m_MaxX);
+		ctx->m_ScissorRect.m_MaxY = core_mini32(binY + SWR_CONFIG_BIN_HEIGHT - 1, scissor.m_MaxY);
+
+		while (chunk) {
+			const uint32_t numTriangles = chunk->m_NumTriangles;
+			for (uint32_t iTri = 0; iTri < numTriangles; ++iTri) {
+				const swr_bin_triangle* tri = chunk->m_Triangles[iTri];
+				ctx->m_BlendMode = tri->m_BlendMode;
+				ctx->m_PixelShader = tri->m_PixelShader;
+				ctx->m_PixelShaderUserData = tri->m_PixelShaderUserData;
+				ctx->m_Varyings = tri->m_Varyings;
+				if (tri->m_Varyings != NULL) {
+					ctx->m_VaryingLayout = tri->m_VaryingLayout;
+				}
+				if (tri->m_Texture != NULL) {
+					ctx->m_Texture = tri->m_Texture;
+					ctx->m_TextureFilter = tri->m_TextureFilter;
+					swr->drawTriangleTextured(ctx
+						, tri->m_Pos[0], tri->m_Pos[1]
+						, tri->m_Pos[2], tri->m_Pos[3]
+						, tri->m_Pos[4], tri->m_Pos[5]
+						, tri->m_TexCoord
+					);
+				} else if (tri->m_Color[0] == tri->m_Color[1] && tri->m_Color[0] == tri->m_Color[2]) {
+					swr->drawTriangleFlat(ctx
+						, tri->m_Pos[0], tri->m_Pos[1]
+						, tri->m_Pos[2], tri->m_Pos[3]
+						, tri->m_Pos[4], tri->m_Pos[5]
+						, tri->m_Color[0]
+					);
+				} else {
+					swr->drawTriangle(ctx
+						, tri->m_Pos[0], tri->m_Pos[1]
+						, tri->m_Pos[2], tri->m_Pos[3]
+						, tri->m_Pos[4], tri->m_Pos[5]
+						, tri->m_Color[0]
+						, tri->m_Color[1]
+						, tri->m_Color[2]
+					);
+				}
+			}
+
+			chunk = chunk->m_Next;
+		}
+	}
+}
+
+static int32_t swrBinnerWorkerThread(void* userData)
+{
+	swr_worker* worker = (swr_worker*)userData;
+	swr_binner* binner = worker->m_Binner;
+
+	while (true) {
+		core_osSemaphoreWait(binner->m_WorkSemaphore, UINT32_MAX);
+		if (core_atomicLoadi32(&binner->m_Quit) != 0) {
+			break;
+		}
+
+		swrBinnerRasterizeBins(worker);
+
+		core_osSemaphoreSignal(binner->m_DoneSemaphore, 1);
+	}
+
+	return 0;
+}
+
+static void swrBinnerResetBins(swr_binner* binner)
+{
+	core_memSet(binner->m_Bins, 0, sizeof(swr_bin) * binner->m_NumBinsX * binner->m_NumBinsY);
+}
@@ -0,0 +1,15 @@
+#include "swr.h"
+#include "swr_p.h"
+
+void swrBlendCoverageRef(uint32_t* dst, const uint8_t* coverage, uint32_t n, uint32_t color)
+{
+	const uint32_t rgb = color & 0x00FFFFFF;
+	const uint32_t srcAlpha = color >> 24;
+	for (uint32_t i = 0; i < n; ++i) {
+		// Blending with 0 alpha leaves the framebuffer unchanged.
+		if (coverage[i] != 0) {
+			const uint32_t alpha = swrMulAlpha(coverage[i], srcAlpha);
+			dst[i] = swrBlendColor(rgb | (alpha << 24), dst[i], SWR_BLEND_MODE_SRC_OVER);
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#include "swr.h"
+#include "swr_p.h"
+
+#define SWR_VEC_MATH_SSE2
+#include "swr_vec_math.h"
+
+// Same as swrBlendCoverageRef, 4 pixels at a time. Groups of 4 pixels without any 
+// coverage, which make up most of a glyph's bounding box, are skipped.
+void swrBlendCoverageSSE2(uint32_t* dst, const uint8_t* coverage, uint32_t n, uint32_t color)
+{
+	const uint32_t rgb = color & 0x00FFFFFF;
+	const uint32_t srcAlpha = color >> 24;
+	const vec4i v_rgb = vec4i_fromInt((int32_t)rgb);
+	const vec4i v_srcAlpha = vec4i_fromInt((int32_t)srcAlpha);
+	const vec4i v_128 = vec4i_fromInt(128);
+
+	uint32_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		if (*(const uint32_t*)&coverage[i] == 0) {
+			continue;
+		}
+
+		// Same as swrMulAlpha
+		const vec4i v_t = vec4i_add(vec4i_mullo(vec4i_fromUint8x4vu(&coverage[i]), v_srcAlpha), v_128);
+		const vec4i v_alpha = vec4i_slr(vec4i_add(v_t, vec4i_slr(v_t, 8)), 8);
+
+		const vec4i v_src = vec4i_or(v_rgb, vec4i_sal(v_alpha, 24));
+		const vec4i v_dst = vec4i_fromInt4vu((const int32_t*)&dst[i]);
+		vec4i_toInt4vu(vec4i_blendSrcOverRGBA8(v_src, v_dst), (int32_t*)&dst[i]);
+	}
+
+	for (; i < n; ++i) {
+		if (coverage[i] != 0) {
+			const uint32_t alpha = swrMulAlpha(coverage[i], srcAlpha);
+			dst[i] = swrBlendColor(rgb | (alpha << 24), dst[i], SWR_BLEND_MODE_SRC_OVER);
+		}
+	}
+}
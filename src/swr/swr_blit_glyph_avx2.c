@@ -0,0 +1,25 @@
+#include "swr.h"
+#include "swr_p.h"
+
+#define SWR_VEC_MATH_AVX2
+#include "swr_vec_math.h"
+
+// Same as swrBlitGlyphRef. Each glyph row is expanded into an 8-lane mask by testing 
+// one bit per lane and the whole row is written with a single masked store. Masked out 
+// pixels are never read or written.
+void swrBlitGlyphAVX2(uint32_t* dst, uint32_t stride, const uint8_t* rows, uint32_t numRows, int32_t shift, uint32_t columnMask, uint32_t color)
+{
+	const vec8i v_color = vec8i_fromInt((int32_t)color);
+	const vec8i v_zero = vec8i_zero();
+	const vec8i v_bits = vec8i_fromInt8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+
+	for (uint32_t y = 0; y < numRows; ++y) {
+		const uint32_t mask = swrGlyphRowMask(rows[y], shift, columnMask);
+		if (mask != 0) {
+			const vec8i v_maskInv = vec8i_cmpeq(vec8i_and(vec8i_fromInt((int32_t)mask), v_bits), v_zero);
+			vec8i_toInt8vu_maskedInv(v_color, v_maskInv, (int32_t*)dst);
+		}
+
+		dst += stride;
+	}
+}
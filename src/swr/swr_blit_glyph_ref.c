@@ -0,0 +1,16 @@
+#include "swr.h"
+#include "swr_p.h"
+
+void swrBlitGlyphRef(uint32_t* dst, uint32_t stride, const uint8_t* rows, uint32_t numRows, int32_t shift, uint32_t columnMask, uint32_t color)
+{
+	for (uint32_t y = 0; y < numRows; ++y) {
+		const uint32_t mask = swrGlyphRowMask(rows[y], shift, columnMask);
+		for (uint32_t x = 0; x < 8; ++x) {
+			if ((mask & (1u << x)) != 0) {
+				dst[x] = color;
+			}
+		}
+
+		dst += stride;
+	}
+}
@@ -0,0 +1,30 @@
+#include "swr.h"
+#include "swr_p.h"
+
+#define SWR_VEC_MATH_SSE2
+#include "swr_vec_math.h"
+
+// Same as swrBlitGlyphRef. Each glyph row is expanded into two 4-lane masks by testing 
+// one bit per lane, and each half of the row is written with a single masked store.
+void swrBlitGlyphSSE2(uint32_t* dst, uint32_t stride, const uint8_t* rows, uint32_t numRows, int32_t shift, uint32_t columnMask, uint32_t color)
+{
+	const vec4i v_color = vec4i_fromInt((int32_t)color);
+	const vec4i v_zero = vec4i_zero();
+	const vec4i v_bitsLo = vec4i_fromInt4(0x01, 0x02, 0x04, 0x08);
+	const vec4i v_bitsHi = vec4i_fromInt4(0x10, 0x20, 0x40, 0x80);
+
+	for (uint32_t y = 0; y < numRows; ++y) {
+		const uint32_t mask = swrGlyphRowMask(rows[y], shift, columnMask);
+		if (mask != 0) {
+			const vec4i v_mask = vec4i_fromInt((int32_t)mask);
+			if ((mask & 0x0F) != 0) {
+				vec4i_toInt4vu_maskedInv(v_color, vec4i_cmpeq(vec4i_and(v_mask, v_bitsLo), v_zero), (int32_t*)&dst[0]);
+			}
+			if ((mask & 0xF0) != 0) {
+				vec4i_toInt4vu_maskedInv(v_color, vec4i_cmpeq(vec4i_and(v_mask, v_bitsHi), v_zero), (int32_t*)&dst[4]);
+			}
+		}
+
+		dst += stride;
+	}
+}
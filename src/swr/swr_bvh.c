@@ -0,0 +1,220 @@
+#include "swr.h"
+#include "swr_p.h"
+#include "../core/allocator.h"
+#include "../core/memory.h"
+#include "../core/math.h"
+#include <float.h>
+
+typedef struct swr_bvh_builder
+{
+	swr_bvh* m_BVH;
+	const uint16_t* m_SrcIndices;
+	uint32_t* m_TriangleIDs;
+	float* m_TriangleBounds;   // minx, miny, maxx, maxy per triangle
+	float* m_TriangleCentroids;
+	uint32_t* m_VertexMap;     // Original vertex index -> BVH vertex (UINT32_MAX if not used yet)
+} swr_bvh_builder;
+
+static void swrBVHBuildNode(swr_bvh_builder* builder, uint32_t first, uint32_t count, uint32_t depth);
+static void swrBVHEmitLeaf(swr_bvh_builder* builder, swr_bvh_node* node, uint32_t first, uint32_t count);
+
+// Builds a bounding volume hierarchy over the triangles of a static indexed mesh.
+// Nodes are split at the midpoint of the longest axis of their triangles' centroids
+// until they hold at most SWR_CONFIG_BVH_LEAF_SIZE triangles. Below 
+// SWR_CONFIG_BVH_MAX_SPATIAL_DEPTH they are split in half instead.
+swr_bvh* swrCreateBVH(core_allocator_i* allocator, const float* pos, const uint16_t* indices, uint32_t numIndices)
+{
+	const uint32_t numTriangles = numIndices / 3;
+
+	swr_bvh* bvh = (swr_bvh*)CORE_ALLOC(allocator, sizeof(swr_bvh));
+	if (!bvh) {
+		return NULL;
+	}
+
+	core_memSet(bvh, 0, sizeof(swr_bvh));
+	if (numTriangles == 0) {
+		return bvh;
+	}
+
+	const uint32_t maxNodes = numTriangles * 2 - 1;
+	bvh->m_Nodes = (swr_bvh_node*)CORE_ALLOC(allocator, sizeof(swr_bvh_node) * maxNodes);
+	bvh->m_Indices = (uint16_t*)CORE_ALLOC(allocator, sizeof(uint16_t) * numTriangles * 3);
+	bvh->m_VertexIDs = (uint16_t*)CORE_ALLOC(allocator, sizeof(uint16_t) * 65536);
+
+	swr_bvh_builder builder = {
+		.m_BVH = bvh,
+		.m_SrcIndices = indices,
+		.m_TriangleIDs = (uint32_t*)CORE_ALLOC(allocator, sizeof(uint32_t) * numTriangles),
+		.m_TriangleBounds = (float*)CORE_ALLOC(allocator, sizeof(float) * 4 * numTriangles),
+		.m_TriangleCentroids = (float*)CORE_ALLOC(allocator, sizeof(float) * 2 * numTriangles),
+		.m_VertexMap = (uint32_t*)CORE_ALLOC(allocator, sizeof(uint32_t) * 65536)
+	};
+
+	if (!bvh->m_Nodes || !bvh->m_Indices || !bvh->m_VertexIDs || !builder.m_TriangleIDs || !builder.m_TriangleBounds || !builder.m_TriangleCentroids || !builder.m_VertexMap) {
+		CORE_FREE(allocator, builder.m_TriangleIDs);
+		CORE_FREE(allocator, builder.m_TriangleBounds);
+		CORE_FREE(allocator, builder.m_TriangleCentroids);
+		CORE_FREE(allocator, builder.m_VertexMap);
+		swrDestroyBVH(allocator, bvh);
+		return NULL;
+	}
+
+	core_memSet(builder.m_VertexMap, 0xFF, sizeof(uint32_t) * 65536);
+
+	uint32_t maxVertexID = 0;
+	for (uint32_t iTri = 0; iTri < numTriangles; ++iTri) {
+		const uint16_t* tri = &indices[iTri * 3];
+		const float* p0 = &pos[tri[0] * 2];
+		const float* p1 = &pos[tri[1] * 2];
+		const float* p2 = &pos[tri[2] * 2];
+
+		float* bounds = &builder.m_TriangleBounds[iTri * 4];
+		bounds[0] = core_minf(p0[0], core_minf(p1[0], p2[0]));
+		bounds[1] = core_minf(p0[1], core_minf(p1[1], p2[1]));
+		bounds[2] = core_maxf(p0[0], core_maxf(p1[0], p2[0]));
+		bounds[3] = core_maxf(p0[1], core_maxf(p1[1], p2[1]));
+
+		builder.m_TriangleCentroids[iTri * 2 + 0] = (bounds[0] + bounds[2]) * 0.5f;
+		builder.m_TriangleCentroids[iTri * 2 + 1] = (bounds[1] + bounds[3]) * 0.5f;
+		builder.m_TriangleIDs[iTri] = iTri;
+
+		maxVertexID = core_maxu32(maxVertexID, core_maxu32(tri[0], core_maxu32(tri[1], tri[2])));
+	}
+
+	bvh->m_MaxVertexID = maxVertexID;
+	swrBVHBuildNode(&builder, 0, numTriangles, 0);
+
+	// Give back the memory of the unused nodes and vertex slots. This is optional so 
+	// the original arrays are kept if it fails.
+	swr_bvh_node* nodes = (swr_bvh_node*)CORE_REALLOC(allocator, bvh->m_Nodes, sizeof(swr_bvh_node) * bvh->m_NumNodes);
+	if (nodes) {
+		bvh->m_Nodes = nodes;
+	}
+
+	uint16_t* vertexIDs = (uint16_t*)CORE_REALLOC(allocator, bvh->m_VertexIDs, sizeof(uint16_t) * bvh->m_NumVertices);
+	if (vertexIDs) {
+		bvh->m_VertexIDs = vertexIDs;
+	}
+
+	CORE_FREE(allocator, builder.m_TriangleIDs);
+	CORE_FREE(allocator, builder.m_TriangleBounds);
+	CORE_FREE(allocator, builder.m_TriangleCentroids);
+	CORE_FREE(allocator, builder.m_VertexMap);
+
+	return bvh;
+}
+
+void swrDestroyBVH(core_allocator_i* allocator, swr_bvh* bvh)
+{
+	CORE_FREE(allocator, bvh->m_Nodes);
+	CORE_FREE(allocator, bvh->m_Indices);
+	CORE_FREE(allocator, bvh->m_VertexIDs);
+	CORE_FREE(allocator, bvh);
+}
+
+static void swrBVHBuildNode(swr_bvh_builder* builder, uint32_t first, uint32_t count, uint32_t depth)
+{
+	swr_bvh* bvh = builder->m_BVH;
+	const uint32_t nodeID = bvh->m_NumNodes++;
+	swr_bvh_node* node = &bvh->m_Nodes[nodeID];
+
+	uint32_t* triIDs = &builder->m_TriangleIDs[first];
+	const float* centroids = builder->m_TriangleCentroids;
+
+	float centroidMin[2] = { FLT_MAX, FLT_MAX };
+	float centroidMax[2] = { -FLT_MAX, -FLT_MAX };
+	node->m_BoundsMin[0] = node->m_BoundsMin[1] = FLT_MAX;
+	node->m_BoundsMax[0] = node->m_BoundsMax[1] = -FLT_MAX;
+	for (uint32_t i = 0; i < count; ++i) {
+		const uint32_t triID = triIDs[i];
+		const float* bounds = &builder->m_TriangleBounds[triID * 4];
+		node->m_BoundsMin[0] = core_minf(node->m_BoundsMin[0], bounds[0]);
+		node->m_BoundsMin[1] = core_minf(node->m_BoundsMin[1], bounds[1]);
+		node->m_BoundsMax[0] = core_maxf(node->m_BoundsMax[0], bounds[2]);
+		node->m_BoundsMax[1] = core_maxf(node->m_BoundsMax[1], bounds[3]);
+
+		const float* c = &centroids[triID * 2];
+		centroidMin[0] = core_minf(centroidMin[0], c[0]);
+		centroidMin[1] = core_minf(centroidMin[1], c[1]);
+		centroidMax[0] = core_maxf(centroidMax[0], c[0]);
+		centroidMax[1] = core_maxf(centroidMax[1], c[1]);
+	}
+
+	if (count <= SWR_CONFIG_BVH_LEAF_SIZE) {
+		swrBVHEmitLeaf(builder, node, first, count);
+		node->m_SkipNodeID = nodeID + 1;
+		return;
+	}
+
+	// Partition the triangles around the split position.
+	uint32_t numLeft = 0;
+	if (depth < SWR_CONFIG_BVH_MAX_SPATIAL_DEPTH) {
+		const uint32_t axis = (centroidMax[0] - centroidMin[0]) >= (centroidMax[1] - centroidMin[1]) ? 0 : 1;
+		const float split = (centroidMin[axis] + centroidMax[axis]) * 0.5f;
+
+		uint32_t right = count;
+		while (numLeft < right) {
+			if (centroids[triIDs[numLeft] * 2 + axis] < split) {
+				++numLeft;
+			} else {
+				--right;
+				const uint32_t tmp = triIDs[numLeft];
+				triIDs[numLeft] = triIDs[right];
+				triIDs[right] = tmp;
+			}
+		}
+	}
+
+	// All centroids on the same side (e.g. they coincide) or too deep. Split the list in half.
+	if (numLeft == 0 || numLeft == count) {
+		numLeft = count / 2;
+	}
+
+	node->m_FirstTriangle = 0;
+	node->m_NumTriangles = 0;
+	node->m_MinVertex = 0;
+	node->m_MaxVertex = 0;
+	node->_padding = 0;
+
+	swrBVHBuildNode(builder, first, numLeft, depth + 1);
+	swrBVHBuildNode(builder, first + numLeft, count - numLeft, depth + 1);
+
+	// NOTE: bvh->m_Nodes doesn't move during the build so 'node' is still valid.
+	node->m_SkipNodeID = bvh->m_NumNodes;
+}
+
+// Copies the leaf's triangles to the BVH's index buffer. Vertices are renumbered in
+// order of first use so the vertices of each leaf form a compact range.
+static void swrBVHEmitLeaf(swr_bvh_builder* builder, swr_bvh_node* node, uint32_t first, uint32_t count)
+{
+	swr_bvh* bvh = builder->m_BVH;
+	uint32_t* vertexMap = builder->m_VertexMap;
+
+	uint32_t minVertex = UINT32_MAX;
+	uint32_t maxVertex = 0;
+	uint16_t* dstIndices = &bvh->m_Indices[bvh->m_NumTriangles * 3];
+	for (uint32_t i = 0; i < count; ++i) {
+		const uint16_t* srcTri = &builder->m_SrcIndices[builder->m_TriangleIDs[first + i] * 3];
+		for (uint32_t j = 0; j < 3; ++j) {
+			const uint16_t srcVertexID = srcTri[j];
+			uint32_t vertexID = vertexMap[srcVertexID];
+			if (vertexID == UINT32_MAX) {
+				vertexID = bvh->m_NumVertices++;
+				vertexMap[srcVertexID] = vertexID;
+				bvh->m_VertexIDs[vertexID] = srcVertexID;
+			}
+
+			dstIndices[i * 3 + j] = (uint16_t)vertexID;
+			minVertex = core_minu32(minVertex, vertexID);
+			maxVertex = core_maxu32(maxVertex, vertexID);
+		}
+	}
+
+	node->m_FirstTriangle = bvh->m_NumTriangles;
+	node->m_NumTriangles = (uint16_t)count;
+	node->m_MinVertex = (uint16_t)minVertex;
+	node->m_MaxVertex = (uint16_t)maxVertex;
+	node->_padding = 0;
+
+	bvh->m_NumTriangles += count;
+}
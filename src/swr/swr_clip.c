@@ -0,0 +1,59 @@
+#include "swr.h"
+#include "swr_p.h"
+
+static uint32_t swrClipPolygonAgainstPlane(const swr_clip_vertex* src, uint32_t numVertices, swr_clip_vertex* dst, uint32_t axis, float value, bool keepBelow);
+
+// Sutherland-Hodgman clipping of a convex polygon against an axis aligned rectangle.
+// 'vertices' must have room for SWR_CLIP_MAX_VERTICES entries. Returns the number of
+// vertices of the clipped polygon (0 if it's completely outside the rectangle).
+uint32_t swrClipPolygon(swr_clip_vertex* vertices, uint32_t numVertices, float minX, float minY, float maxX, float maxY)
+{
+	swr_clip_vertex temp[SWR_CLIP_MAX_VERTICES];
+
+	numVertices = swrClipPolygonAgainstPlane(vertices, numVertices, temp, 0, minX, false);
+	numVertices = swrClipPolygonAgainstPlane(temp, numVertices, vertices, 0, maxX, true);
+	numVertices = swrClipPolygonAgainstPlane(vertices, numVertices, temp, 1, minY, false);
+	numVertices = swrClipPolygonAgainstPlane(temp, numVertices, vertices, 1, maxY, true);
+
+	return numVertices;
+}
+
+static uint32_t swrClipPolygonAgainstPlane(const swr_clip_vertex* src, uint32_t numVertices, swr_clip_vertex* dst, uint32_t axis, float value, bool keepBelow)
+{
+	if (numVertices < 3) {
+		return 0;
+	}
+
+	uint32_t numOut = 0;
+	const swr_clip_vertex* prev = &src[numVertices - 1];
+	bool prevInside = keepBelow ? prev->m_Pos[axis] <= value : prev->m_Pos[axis] >= value;
+	for (uint32_t i = 0; i < numVertices; ++i) {
+		const swr_clip_vertex* cur = &src[i];
+		const bool curInside = keepBelow ? cur->m_Pos[axis] <= value : cur->m_Pos[axis] >= value;
+
+		if (curInside != prevInside) {
+			// Always interpolate from the inside vertex towards the outside one so that
+			// an edge shared by two triangles is split at exactly the same point.
+			const swr_clip_vertex* in = curInside ? cur : prev;
+			const swr_clip_vertex* out = curInside ? prev : cur;
+			const float t = (value - in->m_Pos[axis]) / (out->m_Pos[axis] - in->m_Pos[axis]);
+
+			swr_clip_vertex* v = &dst[numOut++];
+			v->m_Pos[0] = in->m_Pos[0] + (out->m_Pos[0] - in->m_Pos[0]) * t;
+			v->m_Pos[1] = in->m_Pos[1] + (out->m_Pos[1] - in->m_Pos[1]) * t;
+			v->m_Pos[axis] = value;
+			v->m_Bary[0] = in->m_Bary[0] + (out->m_Bary[0] - in->m_Bary[0]) * t;
+			v->m_Bary[1] = in->m_Bary[1] + (out->m_Bary[1] - in->m_Bary[1]) * t;
+			v->m_Src = -1;
+		}
+
+		if (curInside) {
+			dst[numOut++] = *cur;
+		}
+
+		prev = cur;
+		prevInside = curInside;
+	}
+
+	return numOut;
+}
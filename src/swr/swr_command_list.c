@@ -0,0 +1,616 @@
+#include "swr.h"
+#include "swr_p.h"
+#include "../core/allocator.h"
+#include "../core/memory.h"
+#include "../core/macros.h"
+#include <stdbool.h>
+
+typedef enum swr_command_type
+{
+	SWR_COMMAND_TYPE_CLEAR = 0,
+	SWR_COMMAND_TYPE_SET_WORLD_TO_SCREEN_TRANSFORM,
+	SWR_COMMAND_TYPE_SET_BLEND_MODE,
+	SWR_COMMAND_TYPE_SET_LINE_STYLE,
+	SWR_COMMAND_TYPE_BIND_TEXTURE,
+	SWR_COMMAND_TYPE_UNBIND_TEXTURE,
+	SWR_COMMAND_TYPE_BIND_PIXEL_SHADER,
+	SWR_COMMAND_TYPE_UNBIND_PIXEL_SHADER,
+	SWR_COMMAND_TYPE_BIND_VERTEX_BUFFER,
+	SWR_COMMAND_TYPE_UNBIND_VERTEX_BUFFER,
+	SWR_COMMAND_TYPE_BIND_INDEX_BUFFER,
+	SWR_COMMAND_TYPE_UNBIND_INDEX_BUFFER,
+	SWR_COMMAND_TYPE_BIND_CLUSTER_BUFFER,
+	SWR_COMMAND_TYPE_UNBIND_CLUSTER_BUFFER,
+	SWR_COMMAND_TYPE_DRAW_PRIMITIVES,
+	SWR_COMMAND_TYPE_DRAW_BVH
+} swr_command_type;
+
+// State tracked by the command list. Bits 0 to 7 match the vertex attributes.
+#define SWR_COMMAND_STATE_VERTEX_BUFFER(va) (1u << (va))
+#define SWR_COMMAND_STATE_LINE_STYLE        (1u << 25)
+#define SWR_COMMAND_STATE_PIXEL_SHADER      (1u << 26)
+#define SWR_COMMAND_STATE_TEXTURE           (1u << 27)
+#define SWR_COMMAND_STATE_BLEND_MODE        (1u << 28)
+#define SWR_COMMAND_STATE_CLUSTER_BUFFER    (1u << 29)
+#define SWR_COMMAND_STATE_INDEX_BUFFER      (1u << 30)
+#define SWR_COMMAND_STATE_TRANSFORM         (1u << 31)
+
+typedef struct swr_command
+{
+	uint32_t m_Type;
+	uint32_t _padding;
+	union
+	{
+		uint32_t m_ClearColor;
+		swr_matrix2d m_Transform;
+		uint32_t m_BlendMode;
+
+		struct
+		{
+			float m_Width;
+			uint32_t m_AntiAliased;
+		} m_LineStyle;
+
+		struct
+		{
+			const swr_texture* m_Texture;
+			uint32_t m_Filter;
+		} m_BindTexture;
+
+		struct
+		{
+			swr_pixel_shader_func m_Func;
+			void* m_UserData;
+		} m_BindPixelShader;
+
+		struct
+		{
+			uint32_t m_Attrib;
+			swr_vertex_buffer m_Buffer;
+		} m_VertexBuffer;
+
+		swr_index_buffer m_IndexBuffer;
+		swr_cluster_buffer m_ClusterBuffer;
+
+		struct
+		{
+			uint32_t m_PrimType;
+			uint32_t m_StartIndex;
+			uint32_t m_EndIndex;
+			uint32_t m_NumIndices;
+			uint32_t m_BaseIndex;
+			uint32_t m_BaseVertex;
+		} m_DrawPrimitives;
+
+		struct
+		{
+			const swr_bvh* m_BVH;
+			uint32_t m_BaseVertex;
+		} m_DrawBVH;
+	} m_Data;
+} swr_command;
+
+typedef struct swr_command_list_state
+{
+	swr_matrix2d m_WorldToScreenTransform;
+	uint32_t m_BlendMode;
+	float m_LineWidth;
+	uint32_t m_LineAntiAliased;
+	const swr_texture* m_Texture; // NULL if no texture is bound
+	uint32_t m_TextureFilter;
+	swr_pixel_shader_func m_PixelShader; // NULL if no pixel shader is bound
+	void* m_PixelShaderUserData;
+	swr_vertex_buffer m_VertexBuffers[SWR_VERTEX_ATTRIB_COUNT];
+	swr_index_buffer m_IndexBuffer;
+	swr_cluster_buffer m_ClusterBuffer;
+	uint32_t m_BoundBuffers; // Same layout as swr_context::m_BoundBuffers
+	uint32_t m_ValidMask;    // SWR_COMMAND_STATE_xxx bits set on this state
+} swr_command_list_state;
+
+// State commands are not recorded immediately. The command list keeps track of
+// the current state and, right before each draw, emits only the state that is
+// different from what the previous draw used. This way redundant or overwritten
+// state changes never make it into the command stream. Clears drop everything
+// recorded before them since all previous draws are going to be overwritten anyway.
+typedef struct swr_command_list
+{
+	core_allocator_i* m_Allocator;
+	swr_command* m_Commands;
+	uint32_t m_NumCommands;
+	uint32_t m_Capacity;
+	swr_command_list_state m_State;        // State as set by the cmdXXX functions
+	swr_command_list_state m_EmittedState; // State as seen by the last recorded draw
+} swr_command_list;
+
+static swr_command* swrCmdListAlloc(swr_command_list* cmdList, swr_command_type type);
+static void swrCmdListEmitState(swr_command_list* cmdList, const swr_command_list_state* state, swr_command_list_state* emittedState);
+static bool swrVertexBufferEqual(const swr_vertex_buffer* a, const swr_vertex_buffer* b);
+
+swr_command_list* swrCreateCommandList(core_allocator_i* allocator)
+{
+	swr_command_list* cmdList = (swr_command_list*)CORE_ALLOC(allocator, sizeof(swr_command_list));
+	if (!cmdList) {
+		return NULL;
+	}
+
+	core_memSet(cmdList, 0, sizeof(swr_command_list));
+	cmdList->m_Allocator = allocator;
+
+	return cmdList;
+}
+
+void swrDestroyCommandList(core_allocator_i* allocator, swr_command_list* cmdList)
+{
+	CORE_FREE(allocator, cmdList->m_Commands);
+	CORE_FREE(allocator, cmdList);
+}
+
+void swrCmdReset(swr_command_list* cmdList)
+{
+	cmdList->m_NumCommands = 0;
+	core_memSet(&cmdList->m_State, 0, sizeof(swr_command_list_state));
+	core_memSet(&cmdList->m_EmittedState, 0, sizeof(swr_command_list_state));
+}
+
+void swrCmdClear(swr_command_list* cmdList, uint32_t color)
+{
+	// Nothing recorded up until now will be visible after the clear. State
+	// changes are kept in m_State so they will be re-emitted by the next draw.
+	cmdList->m_NumCommands = 0;
+	cmdList->m_EmittedState.m_ValidMask = 0;
+
+	swr_command* cmd = swrCmdListAlloc(cmdList, SWR_COMMAND_TYPE_CLEAR);
+	if (cmd) {
+		cmd->m_Data.m_ClearColor = color;
+	}
+}
+
+void swrCmdSetWorldToScreenTransform(swr_command_list* cmdList, const swr_matrix2d* mtx)
+{
+	core_memCopy(&cmdList->m_State.m_WorldToScreenTransform, mtx, sizeof(swr_matrix2d));
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_TRANSFORM;
+}
+
+void swrCmdSetBlendMode(swr_command_list* cmdList, swr_blend_mode mode)
+{
+	cmdList->m_State.m_BlendMode = (uint32_t)mode;
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_BLEND_MODE;
+}
+
+void swrCmdSetLineStyle(swr_command_list* cmdList, float width, bool antiAliased)
+{
+	cmdList->m_State.m_LineWidth = width;
+	cmdList->m_State.m_LineAntiAliased = antiAliased ? 1 : 0;
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_LINE_STYLE;
+}
+
+void swrCmdBindTexture(swr_command_list* cmdList, const swr_texture* tex, swr_texture_filter filter)
+{
+	cmdList->m_State.m_Texture = tex;
+	cmdList->m_State.m_TextureFilter = (uint32_t)filter;
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_TEXTURE;
+}
+
+void swrCmdUnbindTexture(swr_command_list* cmdList)
+{
+	cmdList->m_State.m_Texture = NULL;
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_TEXTURE;
+}
+
+void swrCmdBindPixelShader(swr_command_list* cmdList, swr_pixel_shader_func func, void* userData)
+{
+	cmdList->m_State.m_PixelShader = func;
+	cmdList->m_State.m_PixelShaderUserData = userData;
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_PIXEL_SHADER;
+}
+
+void swrCmdUnbindPixelShader(swr_command_list* cmdList)
+{
+	cmdList->m_State.m_PixelShader = NULL;
+	cmdList->m_State.m_PixelShaderUserData = NULL;
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_PIXEL_SHADER;
+}
+
+void swrCmdBindVertexBuffer(swr_command_list* cmdList, swr_vertex_attrib va, swr_format format, uint32_t stride, uint32_t n, const void* ptr)
+{
+	swr_vertex_buffer* vb = &cmdList->m_State.m_VertexBuffers[va];
+	vb->m_Ptr = ptr;
+	vb->m_Count = n;
+	vb->m_Format = format;
+	vb->m_Stride = stride;
+
+	cmdList->m_State.m_BoundBuffers |= (1u << va);
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_VERTEX_BUFFER(va);
+}
+
+void swrCmdUnbindVertexBuffer(swr_command_list* cmdList, swr_vertex_attrib va)
+{
+	cmdList->m_State.m_BoundBuffers &= ~(1u << va);
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_VERTEX_BUFFER(va);
+}
+
+void swrCmdBindIndexBuffer(swr_command_list* cmdList, swr_format format, uint32_t n, const void* ptr)
+{
+	swr_index_buffer* ib = &cmdList->m_State.m_IndexBuffer;
+	ib->m_Ptr = ptr;
+	ib->m_Count = n;
+	ib->m_Format = format;
+
+	cmdList->m_State.m_BoundBuffers |= (1u << 31);
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_INDEX_BUFFER;
+}
+
+void swrCmdUnbindIndexBuffer(swr_command_list* cmdList)
+{
+	cmdList->m_State.m_BoundBuffers &= ~(1u << 31);
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_INDEX_BUFFER;
+}
+
+void swrCmdBindClusterBuffer(swr_command_list* cmdList, uint32_t n, uint32_t numTrianglesPerCluster, const swr_cluster* ptr)
+{
+	if (numTrianglesPerCluster == 0) {
+		swrCmdUnbindClusterBuffer(cmdList);
+		return;
+	}
+
+	swr_cluster_buffer* cb = &cmdList->m_State.m_ClusterBuffer;
+	cb->m_Ptr = ptr;
+	cb->m_Count = n;
+	cb->m_NumTrianglesPerCluster = numTrianglesPerCluster;
+
+	cmdList->m_State.m_BoundBuffers |= (1u << 30);
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_CLUSTER_BUFFER;
+}
+
+void swrCmdUnbindClusterBuffer(swr_command_list* cmdList)
+{
+	cmdList->m_State.m_BoundBuffers &= ~(1u << 30);
+	cmdList->m_State.m_ValidMask |= SWR_COMMAND_STATE_CLUSTER_BUFFER;
+}
+
+void swrCmdDrawPrimitives(swr_command_list* cmdList, swr_primitive_type primType, uint32_t startIndex, uint32_t endIndex, uint32_t numIndices, uint32_t baseIndex, uint32_t baseVertex)
+{
+	if (numIndices == 0 || startIndex >= endIndex) {
+		return;
+	}
+
+	swrCmdListEmitState(cmdList, &cmdList->m_State, &cmdList->m_EmittedState);
+
+	swr_command* cmd = swrCmdListAlloc(cmdList, SWR_COMMAND_TYPE_DRAW_PRIMITIVES);
+	if (cmd) {
+		cmd->m_Data.m_DrawPrimitives.m_PrimType = primType;
+		cmd->m_Data.m_DrawPrimitives.m_StartIndex = startIndex;
+		cmd->m_Data.m_DrawPrimitives.m_EndIndex = endIndex;
+		cmd->m_Data.m_DrawPrimitives.m_NumIndices = numIndices;
+		cmd->m_Data.m_DrawPrimitives.m_BaseIndex = baseIndex;
+		cmd->m_Data.m_DrawPrimitives.m_BaseVertex = baseVertex;
+	}
+}
+
+void swrCmdDrawBVH(swr_command_list* cmdList, const swr_bvh* bvh, uint32_t baseVertex)
+{
+	swrCmdListEmitState(cmdList, &cmdList->m_State, &cmdList->m_EmittedState);
+
+	swr_command* cmd = swrCmdListAlloc(cmdList, SWR_COMMAND_TYPE_DRAW_BVH);
+	if (cmd) {
+		cmd->m_Data.m_DrawBVH.m_BVH = bvh;
+		cmd->m_Data.m_DrawBVH.m_BaseVertex = baseVertex;
+	}
+}
+
+void swrExecuteCommandList(swr_context* ctx, const swr_command_list* cmdList)
+{
+	const uint32_t numCommands = cmdList->m_NumCommands;
+	const swr_command* cmd = cmdList->m_Commands;
+	for (uint32_t iCmd = 0; iCmd < numCommands; ++iCmd) {
+		switch (cmd->m_Type) {
+		case SWR_COMMAND_TYPE_CLEAR:
+			swr->clear(ctx, cmd->m_Data.m_ClearColor);
+			break;
+		case SWR_COMMAND_TYPE_SET_WORLD_TO_SCREEN_TRANSFORM:
+			swr->setWorldToScreenTransform(ctx, &cmd->m_Data.m_Transform);
+			break;
+		case SWR_COMMAND_TYPE_SET_BLEND_MODE:
+			swr->setBlendMode(ctx, (swr_blend_mode)cmd->m_Data.m_BlendMode);
+			break;
+		case SWR_COMMAND_TYPE_SET_LINE_STYLE:
+			swr->setLineStyle(ctx, cmd->m_Data.m_LineStyle.m_Width, cmd->m_Data.m_LineStyle.m_AntiAliased != 0);
+			break;
+		case SWR_COMMAND_TYPE_BIND_TEXTURE:
+			swr->bindTexture(ctx, cmd->m_Data.m_BindTexture.m_Texture, (swr_texture_filter)cmd->m_Data.m_BindTexture.m_Filter);
+			break;
+		case SWR_COMMAND_TYPE_UNBIND_TEXTURE:
+			swr->unbindTexture(ctx);
+			break;
+		case SWR_COMMAND_TYPE_BIND_PIXEL_SHADER:
+			swr->bindPixelShader(ctx, cmd->m_Data.m_BindPixelShader.m_Func, cmd->m_Data.m_BindPixelShader.m_UserData);
+			break;
+		case SWR_COMMAND_TYPE_UNBIND_PIXEL_SHADER:
+			swr->unbindPixelShader(ctx);
+			break;
+		case SWR_COMMAND_TYPE_BIND_VERTEX_BUFFER: {
+			const swr_vertex_buffer* vb = &cmd->m_Data.m_VertexBuffer.m_Buffer;
+			swr->bindVertexBuffer(ctx, (swr_vertex_attrib)cmd->m_Data.m_VertexBuffer.m_Attrib, (swr_format)vb->m_Format, vb->m_Stride, vb->m_Count, vb->m_Ptr);
+		} break;
+		case SWR_COMMAND_TYPE_UNBIND_VERTEX_BUFFER:
+			swr->unbindVertexBuffer(ctx, (swr_vertex_attrib)cmd->m_Data.m_VertexBuffer.m_Attrib);
+			break;
+		case SWR_COMMAND_TYPE_BIND_INDEX_BUFFER:
+			swr->bindIndexBuffer(ctx, (swr_format)cmd->m_Data.m_IndexBuffer.m_Format, cmd->m_Data.m_IndexBuffer.m_Count, cmd->m_Data.m_IndexBuffer.m_Ptr);
+			break;
+		case SWR_COMMAND_TYPE_UNBIND_INDEX_BUFFER:
+			swr->unbindIndexBuffer(ctx);
+			break;
+		case SWR_COMMAND_TYPE_BIND_CLUSTER_BUFFER:
+			swr->bindClusterBuffer(ctx, cmd->m_Data.m_ClusterBuffer.m_Count, cmd->m_Data.m_ClusterBuffer.m_NumTrianglesPerCluster, cmd->m_Data.m_ClusterBuffer.m_Ptr);
+			break;
+		case SWR_COMMAND_TYPE_UNBIND_CLUSTER_BUFFER:
+			swr->unbindClusterBuffer(ctx);
+			break;
+		case SWR_COMMAND_TYPE_DRAW_PRIMITIVES:
+			swr->drawPrimitives(ctx
+				, (swr_primitive_type)cmd->m_Data.m_DrawPrimitives.m_PrimType
+				, cmd->m_Data.m_DrawPrimitives.m_StartIndex
+				, cmd->m_Data.m_DrawPrimitives.m_EndIndex
+				, cmd->m_Data.m_DrawPrimitives.m_NumIndices
+				, cmd->m_Data.m_DrawPrimitives.m_BaseIndex
+				, cmd->m_Data.m_DrawPrimitives.m_BaseVertex
+			);
+			break;
+		case SWR_COMMAND_TYPE_DRAW_BVH:
+			swr->drawBVH(ctx, cmd->m_Data.m_DrawBVH.m_BVH, cmd->m_Data.m_DrawBVH.m_BaseVertex);
+			break;
+		default:
+			break;
+		}
+
+		++cmd;
+	}
+
+	// Leave the context in the same state as if the commands were executed
+	// immediately. Only state touched by the command list is updated.
+	{
+		const swr_command_list_state* state = &cmdList->m_State;
+		const uint32_t validMask = state->m_ValidMask;
+		if ((validMask & SWR_COMMAND_STATE_TRANSFORM) != 0) {
+			swr->setWorldToScreenTransform(ctx, &state->m_WorldToScreenTransform);
+		}
+
+		if ((validMask & SWR_COMMAND_STATE_BLEND_MODE) != 0) {
+			swr->setBlendMode(ctx, (swr_blend_mode)state->m_BlendMode);
+		}
+
+		if ((validMask & SWR_COMMAND_STATE_LINE_STYLE) != 0) {
+			swr->setLineStyle(ctx, state->m_LineWidth, state->m_LineAntiAliased != 0);
+		}
+
+		if ((validMask & SWR_COMMAND_STATE_TEXTURE) != 0) {
+			if (state->m_Texture != NULL) {
+				swr->bindTexture(ctx, state->m_Texture, (swr_texture_filter)state->m_TextureFilter);
+			} else {
+				swr->unbindTexture(ctx);
+			}
+		}
+
+		if ((validMask & SWR_COMMAND_STATE_PIXEL_SHADER) != 0) {
+			if (state->m_PixelShader != NULL) {
+				swr->bindPixelShader(ctx, state->m_PixelShader, state->m_PixelShaderUserData);
+			} else {
+				swr->unbindPixelShader(ctx);
+			}
+		}
+
+		for (uint32_t va = 0; va < CORE_COUNTOF(state->m_VertexBuffers); ++va) {
+			if ((validMask & SWR_COMMAND_STATE_VERTEX_BUFFER(va)) != 0) {
+				if ((state->m_BoundBuffers & (1u << va)) != 0) {
+					const swr_vertex_buffer* vb = &state->m_VertexBuffers[va];
+					swr->bindVertexBuffer(ctx, (swr_vertex_attrib)va, (swr_format)vb->m_Format, vb->m_Stride, vb->m_Count, vb->m_Ptr);
+				} else {
+					swr->unbindVertexBuffer(ctx, (swr_vertex_attrib)va);
+				}
+			}
+		}
+
+		if ((validMask & SWR_COMMAND_STATE_INDEX_BUFFER) != 0) {
+			if ((state->m_BoundBuffers & (1u << 31)) != 0) {
+				swr->bindIndexBuffer(ctx, (swr_format)state->m_IndexBuffer.m_Format, state->m_IndexBuffer.m_Count, state->m_IndexBuffer.m_Ptr);
+			} else {
+				swr->unbindIndexBuffer(ctx);
+			}
+		}
+
+		if ((validMask & SWR_COMMAND_STATE_CLUSTER_BUFFER) != 0) {
+			if ((state->m_BoundBuffers & (1u << 30)) != 0) {
+				const swr_cluster_buffer* cb = &state->m_ClusterBuffer;
+				swr->bindClusterBuffer(ctx, cb->m_Count, cb->m_NumTrianglesPerCluster, cb->m_Ptr);
+			} else {
+				swr->unbindClusterBuffer(ctx);
+			}
+		}
+	}
+
+	// All draws have been submitted. In binned mode this rasterizes the whole
+	// command list in one go using all worker threads.
+	swr->flush(ctx);
+}
+
+static swr_command* swrCmdListAlloc(swr_command_list* cmdList, swr_command_type type)
+{
+	if (cmdList->m_NumCommands == cmdList->m_Capacity) {
+		const uint32_t newCapacity = cmdList->m_Capacity != 0
+			? cmdList->m_Capacity * 2
+			: 64
+			;
+
+		swr_command* newCommands = (swr_command*)CORE_REALLOC(cmdList->m_Allocator, cmdList->m_Commands, sizeof(swr_command) * newCapacity);
+		if (!newCommands) {
+			return NULL;
+		}
+
+		cmdList->m_Commands = newCommands;
+		cmdList->m_Capacity = newCapacity;
+	}
+
+	swr_command* cmd = &cmdList->m_Commands[cmdList->m_NumCommands++];
+	cmd->m_Type = type;
+
+	return cmd;
+}
+
+static void swrCmdListEmitState(swr_command_list* cmdList, const swr_command_list_state* state, swr_command_list_state* emittedState)
+{
+	const uint32_t validMask = state->m_ValidMask;
+
+	if ((validMask & SWR_COMMAND_STATE_TRANSFORM) != 0) {
+		const bool isEmitted = (emittedState->m_ValidMask & SWR_COMMAND_STATE_TRANSFORM) != 0
+			&& core_memCmp(&emittedState->m_WorldToScreenTransform, &state->m_WorldToScreenTransform, sizeof(swr_matrix2d)) == 0
+			;
+		if (!isEmitted) {
+			swr_command* cmd = swrCmdListAlloc(cmdList, SWR_COMMAND_TYPE_SET_WORLD_TO_SCREEN_TRANSFORM);
+			if (cmd) {
+				core_memCopy(&cmd->m_Data.m_Transform, &state->m_WorldToScreenTransform, sizeof(swr_matrix2d));
+			}
+
+			core_memCopy(&emittedState->m_WorldToScreenTransform, &state->m_WorldToScreenTransform, sizeof(swr_matrix2d));
+		}
+	}
+
+	if ((validMask & SWR_COMMAND_STATE_BLEND_MODE) != 0) {
+		const bool isEmitted = (emittedState->m_ValidMask & SWR_COMMAND_STATE_BLEND_MODE) != 0
+			&& emittedState->m_BlendMode == state->m_BlendMode
+			;
+		if (!isEmitted) {
+			swr_command* cmd = swrCmdListAlloc(cmdList, SWR_COMMAND_TYPE_SET_BLEND_MODE);
+			if (cmd) {
+				cmd->m_Data.m_BlendMode = state->m_BlendMode;
+			}
+
+			emittedState->m_BlendMode = state->m_BlendMode;
+		}
+	}
+
+	if ((validMask & SWR_COMMAND_STATE_LINE_STYLE) != 0) {
+		const bool isEmitted = (emittedState->m_ValidMask & SWR_COMMAND_STATE_LINE_STYLE) != 0
+			&& emittedState->m_LineWidth == state->m_LineWidth
+			&& emittedState->m_LineAntiAliased == state->m_LineAntiAliased
+			;
+		if (!isEmitted) {
+			swr_command* cmd = swrCmdListAlloc(cmdList, SWR_COMMAND_TYPE_SET_LINE_STYLE);
+			if (cmd) {
+				cmd->m_Data.m_LineStyle.m_Width = state->m_LineWidth;
+				cmd->m_Data.m_LineStyle.m_AntiAliased = state->m_LineAntiAliased;
+			}
+
+			emittedState->m_LineWidth = state->m_LineWidth;
+			emittedState->m_LineAntiAliased = state->m_LineAntiAliased;
+		}
+	}
+
+	if ((validMask & SWR_COMMAND_STATE_TEXTURE) != 0) {
+		const bool isBound = state->m_Texture != NULL;
+		const bool isEmitted = (emittedState->m_ValidMask & SWR_COMMAND_STATE_TEXTURE) != 0
+			&& emittedState->m_Texture == state->m_Texture
+			&& (!isBound || emittedState->m_TextureFilter == state->m_TextureFilter)
+			;
+		if (!isEmitted) {
+			swr_command* cmd = swrCmdListAlloc(cmdList, isBound ? SWR_COMMAND_TYPE_BIND_TEXTURE : SWR_COMMAND_TYPE_UNBIND_TEXTURE);
+			if (cmd) {
+				cmd->m_Data.m_BindTexture.m_Texture = state->m_Texture;
+				cmd->m_Data.m_BindTexture.m_Filter = state->m_TextureFilter;
+			}
+
+			emittedState->m_Texture = state->m_Texture;
+			emittedState->m_TextureFilter = state->m_TextureFilter;
+		}
+	}
+
+	if ((validMask & SWR_COMMAND_STATE_PIXEL_SHADER) != 0) {
+		const bool isBound = state->m_PixelShader != NULL;
+		const bool isEmitted = (emittedState->m_ValidMask & SWR_COMMAND_STATE_PIXEL_SHADER) != 0
+			&& emittedState->m_PixelShader == state->m_PixelShader
+			&& emittedState->m_PixelShaderUserData == state->m_PixelShaderUserData
+			;
+		if (!isEmitted) {
+			swr_command* cmd = swrCmdListAlloc(cmdList, isBound ? SWR_COMMAND_TYPE_BIND_PIXEL_SHADER : SWR_COMMAND_TYPE_UNBIND_PIXEL_SHADER);
+			if (cmd) {
+				cmd->m_Data.m_BindPixelShader.m_Func = state->m_PixelShader;
+				cmd->m_Data.m_BindPixelShader.m_UserData = state->m_PixelShaderUserData;
+			}
+
+			emittedState->m_PixelShader = state->m_PixelShader;
+			emittedState->m_PixelShaderUserData = state->m_PixelShaderUserData;
+		}
+	}
+
+	for (uint32_t va = 0; va < CORE_COUNTOF(state->m_VertexBuffers); ++va) {
+		const uint32_t stateBit = SWR_COMMAND_STATE_VERTEX_BUFFER(va);
+		if ((validMask & stateBit) == 0) {
+			continue;
+		}
+
+		const bool isBound = (state->m_BoundBuffers & (1u << va)) != 0;
+		const bool isEmitted = (emittedState->m_ValidMask & stateBit) != 0
+			&& ((emittedState->m_BoundBuffers & (1u << va)) != 0) == isBound
+			&& (!isBound || swrVertexBufferEqual(&emittedState->m_VertexBuffers[va], &state->m_VertexBuffers[va]))
+			;
+		if (isEmitted) {
+			continue;
+		}
+
+		swr_command* cmd = swrCmdListAlloc(cmdList, isBound ? SWR_COMMAND_TYPE_BIND_VERTEX_BUFFER : SWR_COMMAND_TYPE_UNBIND_VERTEX_BUFFER);
+		if (cmd) {
+			cmd->m_Data.m_VertexBuffer.m_Attrib = va;
+			core_memCopy(&cmd->m_Data.m_VertexBuffer.m_Buffer, &state->m_VertexBuffers[va], sizeof(swr_vertex_buffer));
+		}
+
+		core_memCopy(&emittedState->m_VertexBuffers[va], &state->m_VertexBuffers[va], sizeof(swr_vertex_buffer));
+		emittedState->m_BoundBuffers = (emittedState->m_BoundBuffers & ~(1u << va)) | (state->m_BoundBuffers & (1u << va));
+	}
+
+	if ((validMask & SWR_COMMAND_STATE_INDEX_BUFFER) != 0) {
+		const bool isBound = (state->m_BoundBuffers & (1u << 31)) != 0;
+		const bool isEmitted = (emittedState->m_ValidMask & SWR_COMMAND_STATE_INDEX_BUFFER) != 0
+			&& ((emittedState->m_BoundBuffers & (1u << 31)) != 0) == isBound
+			&& (!isBound || core_memCmp(&emittedState->m_IndexBuffer, &state->m_IndexBuffer, sizeof(swr_index_buffer)) == 0)
+			;
+		if (!isEmitted) {
+			swr_command* cmd = swrCmdListAlloc(cmdList, isBound ? SWR_COMMAND_TYPE_BIND_INDEX_BUFFER : SWR_COMMAND_TYPE_UNBIND_INDEX_BUFFER);
+			if (cmd) {
+				cmd->m_Data.m_IndexBuffer = state->m_IndexBuffer;
+			}
+
+			emittedState->m_IndexBuffer = state->m_IndexBuffer;
+			emittedState->m_BoundBuffers = (emittedState->m_BoundBuffers & ~(1u << 31)) | (state->m_BoundBuffers & (1u << 31));
+		}
+	}
+
+	if ((validMask & SWR_COMMAND_STATE_CLUSTER_BUFFER) != 0) {
+		const swr_cluster_buffer* cb = &state->m_ClusterBuffer;
+		const swr_cluster_buffer* emittedCB = &emittedState->m_ClusterBuffer;
+		const bool isBound = (state->m_BoundBuffers & (1u << 30)) != 0;
+		const bool isEmitted = (emittedState->m_ValidMask & SWR_COMMAND_STATE_CLUSTER_BUFFER) != 0
+			&& ((emittedState->m_BoundBuffers & (1u << 30)) != 0) == isBound
+			&& (!isBound || (emittedCB->m_Ptr == cb->m_Ptr && emittedCB->m_Count == cb->m_Count && emittedCB->m_NumTrianglesPerCluster == cb->m_NumTrianglesPerCluster))
+			;
+		if (!isEmitted) {
+			swr_command* cmd = swrCmdListAlloc(cmdList, isBound ? SWR_COMMAND_TYPE_BIND_CLUSTER_BUFFER : SWR_COMMAND_TYPE_UNBIND_CLUSTER_BUFFER);
+			if (cmd) {
+				cmd->m_Data.m_ClusterBuffer = *cb;
+			}
+
+			emittedState->m_ClusterBuffer = *cb;
+			emittedState->m_BoundBuffers = (emittedState->m_BoundBuffers & ~(1u << 30)) | (state->m_BoundBuffers & (1u << 30));
+		}
+	}
+
+	emittedState->m_ValidMask |= validMask;
+}
+
+static bool swrVertexBufferEqual(const swr_vertex_buffer* a, const swr_vertex_buffer* b)
+{
+	return a->m_Ptr == b->m_Ptr
+		&& a->m_Count == b->m_Count
+		&& a->m_Format == b->m_Format
+		&& a->m_Stride == b->m_Stride
+		;
+}
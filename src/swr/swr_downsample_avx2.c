@@ -0,0 +1,42 @@
+#include "swr.h"
+#include "swr_p.h"
+
+#define SWR_VEC_MATH_AVX2
+#include "swr_vec_math.h"
+
+extern void swrDownsample2x2Ref(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst);
+
+// Same as swrDownsample2x2Ref, 8 pixels at a time. Rows are summed first and then 
+// adjacent pixels are paired up by splitting them into even and odd lanes.
+void swrDownsample2x2AVX2(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst)
+{
+	const vec8i v_bias = vec8i_fromInt(0x00020002);
+	const vec8i v_channelMask = vec8i_fromInt(0x00FF00FF);
+
+	const uint32_t numIter = numPixels >> 3;
+	for (uint32_t i = 0; i < numIter; ++i) {
+		const int32_t* src0 = (const int32_t*)&row0[i << 4];
+		const int32_t* src1 = (const int32_t*)&row1[i << 4];
+		const vec8i v_row0a = vec8i_fromInt8vu(&src0[0]);
+		const vec8i v_row0b = vec8i_fromInt8vu(&src0[8]);
+		const vec8i v_row1a = vec8i_fromInt8vu(&src1[0]);
+		const vec8i v_row1b = vec8i_fromInt8vu(&src1[8]);
+
+		const vec8i v_evenA = vec8i_add(vec8i_and(v_row0a, v_channelMask), vec8i_and(v_row1a, v_channelMask));
+		const vec8i v_evenB = vec8i_add(vec8i_and(v_row0b, v_channelMask), vec8i_and(v_row1b, v_channelMask));
+		const vec8i v_oddA = vec8i_add(vec8i_and(vec8i_slr(v_row0a, 8), v_channelMask), vec8i_and(vec8i_slr(v_row1a, 8), v_channelMask));
+		const vec8i v_oddB = vec8i_add(vec8i_and(vec8i_slr(v_row0b, 8), v_channelMask), vec8i_and(vec8i_slr(v_row1b, 8), v_channelMask));
+
+		const vec8i v_sumEven = vec8i_add(vec8i_add(vec8i_evenLanes(v_evenA, v_evenB), vec8i_oddLanes(v_evenA, v_evenB)), v_bias);
+		const vec8i v_sumOdd = vec8i_add(vec8i_add(vec8i_evenLanes(v_oddA, v_oddB), vec8i_oddLanes(v_oddA, v_oddB)), v_bias);
+
+		const vec8i v_even = vec8i_and(vec8i_slr(v_sumEven, 2), v_channelMask);
+		const vec8i v_odd = vec8i_and(vec8i_slr(v_sumOdd, 2), v_channelMask);
+		vec8i_toInt8vu(vec8i_or(v_even, vec8i_sal(v_odd, 8)), (int32_t*)&dst[i << 3]);
+	}
+
+	const uint32_t numDone = numIter << 3;
+	if (numDone != numPixels) {
+		swrDownsample2x2Ref(numPixels - numDone, &row0[numDone * 2], &row1[numDone * 2], &dst[numDone]);
+	}
+}
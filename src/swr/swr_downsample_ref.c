@@ -0,0 +1,29 @@
+#include "swr.h"
+#include "swr_p.h"
+
+// 2x2 box filter. Channels are summed 2 at a time, in the 16-bit halves of a 32-bit 
+// integer (see swrResolveSamplesRef).
+void swrDownsample2x2Ref(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst)
+{
+	for (uint32_t i = 0; i < numPixels; ++i) {
+		const uint32_t c00 = row0[i * 2 + 0];
+		const uint32_t c10 = row0[i * 2 + 1];
+		const uint32_t c01 = row1[i * 2 + 0];
+		const uint32_t c11 = row1[i * 2 + 1];
+
+		const uint32_t sumEven = 0x00020002u
+			+ (c00 & 0x00FF00FFu)
+			+ (c10 & 0x00FF00FFu)
+			+ (c01 & 0x00FF00FFu)
+			+ (c11 & 0x00FF00FFu)
+			;
+		const uint32_t sumOdd = 0x00020002u
+			+ ((c00 >> 8) & 0x00FF00FFu)
+			+ ((c10 >> 8) & 0x00FF00FFu)
+			+ ((c01 >> 8) & 0x00FF00FFu)
+			+ ((c11 >> 8) & 0x00FF00FFu)
+			;
+
+		dst[i] = ((sumEven >> 2) & 0x00FF00FFu) | (((sumOdd >> 2) & 0x00FF00FFu) << 8);
+	}
+}
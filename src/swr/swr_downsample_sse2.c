@@ -0,0 +1,42 @@
+#include "swr.h"
+#include "swr_p.h"
+
+#define SWR_VEC_MATH_SSE2
+#include "swr_vec_math.h"
+
+extern void swrDownsample2x2Ref(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst);
+
+// Same as swrDownsample2x2Ref, 4 pixels at a time. Rows are summed first and then 
+// adjacent pixels are paired up by splitting them into even and odd lanes.
+void swrDownsample2x2SSE2(uint32_t numPixels, const uint32_t* row0, const uint32_t* row1, uint32_t* dst)
+{
+	const vec4i v_bias = vec4i_fromInt(0x00020002);
+	const vec4i v_channelMask = vec4i_fromInt(0x00FF00FF);
+
+	const uint32_t numIter = numPixels >> 2;
+	for (uint32_t i = 0; i < numIter; ++i) {
+		const int32_t* src0 = (const int32_t*)&row0[i << 3];
+		const int32_t* src1 = (const int32_t*)&row1[i << 3];
+		const vec4i v_row0a = vec4i_fromInt4vu(&src0[0]);
+		const vec4i v_row0b = vec4i_fromInt4vu(&src0[4]);
+		const vec4i v_row1a = vec4i_fromInt4vu(&src1[0]);
+		const vec4i v_row1b = vec4i_fromInt4vu(&src1[4]);
+
+		const vec4i v_evenA = vec4i_add(vec4i_and(v_row0a, v_channelMask), vec4i_and(v_row1a, v_channelMask));
+		const vec4i v_evenB = vec4i_add(vec4i_and(v_row0b, v_channelMask), vec4i_and(v_row1b, v_channelMask));
+		const vec4i v_oddA = vec4i_add(vec4i_and(vec4i_slr(v_row0a, 8), v_channelMask), vec4i_and(vec4i_slr(v_row1a, 8), v_channelMask));
+		const vec4i v_oddB = vec4i_add(vec4i_and(vec4i_slr(v_row0b, 8), v_channelMask), vec4i_and(vec4i_slr(v_row1b, 8), v_channelMask));
+
+		const vec4i v_sumEven = vec4i_add(vec4i_add(vec4i_evenLanes(v_evenA, v_evenB), vec4i_oddLanes(v_evenA, v_evenB)), v_bias);
+		const vec4i v_sumOdd = vec4i_add(vec4i_add(vec4i_evenLanes(v_oddA, v_oddB), vec4i_oddLanes(v_oddA, v_oddB)), v_bias);
+
+		const vec4i v_even = vec4i_and(vec4i_slr(v_sumEven, 2), v_channelMask);
+		const vec4i v_odd = vec4i_and(vec4i_slr(v_sumOdd, 2), v_channelMask);
+		vec4i_toInt4vu(vec4i_or(v_even, vec4i_sal(v_odd, 8)), (int32_t*)&dst[i << 2]);
+	}
+
+	const uint32_t numDone = numIter << 2;
+	if (numDone != numPixels) {
+		swrDownsample2x2Ref(numPixels - numDone, &row0[numDone * 2], &row1[numDone * 2], &dst[numDone]);
+	}
+}
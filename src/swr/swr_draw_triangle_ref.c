@@ -9,34 +9,115 @@ typedef struct swr_edge
 	int32_t m_y0;
 	int32_t m_dx;
 	int32_t m_dy;
+	int32_t m_bias;
 } swr_edge;
 
 static inline swr_edge swr_edgeInit(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
 {
+	const int32_t dx = (y1 - y0);
+	const int32_t dy = (x0 - x1);
+
+	// Top-left fill rule. (dx, dy) is the gradient of the edge function and points towards 
+	// the inside of the triangle. Left edges have the inside to their right (dx > 0) and 
+	// top edges are horizontal with the inside below them (dx == 0, dy > 0). Sample points 
+	// exactly on any other edge must not be drawn, so their edge function is biased by -1.
+	const bool isTopLeft = dx > 0 || (dx == 0 && dy > 0);
+
 	return (swr_edge){
 		.m_x0 = x0,
 		.m_y0 = y0,
-		.m_dx = (y1 - y0),
-		.m_dy = (x0 - x1),
+		.m_dx = dx,
+		.m_dy = dy,
+		.m_bias = isTopLeft ? 0 : -1
 	};
 }
 
-static inline int32_t swr_edgeEval(swr_edge edge, int32_t x, int32_t y)
+// Value of the biased edge function at the sample point of pixel (x, y), divided by the 
+// sub-pixel step and rounded down. Since stepping one pixel changes the full precision 
+// value by a multiple of the sub-pixel step, this keeps its sign (pixel coverage) exact 
+// while the value changes by m_dx/m_dy from one pixel to the next.
+static inline int64_t swr_edgeEval(swr_edge edge, int32_t x, int32_t y)
 {
-	return 0
-		+ (x - edge.m_x0) * edge.m_dx 
-		+ (y - edge.m_y0) * edge.m_dy
+	const int64_t e = 0
+		+ (int64_t)((x << SWR_CONFIG_SUBPIXEL_BITS) - edge.m_x0) * edge.m_dx
+		+ (int64_t)((y << SWR_CONFIG_SUBPIXEL_BITS) - edge.m_y0) * edge.m_dy
+		+ edge.m_bias
 		;
+	return e >> SWR_CONFIG_SUBPIXEL_BITS;
+}
+
+// Multisampling. Difference between swr_edgeEval at each of the pixel's sample points 
+// (see swr_context::m_SampleOffsets) and at its integer coordinates. For the same reason 
+// swr_edgeEval's value changes exactly by m_dx/m_dy from one pixel to the next, these 
+// are the same for all pixels. All 0 without multisampling.
+static inline void swr_edgeSampleOffsets(swr_edge edge, const swr_context* ctx, int64_t* offsets)
+{
+	const int64_t e = edge.m_bias - (int64_t)edge.m_x0 * edge.m_dx - (int64_t)edge.m_y0 * edge.m_dy;
+	for (uint32_t i = 0; i < ctx->m_NumSamples; ++i) {
+		const int64_t es = e
+			+ (int64_t)ctx->m_SampleOffsets[i * 2 + 0] * edge.m_dx
+			+ (int64_t)ctx->m_SampleOffsets[i * 2 + 1] * edge.m_dy
+			;
+		offsets[i] = (es >> SWR_CONFIG_SUBPIXEL_BITS) - (e >> SWR_CONFIG_SUBPIXEL_BITS);
+	}
+}
+
+// With multisampling, colors are still evaluated at the pixel's integer coordinates which 
+// might be outside the triangle. Clamp the extrapolated values.
+static inline uint32_t swr_colorChannel(float c)
+{
+	return (uint32_t)core_maxf(core_minf(c, 255.0f), 0.0f);
+}
+
+// Runs the bound pixel shader (see bindPixelShader) on a single pixel. 'varyings' are 
+// the triangle's varyings in the rasterizer's vertex order (see swrTriangleVaryings).
+static inline uint32_t swr_pixelShaderEval(const swr_context* ctx, int32_t x, int32_t y, float l0, float l1, const uint32_t* vertexColors, const float* varyings)
+{
+	swr_pixel_shader_tile tile = {
+		.m_Bary0 = &l0,
+		.m_Bary1 = &l1,
+		.m_VertexColors = vertexColors,
+		.m_X = x,
+		.m_Y = y,
+		.m_Width = 1,
+		.m_Height = 1,
+		.m_CoverageMask = 1
+	};
+
+	float values[SWR_CONFIG_MAX_VARYINGS];
+	if (varyings != NULL) {
+		const swr_varying_layout* layout = &ctx->m_VaryingLayout;
+		const uint32_t n = layout->m_NumVaryings;
+		for (uint32_t i = 0; i < n; ++i) {
+			const float v2 = varyings[n * 2 + i];
+			values[i] = (varyings[i] - v2) * l0 + (varyings[n + i] - v2) * l1 + v2;
+		}
+
+		for (uint32_t va = 0; va < SWR_VERTEX_ATTRIB_COUNT; ++va) {
+			tile.m_Attribs[va] = layout->m_NumComponents[va] != 0
+				? &values[layout->m_FirstVarying[va]]
+				: NULL
+				;
+		}
+	}
+
+	uint32_t rgba;
+	ctx->m_PixelShader(&tile, &rgba, ctx->m_PixelShaderUserData);
+	return rgba;
 }
 
+void swrDrawSmallTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int64_t iarea, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, uint32_t color0, uint32_t color1, uint32_t color2, const float* varyings, bool constColor);
+
 // Reference implementation
 // https://fgiesen.wordpress.com/2013/02/08/triangle-rasterization-in-practice/
-// NOTE: No fill rule used. All pixels lying ON an edge are drawn.
+// All edge function math is done in 64 bits so it can handle any vertex positions. 
+// The SIMD kernels fall back to it for triangles which might overflow their 32-bit math.
 #if 1
 void swrDrawTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2)
 {
 	// Make sure the triangle is CCW. If it's not swap points 1 and 2 to make it CCW.
-	int32_t iarea = (x0 - x2) * (y1 - y0) - (x1 - x0) * (y0 - y2);
+	int64_t iarea = (int64_t)(x0 - x2) * (int64_t)(y1 - y0) - (int64_t)(x1 - x0) * (int64_t)(y0 - y2);
+	bool swapped = false;
 	if (iarea == 0) {
 		// Degenerate triangle with 0 area.
 		return;
@@ -46,16 +127,45 @@ void swrDrawTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, in
 		{ int32_t tmp = y1; y1 = y2; y2 = tmp; }
 		{ uint32_t tmp = color1; color1 = color2; color2 = tmp; }
 		iarea = -iarea;
+		swapped = true;
 	}
 
 	// Compute triangle bounding box
-	const int32_t minX = core_maxi32(core_min3i32(x0, x1, x2), 0);
-	const int32_t minY = core_maxi32(core_min3i32(y0, y1, y2), 0);
-	const int32_t maxX = core_mini32(core_max3i32(x0, x1, x2), (int32_t)(ctx->m_Width - 1));
-	const int32_t maxY = core_mini32(core_max3i32(y0, y1, y2), (int32_t)(ctx->m_Height - 1));
+	const int32_t sampleMinX = swrSubpixelCeil(core_min3i32(x0, x1, x2) - ctx->m_SampleExtent);
+	const int32_t sampleMinY = swrSubpixelCeil(core_min3i32(y0, y1, y2) - ctx->m_SampleExtent);
+	const int32_t sampleMaxX = swrSubpixelFloor(core_max3i32(x0, x1, x2) + ctx->m_SampleExtent);
+	const int32_t sampleMaxY = swrSubpixelFloor(core_max3i32(y0, y1, y2) + ctx->m_SampleExtent);
+	int32_t minX = core_maxi32(sampleMinX, 0);
+	int32_t minY = core_maxi32(sampleMinY, 0);
+	int32_t maxX = core_mini32(sampleMaxX, (int32_t)(ctx->m_Width - 1));
+	int32_t maxY = core_mini32(sampleMaxY, (int32_t)(ctx->m_Height - 1));
+	if (minX > maxX || minY > maxY) {
+		return;
+	}
+
+	// Clip bounding box to the scissor rect
+	minX = core_maxi32(minX, ctx->m_ScissorRect.m_MinX);
+	minY = core_maxi32(minY, ctx->m_ScissorRect.m_MinY);
+	maxX = core_mini32(maxX, ctx->m_ScissorRect.m_MaxX);
+	maxY = core_mini32(maxY, ctx->m_ScissorRect.m_MaxY);
 	const int32_t bboxWidth = maxX - minX;
 	const int32_t bboxHeight = maxY - minY;
-	if (bboxWidth <= 0 || bboxHeight <= 0) {
+	if (bboxWidth < 0 || bboxHeight < 0) {
+		return;
+	}
+
+	swrTouchTiles(ctx, minX, minY, maxX, maxY);
+
+	float varyingBuffer[SWR_CONFIG_MAX_VARYINGS * 3];
+	const float* varyings = ctx->m_PixelShader != NULL
+		? swrTriangleVaryings(ctx, swapped, varyingBuffer)
+		: NULL
+		;
+
+	// Triangles which cover at most a few sample points in each direction take the 
+	// small triangle path so that all kernels agree on them (see SWR_CONFIG_SMALL_TRIANGLE_LOD).
+	if (sampleMaxX - sampleMinX < SWR_CONFIG_SMALL_TRIANGLE_SIZE && sampleMaxY - sampleMinY < SWR_CONFIG_SMALL_TRIANGLE_SIZE) {
+		swrDrawSmallTriangleRef(ctx, x0, y0, x1, y1, x2, y2, iarea, minX, minY, maxX, maxY, color0, color1, color2, varyings, false);
 		return;
 	}
 
@@ -81,55 +191,84 @@ void swrDrawTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, in
 	const int32_t cg12 = (int32_t)c1g - (int32_t)c2g;
 	const int32_t cb12 = (int32_t)c1b - (int32_t)c2b;
 	const int32_t ca12 = (int32_t)c1a - (int32_t)c2a;
+	const uint32_t vertexColors[3] = { color0, color1, color2 };
 #endif
 
 	// Triangle setup
 	const swr_edge edge0 = swr_edgeInit(x2, y2, x1, y1);
 	const swr_edge edge1 = swr_edgeInit(x0, y0, x2, y2);
 	const swr_edge edge2 = swr_edgeInit(x1, y1, x0, y0);
-	const int32_t w0_pmin = swr_edgeEval(edge0, minX, minY);
-	const int32_t w1_pmin = swr_edgeEval(edge1, minX, minY);
-	const int32_t w2_pmin = swr_edgeEval(edge2, minX, minY);
-
-	// Barycentric coordinate normalization
+	const int64_t w0_pmin = swr_edgeEval(edge0, minX, minY);
+	const int64_t w1_pmin = swr_edgeEval(edge1, minX, minY);
+	const int64_t w2_pmin = swr_edgeEval(edge2, minX, minY);
+
+	const uint32_t numSamples = ctx->m_NumSamples;
+	int64_t w0_sample[SWR_CONFIG_MAX_SAMPLES];
+	int64_t w1_sample[SWR_CONFIG_MAX_SAMPLES];
+	int64_t w2_sample[SWR_CONFIG_MAX_SAMPLES];
+	swr_edgeSampleOffsets(edge0, ctx, w0_sample);
+	swr_edgeSampleOffsets(edge1, ctx, w1_sample);
+	swr_edgeSampleOffsets(edge2, ctx, w2_sample);
+
+	// Barycentric coordinate normalization. The edge functions have been divided by 
+	// the sub-pixel step so the area has to be as well.
 #if !SWR_CONFIG_DISABLE_PIXEL_SHADERS
-	const float inv_area = 1.0f / (float)iarea;
+	const float inv_area = (float)(1 << SWR_CONFIG_SUBPIXEL_BITS) / (float)iarea;
 #endif
 
 	// Rasterize
-	int32_t w0_row = w0_pmin;
-	int32_t w1_row = w1_pmin;
-	int32_t w2_row = w2_pmin;
-	uint32_t* fb_row = &ctx->m_FrameBuffer[minX + minY * ctx->m_Width];
+	int64_t w0_row = w0_pmin;
+	int64_t w1_row = w1_pmin;
+	int64_t w2_row = w2_pmin;
+	uint32_t* fb_row = &ctx->m_SampleBuffer[minX + minY * ctx->m_Width];
+	const uint32_t sampleStride = ctx->m_SampleStride;
+	const uint32_t blendMode = ctx->m_BlendMode;
 
 	for (int32_t py = 0; py <= bboxHeight; ++py) {
-		int32_t w0 = w0_row;
-		int32_t w1 = w1_row;
-		int32_t w2 = w2_row;
+		int64_t w0 = w0_row;
+		int64_t w1 = w1_row;
+		int64_t w2 = w2_row;
 		for (int32_t px = 0; px <= bboxWidth; ++px) {
-			if (w0 >= 0 && w1 >= 0 && w2 >= 0) {
+			uint32_t sampleMask = 0;
+			for (uint32_t i = 0; i < numSamples; ++i) {
+				if (((w0 + w0_sample[i]) | (w1 + w1_sample[i]) | (w2 + w2_sample[i])) >= 0) {
+					sampleMask |= 1u << i;
+				}
+			}
+
+			if (sampleMask != 0) {
 #if SWR_CONFIG_DISABLE_PIXEL_SHADERS
 				const uint32_t rgba = 0xFFFFFFFF;
 #else
 				const float l0 = (float)w0 * inv_area;
 				const float l1 = (float)w1 * inv_area;
 
-				// l2 = 1.0f - (l0 + l1)
-				//
-				// attr = attr0 * l0 + attr1 * l1 + attr2 * l2 <=>
-				// attr = attr0 * l0 + attr1 * l1 + attr2 * (1.0 - l0 - l1) <=>
-				// attr = (attr0 - attr2) * l0 + (attr1 - attr2) * l1 + attr2 <=>
-				// attr = dattr02 * l0 + dattr12 * l1 + attr2 <=>
-				//
-				// attr = fmad(dattr02, l0, fmad(dattr12, l1, attr2));
-				const uint32_t cr = (uint32_t)(cr02 * l0 + cr12 * l1 + c2r);
-				const uint32_t cg = (uint32_t)(cg02 * l0 + cg12 * l1 + c2g);
-				const uint32_t cb = (uint32_t)(cb02 * l0 + cb12 * l1 + c2b);
-				const uint32_t ca = (uint32_t)(ca02 * l0 + ca12 * l1 + c2a);
-				const uint32_t rgba = SWR_COLOR(cr, cg, cb, ca);
+				uint32_t rgba;
+				if (ctx->m_PixelShader != NULL) {
+					rgba = swr_pixelShaderEval(ctx, minX + px, minY + py, l0, l1, vertexColors, varyings);
+				} else {
+					// l2 = 1.0f - (l0 + l1)
+					//
+					// attr = attr0 * l0 + attr1 * l1 + attr2 * l2 <=>
+					// attr = attr0 * l0 + attr1 * l1 + attr2 * (1.0 - l0 - l1) <=>
+					// attr = (attr0 - attr2) * l0 + (attr1 - attr2) * l1 + attr2 <=>
+					// attr = dattr02 * l0 + dattr12 * l1 + attr2 <=>
+					//
+					// attr = fmad(dattr02, l0, fmad(dattr12, l1, attr2));
+					const uint32_t cr = swr_colorChannel(cr02 * l0 + cr12 * l1 + c2r);
+					const uint32_t cg = swr_colorChannel(cg02 * l0 + cg12 * l1 + c2g);
+					const uint32_t cb = swr_colorChannel(cb02 * l0 + cb12 * l1 + c2b);
+					const uint32_t ca = swr_colorChannel(ca02 * l0 + ca12 * l1 + c2a);
+					rgba = SWR_COLOR(cr, cg, cb, ca);
+				}
 #endif
 
-				fb_row[px] = rgba;
+				uint32_t* fb = &fb_row[px];
+				for (uint32_t i = 0; i < numSamples; ++i, fb += sampleStride) {
+					if ((sampleMask & (1u << i)) != 0) {
+						*fb = blendMode == SWR_BLEND_MODE_OPAQUE ? rgba : swrBlendColor(rgba, *fb, blendMode);
+					}
+				}
 			}
 
 			w0 += edge0.m_dx;
@@ -165,16 +304,27 @@ void swrDrawTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, in
 	}
 
 	// Compute triangle bounding box
-	const int32_t minX = core_maxi32(core_min3i32(x0, x1, x2), 0);
-	const int32_t minY = core_maxi32(core_min3i32(y0, y1, y2), 0);
-	const int32_t maxX = core_mini32(core_max3i32(x0, x1, x2), (int32_t)(ctx->m_Width - 1));
-	const int32_t maxY = core_mini32(core_max3i32(y0, y1, y2), (int32_t)(ctx->m_Height - 1));
+	int32_t minX = core_maxi32(core_min3i32(x0, x1, x2), 0);
+	int32_t minY = core_maxi32(core_min3i32(y0, y1, y2), 0);
+	int32_t maxX = core_mini32(core_max3i32(x0, x1, x2), (int32_t)(ctx->m_Width - 1));
+	int32_t maxY = core_mini32(core_max3i32(y0, y1, y2), (int32_t)(ctx->m_Height - 1));
+	if (maxX - minX <= 0 || maxY - minY <= 0) {
+		return;
+	}
+
+	// Clip bounding box to the scissor rect
+	minX = core_maxi32(minX, ctx->m_ScissorRect.m_MinX);
+	minY = core_maxi32(minY, ctx->m_ScissorRect.m_MinY);
+	maxX = core_mini32(maxX, ctx->m_ScissorRect.m_MaxX);
+	maxY = core_mini32(maxY, ctx->m_ScissorRect.m_MaxY);
 	const int32_t bboxWidth = maxX - minX;
 	const int32_t bboxHeight = maxY - minY;
-	if (bboxWidth <= 0 || bboxHeight <= 0) {
+	if (bboxWidth < 0 || bboxHeight < 0) {
 		return;
 	}
 
+	swrTouchTiles(ctx, minX, minY, maxX, maxY);
+
 	// Prepare interpolated attributes
 #if !SWR_CONFIG_DISABLE_PIXEL_SHADERS
 	const uint32_t c0r = (color0 & SWR_COLOR_RED_Msk) >> SWR_COLOR_RED_Pos;
@@ -217,6 +367,7 @@ void swrDrawTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, in
 	int32_t w1_row = w1_pmin;
 	int32_t w2_row = w2_pmin;
 	uint32_t* fb_row = &ctx->m_FrameBuffer[minX + minY * ctx->m_Width];
+	const uint32_t blendMode = ctx->m_BlendMode;
 
 	for (int32_t py = 0; py <= bboxHeight; ++py) {
 		int32_t pxmin = 0;
@@ -295,7 +446,237 @@ void swrDrawTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, in
 				const uint32_t rgba = SWR_COLOR(cr, cg, cb, ca);
 #endif
 
-				fb_row[px] = rgba;
+				fb_row[px] = blendMode == SWR_BLEND_MODE_OPAQUE ? rgba : swrBlendColor(rgba, fb_row[px], blendMode);
+			}
+
+			w0 += edge0.m_dx;
+			w1 += edge1.m_dx;
+			w2 += edge2.m_dx;
+		}
+
+		w0_row += edge0.m_dy;
+		w1_row += edge1.m_dy;
+		w2_row += edge2.m_dy;
+		fb_row += ctx->m_Width;
+	}
+}
+#endif
+void swrDrawTriangleFlatRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+{
+	// Pixel shaders get the same inputs as for any other triangle.
+	if (ctx->m_PixelShader != NULL) {
+		swrDrawTriangleRef(ctx, x0, y0, x1, y1, x2, y2, color, color, color);
+		return;
+	}
+
+	// Make sure the triangle is CCW. If it's not swap points 1 and 2 to make it CCW.
+	int64_t iarea = (int64_t)(x0 - x2) * (int64_t)(y1 - y0) - (int64_t)(x1 - x0) * (int64_t)(y0 - y2);
+	if (iarea == 0) {
+		// Degenerate triangle with 0 area.
+		return;
+	} else if (iarea < 0) {
+		// Swap (x1, y1) <-> (x2, y2)
+		{ int32_t tmp = x1; x1 = x2; x2 = tmp; }
+		{ int32_t tmp = y1; y1 = y2; y2 = tmp; }
+		iarea = -iarea;
+	}
+
+	// Compute triangle bounding box
+	const int32_t sampleMinX = swrSubpixelCeil(core_min3i32(x0, x1, x2) - ctx->m_SampleExtent);
+	const int32_t sampleMinY = swrSubpixelCeil(core_min3i32(y0, y1, y2) - ctx->m_SampleExtent);
+	const int32_t sampleMaxX = swrSubpixelFloor(core_max3i32(x0, x1, x2) + ctx->m_SampleExtent);
+	const int32_t sampleMaxY = swrSubpixelFloor(core_max3i32(y0, y1, y2) + ctx->m_SampleExtent);
+	int32_t minX = core_maxi32(sampleMinX, 0);
+	int32_t minY = core_maxi32(sampleMinY, 0);
+	int32_t maxX = core_mini32(sampleMaxX, (int32_t)(ctx->m_Width - 1));
+	int32_t maxY = core_mini32(sampleMaxY, (int32_t)(ctx->m_Height - 1));
+	if (minX > maxX || minY > maxY) {
+		return;
+	}
+
+	// Clip bounding box to the scissor rect
+	minX = core_maxi32(minX, ctx->m_ScissorRect.m_MinX);
+	minY = core_maxi32(minY, ctx->m_ScissorRect.m_MinY);
+	maxX = core_mini32(maxX, ctx->m_ScissorRect.m_MaxX);
+	maxY = core_mini32(maxY, ctx->m_ScissorRect.m_MaxY);
+	const int32_t bboxWidth = maxX - minX;
+	const int32_t bboxHeight = maxY - minY;
+	if (bboxWidth < 0 || bboxHeight < 0) {
+		return;
+	}
+
+	swrTouchTiles(ctx, minX, minY, maxX, maxY);
+
+	// Triangles which cover at most a few sample points in each direction take the 
+	// small triangle path so that all kernels agree on them (see SWR_CONFIG_SMALL_TRIANGLE_LOD).
+	if (sampleMaxX - sampleMinX < SWR_CONFIG_SMALL_TRIANGLE_SIZE && sampleMaxY - sampleMinY < SWR_CONFIG_SMALL_TRIANGLE_SIZE) {
+		swrDrawSmallTriangleRef(ctx, x0, y0, x1, y1, x2, y2, iarea, minX, minY, maxX, maxY, color, color, color, NULL, true);
+		return;
+	}
+
+	// Triangle setup
+	const swr_edge edge0 = swr_edgeInit(x2, y2, x1, y1);
+	const swr_edge edge1 = swr_edgeInit(x0, y0, x2, y2);
+	const swr_edge edge2 = swr_edgeInit(x1, y1, x0, y0);
+
+	// Rasterize. No attributes to interpolate so there's no need for barycentric 
+	// coordinate normalization.
+	int64_t w0_row = swr_edgeEval(edge0, minX, minY);
+	int64_t w1_row = swr_edgeEval(edge1, minX, minY);
+	int64_t w2_row = swr_edgeEval(edge2, minX, minY);
+	uint32_t* fb_row = &ctx->m_SampleBuffer[minX + minY * ctx->m_Width];
+	const uint32_t sampleStride = ctx->m_SampleStride;
+	const uint32_t blendMode = ctx->m_BlendMode;
+
+	const uint32_t numSamples = ctx->m_NumSamples;
+	int64_t w0_sample[SWR_CONFIG_MAX_SAMPLES];
+	int64_t w1_sample[SWR_CONFIG_MAX_SAMPLES];
+	int64_t w2_sample[SWR_CONFIG_MAX_SAMPLES];
+	swr_edgeSampleOffsets(edge0, ctx, w0_sample);
+	swr_edgeSampleOffsets(edge1, ctx, w1_sample);
+	swr_edgeSampleOffsets(edge2, ctx, w2_sample);
+
+	for (int32_t py = 0; py <= bboxHeight; ++py) {
+		int64_t w0 = w0_row;
+		int64_t w1 = w1_row;
+		int64_t w2 = w2_row;
+		for (int32_t px = 0; px <= bboxWidth; ++px) {
+			uint32_t* fb = &fb_row[px];
+			for (uint32_t i = 0; i < numSamples; ++i, fb += sampleStride) {
+				if (((w0 + w0_sample[i]) | (w1 + w1_sample[i]) | (w2 + w2_sample[i])) >= 0) {
+					*fb = blendMode == SWR_BLEND_MODE_OPAQUE ? color : swrBlendColor(color, *fb, blendMode);
+				}
+			}
+
+			w0 += edge0.m_dx;
+			w1 += edge1.m_dx;
+			w2 += edge2.m_dx;
+		}
+
+		w0_row += edge0.m_dy;
+		w1_row += edge1.m_dy;
+		w2_row += edge2.m_dy;
+		fb_row += ctx->m_Width;
+	}
+}
+
+// Texture coordinates are interpolated the same way as colors in swrDrawTriangleRef and
+// sampled with swrTextureSample from the triangle's mip level. Small triangles don't get
+// special treatment; the SIMD kernels send them here.
+void swrDrawTriangleTexturedRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv)
+{
+	if (ctx->m_Texture == NULL) {
+		return;
+	}
+
+	const swr_texture_level* tex = swrTextureSelectLevel(ctx->m_Texture, x0, y0, x1, y1, x2, y2, uv);
+	const uint32_t filter = ctx->m_TextureFilter;
+	float s0 = swrTexCoordToTexel(uv[0], tex->m_Width, filter);
+	float t0 = swrTexCoordToTexel(uv[1], tex->m_Height, filter);
+	float s1 = swrTexCoordToTexel(uv[2], tex->m_Width, filter);
+	float t1 = swrTexCoordToTexel(uv[3], tex->m_Height, filter);
+	float s2 = swrTexCoordToTexel(uv[4], tex->m_Width, filter);
+	float t2 = swrTexCoordToTexel(uv[5], tex->m_Height, filter);
+
+	// Make sure the triangle is CCW. If it's not swap points 1 and 2 to make it CCW.
+	int64_t iarea = (int64_t)(x0 - x2) * (int64_t)(y1 - y0) - (int64_t)(x1 - x0) * (int64_t)(y0 - y2);
+	if (iarea == 0) {
+		// Degenerate triangle with 0 area.
+		return;
+	} else if (iarea < 0) {
+		// Swap (x1, y1) <-> (x2, y2)
+		{ int32_t tmp = x1; x1 = x2; x2 = tmp; }
+		{ int32_t tmp = y1; y1 = y2; y2 = tmp; }
+		{ float tmp = s1; s1 = s2; s2 = tmp; }
+		{ float tmp = t1; t1 = t2; t2 = tmp; }
+		iarea = -iarea;
+	}
+
+	// Compute triangle bounding box
+	const int32_t sampleMinX = swrSubpixelCeil(core_min3i32(x0, x1, x2) - ctx->m_SampleExtent);
+	const int32_t sampleMinY = swrSubpixelCeil(core_min3i32(y0, y1, y2) - ctx->m_SampleExtent);
+	const int32_t sampleMaxX = swrSubpixelFloor(core_max3i32(x0, x1, x2) + ctx->m_SampleExtent);
+	const int32_t sampleMaxY = swrSubpixelFloor(core_max3i32(y0, y1, y2) + ctx->m_SampleExtent);
+	int32_t minX = core_maxi32(sampleMinX, 0);
+	int32_t minY = core_maxi32(sampleMinY, 0);
+	int32_t maxX = core_mini32(sampleMaxX, (int32_t)(ctx->m_Width - 1));
+	int32_t maxY = core_mini32(sampleMaxY, (int32_t)(ctx->m_Height - 1));
+	if (minX > maxX || minY > maxY) {
+		return;
+	}
+
+	// Clip bounding box to the scissor rect
+	minX = core_maxi32(minX, ctx->m_ScissorRect.m_MinX);
+	minY = core_maxi32(minY, ctx->m_ScissorRect.m_MinY);
+	maxX = core_mini32(maxX, ctx->m_ScissorRect.m_MaxX);
+	maxY = core_mini32(maxY, ctx->m_ScissorRect.m_MaxY);
+	const int32_t bboxWidth = maxX - minX;
+	const int32_t bboxHeight = maxY - minY;
+	if (bboxWidth < 0 || bboxHeight < 0) {
+		return;
+	}
+
+	swrTouchTiles(ctx, minX, minY, maxX, maxY);
+
+	// Prepare interpolated attributes
+	const float s02 = s0 - s2;
+	const float t02 = t0 - t2;
+	const float s12 = s1 - s2;
+	const float t12 = t1 - t2;
+
+	// Triangle setup
+	const swr_edge edge0 = swr_edgeInit(x2, y2, x1, y1);
+	const swr_edge edge1 = swr_edgeInit(x0, y0, x2, y2);
+	const swr_edge edge2 = swr_edgeInit(x1, y1, x0, y0);
+
+	const uint32_t numSamples = ctx->m_NumSamples;
+	int64_t w0_sample[SWR_CONFIG_MAX_SAMPLES];
+	int64_t w1_sample[SWR_CONFIG_MAX_SAMPLES];
+	int64_t w2_sample[SWR_CONFIG_MAX_SAMPLES];
+	swr_edgeSampleOffsets(edge0, ctx, w0_sample);
+	swr_edgeSampleOffsets(edge1, ctx, w1_sample);
+	swr_edgeSampleOffsets(edge2, ctx, w2_sample);
+
+	// Barycentric coordinate normalization (see swrDrawTriangleRef).
+	const float inv_area = (float)(1 << SWR_CONFIG_SUBPIXEL_BITS) / (float)iarea;
+
+	// Rasterize
+	int64_t w0_row = swr_edgeEval(edge0, minX, minY);
+	int64_t w1_row = swr_edgeEval(edge1, minX, minY);
+	int64_t w2_row = swr_edgeEval(edge2, minX, minY);
+	uint32_t* fb_row = &ctx->m_SampleBuffer[minX + minY * ctx->m_Width];
+	const uint32_t sampleStride = ctx->m_SampleStride;
+	const uint32_t blendMode = ctx->m_BlendMode;
+
+	for (int32_t py = 0; py <= bboxHeight; ++py) {
+		int64_t w0 = w0_row;
+		int64_t w1 = w1_row;
+		int64_t w2 = w2_row;
+		for (int32_t px = 0; px <= bboxWidth; ++px) {
+			uint32_t sampleMask = 0;
+			for (uint32_t i = 0; i < numSamples; ++i) {
+				if (((w0 + w0_sample[i]) | (w1 + w1_sample[i]) | (w2 + w2_sample[i])) >= 0) {
+					sampleMask |= 1u << i;
+				}
+			}
+
+			if (sampleMask != 0) {
+#if SWR_CONFIG_DISABLE_PIXEL_SHADERS
+				const uint32_t rgba = 0xFFFFFFFF;
+#else
+				const float l0 = (float)w0 * inv_area;
+				const float l1 = (float)w1 * inv_area;
+				const float s = s02 * l0 + s12 * l1 + s2;
+				const float t = t02 * l0 + t12 * l1 + t2;
+				const uint32_t rgba = swrTextureSample(tex, s, t, filter);
+#endif
+
+				uint32_t* fb = &fb_row[px];
+				for (uint32_t i = 0; i < numSamples; ++i, fb += sampleStride) {
+					if ((sampleMask & (1u << i)) != 0) {
+						*fb = blendMode == SWR_BLEND_MODE_OPAQUE ? rgba : swrBlendColor(rgba, *fb, blendMode);
+					}
+				}
 			}
 
 			w0 += edge0.m_dx;
@@ -309,4 +690,125 @@ void swrDrawTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, in
 		fb_row += ctx->m_Width;
 	}
 }
-#endif
\ No newline at end of file
+
+// Small footprint rasterizer for triangles whose bounding box spans at most
+// SWR_CONFIG_SMALL_TRIANGLE_SIZE sample points in each direction. Expects a CCW 
+// triangle, its (positive) doubled area and its bounding box, already clipped to the 
+// screen and the scissor rect. Vertex positions are at most a few pixels apart so 
+// the edge functions can't overflow 32 bits. 'varyings' are in the same vertex order as 
+// the positions (see swrTriangleVaryings). 'iarea', 'color1', 'color2' and 'varyings' 
+// are ignored when 'constColor' is true.
+void swrDrawSmallTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int64_t iarea, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, uint32_t color0, uint32_t color1, uint32_t color2, const float* varyings, bool constColor)
+{
+#if SWR_CONFIG_SMALL_TRIANGLE_LOD
+	// Lossy LOD mode. Draw a single pixel, the one nearest to the centroid, without 
+	// testing coverage.
+	const int64_t cx = ((int64_t)x0 + (int64_t)x1 + (int64_t)x2) / 3;
+	const int64_t cy = ((int64_t)y0 + (int64_t)y1 + (int64_t)y2) / 3;
+	const int32_t px = core_maxi32(core_mini32(swrSubpixelFloor((int32_t)cx + (1 << (SWR_CONFIG_SUBPIXEL_BITS - 1))), maxX), minX);
+	const int32_t py = core_maxi32(core_mini32(swrSubpixelFloor((int32_t)cy + (1 << (SWR_CONFIG_SUBPIXEL_BITS - 1))), maxY), minY);
+
+#if SWR_CONFIG_DISABLE_PIXEL_SHADERS
+	const uint32_t rgba = 0xFFFFFFFF;
+#else
+	uint32_t rgba = color0;
+	if (!constColor && ctx->m_PixelShader != NULL) {
+		const uint32_t vertexColors[3] = { color0, color1, color2 };
+		rgba = swr_pixelShaderEval(ctx, px, py, 1.0f / 3.0f, 1.0f / 3.0f, vertexColors, varyings);
+	} else if (!constColor) {
+		// Average of the vertex colors, i.e. the color at the centroid.
+		const uint32_t cr = (((color0 & SWR_COLOR_RED_Msk) >> SWR_COLOR_RED_Pos) + ((color1 & SWR_COLOR_RED_Msk) >> SWR_COLOR_RED_Pos) + ((color2 & SWR_COLOR_RED_Msk) >> SWR_COLOR_RED_Pos)) / 3;
+		const uint32_t cg = (((color0 & SWR_COLOR_GREEN_Msk) >> SWR_COLOR_GREEN_Pos) + ((color1 & SWR_COLOR_GREEN_Msk) >> SWR_COLOR_GREEN_Pos) + ((color2 & SWR_COLOR_GREEN_Msk) >> SWR_COLOR_GREEN_Pos)) / 3;
+		const uint32_t cb = (((color0 & SWR_COLOR_BLUE_Msk) >> SWR_COLOR_BLUE_Pos) + ((color1 & SWR_COLOR_BLUE_Msk) >> SWR_COLOR_BLUE_Pos) + ((color2 & SWR_COLOR_BLUE_Msk) >> SWR_COLOR_BLUE_Pos)) / 3;
+		const uint32_t ca = (((color0 & SWR_COLOR_ALPHA_Msk) >> SWR_COLOR_ALPHA_Pos) + ((color1 & SWR_COLOR_ALPHA_Msk) >> SWR_COLOR_ALPHA_Pos) + ((color2 & SWR_COLOR_ALPHA_Msk) >> SWR_COLOR_ALPHA_Pos)) / 3;
+		rgba = SWR_COLOR(cr, cg, cb, ca);
+	}
+#endif
+
+	uint32_t* fb = &ctx->m_SampleBuffer[px + py * ctx->m_Width];
+	for (uint32_t i = 0; i < ctx->m_NumSamples; ++i, fb += ctx->m_SampleStride) {
+		*fb = ctx->m_BlendMode == SWR_BLEND_MODE_OPAQUE ? rgba : swrBlendColor(rgba, *fb, ctx->m_BlendMode);
+	}
+#else
+	const swr_edge edge0 = swr_edgeInit(x2, y2, x1, y1);
+	const swr_edge edge1 = swr_edgeInit(x0, y0, x2, y2);
+	const swr_edge edge2 = swr_edgeInit(x1, y1, x0, y0);
+	const int32_t w0_pmin = (int32_t)swr_edgeEval(edge0, minX, minY);
+	const int32_t w1_pmin = (int32_t)swr_edgeEval(edge1, minX, minY);
+	const int32_t w2_pmin = (int32_t)swr_edgeEval(edge2, minX, minY);
+
+	const uint32_t numSamples = ctx->m_NumSamples;
+	int64_t w0_sample[SWR_CONFIG_MAX_SAMPLES];
+	int64_t w1_sample[SWR_CONFIG_MAX_SAMPLES];
+	int64_t w2_sample[SWR_CONFIG_MAX_SAMPLES];
+	swr_edgeSampleOffsets(edge0, ctx, w0_sample);
+	swr_edgeSampleOffsets(edge1, ctx, w1_sample);
+	swr_edgeSampleOffsets(edge2, ctx, w2_sample);
+
+#if !SWR_CONFIG_DISABLE_PIXEL_SHADERS
+	// Same interpolation as swrDrawTriangleRef.
+	const int32_t c2r = (int32_t)((color2 & SWR_COLOR_RED_Msk) >> SWR_COLOR_RED_Pos);
+	const int32_t c2g = (int32_t)((color2 & SWR_COLOR_GREEN_Msk) >> SWR_COLOR_GREEN_Pos);
+	const int32_t c2b = (int32_t)((color2 & SWR_COLOR_BLUE_Msk) >> SWR_COLOR_BLUE_Pos);
+	const int32_t c2a = (int32_t)((color2 & SWR_COLOR_ALPHA_Msk) >> SWR_COLOR_ALPHA_Pos);
+	const int32_t cr02 = (int32_t)((color0 & SWR_COLOR_RED_Msk) >> SWR_COLOR_RED_Pos) - c2r;
+	const int32_t cg02 = (int32_t)((color0 & SWR_COLOR_GREEN_Msk) >> SWR_COLOR_GREEN_Pos) - c2g;
+	const int32_t cb02 = (int32_t)((color0 & SWR_COLOR_BLUE_Msk) >> SWR_COLOR_BLUE_Pos) - c2b;
+	const int32_t ca02 = (int32_t)((color0 & SWR_COLOR_ALPHA_Msk) >> SWR_COLOR_ALPHA_Pos) - c2a;
+	const int32_t cr12 = (int32_t)((color1 & SWR_COLOR_RED_Msk) >> SWR_COLOR_RED_Pos) - c2r;
+	const int32_t cg12 = (int32_t)((color1 & SWR_COLOR_GREEN_Msk) >> SWR_COLOR_GREEN_Pos) - c2g;
+	const int32_t cb12 = (int32_t)((color1 & SWR_COLOR_BLUE_Msk) >> SWR_COLOR_BLUE_Pos) - c2b;
+	const int32_t ca12 = (int32_t)((color1 & SWR_COLOR_ALPHA_Msk) >> SWR_COLOR_ALPHA_Pos) - c2a;
+	const float inv_area = constColor ? 0.0f : (float)(1 << SWR_CONFIG_SUBPIXEL_BITS) / (float)iarea;
+	const uint32_t vertexColors[3] = { color0, color1, color2 };
+#endif
+
+	uint32_t* fb_row = &ctx->m_SampleBuffer[minX + minY * ctx->m_Width];
+	for (int32_t py = 0; py <= maxY - minY; ++py) {
+		for (int32_t px = 0; px <= maxX - minX; ++px) {
+			const int32_t w0 = w0_pmin + px * edge0.m_dx + py * edge0.m_dy;
+			const int32_t w1 = w1_pmin + px * edge1.m_dx + py * edge1.m_dy;
+			const int32_t w2 = w2_pmin + px * edge2.m_dx + py * edge2.m_dy;
+
+			uint32_t sampleMask = 0;
+			for (uint32_t i = 0; i < numSamples; ++i) {
+				if (((w0 + w0_sample[i]) | (w1 + w1_sample[i]) | (w2 + w2_sample[i])) >= 0) {
+					sampleMask |= 1u << i;
+				}
+			}
+
+			if (sampleMask == 0) {
+				continue;
+			}
+
+#if SWR_CONFIG_DISABLE_PIXEL_SHADERS
+			uint32_t rgba = 0xFFFFFFFF;
+#else
+			uint32_t rgba = color0;
+			if (!constColor) {
+				const float l0 = (float)w0 * inv_area;
+				const float l1 = (float)w1 * inv_area;
+				if (ctx->m_PixelShader != NULL) {
+					rgba = swr_pixelShaderEval(ctx, minX + px, minY + py, l0, l1, vertexColors, varyings);
+				} else {
+					const uint32_t cr = swr_colorChannel(cr02 * l0 + cr12 * l1 + c2r);
+					const uint32_t cg = swr_colorChannel(cg02 * l0 + cg12 * l1 + c2g);
+					const uint32_t cb = swr_colorChannel(cb02 * l0 + cb12 * l1 + c2b);
+					const uint32_t ca = swr_colorChannel(ca02 * l0 + ca12 * l1 + c2a);
+					rgba = SWR_COLOR(cr, cg, cb, ca);
+				}
+			}
+#endif
+
+			uint32_t* fb = &fb_row[px];
+			for (uint32_t i = 0; i < numSamples; ++i, fb += ctx->m_SampleStride) {
+				if ((sampleMask & (1u << i)) != 0) {
+					*fb = ctx->m_BlendMode == SWR_BLEND_MODE_OPAQUE ? rgba : swrBlendColor(rgba, *fb, ctx->m_BlendMode);
+				}
+			}
+		}
+
+		fb_row += ctx->m_Width;
+	}
+#endif
+}
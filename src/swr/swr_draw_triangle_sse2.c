@@ -11,6 +11,7 @@ typedef struct swr_edge
 	int32_t m_y0;
 	int32_t m_dx;
 	int32_t m_dy;
+	int32_t m_bias;
 } swr_edge;
 
 typedef struct swr_vertex_attrib_data
@@ -22,27 +23,90 @@ typedef struct swr_vertex_attrib_data
 
 typedef struct swr_tile_desc
 {
-	uint32_t m_CoverageMask;
 	uint32_t m_FrameBufferOffset;
 	int32_t m_BarycentricCoords[2];
+	uint32_t m_CoverageMask[SWR_CONFIG_MAX_SAMPLES]; // One per sample. Only the first is used without multisampling.
 } swr_tile_desc;
 
+// Per-triangle inputs of the pixel shaders (see swr_shadeTile).
+typedef struct swr_pixel_shader_data
+{
+	swr_vertex_attrib_data m_Attribs[4]; // SWR_PIXEL_SHADER_VERTEX_COLOR: r, g, b, a. SWR_PIXEL_SHADER_TEXTURE: s, t.
+	const swr_texture_level* m_Texture;  // SWR_PIXEL_SHADER_TEXTURE only
+	swr_pixel_shader_func m_Func;        // SWR_PIXEL_SHADER_CUSTOM only
+	void* m_UserData;
+	uint32_t m_VertexColors[3];
+	uint32_t m_FrameBufferWidth;
+	const swr_varying_layout* m_VaryingLayout; // NULL if the triangle has no varyings
+	swr_vertex_attrib_data m_Varyings[SWR_CONFIG_MAX_VARYINGS];
+} swr_pixel_shader_data;
+
 static __forceinline swr_edge swr_edgeInit(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
 {
+	const int32_t dx = (y1 - y0);
+	const int32_t dy = (x0 - x1);
+
+	// Top-left fill rule (see swrDrawTriangleRef)
+	const bool isTopLeft = dx > 0 || (dx == 0 && dy > 0);
+
 	return (swr_edge)
 	{
 		.m_x0 = x0,
 		.m_y0 = y0,
-		.m_dx = (y1 - y0),
-		.m_dy = (x0 - x1),
+		.m_dx = dx,
+		.m_dy = dy,
+		.m_bias = isTopLeft ? 0 : -1
 	};
 }
 
-static __forceinline int32_t swr_edgeEval(swr_edge edge, int32_t x, int32_t y)
+// Value of the biased edge function at the sample point of pixel (x, y), divided by 
+// the sub-pixel step (see swrDrawTriangleRef).
+static __forceinline int64_t swr_edgeEval(swr_edge edge, int32_t x, int32_t y)
 {
-	return 0
-		+ (x - edge.m_x0) * edge.m_dx
-		+ (y - edge.m_y0) * edge.m_dy
+	const int64_t e = 0
+		+ (int64_t)((x << SWR_CONFIG_SUBPIXEL_BITS) - edge.m_x0) * edge.m_dx
+		+ (int64_t)((y << SWR_CONFIG_SUBPIXEL_BITS) - edge.m_y0) * edge.m_dy
+		+ edge.m_bias
+		;
+	return e >> SWR_CONFIG_SUBPIXEL_BITS;
+}
+
+// Per-sample offsets of the edge function from its value at the pixel's integer 
+// coordinates (see swrDrawTriangleRef).
+static __forceinline void swr_edgeSampleOffsets(swr_edge edge, const swr_context* ctx, int32_t* offsets)
+{
+	const int64_t e = edge.m_bias - (int64_t)edge.m_x0 * edge.m_dx - (int64_t)edge.m_y0 * edge.m_dy;
+	for (uint32_t i = 0; i < ctx->m_NumSamples; ++i) {
+		const int64_t es = e
+			+ (int64_t)ctx->m_SampleOffsets[i * 2 + 0] * edge.m_dx
+			+ (int64_t)ctx->m_SampleOffsets[i * 2 + 1] * edge.m_dy
+			;
+		offsets[i] = (int32_t)((es >> SWR_CONFIG_SUBPIXEL_BITS) - (e >> SWR_CONFIG_SUBPIXEL_BITS));
+	}
+}
+
+// Checks if the 32-bit traversal code can evaluate the edge function anywhere inside 
+// the [xmin, xmax] x [ymin, ymax] pixel rect without overflowing. The edge function is 
+// linear so its extremes are at the rect's corners. Keeping its value below 2^30 and
+// its per-pixel deltas below 2^24 leaves enough headroom for the corner offsets added 
+// to it during traversal.
+static __forceinline bool swr_edgeFitsInt32(swr_edge edge, int32_t xmin, int32_t ymin, int32_t xmax, int32_t ymax)
+{
+	const int32_t maxDelta = 1 << 24;
+	if (edge.m_dx <= -maxDelta || edge.m_dx >= maxDelta || edge.m_dy <= -maxDelta || edge.m_dy >= maxDelta) {
+		return false;
+	}
+
+	const int64_t maxValue = (int64_t)1 << 30;
+	const int64_t e00 = swr_edgeEval(edge, xmin, ymin);
+	const int64_t e10 = e00 + (int64_t)(xmax - xmin) * edge.m_dx;
+	const int64_t e01 = e00 + (int64_t)(ymax - ymin) * edge.m_dy;
+	const int64_t e11 = e10 + (int64_t)(ymax - ymin) * edge.m_dy;
+	return true
+		&& e00 > -maxValue && e00 < maxValue
+		&& e10 > -maxValue && e10 < maxValue
+		&& e01 > -maxValue && e01 < maxValue
+		&& e11 > -maxValue && e11 < maxValue
 		;
 }
 
@@ -60,7 +124,79 @@ static __forceinline vec4f swr_vertexAttribEval(swr_vertex_attrib_data va, vec4f
 	return vec4f_madd(va.m_dVal02, w0, vec4f_madd(va.m_dVal12, w1, va.m_Val2));
 }
 
-static __forceinline void rasterizeTile4x4_constColor(uint32_t color, uint32_t coverageMask, uint32_t* tileFB, uint32_t rowStride)
+// Returns the final color of 4 pixels of the framebuffer. Opaque triangles don't
+// read the framebuffer at all.
+static __forceinline vec4i swr_blend(vec4i rgba, const uint32_t* fb, uint32_t blendMode)
+{
+	if (blendMode == SWR_BLEND_MODE_OPAQUE) {
+		return rgba;
+	}
+
+	const vec4i dst = vec4i_fromInt4vu((const int32_t*)fb);
+	if (blendMode == SWR_BLEND_MODE_SRC_OVER) {
+		return vec4i_blendSrcOverRGBA8(rgba, dst);
+	} else if (blendMode == SWR_BLEND_MODE_ADDITIVE) {
+		return vec4i_blendAddRGBA8(rgba, dst);
+	}
+
+	return vec4i_blendMulRGBA8(rgba, dst);
+}
+
+// Coverage mask of a 4x4 tile (see rasterizeTile4x4_constColor for the bit layout) 
+// given the edge function values of its first row.
+static __forceinline uint32_t swr_tileCoverageMask(vec4i v_w0_row0, vec4i v_w1_row0, vec4i v_w2_row0, vec4i v_edge0_dy, vec4i v_edge1_dy, vec4i v_edge2_dy, vec4i v_edge0_dy2, vec4i v_edge1_dy2, vec4i v_edge2_dy2, vec4i v_edge0_dy3, vec4i v_edge1_dy3, vec4i v_edge2_dy3)
+{
+	const vec4i v_signMask = vec4i_fromInt(0x80000000);
+
+	const vec4i v_w0_row1 = vec4i_add(v_w0_row0, v_edge0_dy);
+	const vec4i v_w1_row1 = vec4i_add(v_w1_row0, v_edge1_dy);
+	const vec4i v_w2_row1 = vec4i_add(v_w2_row0, v_edge2_dy);
+	const vec4i v_w0_row2 = vec4i_add(v_w0_row0, v_edge0_dy2);
+	const vec4i v_w1_row2 = vec4i_add(v_w1_row0, v_edge1_dy2);
+	const vec4i v_w2_row2 = vec4i_add(v_w2_row0, v_edge2_dy2);
+	const vec4i v_w0_row3 = vec4i_add(v_w0_row0, v_edge0_dy3);
+	const vec4i v_w1_row3 = vec4i_add(v_w1_row0, v_edge1_dy3);
+	const vec4i v_w2_row3 = vec4i_add(v_w2_row0, v_edge2_dy3);
+
+	const vec4i v_mask0 = vec4i_or3(v_w0_row0, v_w1_row0, v_w2_row0);
+	const vec4i v_mask1 = vec4i_or3(v_w0_row1, v_w1_row1, v_w2_row1);
+	const vec4i v_mask2 = vec4i_or3(v_w0_row2, v_w1_row2, v_w2_row2);
+	const vec4i v_mask3 = vec4i_or3(v_w0_row3, v_w1_row3, v_w2_row3);
+
+	const vec4i v_mask0_sign = vec4i_and(v_mask0, v_signMask);
+	const vec4i v_mask1_sign = vec4i_and(v_mask1, v_signMask);
+	const vec4i v_mask2_sign = vec4i_and(v_mask2, v_signMask);
+	const vec4i v_mask3_sign = vec4i_and(v_mask3, v_signMask);
+
+	const vec4i v_mask01 = vec4i_or(vec4i_slr(v_mask0_sign, 24), vec4i_slr(v_mask1_sign, 16));
+	const vec4i v_mask23 = vec4i_or(vec4i_slr(v_mask2_sign, 8), v_mask3_sign);
+	const vec4i v_mask0_3 = vec4i_or(v_mask01, v_mask23);
+
+	return (~vec4i_getByteSignMask(v_mask0_3)) & 0x0000FFFFu;
+}
+
+// Stores one row of a 4x4 tile to all sample planes. 'v_rowBits' selects the row's 
+// bits from the coverage masks (see rasterizeTile4x4_constColor).
+static __forceinline void swr_storeTileRow(vec4i rgba, const uint32_t* coverageMasks, uint32_t numSamples, vec4i v_rowBits, uint32_t* rowFB, uint32_t sampleStride, uint32_t blendMode)
+{
+	for (uint32_t i = 0; i < numSamples; ++i) {
+		const uint32_t coverageMask = coverageMasks[i];
+		if (coverageMask == 0) {
+			continue;
+		}
+
+		uint32_t* sampleFB = &rowFB[i * sampleStride];
+		const vec4i color = swr_blend(rgba, sampleFB, blendMode);
+		if (coverageMask == 0x0000FFFFu) {
+			vec4i_toInt4va(color, sampleFB);
+		} else {
+			const vec4i pixelMask = vec4i_sar(vec4i_mullo(vec4i_fromInt(coverageMask), v_rowBits), 31);
+			vec4i_toInt4va_masked(color, pixelMask, sampleFB);
+		}
+	}
+}
+
+static __forceinline void rasterizeTile4x4_constColor(uint32_t color, uint32_t coverageMask, uint32_t* tileFB, uint32_t rowStride, uint32_t blendMode)
 {
 	const vec4i rgba = vec4i_fromInt(color);
 	const vec4i v_coverageMask = vec4i_fromInt(coverageMask);
@@ -68,7 +204,7 @@ static __forceinline void rasterizeTile4x4_constColor(uint32_t color, uint32_t c
 	// Row #0
 	{
 		const vec4i pixelMask = vec4i_sar(vec4i_mullo(v_coverageMask, vec4i_fromInt4(1u << 31, 1u << 27, 1u << 23, 1u << 19)), 31);
-		vec4i_toInt4va_masked(rgba, pixelMask, tileFB);
+		vec4i_toInt4va_masked(swr_blend(rgba, tileFB, blendMode), pixelMask, tileFB);
 
 		tileFB += rowStride;
 	}
@@ -76,7 +212,7 @@ static __forceinline void rasterizeTile4x4_constColor(uint32_t color, uint32_t c
 	// Row #1
 	{
 		const vec4i pixelMask = vec4i_sar(vec4i_mullo(v_coverageMask, vec4i_fromInt4(1u << 30, 1u << 26, 1u << 22, 1u << 18)), 31);
-		vec4i_toInt4va_masked(rgba, pixelMask, tileFB);
+		vec4i_toInt4va_masked(swr_blend(rgba, tileFB, blendMode), pixelMask, tileFB);
 
 		tileFB += rowStride;
 	}
@@ -84,7 +220,7 @@ static __forceinline void rasterizeTile4x4_constColor(uint32_t color, uint32_t c
 	// Row #2
 	{
 		const vec4i pixelMask = vec4i_sar(vec4i_mullo(v_coverageMask, vec4i_fromInt4(1u << 29, 1u << 25, 1u << 21, 1u << 17)), 31);
-		vec4i_toInt4va_masked(rgba, pixelMask, tileFB);
+		vec4i_toInt4va_masked(swr_blend(rgba, tileFB, blendMode), pixelMask, tileFB);
 
 		tileFB += rowStride;
 	}
@@ -92,75 +228,236 @@ static __forceinline void rasterizeTile4x4_constColor(uint32_t color, uint32_t c
 	// Row #3
 	{
 		const vec4i pixelMask = vec4i_sar(vec4i_mullo(v_coverageMask, vec4i_fromInt4(1u << 28, 1u << 24, 1u << 20, 1u << 16)), 31);
-		vec4i_toInt4va_masked(rgba, pixelMask, tileFB);
+		vec4i_toInt4va_masked(swr_blend(rgba, tileFB, blendMode), pixelMask, tileFB);
+	}
+}
+
+static __forceinline void rasterizeBlock_constColor(uint32_t color, int32_t blockWidth, int32_t blockHeight, uint32_t* blockFB, uint32_t rowStride, bool stream, uint32_t blendMode)
+{
+	const vec4i rgba = vec4i_fromInt(color);
+
+	if (stream) {
+		for (int32_t y = 0; y < blockHeight; ++y) {
+			for (int32_t x = 0; x < blockWidth; x += 4) {
+				vec4i_toInt4va_stream(rgba, &blockFB[x]);
+			}
+			blockFB += rowStride;
+		}
+	} else {
+		for (int32_t y = 0; y < blockHeight; ++y) {
+			for (int32_t x = 0; x < blockWidth; x += 4) {
+				vec4i_toInt4vu(swr_blend(rgba, &blockFB[x], blendMode), &blockFB[x]);
+			}
+			blockFB += rowStride;
+		}
 	}
 }
 
-static __forceinline void rasterizeTile4x4_varColor(vec4f v_l0, vec4f v_l1, vec4f v_dl0, vec4f v_dl1, swr_vertex_attrib_data va_r, swr_vertex_attrib_data va_g, swr_vertex_attrib_data va_b, swr_vertex_attrib_data va_a, uint32_t coverageMask, uint32_t* tileFB, uint32_t rowStride)
+// Offsets of texels in the blocked texture layout (see swrTextureOffsetX/Y).
+static __forceinline vec4i swr_textureOffsetX(vec4i x)
 {
-	const vec4f v_dcr = vec4f_madd(va_r.m_dVal12, v_dl1, vec4f_mul(va_r.m_dVal02, v_dl0));
-	const vec4f v_dcg = vec4f_madd(va_g.m_dVal12, v_dl1, vec4f_mul(va_g.m_dVal02, v_dl0));
-	const vec4f v_dcb = vec4f_madd(va_b.m_dVal12, v_dl1, vec4f_mul(va_b.m_dVal02, v_dl0));
-	const vec4f v_dca = vec4f_madd(va_a.m_dVal12, v_dl1, vec4f_mul(va_a.m_dVal02, v_dl0));
+	const vec4i v_blockMask = vec4i_fromInt((1 << SWR_TEXTURE_BLOCK_SIZE_LOG2) - 1);
+	return vec4i_or(vec4i_sal(vec4i_andnot(v_blockMask, x), SWR_TEXTURE_BLOCK_SIZE_LOG2), vec4i_and(x, v_blockMask));
+}
 
-	vec4f v_cr = swr_vertexAttribEval(va_r, v_l0, v_l1);
-	vec4f v_cg = swr_vertexAttribEval(va_g, v_l0, v_l1);
-	vec4f v_cb = swr_vertexAttribEval(va_b, v_l0, v_l1);
-	vec4f v_ca = swr_vertexAttribEval(va_a, v_l0, v_l1);
+static __forceinline vec4i swr_textureOffsetY(vec4i y, vec4i v_blockRowStride)
+{
+	const vec4i v_blockMask = vec4i_fromInt((1 << SWR_TEXTURE_BLOCK_SIZE_LOG2) - 1);
+	return vec4i_add(vec4i_mullo(vec4i_sar(y, SWR_TEXTURE_BLOCK_SIZE_LOG2), v_blockRowStride), vec4i_sal(vec4i_and(y, v_blockMask), SWR_TEXTURE_BLOCK_SIZE_LOG2));
+}
 
-	const vec4i v_coverageMask = vec4i_fromInt(coverageMask);
+// Samples the texture at 4 points given in texels with 8 fractional bits. Same math as 
+// swrTextureSample. Bilinear filtering gathers the 4 texels around each point separately.
+static __forceinline vec4i swr_textureSample(const swr_texture_level* tex, vec4f s, vec4f t, uint32_t textureFilter)
+{
+	const int32_t* texels = (const int32_t*)tex->m_Pixels;
+	const vec4i v_blockRowStride = vec4i_fromInt((int32_t)tex->m_BlockRowStride);
+	const vec4f v_zero = vec4f_zero();
+
+	if (textureFilter == SWR_TEXTURE_FILTER_NEAREST) {
+		const vec4f v_maxS = vec4f_fromFloat((float)((tex->m_Width << 8) - 1));
+		const vec4f v_maxT = vec4f_fromFloat((float)((tex->m_Height << 8) - 1));
+		const vec4i x = vec4i_sar(vec4i_fromVec4f_trunc(vec4f_max(vec4f_min(s, v_maxS), v_zero)), 8);
+		const vec4i y = vec4i_sar(vec4i_fromVec4f_trunc(vec4f_max(vec4f_min(t, v_maxT), v_zero)), 8);
+		return vec4i_gather(texels, vec4i_add(swr_textureOffsetX(x), swr_textureOffsetY(y, v_blockRowStride)));
+	}
+
+	const vec4f v_maxS = vec4f_fromFloat((float)((tex->m_Width - 1) << 8));
+	const vec4f v_maxT = vec4f_fromFloat((float)((tex->m_Height - 1) << 8));
+	const vec4i sx = vec4i_fromVec4f_trunc(vec4f_max(vec4f_min(s, v_maxS), v_zero));
+	const vec4i sy = vec4i_fromVec4f_trunc(vec4f_max(vec4f_min(t, v_maxT), v_zero));
+
+	const vec4i v_fracMask = vec4i_fromInt(0xFF);
+	const vec4i fx = vec4i_and(sx, v_fracMask);
+	const vec4i fy = vec4i_and(sy, v_fracMask);
+	const vec4i x0 = vec4i_sar(sx, 8);
+	const vec4i y0 = vec4i_sar(sy, 8);
+	const vec4i ox0 = swr_textureOffsetX(x0);
+	const vec4i ox1 = swr_textureOffsetX(vec4i_add(x0, vec4i_slr(vec4i_add(fx, v_fracMask), 8)));
+	const vec4i oy0 = swr_textureOffsetY(y0, v_blockRowStride);
+	const vec4i oy1 = swr_textureOffsetY(vec4i_add(y0, vec4i_slr(vec4i_add(fy, v_fracMask), 8)), v_blockRowStride);
+
+	return vec4i_bilerpRGBA8(
+		vec4i_gather(texels, vec4i_add(ox0, oy0)),
+		vec4i_gather(texels, vec4i_add(ox1, oy0)),
+		vec4i_gather(texels, vec4i_add(ox0, oy1)),
+		vec4i_gather(texels, vec4i_add(ox1, oy1)),
+		fx, fy
+	);
+}
+
+// Computes the colors of the 4 rows of a tile. 'pixelShader' is a compile-time constant 
+// (see SWR_PIXEL_SHADER_VERTEX_COLOR) so only one of the branches is ever compiled in.
+static __forceinline void swr_shadeTile(uint32_t pixelShader, const swr_pixel_shader_data* ps, uint32_t textureFilter, vec4f v_l0, vec4f v_l1, vec4f v_dl0, vec4f v_dl1, const swr_tile_desc* tile, uint32_t numSamples, vec4i* rgba)
+{
+	if (pixelShader == SWR_PIXEL_SHADER_VERTEX_COLOR) {
+		const swr_vertex_attrib_data va_r = ps->m_Attribs[0];
+		const swr_vertex_attrib_data va_g = ps->m_Attribs[1];
+		const swr_vertex_attrib_data va_b = ps->m_Attribs[2];
+		const swr_vertex_attrib_data va_a = ps->m_Attribs[3];
+		const vec4f v_dcr = vec4f_madd(va_r.m_dVal12, v_dl1, vec4f_mul(va_r.m_dVal02, v_dl0));
+		const vec4f v_dcg = vec4f_madd(va_g.m_dVal12, v_dl1, vec4f_mul(va_g.m_dVal02, v_dl0));
+		const vec4f v_dcb = vec4f_madd(va_b.m_dVal12, v_dl1, vec4f_mul(va_b.m_dVal02, v_dl0));
+		const vec4f v_dca = vec4f_madd(va_a.m_dVal12, v_dl1, vec4f_mul(va_a.m_dVal02, v_dl0));
+
+		vec4f v_cr = swr_vertexAttribEval(va_r, v_l0, v_l1);
+		vec4f v_cg = swr_vertexAttribEval(va_g, v_l0, v_l1);
+		vec4f v_cb = swr_vertexAttribEval(va_b, v_l0, v_l1);
+		vec4f v_ca = swr_vertexAttribEval(va_a, v_l0, v_l1);
+		for (uint32_t row = 0; row < 4; ++row) {
+			rgba[row] = vec4i_packR32G32B32A32_to_RGBA8(vec4i_fromVec4f(v_cr), vec4i_fromVec4f(v_cg), vec4i_fromVec4f(v_cb), vec4i_fromVec4f(v_ca));
+
+			v_cr = vec4f_add(v_cr, v_dcr);
+			v_cg = vec4f_add(v_cg, v_dcg);
+			v_cb = vec4f_add(v_cb, v_dcb);
+			v_ca = vec4f_add(v_ca, v_dca);
+		}
+	} else if (pixelShader == SWR_PIXEL_SHADER_TEXTURE) {
+		const swr_vertex_attrib_data va_s = ps->m_Attribs[0];
+		const swr_vertex_attrib_data va_t = ps->m_Attribs[1];
+		const vec4f v_ds = vec4f_madd(va_s.m_dVal12, v_dl1, vec4f_mul(va_s.m_dVal02, v_dl0));
+		const vec4f v_dt = vec4f_madd(va_t.m_dVal12, v_dl1, vec4f_mul(va_t.m_dVal02, v_dl0));
+
+		vec4f v_s = swr_vertexAttribEval(va_s, v_l0, v_l1);
+		vec4f v_t = swr_vertexAttribEval(va_t, v_l0, v_l1);
+		for (uint32_t row = 0; row < 4; ++row) {
+			rgba[row] = swr_textureSample(ps->m_Texture, v_s, v_t, textureFilter);
+
+			v_s = vec4f_add(v_s, v_ds);
+			v_t = vec4f_add(v_t, v_dt);
+		}
+	} else {
+		// Custom shaders get the whole tile at once, in row-major order. Varyings are 
+		// stepped down the rows the same way as the built-in shaders' attributes.
+		float bary0[16];
+		float bary1[16];
+		float varyings[SWR_CONFIG_MAX_VARYINGS * 16];
+		uint32_t colors[16];
+		const swr_varying_layout* layout = ps->m_VaryingLayout;
+		const uint32_t numVaryings = layout != NULL ? layout->m_NumVaryings : 0;
+		for (uint32_t i = 0; i < numVaryings; ++i) {
+			const swr_vertex_attrib_data va = ps->m_Varyings[i];
+			const vec4f v_dv = vec4f_madd(va.m_dVal12, v_dl1, vec4f_mul(va.m_dVal02, v_dl0));
+
+			vec4f v_v = swr_vertexAttribEval(va, v_l0, v_l1);
+			for (uint32_t row = 0; row < 4; ++row) {
+				vec4f_toFloat4vu(v_v, &varyings[i * 16 + row * 4]);
+				v_v = vec4f_add(v_v, v_dv);
+			}
+		}
+
+		for (uint32_t row = 0; row < 4; ++row) {
+			vec4f_toFloat4vu(v_l0, &bary0[row * 4]);
+			vec4f_toFloat4vu(v_l1, &bary1[row * 4]);
+
+			v_l0 = vec4f_add(v_l0, v_dl0);
+			v_l1 = vec4f_add(v_l1, v_dl1);
+		}
+
+		uint32_t coverageMask = 0;
+		for (uint32_t i = 0; i < numSamples; ++i) {
+			coverageMask |= tile->m_CoverageMask[i];
+		}
+
+		swr_pixel_shader_tile shaderTile = {
+			.m_Bary0 = bary0,
+			.m_Bary1 = bary1,
+			.m_VertexColors = ps->m_VertexColors,
+			.m_X = (int32_t)(tile->m_FrameBufferOffset % ps->m_FrameBufferWidth),
+			.m_Y = (int32_t)(tile->m_FrameBufferOffset / ps->m_FrameBufferWidth),
+			.m_Width = 4,
+			.m_Height = 4,
+			.m_CoverageMask = swrTileCoverageToRowMajor(coverageMask, 4)
+		};
+		if (layout != NULL) {
+			for (uint32_t va = 0; va < SWR_VERTEX_ATTRIB_COUNT; ++va) {
+				shaderTile.m_Attribs[va] = layout->m_NumComponents[va] != 0
+					? &varyings[layout->m_FirstVarying[va] * 16]
+					: NULL
+					;
+			}
+		}
+		ps->m_Func(&shaderTile, colors, ps->m_UserData);
+
+		for (uint32_t row = 0; row < 4; ++row) {
+			rgba[row] = vec4i_fromInt4vu((const int32_t*)&colors[row * 4]);
+		}
+	}
+}
+
+// Colors are computed once per pixel and stored to all its covered samples.
+static __forceinline void rasterizeTile4x4_shaded(uint32_t pixelShader, const swr_pixel_shader_data* ps, uint32_t textureFilter, vec4f v_l0, vec4f v_l1, vec4f v_dl0, vec4f v_dl1, const swr_tile_desc* tile, uint32_t numSamples, uint32_t* tileFB, uint32_t rowStride, uint32_t sampleStride, uint32_t blendMode)
+{
+	vec4i rgba[4];
+	swr_shadeTile(pixelShader, ps, textureFilter, v_l0, v_l1, v_dl0, v_dl1, tile, numSamples, rgba);
 
 	// Row #0
 	{
-		const vec4i pixelMask = vec4i_sar(vec4i_mullo(v_coverageMask, vec4i_fromInt4(1u << 31, 1u << 27, 1u << 23, 1u << 19)), 31);
-		const vec4i rgba = vec4i_packR32G32B32A32_to_RGBA8(vec4i_fromVec4f(v_cr), vec4i_fromVec4f(v_cg), vec4i_fromVec4f(v_cb), vec4i_fromVec4f(v_ca));
-		vec4i_toInt4va_masked(rgba, pixelMask, tileFB);
+		swr_storeTileRow(rgba[0], tile->m_CoverageMask, numSamples, vec4i_fromInt4(1u << 31, 1u << 27, 1u << 23, 1u << 19), tileFB, sampleStride, blendMode);
 
 		tileFB += rowStride;
-		v_cr = vec4f_add(v_cr, v_dcr);
-		v_cg = vec4f_add(v_cg, v_dcg);
-		v_cb = vec4f_add(v_cb, v_dcb);
-		v_ca = vec4f_add(v_ca, v_dca);
 	}
 
 	// Row #1
 	{
-		const vec4i pixelMask = vec4i_sar(vec4i_mullo(v_coverageMask, vec4i_fromInt4(1u << 30, 1u << 26, 1u << 22, 1u << 18)), 31);
-		const vec4i rgba = vec4i_packR32G32B32A32_to_RGBA8(vec4i_fromVec4f(v_cr), vec4i_fromVec4f(v_cg), vec4i_fromVec4f(v_cb), vec4i_fromVec4f(v_ca));
-		vec4i_toInt4va_masked(rgba, pixelMask, tileFB);
+		swr_storeTileRow(rgba[1], tile->m_CoverageMask, numSamples, vec4i_fromInt4(1u << 30, 1u << 26, 1u << 22, 1u << 18), tileFB, sampleStride, blendMode);
 
 		tileFB += rowStride;
-		v_cr = vec4f_add(v_cr, v_dcr);
-		v_cg = vec4f_add(v_cg, v_dcg);
-		v_cb = vec4f_add(v_cb, v_dcb);
-		v_ca = vec4f_add(v_ca, v_dca);
 	}
 
 	// Row #2
 	{
-		const vec4i pixelMask = vec4i_sar(vec4i_mullo(v_coverageMask, vec4i_fromInt4(1u << 29, 1u << 25, 1u << 21, 1u << 17)), 31);
-		const vec4i rgba = vec4i_packR32G32B32A32_to_RGBA8(vec4i_fromVec4f(v_cr), vec4i_fromVec4f(v_cg), vec4i_fromVec4f(v_cb), vec4i_fromVec4f(v_ca));
-		vec4i_toInt4va_masked(rgba, pixelMask, tileFB);
+		swr_storeTileRow(rgba[2], tile->m_CoverageMask, numSamples, vec4i_fromInt4(1u << 29, 1u << 25, 1u << 21, 1u << 17), tileFB, sampleStride, blendMode);
 
 		tileFB += rowStride;
-		v_cr = vec4f_add(v_cr, v_dcr);
-		v_cg = vec4f_add(v_cg, v_dcg);
-		v_cb = vec4f_add(v_cb, v_dcb);
-		v_ca = vec4f_add(v_ca, v_dca);
 	}
 
 	// Row #3
 	{
-		const vec4i pixelMask = vec4i_sar(vec4i_mullo(v_coverageMask, vec4i_fromInt4(1u << 28, 1u << 24, 1u << 20, 1u << 16)), 31);
-		const vec4i rgba = vec4i_packR32G32B32A32_to_RGBA8(vec4i_fromVec4f(v_cr), vec4i_fromVec4f(v_cg), vec4i_fromVec4f(v_cb), vec4i_fromVec4f(v_ca));
-		vec4i_toInt4va_masked(rgba, pixelMask, tileFB);
+		swr_storeTileRow(rgba[3], tile->m_CoverageMask, numSamples, vec4i_fromInt4(1u << 28, 1u << 24, 1u << 20, 1u << 16), tileFB, sampleStride, blendMode);
 	}
 }
 
-void swrDrawTriangleSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2)
+extern void swrDrawTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
+extern void swrDrawTriangleFlatRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+extern void swrDrawTriangleTexturedRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv);
+extern void swrDrawSmallTriangleRef(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int64_t iarea, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, uint32_t color0, uint32_t color1, uint32_t color2, const float* varyings, bool constColor);
+
+static __forceinline void drawTriangle_internal(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2, bool constColor, uint32_t blendMode, bool multisample, uint32_t pixelShader, const float* uv, uint32_t textureFilter)
 {
+	// Textured triangles sample ctx->m_Texture instead of interpolating colors. 'uv' is 
+	// NULL otherwise.
+	const bool textured = pixelShader == SWR_PIXEL_SHADER_TEXTURE;
+	float texCoords[6];
+	if (textured) {
+		for (uint32_t i = 0; i < 6; ++i) {
+			texCoords[i] = uv[i];
+		}
+	}
+
 	// Make sure the triangle is CCW. If it's not swap points 1 and 2 to make it CCW.
-	int32_t iarea = (x0 - x2) * (y1 - y0) - (x1 - x0) * (y0 - y2);
+	int64_t iarea = (int64_t)(x0 - x2) * (int64_t)(y1 - y0) - (int64_t)(x1 - x0) * (int64_t)(y0 - y2);
+	bool swapped = false;
 	if (iarea == 0) {
 		// Degenerate triangle with 0 area.
 		return;
@@ -169,17 +466,59 @@ void swrDrawTriangleSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, i
 		{ int32_t tmp = x1; x1 = x2; x2 = tmp; }
 		{ int32_t tmp = y1; y1 = y2; y2 = tmp; }
 		{ uint32_t tmp = color1; color1 = color2; color2 = tmp; }
+		if (textured) {
+			{ float tmp = texCoords[2]; texCoords[2] = texCoords[4]; texCoords[4] = tmp; }
+			{ float tmp = texCoords[3]; texCoords[3] = texCoords[5]; texCoords[5] = tmp; }
+		}
 		iarea = -iarea;
+		swapped = true;
 	}
 
+	const uint32_t numSamples = multisample ? ctx->m_NumSamples : 1;
+	const int32_t sampleExtent = multisample ? ctx->m_SampleExtent : 0;
+	const uint32_t sampleStride = ctx->m_SampleStride;
+	uint32_t* frameBuffer = ctx->m_SampleBuffer;
+
 	// Compute triangle bounding box
-	const int32_t bboxMinX = core_maxi32(core_min3i32(x0, x1, x2), 0);
-	const int32_t bboxMinY = core_maxi32(core_min3i32(y0, y1, y2), 0);
-	const int32_t bboxMaxX = core_mini32(core_max3i32(x0, x1, x2), (int32_t)(ctx->m_Width - 1));
-	const int32_t bboxMaxY = core_mini32(core_max3i32(y0, y1, y2), (int32_t)(ctx->m_Height - 1));
-	const int32_t bboxWidth = bboxMaxX - bboxMinX;
-	const int32_t bboxHeight = bboxMaxY - bboxMinY;
-	if (bboxWidth <= 0 || bboxHeight <= 0) {
+	const int32_t sampleMinX = swrSubpixelCeil(core_min3i32(x0, x1, x2) - sampleExtent);
+	const int32_t sampleMinY = swrSubpixelCeil(core_min3i32(y0, y1, y2) - sampleExtent);
+	const int32_t sampleMaxX = swrSubpixelFloor(core_max3i32(x0, x1, x2) + sampleExtent);
+	const int32_t sampleMaxY = swrSubpixelFloor(core_max3i32(y0, y1, y2) + sampleExtent);
+	int32_t bboxMinX = core_maxi32(sampleMinX, 0);
+	int32_t bboxMinY = core_maxi32(sampleMinY, 0);
+	int32_t bboxMaxX = core_mini32(sampleMaxX, (int32_t)(ctx->m_Width - 1));
+	int32_t bboxMaxY = core_mini32(sampleMaxY, (int32_t)(ctx->m_Height - 1));
+	if (bboxMinX > bboxMaxX || bboxMinY > bboxMaxY) {
+		return;
+	}
+
+	// Clip bounding box to the scissor rect
+	bboxMinX = core_maxi32(bboxMinX, ctx->m_ScissorRect.m_MinX);
+	bboxMinY = core_maxi32(bboxMinY, ctx->m_ScissorRect.m_MinY);
+	bboxMaxX = core_mini32(bboxMaxX, ctx->m_ScissorRect.m_MaxX);
+	bboxMaxY = core_mini32(bboxMaxY, ctx->m_ScissorRect.m_MaxY);
+	if (bboxMinX > bboxMaxX || bboxMinY > bboxMaxY) {
+		return;
+	}
+
+	swrTouchTiles(ctx, bboxMinX, bboxMinY, bboxMaxX, bboxMaxY);
+
+	// Custom pixel shader varyings, in the same vertex order as the positions.
+	float varyingBuffer[SWR_CONFIG_MAX_VARYINGS * 3];
+	const float* varyings = pixelShader == SWR_PIXEL_SHADER_CUSTOM
+		? swrTriangleVaryings(ctx, swapped, varyingBuffer)
+		: NULL
+		;
+
+	// Triangles which cover at most a few sample points in each direction don't benefit 
+	// from tile traversal.
+	if (sampleMaxX - sampleMinX < SWR_CONFIG_SMALL_TRIANGLE_SIZE && sampleMaxY - sampleMinY < SWR_CONFIG_SMALL_TRIANGLE_SIZE) {
+		if (textured) {
+			swrDrawTriangleTexturedRef(ctx, x0, y0, x1, y1, x2, y2, texCoords);
+			return;
+		}
+
+		swrDrawSmallTriangleRef(ctx, x0, y0, x1, y1, x2, y2, iarea, bboxMinX, bboxMinY, bboxMaxX, bboxMaxY, color0, color1, color2, varyings, constColor);
 		return;
 	}
 
@@ -203,6 +542,38 @@ void swrDrawTriangleSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, i
 	const swr_edge edge1 = swr_edgeInit(x0, y0, x2, y2);
 	const swr_edge edge2 = swr_edgeInit(x1, y1, x0, y0);
 
+	// Traversal visits blocks up to SWR_CONFIG_COARSE_BLOCK_SIZE pixels past the end of 
+	// the bounding box. If any edge function might overflow there, use the 64-bit 
+	// reference rasterizer instead. Sample points are less than a pixel away from their 
+	// pixel's integer coordinates so growing the rect by 1 pixel covers them too.
+	{
+		const int32_t sampleMargin = multisample ? 1 : 0;
+		const int32_t xmin = bboxMinX_aligned - sampleMargin;
+		const int32_t ymin = bboxMinY_aligned - sampleMargin;
+		const int32_t xmax = bboxMaxX_aligned + SWR_CONFIG_COARSE_BLOCK_SIZE + sampleMargin;
+		const int32_t ymax = bboxMaxY_aligned + SWR_CONFIG_COARSE_BLOCK_SIZE + sampleMargin;
+		const bool fitsInt32 = true
+			&& swr_edgeFitsInt32(edge0, xmin, ymin, xmax, ymax)
+			&& swr_edgeFitsInt32(edge1, xmin, ymin, xmax, ymax)
+			&& swr_edgeFitsInt32(edge2, xmin, ymin, xmax, ymax)
+			;
+		if (!fitsInt32) {
+			if (textured) {
+				swrDrawTriangleTexturedRef(ctx, x0, y0, x1, y1, x2, y2, texCoords);
+			} else if (constColor) {
+				swrDrawTriangleFlatRef(ctx, x0, y0, x1, y1, x2, y2, color0);
+			} else {
+				// The reference rasterizer reads the varyings from the context, where they 
+				// are in the caller's vertex order.
+				const float* callerVaryings = ctx->m_Varyings;
+				ctx->m_Varyings = varyings;
+				swrDrawTriangleRef(ctx, x0, y0, x1, y1, x2, y2, color0, color1, color2);
+				ctx->m_Varyings = callerVaryings;
+			}
+			return;
+		}
+	}
+
 	// The Trivial Reject Corner (TRC) is the most positive corner of a tile
 	// for each edge function. If the edge function at the TRC is negative it 
 	// means that it will never be positive inside that tile so it can be 
@@ -239,10 +610,33 @@ void swrDrawTriangleSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, i
 	// functions at the respective TRCs are all positive but no pixel will be rasterized because
 	// the pixel masks generated by each edge function do not intersect.
 	// 
+	// NOTE #3: With multisampling, the edge function at each sample point differs from its 
+	// value at the pixel's integer coordinates by a constant (see swr_edgeSampleOffsets). 
+	// The reject tests add the largest of these offsets and the accept tests the smallest.
+	// 
+	int32_t w0_sampleOffsets[SWR_CONFIG_MAX_SAMPLES] = { 0 };
+	int32_t w1_sampleOffsets[SWR_CONFIG_MAX_SAMPLES] = { 0 };
+	int32_t w2_sampleOffsets[SWR_CONFIG_MAX_SAMPLES] = { 0 };
+	int32_t w0_sampleMin = 0, w1_sampleMin = 0, w2_sampleMin = 0;
+	int32_t w0_sampleMax = 0, w1_sampleMax = 0, w2_sampleMax = 0;
+	if (multisample) {
+		swr_edgeSampleOffsets(edge0, ctx, w0_sampleOffsets);
+		swr_edgeSampleOffsets(edge1, ctx, w1_sampleOffsets);
+		swr_edgeSampleOffsets(edge2, ctx, w2_sampleOffsets);
+		for (uint32_t i = 0; i < numSamples; ++i) {
+			w0_sampleMin = core_mini32(w0_sampleMin, w0_sampleOffsets[i]);
+			w1_sampleMin = core_mini32(w1_sampleMin, w1_sampleOffsets[i]);
+			w2_sampleMin = core_mini32(w2_sampleMin, w2_sampleOffsets[i]);
+			w0_sampleMax = core_maxi32(w0_sampleMax, w0_sampleOffsets[i]);
+			w1_sampleMax = core_maxi32(w1_sampleMax, w1_sampleOffsets[i]);
+			w2_sampleMax = core_maxi32(w2_sampleMax, w2_sampleOffsets[i]);
+		}
+	}
+
 	const int32_t blockSize = 4;
-	const int32_t trivialRejectOffset0 = (core_maxi32(edge0.m_dx, 0) + core_maxi32(edge0.m_dy, 0)) * (blockSize - 1);
-	const int32_t trivialRejectOffset1 = (core_maxi32(edge1.m_dx, 0) + core_maxi32(edge1.m_dy, 0)) * (blockSize - 1);
-	const int32_t trivialRejectOffset2 = (core_maxi32(edge2.m_dx, 0) + core_maxi32(edge2.m_dy, 0)) * (blockSize - 1);
+	const int32_t trivialRejectOffset0 = (core_maxi32(edge0.m_dx, 0) + core_maxi32(edge0.m_dy, 0)) * (blockSize - 1) + w0_sampleMax;
+	const int32_t trivialRejectOffset1 = (core_maxi32(edge1.m_dx, 0) + core_maxi32(edge1.m_dy, 0)) * (blockSize - 1) + w1_sampleMax;
+	const int32_t trivialRejectOffset2 = (core_maxi32(edge2.m_dx, 0) + core_maxi32(edge2.m_dy, 0)) * (blockSize - 1) + w2_sampleMax;
 
 	const vec4i v_pixelOffsets = vec4i_fromInt4(0, 1, 2, 3);
 	const vec4i v_edge0_dx_off = vec4i_mullo(vec4i_fromInt(edge0.m_dx), v_pixelOffsets);
@@ -258,117 +652,341 @@ void swrDrawTriangleSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, i
 	const vec4i v_edge1_dy3 = vec4i_add(v_edge1_dy, v_edge1_dy2);
 	const vec4i v_edge2_dy3 = vec4i_add(v_edge2_dy, v_edge2_dy2);
 
-	const vec4i v_signMask = vec4i_fromInt(0x80000000);
+	// Coarse level. Same as above but for whole blocks. The Trivial Accept Corner (TAC) is 
+	// the most negative corner of a block for each edge function. If all 3 edge functions 
+	// are positive at their TACs the block is completely inside the triangle.
+	const int32_t coarseBlockSize = SWR_CONFIG_COARSE_BLOCK_SIZE;
+	const int32_t coarseRejectOffset0 = (core_maxi32(edge0.m_dx, 0) + core_maxi32(edge0.m_dy, 0)) * (coarseBlockSize - 1) + w0_sampleMax;
+	const int32_t coarseRejectOffset1 = (core_maxi32(edge1.m_dx, 0) + core_maxi32(edge1.m_dy, 0)) * (coarseBlockSize - 1) + w1_sampleMax;
+	const int32_t coarseRejectOffset2 = (core_maxi32(edge2.m_dx, 0) + core_maxi32(edge2.m_dy, 0)) * (coarseBlockSize - 1) + w2_sampleMax;
+
+	// Fully covered blocks are filled with streaming stores when all rows are 16-byte aligned.
+	// Blended blocks have to read the framebuffer so they are never streamed.
+	const bool canStream = blendMode == SWR_BLEND_MODE_OPAQUE && (ctx->m_Width & 3) == 0;
+	bool streamed = false;
 
 	uint32_t numTiles = 0;
 	swr_tile_desc* tiles = (swr_tile_desc*)ctx->m_TileBuffer[0];
 
-	int32_t w0_y = swr_edgeEval(edge0, bboxMinX_aligned, bboxMinY_aligned);
-	int32_t w1_y = swr_edgeEval(edge1, bboxMinX_aligned, bboxMinY_aligned);
-	int32_t w2_y = swr_edgeEval(edge2, bboxMinX_aligned, bboxMinY_aligned);
-	for (int32_t tileY = bboxMinY_aligned; tileY < bboxMaxY_aligned; tileY += 4) {
-		int32_t w0_tileMin = w0_y;
-		int32_t w1_tileMin = w1_y;
-		int32_t w2_tileMin = w2_y;
-		for (int32_t tileX = bboxMinX_aligned; tileX < bboxMaxX_aligned; tileX += 4) {
-			const int32_t w0_trivialReject = w0_tileMin + trivialRejectOffset0;
-			const int32_t w1_trivialReject = w1_tileMin + trivialRejectOffset1;
-			const int32_t w2_trivialReject = w2_tileMin + trivialRejectOffset2;
-			const int32_t trivialReject = w0_trivialReject | w1_trivialReject | w2_trivialReject;
-			if (trivialReject < 0) {
-				w0_tileMin += edge0.m_dx << 2;
-				w1_tileMin += edge1.m_dx << 2;
-				w2_tileMin += edge2.m_dx << 2;
+	int32_t w0_blockY = (int32_t)swr_edgeEval(edge0, bboxMinX_aligned, bboxMinY_aligned);
+	int32_t w1_blockY = (int32_t)swr_edgeEval(edge1, bboxMinX_aligned, bboxMinY_aligned);
+	int32_t w2_blockY = (int32_t)swr_edgeEval(edge2, bboxMinX_aligned, bboxMinY_aligned);
+	for (int32_t blockY = bboxMinY_aligned; blockY < bboxMaxY_aligned; blockY += coarseBlockSize) {
+		const int32_t blockH = core_mini32(bboxMaxY_aligned - blockY, coarseBlockSize);
+
+		int32_t w0_block = w0_blockY;
+		int32_t w1_block = w1_blockY;
+		int32_t w2_block = w2_blockY;
+		for (int32_t blockX = bboxMinX_aligned; blockX < bboxMaxX_aligned; blockX += coarseBlockSize) {
+			const int32_t blockW = core_mini32(bboxMaxX_aligned - blockX, coarseBlockSize);
+
+			const int32_t coarseReject = 0
+				| (w0_block + coarseRejectOffset0)
+				| (w1_block + coarseRejectOffset1)
+				| (w2_block + coarseRejectOffset2)
+				;
+			if (coarseReject < 0) {
+				w0_block += edge0.m_dx * coarseBlockSize;
+				w1_block += edge1.m_dx * coarseBlockSize;
+				w2_block += edge2.m_dx * coarseBlockSize;
 				continue;
 			}
 
-			const vec4i v_w0_row0 = vec4i_add(vec4i_fromInt(w0_tileMin), v_edge0_dx_off);
-			const vec4i v_w1_row0 = vec4i_add(vec4i_fromInt(w1_tileMin), v_edge1_dx_off);
-			const vec4i v_w2_row0 = vec4i_add(vec4i_fromInt(w2_tileMin), v_edge2_dx_off);
-			const vec4i v_w0_row1 = vec4i_add(v_w0_row0, v_edge0_dy);
-			const vec4i v_w1_row1 = vec4i_add(v_w1_row0, v_edge1_dy);
-			const vec4i v_w2_row1 = vec4i_add(v_w2_row0, v_edge2_dy);
-			const vec4i v_w0_row2 = vec4i_add(v_w0_row0, v_edge0_dy2);
-			const vec4i v_w1_row2 = vec4i_add(v_w1_row0, v_edge1_dy2);
-			const vec4i v_w2_row2 = vec4i_add(v_w2_row0, v_edge2_dy2);
-			const vec4i v_w0_row3 = vec4i_add(v_w0_row0, v_edge0_dy3);
-			const vec4i v_w1_row3 = vec4i_add(v_w1_row0, v_edge1_dy3);
-			const vec4i v_w2_row3 = vec4i_add(v_w2_row0, v_edge2_dy3);
-
-			const vec4i v_mask0 = vec4i_or3(v_w0_row0, v_w1_row0, v_w2_row0);
-			const vec4i v_mask1 = vec4i_or3(v_w0_row1, v_w1_row1, v_w2_row1);
-			const vec4i v_mask2 = vec4i_or3(v_w0_row2, v_w1_row2, v_w2_row2);
-			const vec4i v_mask3 = vec4i_or3(v_w0_row3, v_w1_row3, v_w2_row3);
-
-			const vec4i v_mask0_sign = vec4i_and(v_mask0, v_signMask);
-			const vec4i v_mask1_sign = vec4i_and(v_mask1, v_signMask);
-			const vec4i v_mask2_sign = vec4i_and(v_mask2, v_signMask);
-			const vec4i v_mask3_sign = vec4i_and(v_mask3, v_signMask);
-
-			const vec4i v_mask01 = vec4i_or(vec4i_slr(v_mask0_sign, 24), vec4i_slr(v_mask1_sign, 16));
-			const vec4i v_mask23 = vec4i_or(vec4i_slr(v_mask2_sign, 8), v_mask3_sign);
-			const vec4i v_mask0_3 = vec4i_or(v_mask01, v_mask23);
-
-			const uint32_t mask0_3 = vec4i_getByteSignMask(v_mask0_3);
-			if (mask0_3 != UINT16_MAX) {
-				swr_tile_desc* tile = &tiles[numTiles];
-				tile->m_CoverageMask = (~mask0_3) & 0x0000FFFFu;
-				tile->m_FrameBufferOffset = tileX + tileY * ctx->m_Width;
-				tile->m_BarycentricCoords[0] = w0_tileMin;
-				tile->m_BarycentricCoords[1] = w1_tileMin;
-				++numTiles;
+			// The last block in each row/column might be smaller so the TAC is calculated per block.
+			const int32_t coarseAccept = 0
+				| (w0_block + core_mini32(edge0.m_dx, 0) * (blockW - 1) + core_mini32(edge0.m_dy, 0) * (blockH - 1) + w0_sampleMin)
+				| (w1_block + core_mini32(edge1.m_dx, 0) * (blockW - 1) + core_mini32(edge1.m_dy, 0) * (blockH - 1) + w1_sampleMin)
+				| (w2_block + core_mini32(edge2.m_dx, 0) * (blockW - 1) + core_mini32(edge2.m_dy, 0) * (blockH - 1) + w2_sampleMin)
+				;
+			if (coarseAccept >= 0) {
+				// The whole block is inside the triangle. No need to calculate coverage masks.
+				if (constColor) {
+					for (uint32_t i = 0; i < numSamples; ++i) {
+						rasterizeBlock_constColor(color0, blockW, blockH, &frameBuffer[i * sampleStride + blockX + blockY * ctx->m_Width], ctx->m_Width, canStream, blendMode);
+					}
+					streamed = streamed || canStream;
+				} else {
+					int32_t w0_y = w0_block;
+					int32_t w1_y = w1_block;
+					for (int32_t tileY = blockY; tileY < blockY + blockH; tileY += 4) {
+						int32_t w0_tileMin = w0_y;
+						int32_t w1_tileMin = w1_y;
+						for (int32_t tileX = blockX; tileX < blockX + blockW; tileX += 4) {
+							swr_tile_desc* tile = &tiles[numTiles];
+							for (uint32_t i = 0; i < numSamples; ++i) {
+								tile->m_CoverageMask[i] = 0x0000FFFFu;
+							}
+							tile->m_FrameBufferOffset = tileX + tileY * ctx->m_Width;
+							tile->m_BarycentricCoords[0] = w0_tileMin;
+							tile->m_BarycentricCoords[1] = w1_tileMin;
+							++numTiles;
+
+							w0_tileMin += edge0.m_dx << 2;
+							w1_tileMin += edge1.m_dx << 2;
+						}
+
+						w0_y += edge0.m_dy << 2;
+						w1_y += edge1.m_dy << 2;
+					}
+				}
+
+				w0_block += edge0.m_dx * coarseBlockSize;
+				w1_block += edge1.m_dx * coarseBlockSize;
+				w2_block += edge2.m_dx * coarseBlockSize;
+				continue;
 			}
 
-			w0_tileMin += edge0.m_dx << 2;
-			w1_tileMin += edge1.m_dx << 2;
-			w2_tileMin += edge2.m_dx << 2;
+			// Partially covered block. Go down to the 4x4 tiles.
+			int32_t w0_y = w0_block;
+			int32_t w1_y = w1_block;
+			int32_t w2_y = w2_block;
+			for (int32_t tileY = blockY; tileY < blockY + blockH; tileY += 4) {
+				int32_t w0_tileMin = w0_y;
+				int32_t w1_tileMin = w1_y;
+				int32_t w2_tileMin = w2_y;
+				for (int32_t tileX = blockX; tileX < blockX + blockW; tileX += 4) {
+					const int32_t w0_trivialReject = w0_tileMin + trivialRejectOffset0;
+					const int32_t w1_trivialReject = w1_tileMin + trivialRejectOffset1;
+					const int32_t w2_trivialReject = w2_tileMin + trivialRejectOffset2;
+					const int32_t trivialReject = w0_trivialReject | w1_trivialReject | w2_trivialReject;
+					if (trivialReject < 0) {
+						w0_tileMin += edge0.m_dx << 2;
+						w1_tileMin += edge1.m_dx << 2;
+						w2_tileMin += edge2.m_dx << 2;
+						continue;
+					}
+
+					uint32_t coverageMask[SWR_CONFIG_MAX_SAMPLES];
+					uint32_t anyCoverage = 0;
+					for (uint32_t i = 0; i < numSamples; ++i) {
+						const vec4i v_w0_row0 = vec4i_add(vec4i_fromInt(w0_tileMin + w0_sampleOffsets[i]), v_edge0_dx_off);
+						const vec4i v_w1_row0 = vec4i_add(vec4i_fromInt(w1_tileMin + w1_sampleOffsets[i]), v_edge1_dx_off);
+						const vec4i v_w2_row0 = vec4i_add(vec4i_fromInt(w2_tileMin + w2_sampleOffsets[i]), v_edge2_dx_off);
+						coverageMask[i] = swr_tileCoverageMask(v_w0_row0, v_w1_row0, v_w2_row0, v_edge0_dy, v_edge1_dy, v_edge2_dy, v_edge0_dy2, v_edge1_dy2, v_edge2_dy2, v_edge0_dy3, v_edge1_dy3, v_edge2_dy3);
+						anyCoverage |= coverageMask[i];
+					}
+
+					if (anyCoverage != 0) {
+						if (constColor) {
+							// Nothing to interpolate. Fill the tile right away.
+							for (uint32_t i = 0; i < numSamples; ++i) {
+								rasterizeTile4x4_constColor(color0, coverageMask[i], &frameBuffer[i * sampleStride + tileX + tileY * ctx->m_Width], ctx->m_Width, blendMode);
+							}
+						} else {
+							swr_tile_desc* tile = &tiles[numTiles];
+							for (uint32_t i = 0; i < numSamples; ++i) {
+								tile->m_CoverageMask[i] = coverageMask[i];
+							}
+							tile->m_FrameBufferOffset = tileX + tileY * ctx->m_Width;
+							tile->m_BarycentricCoords[0] = w0_tileMin;
+							tile->m_BarycentricCoords[1] = w1_tileMin;
+							++numTiles;
+						}
+					}
+
+					w0_tileMin += edge0.m_dx << 2;
+					w1_tileMin += edge1.m_dx << 2;
+					w2_tileMin += edge2.m_dx << 2;
+				}
+
+				w0_y += edge0.m_dy << 2;
+				w1_y += edge1.m_dy << 2;
+				w2_y += edge2.m_dy << 2;
+			}
+
+			w0_block += edge0.m_dx * coarseBlockSize;
+			w1_block += edge1.m_dx * coarseBlockSize;
+			w2_block += edge2.m_dx * coarseBlockSize;
 		}
 
-		w0_y += edge0.m_dy << 2;
-		w1_y += edge1.m_dy << 2;
-		w2_y += edge2.m_dy << 2;
+		w0_blockY += edge0.m_dy * coarseBlockSize;
+		w1_blockY += edge1.m_dy * coarseBlockSize;
+		w2_blockY += edge2.m_dy * coarseBlockSize;
 	}
 
-#if !SWR_CONFIG_DISABLE_PIXEL_SHADERS
-	// Prepare interpolated attributes
-	const vec4f v_c0 = vec4f_fromRGBA8(color0);
-	const vec4f v_c1 = vec4f_fromRGBA8(color1);
-	const vec4f v_c2 = vec4f_fromRGBA8(color2);
-	const vec4f v_c02 = vec4f_sub(v_c0, v_c2);
-	const vec4f v_c12 = vec4f_sub(v_c1, v_c2);
+	if (streamed) {
+		// Make the streaming stores globally visible before anyone reads the framebuffer.
+		_mm_sfence();
+	}
 
-	const swr_vertex_attrib_data va_r = swr_vertexAttribInit(vec4f_getX(v_c2), vec4f_getX(v_c02), vec4f_getX(v_c12));
-	const swr_vertex_attrib_data va_g = swr_vertexAttribInit(vec4f_getY(v_c2), vec4f_getY(v_c02), vec4f_getY(v_c12));
-	const swr_vertex_attrib_data va_b = swr_vertexAttribInit(vec4f_getZ(v_c2), vec4f_getZ(v_c02), vec4f_getZ(v_c12));
-	const swr_vertex_attrib_data va_a = swr_vertexAttribInit(vec4f_getW(v_c2), vec4f_getW(v_c02), vec4f_getW(v_c12));
+	if (constColor) {
+		return;
+	}
 
-	// Barycentric coordinate normalization
-	const vec4f v_inv_area = vec4f_fromFloat(1.0f / (float)iarea);
+#if !SWR_CONFIG_DISABLE_PIXEL_SHADERS
+	// Barycentric coordinate normalization. The edge functions have been divided by 
+	// the sub-pixel step so the area has to be as well.
+	const vec4f v_inv_area = vec4f_fromFloat((float)(1 << SWR_CONFIG_SUBPIXEL_BITS) / (float)iarea);
 
 	const vec4f v_dl0 = vec4f_mul(vec4f_fromVec4i(v_edge0_dy), v_inv_area);
 	const vec4f v_dl1 = vec4f_mul(vec4f_fromVec4i(v_edge1_dy), v_inv_area);
+
+	// Per-triangle pixel shader inputs
+	swr_pixel_shader_data ps;
+	if (pixelShader == SWR_PIXEL_SHADER_VERTEX_COLOR) {
+		const vec4f v_c0 = vec4f_fromRGBA8(color0);
+		const vec4f v_c1 = vec4f_fromRGBA8(color1);
+		const vec4f v_c2 = vec4f_fromRGBA8(color2);
+		const vec4f v_c02 = vec4f_sub(v_c0, v_c2);
+		const vec4f v_c12 = vec4f_sub(v_c1, v_c2);
+
+		ps.m_Attribs[0] = swr_vertexAttribInit(vec4f_getX(v_c2), vec4f_getX(v_c02), vec4f_getX(v_c12));
+		ps.m_Attribs[1] = swr_vertexAttribInit(vec4f_getY(v_c2), vec4f_getY(v_c02), vec4f_getY(v_c12));
+		ps.m_Attribs[2] = swr_vertexAttribInit(vec4f_getZ(v_c2), vec4f_getZ(v_c02), vec4f_getZ(v_c12));
+		ps.m_Attribs[3] = swr_vertexAttribInit(vec4f_getW(v_c2), vec4f_getW(v_c02), vec4f_getW(v_c12));
+	} else if (pixelShader == SWR_PIXEL_SHADER_TEXTURE) {
+		// Texture coordinates in texels of the triangle's mip level (see swrTexCoordToTexel).
+		const swr_texture_level* texture = swrTextureSelectLevel(ctx->m_Texture, x0, y0, x1, y1, x2, y2, texCoords);
+		const float s0 = swrTexCoordToTexel(texCoords[0], texture->m_Width, textureFilter);
+		const float t0 = swrTexCoordToTexel(texCoords[1], texture->m_Height, textureFilter);
+		const float s1 = swrTexCoordToTexel(texCoords[2], texture->m_Width, textureFilter);
+		const float t1 = swrTexCoordToTexel(texCoords[3], texture->m_Height, textureFilter);
+		const float s2 = swrTexCoordToTexel(texCoords[4], texture->m_Width, textureFilter);
+		const float t2 = swrTexCoordToTexel(texCoords[5], texture->m_Height, textureFilter);
+		ps.m_Attribs[0] = swr_vertexAttribInit(s2, s0 - s2, s1 - s2);
+		ps.m_Attribs[1] = swr_vertexAttribInit(t2, t0 - t2, t1 - t2);
+		ps.m_Texture = texture;
+	} else {
+		ps.m_Func = ctx->m_PixelShader;
+		ps.m_UserData = ctx->m_PixelShaderUserData;
+		ps.m_VertexColors[0] = color0;
+		ps.m_VertexColors[1] = color1;
+		ps.m_VertexColors[2] = color2;
+		ps.m_FrameBufferWidth = ctx->m_Width;
+		ps.m_VaryingLayout = varyings != NULL ? &ctx->m_VaryingLayout : NULL;
+		if (varyings != NULL) {
+			const uint32_t n = ctx->m_VaryingLayout.m_NumVaryings;
+			for (uint32_t i = 0; i < n; ++i) {
+				const float v2 = varyings[n * 2 + i];
+				ps.m_Varyings[i] = swr_vertexAttribInit(v2, varyings[i] - v2, varyings[n + i] - v2);
+			}
+		}
+	}
 #endif
 
 	for (uint32_t iTile = 0; iTile < numTiles; ++iTile) {
 		const swr_tile_desc* tile = &tiles[iTile];
 #if SWR_CONFIG_DISABLE_PIXEL_SHADERS
-		rasterizeTile4x4_constColor(0xFFFFFFFFu, tile->m_CoverageMask, &ctx->m_FrameBuffer[tile->m_FrameBufferOffset], ctx->m_Width);
+		for (uint32_t i = 0; i < numSamples; ++i) {
+			rasterizeTile4x4_constColor(0xFFFFFFFFu, tile->m_CoverageMask[i], &frameBuffer[i * sampleStride + tile->m_FrameBufferOffset], ctx->m_Width, blendMode);
+		}
 #else
 		const vec4i v_w0_row0 = vec4i_add(vec4i_fromInt(tile->m_BarycentricCoords[0]), v_edge0_dx_off);
 		const vec4i v_w1_row0 = vec4i_add(vec4i_fromInt(tile->m_BarycentricCoords[1]), v_edge1_dx_off);
 		const vec4f v_l0 = vec4f_mul(vec4f_fromVec4i(v_w0_row0), v_inv_area);
 		const vec4f v_l1 = vec4f_mul(vec4f_fromVec4i(v_w1_row0), v_inv_area);
-		rasterizeTile4x4_varColor(
+		rasterizeTile4x4_shaded(
+			pixelShader,
+			&ps,
+			textureFilter,
 			v_l0, v_l1,
 			v_dl0, v_dl1,
-			va_r,
-			va_g,
-			va_b,
-			va_a,
-			tile->m_CoverageMask,
-			&ctx->m_FrameBuffer[tile->m_FrameBufferOffset],
-			ctx->m_Width
+			tile,
+			numSamples,
+			&frameBuffer[tile->m_FrameBufferOffset],
+			ctx->m_Width,
+			sampleStride,
+			blendMode
 		);
 #endif
 	}
 }
+
+// Each blend mode gets its own copy of the rasterizer so the opaque path doesn't pay
+// for blending. Multisampled triangles share a single copy which checks the blend 
+// mode at runtime; the per-sample stores dominate there anyway.
+void swrDrawTriangleSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2)
+{
+	// Custom pixel shaders are called through a pointer once per tile, which costs a lot 
+	// more than checking the blend mode, so they share a single copy of the rasterizer.
+	if (ctx->m_PixelShader != NULL) {
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color0, color1, color2, false, ctx->m_BlendMode, ctx->m_NumSamples != 1, SWR_PIXEL_SHADER_CUSTOM, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		return;
+	}
+
+	if (ctx->m_NumSamples != 1) {
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color0, color1, color2, false, ctx->m_BlendMode, true, SWR_PIXEL_SHADER_VERTEX_COLOR, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		return;
+	}
+
+	switch (ctx->m_BlendMode) {
+	case SWR_BLEND_MODE_SRC_OVER:
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color0, color1, color2, false, SWR_BLEND_MODE_SRC_OVER, false, SWR_PIXEL_SHADER_VERTEX_COLOR, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		break;
+	case SWR_BLEND_MODE_ADDITIVE:
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color0, color1, color2, false, SWR_BLEND_MODE_ADDITIVE, false, SWR_PIXEL_SHADER_VERTEX_COLOR, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		break;
+	case SWR_BLEND_MODE_MULTIPLY:
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color0, color1, color2, false, SWR_BLEND_MODE_MULTIPLY, false, SWR_PIXEL_SHADER_VERTEX_COLOR, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		break;
+	default:
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color0, color1, color2, false, SWR_BLEND_MODE_OPAQUE, false, SWR_PIXEL_SHADER_VERTEX_COLOR, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		break;
+	}
+}
+
+void swrDrawTriangleFlatSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+{
+	// Pixel shaders get the same inputs as for any other triangle.
+	if (ctx->m_PixelShader != NULL) {
+		swrDrawTriangleSSE2(ctx, x0, y0, x1, y1, x2, y2, color, color, color);
+		return;
+	}
+
+	if (ctx->m_NumSamples != 1) {
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color, color, color, true, ctx->m_BlendMode, true, SWR_PIXEL_SHADER_VERTEX_COLOR, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		return;
+	}
+
+	switch (ctx->m_BlendMode) {
+	case SWR_BLEND_MODE_SRC_OVER:
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color, color, color, true, SWR_BLEND_MODE_SRC_OVER, false, SWR_PIXEL_SHADER_VERTEX_COLOR, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		break;
+	case SWR_BLEND_MODE_ADDITIVE:
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color, color, color, true, SWR_BLEND_MODE_ADDITIVE, false, SWR_PIXEL_SHADER_VERTEX_COLOR, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		break;
+	case SWR_BLEND_MODE_MULTIPLY:
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color, color, color, true, SWR_BLEND_MODE_MULTIPLY, false, SWR_PIXEL_SHADER_VERTEX_COLOR, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		break;
+	default:
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, color, color, color, true, SWR_BLEND_MODE_OPAQUE, false, SWR_PIXEL_SHADER_VERTEX_COLOR, NULL, SWR_TEXTURE_FILTER_NEAREST);
+		break;
+	}
+}
+
+static __forceinline void drawTriangleTextured_filter(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv, uint32_t blendMode)
+{
+	if (ctx->m_TextureFilter == SWR_TEXTURE_FILTER_BILINEAR) {
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, 0, 0, 0, false, blendMode, false, SWR_PIXEL_SHADER_TEXTURE, uv, SWR_TEXTURE_FILTER_BILINEAR);
+	} else {
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, 0, 0, 0, false, blendMode, false, SWR_PIXEL_SHADER_TEXTURE, uv, SWR_TEXTURE_FILTER_NEAREST);
+	}
+}
+
+// Textured triangles are specialized on both the blend mode and the texture filter.
+void swrDrawTriangleTexturedSSE2(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv)
+{
+	if (ctx->m_Texture == NULL) {
+		return;
+	}
+
+	if (ctx->m_NumSamples != 1) {
+		drawTriangle_internal(ctx, x0, y0, x1, y1, x2, y2, 0, 0, 0, false, ctx->m_BlendMode, true, SWR_PIXEL_SHADER_TEXTURE, uv, ctx->m_TextureFilter);
+		return;
+	}
+
+	switch (ctx->m_BlendMode) {
+	case SWR_BLEND_MODE_SRC_OVER:
+		drawTriangleTextured_filter(ctx, x0, y0, x1, y1, x2, y2, uv, SWR_BLEND_MODE_SRC_OVER);
+		break;
+	case SWR_BLEND_MODE_ADDITIVE:
+		drawTriangleTextured_filter(ctx, x0, y0, x1, y1, x2, y2, uv, SWR_BLEND_MODE_ADDITIVE);
+		break;
+	case SWR_BLEND_MODE_MULTIPLY:
+		drawTriangleTextured_filter(ctx, x0, y0, x1, y1, x2, y2, uv, SWR_BLEND_MODE_MULTIPLY);
+		break;
+	default:
+		drawTriangleTextured_filter(ctx, x0, y0, x1, y1, x2, y2, uv, SWR_BLEND_MODE_OPAQUE);
+		break;
+	}
+}
@@ -0,0 +1,81 @@
+#include "swr.h"
+#include "swr_p.h"
+
+static inline uint32_t swrGetIndex(const void* indices, bool is32Bit, uint32_t i)
+{
+	return is32Bit
+		? ((const uint32_t*)indices)[i]
+		: (uint32_t)((const uint16_t*)indices)[i]
+		;
+}
+
+// Index i of a strip (i >= 2) adds triangle (i - 2, i - 1, i) and index i of a fan adds 
+// triangle (first, i - 1, i), where 'first' is the first index after the last restart.
+uint32_t swrAssembleTrianglesRef(swr_primitive_type primType, swr_format indexFormat, uint32_t numIndices, const void* indices, uint32_t* triangles)
+{
+	const bool is32Bit = indexFormat == SWR_FORMAT_1UI;
+	const uint32_t restartIndex = is32Bit
+		? SWR_PRIMITIVE_RESTART_INDEX_32
+		: SWR_PRIMITIVE_RESTART_INDEX_16
+		;
+	const bool isStrip = primType == SWR_PRIMITIVE_TYPE_TRIANGLE_STRIP;
+	if (!isStrip && primType != SWR_PRIMITIVE_TYPE_TRIANGLE_FAN) {
+		return 0;
+	}
+
+	uint32_t numTriangles = 0;
+	uint32_t first = 0;
+	for (uint32_t i = 0; i < numIndices; ++i) {
+		const uint32_t id = swrGetIndex(indices, is32Bit, i);
+		if (id == restartIndex) {
+			first = i + 1;
+			continue;
+		}
+
+		if (i < first + 2) {
+			continue;
+		}
+
+		uint32_t* tri = &triangles[numTriangles * 3];
+		if (!isStrip) {
+			tri[0] = swrGetIndex(indices, is32Bit, first);
+			tri[1] = swrGetIndex(indices, is32Bit, i - 1);
+		} else if (((i - first) & 1) == 0) {
+			tri[0] = swrGetIndex(indices, is32Bit, i - 2);
+			tri[1] = swrGetIndex(indices, is32Bit, i - 1);
+		} else {
+			tri[0] = swrGetIndex(indices, is32Bit, i - 1);
+			tri[1] = swrGetIndex(indices, is32Bit, i - 2);
+		}
+		tri[2] = id;
+
+		++numTriangles;
+	}
+
+	return numTriangles;
+}
+
+bool swrRebaseIndicesRef(uint32_t numIndices, const uint32_t* indices, uint16_t* rebased, uint32_t* base)
+{
+	uint32_t minIndex = UINT32_MAX;
+	uint32_t maxIndex = 0;
+	for (uint32_t i = 0; i < numIndices; ++i) {
+		minIndex = core_minu32(minIndex, indices[i]);
+		maxIndex = core_maxu32(maxIndex, indices[i]);
+	}
+
+	if (minIndex > maxIndex) {
+		*base = 0;
+		return true;
+	} else if (maxIndex - minIndex > UINT16_MAX) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < numIndices; ++i) {
+		rebased[i] = (uint16_t)(indices[i] - minIndex);
+	}
+
+	*base = minIndex;
+
+	return true;
+}
@@ -0,0 +1,190 @@
+#include "swr.h"
+#include "swr_p.h"
+
+#define SWR_VEC_MATH_SSE2
+#include "swr_vec_math.h"
+
+static inline uint32_t swrGetIndex(const void* indices, bool is32Bit, uint32_t i)
+{
+	return is32Bit
+		? ((const uint32_t*)indices)[i]
+		: (uint32_t)((const uint16_t*)indices)[i]
+		;
+}
+
+// 4 indices starting at 'i', widened to 32 bits.
+static inline vec4i swrLoadIndices(const void* indices, bool is32Bit, uint32_t i)
+{
+	return is32Bit
+		? vec4i_fromInt4vu((const int32_t*)&((const uint32_t*)indices)[i])
+		: vec4i_fromUint16x4vu(&((const uint16_t*)indices)[i])
+		;
+}
+
+// Same as swrAssembleTrianglesRef. Runs of 6 strip indices or 5 fan indices without restarts 
+// are turned into 4 triangles at a time by shuffling the indices into place. Strip runs 
+// always start at an even triangle so the winding pattern is the same for all of them.
+uint32_t swrAssembleTrianglesSSE2(swr_primitive_type primType, swr_format indexFormat, uint32_t numIndices, const void* indices, uint32_t* triangles)
+{
+	const bool is32Bit = indexFormat == SWR_FORMAT_1UI;
+	const uint32_t restartIndex = is32Bit
+		? SWR_PRIMITIVE_RESTART_INDEX_32
+		: SWR_PRIMITIVE_RESTART_INDEX_16
+		;
+	const vec4i v_restartIndex = vec4i_fromInt((int32_t)restartIndex);
+
+	uint32_t numTriangles = 0;
+	if (primType == SWR_PRIMITIVE_TYPE_TRIANGLE_STRIP) {
+		// 't' is the first index of the next triangle and 'first' the first index of the current strip.
+		uint32_t first = 0;
+		uint32_t t = 0;
+		while (t + 2 < numIndices) {
+			if (((t - first) & 1) == 0 && t + 6 <= numIndices) {
+				const vec4i v_a = swrLoadIndices(indices, is32Bit, t);
+				const vec4i v_b = swrLoadIndices(indices, is32Bit, t + 2);
+				const vec4i v_restart = vec4i_or(vec4i_cmpeq(v_a, v_restartIndex), vec4i_cmpeq(v_b, v_restartIndex));
+				if (vec4i_getSignMask(v_restart) == 0) {
+					// (a0, a1, a2), (a2, a1, a3), (a2, a3, b2), (b2, a3, b3)
+					int32_t* dst = (int32_t*)&triangles[numTriangles * 3];
+					vec4i_toInt4vu(vec4i_shuffle(v_a, v_a, VEC4_SHUFFLE_MASK(0, 1, 2, 2)), &dst[0]);
+					vec4i_toInt4vu(vec4i_shuffle(v_a, v_a, VEC4_SHUFFLE_MASK(1, 3, 2, 3)), &dst[4]);
+					vec4i_toInt4vu(vec4i_shuffle(v_b, v_b, VEC4_SHUFFLE_MASK(2, 2, 1, 3)), &dst[8]);
+					numTriangles += 4;
+					t += 4;
+					continue;
+				}
+			}
+
+			const uint32_t id0 = swrGetIndex(indices, is32Bit, t);
+			const uint32_t id1 = swrGetIndex(indices, is32Bit, t + 1);
+			const uint32_t id2 = swrGetIndex(indices, is32Bit, t + 2);
+			if (id2 == restartIndex) {
+				first = t + 3;
+			} else if (id1 == restartIndex) {
+				first = t + 2;
+			} else if (id0 == restartIndex) {
+				first = t + 1;
+			}
+
+			if (first > t) {
+				t = first;
+				continue;
+			}
+
+			uint32_t* tri = &triangles[numTriangles * 3];
+			const bool isOdd = ((t - first) & 1) != 0;
+			tri[0] = isOdd ? id1 : id0;
+			tri[1] = isOdd ? id0 : id1;
+			tri[2] = id2;
+			++numTriangles;
+			++t;
+		}
+	} else if (primType == SWR_PRIMITIVE_TYPE_TRIANGLE_FAN) {
+		uint32_t i = 0;
+		while (i < numIndices) {
+			const uint32_t center = swrGetIndex(indices, is32Bit, i++);
+			if (center == restartIndex) {
+				continue;
+			}
+
+			// 'i' is the second vertex of the next triangle of the fan.
+			const vec4i v_center = vec4i_fromInt((int32_t)center);
+			while (i + 1 < numIndices) {
+				if (i + 5 <= numIndices) {
+					const vec4i v_a = swrLoadIndices(indices, is32Bit, i);
+					const vec4i v_b = swrLoadIndices(indices, is32Bit, i + 1);
+					const vec4i v_restart = vec4i_or(vec4i_cmpeq(v_a, v_restartIndex), vec4i_cmpeq(v_b, v_restartIndex));
+					if (vec4i_getSignMask(v_restart) == 0) {
+						// (c, a0, b0), (c, a1, b1), (c, a2, b2), (c, a3, b3)
+						const vec4i v_ab01 = vec4i_shuffle(v_a, v_b, VEC4_SHUFFLE_MASK(0, 1, 0, 1));
+						const vec4i v_ab23 = vec4i_shuffle(v_a, v_b, VEC4_SHUFFLE_MASK(2, 3, 2, 3));
+						const vec4i v_cca0b0 = vec4i_shuffle(v_center, v_ab01, VEC4_SHUFFLE_MASK(0, 0, 0, 2));
+						const vec4i v_cca2a2 = vec4i_shuffle(v_center, v_ab23, VEC4_SHUFFLE_MASK(0, 0, 0, 0));
+						const vec4i v_b2b2cc = vec4i_shuffle(v_ab23, v_center, VEC4_SHUFFLE_MASK(2, 2, 0, 0));
+
+						int32_t* dst = (int32_t*)&triangles[numTriangles * 3];
+						vec4i_toInt4vu(vec4i_shuffle(v_cca0b0, v_cca0b0, VEC4_SHUFFLE_MASK(0, 2, 3, 0)), &dst[0]);
+						vec4i_toInt4vu(vec4i_shuffle(v_ab01, v_cca2a2, VEC4_SHUFFLE_MASK(1, 3, 0, 2)), &dst[4]);
+						vec4i_toInt4vu(vec4i_shuffle(v_b2b2cc, v_ab23, VEC4_SHUFFLE_MASK(0, 2, 1, 3)), &dst[8]);
+						numTriangles += 4;
+						i += 4;
+						continue;
+					}
+				}
+
+				const uint32_t id1 = swrGetIndex(indices, is32Bit, i);
+				const uint32_t id2 = swrGetIndex(indices, is32Bit, i + 1);
+				if (id1 == restartIndex) {
+					i += 1;
+					break;
+				} else if (id2 == restartIndex) {
+					i += 2;
+					break;
+				}
+
+				uint32_t* tri = &triangles[numTriangles * 3];
+				tri[0] = center;
+				tri[1] = id1;
+				tri[2] = id2;
+				++numTriangles;
+				++i;
+			}
+		}
+	}
+
+	return numTriangles;
+}
+
+// Same as swrRebaseIndicesRef. Indices are biased by 0x80000000 for the signed min/max.
+bool swrRebaseIndicesSSE2(uint32_t numIndices, const uint32_t* indices, uint16_t* rebased, uint32_t* base)
+{
+	const vec4i v_bias = vec4i_fromInt(INT32_MIN);
+
+	vec4i v_min = vec4i_fromInt(INT32_MAX);
+	vec4i v_max = vec4i_fromInt(INT32_MIN);
+	const uint32_t numIter4 = numIndices >> 2;
+	for (uint32_t i = 0; i < numIter4; ++i) {
+		const vec4i v_indices = vec4i_xor(vec4i_fromInt4vu((const int32_t*)&indices[i << 2]), v_bias);
+		v_min = vec4i_min(v_min, v_indices);
+		v_max = vec4i_max(v_max, v_indices);
+	}
+
+	int32_t minArr[4];
+	int32_t maxArr[4];
+	vec4i_toInt4vu(vec4i_xor(v_min, v_bias), minArr);
+	vec4i_toInt4vu(vec4i_xor(v_max, v_bias), maxArr);
+
+	uint32_t minIndex = UINT32_MAX;
+	uint32_t maxIndex = 0;
+	for (uint32_t i = 0; i < 4; ++i) {
+		minIndex = core_minu32(minIndex, (uint32_t)minArr[i]);
+		maxIndex = core_maxu32(maxIndex, (uint32_t)maxArr[i]);
+	}
+	for (uint32_t i = numIter4 << 2; i < numIndices; ++i) {
+		minIndex = core_minu32(minIndex, indices[i]);
+		maxIndex = core_maxu32(maxIndex, indices[i]);
+	}
+
+	if (minIndex > maxIndex) {
+		*base = 0;
+		return true;
+	} else if (maxIndex - minIndex > UINT16_MAX) {
+		return false;
+	}
+
+	const vec4i v_base = vec4i_fromInt((int32_t)minIndex);
+	const uint32_t numIter8 = numIndices >> 3;
+	for (uint32_t i = 0; i < numIter8; ++i) {
+		const int32_t* src = (const int32_t*)&indices[i << 3];
+		const vec4i v_a = vec4i_sub(vec4i_fromInt4vu(&src[0]), v_base);
+		const vec4i v_b = vec4i_sub(vec4i_fromInt4vu(&src[4]), v_base);
+		vec4i_toUint16x8vu(v_a, v_b, &rebased[i << 3]);
+	}
+	for (uint32_t i = numIter8 << 3; i < numIndices; ++i) {
+		rebased[i] = (uint16_t)(indices[i] - minIndex);
+	}
+
+	*base = minIndex;
+
+	return true;
+}
@@ -0,0 +1,282 @@
+#include "swr.h"
+#include "swr_p.h"
+
+// Writes 'n' pixels starting at 'dst', 'step' pixels apart, to all sample planes. Contiguous
+// spans are written by swr->fillSpan.
+static inline void swrDrawLineSpan(swr_context* ctx, uint32_t* dst, int32_t step, int32_t n, uint32_t color)
+{
+	const uint32_t blendMode = ctx->m_BlendMode;
+	for (uint32_t iSample = 0; iSample < ctx->m_NumSamples; ++iSample) {
+		uint32_t* fb = dst + iSample * ctx->m_SampleStride;
+		if (step == 1) {
+			swr->fillSpan(fb, (uint32_t)n, color, blendMode);
+		} else {
+			for (int32_t i = 0; i < n; ++i) {
+				*fb = blendMode == SWR_BLEND_MODE_OPAQUE ? color : swrBlendColor(color, *fb, blendMode);
+				fb += step;
+			}
+		}
+	}
+}
+
+// Same as swrDrawLineSpan for anti-aliased lines. The first pixel is at distance 'd0' from
+// the line (see swrLineCoverageAlpha).
+static inline void swrDrawLineSpanCoverage(swr_context* ctx, uint32_t* dst, int32_t step, int32_t n, uint32_t color, float d0, float halfWidth, float alphaScale)
+{
+	const uint32_t rgb = color & 0x00FFFFFF;
+	for (uint32_t iSample = 0; iSample < ctx->m_NumSamples; ++iSample) {
+		uint32_t* fb = dst + iSample * ctx->m_SampleStride;
+		if (step == 1) {
+			swr->blendSpanCoverage(fb, (uint32_t)n, color, d0, halfWidth, alphaScale);
+		} else {
+			for (int32_t i = 0; i < n; ++i) {
+				const uint32_t alpha = swrLineCoverageAlpha(d0 + (float)i, halfWidth, alphaScale);
+				*fb = swrBlendColor(rgb | (alpha << 24), *fb, SWR_BLEND_MODE_SRC_OVER);
+				fb += step;
+			}
+		}
+	}
+}
+
+// Bresenham line from (x0, y0) to (x1, y1), in pixels, with both endpoints included.
+// The line is stepped along its major axis (u) and after k steps it has moved
+// m(k) = ceil((2 * k * dv - du) / (2 * du)) pixels along the minor axis (v). This is
+// used to clip the line to the scissor rect once, by solving for the range of k whose
+// pixels are inside it, and to write the pixels in spans of equal v without any
+// per-pixel tests.
+void swrRasterizeLine(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+	const bool steep = core_absi32(x0 - x1) < core_absi32(y0 - y1);
+	int32_t u0 = steep ? y0 : x0;
+	int32_t v0 = steep ? x0 : y0;
+	int32_t u1 = steep ? y1 : x1;
+	int32_t v1 = steep ? x1 : y1;
+	if (u0 > u1) {
+		{ int32_t tmp = u0; u0 = u1; u1 = tmp; }
+		{ int32_t tmp = v0; v0 = v1; v1 = tmp; }
+	}
+
+	const swr_rect* scissor = &ctx->m_ScissorRect;
+	const int32_t minU = steep ? scissor->m_MinY : scissor->m_MinX;
+	const int32_t maxU = steep ? scissor->m_MaxY : scissor->m_MaxX;
+	const int32_t minV = steep ? scissor->m_MinX : scissor->m_MinY;
+	const int32_t maxV = steep ? scissor->m_MaxX : scissor->m_MaxY;
+
+	const int64_t du = (int64_t)u1 - u0;
+	const int64_t dv = core_absi32(v1 - v0);
+	const int32_t vinc = v1 > v0 ? 1 : -1;
+
+	// Steps inside the scissor rect along u...
+	int64_t kMin = core_maxi32(minU - u0, 0);
+	int64_t kMax = core_mini32(maxU - u0, (int32_t)du);
+
+	// ...and along v, where m(k) must be in [mMin, mMax].
+	const int64_t mMin = vinc > 0 ? (int64_t)minV - v0 : (int64_t)v0 - maxV;
+	const int64_t mMax = vinc > 0 ? (int64_t)maxV - v0 : (int64_t)v0 - minV;
+	if (mMax < 0 || (mMin > 0 && dv == 0)) {
+		return;
+	}
+	if (mMin > 0) {
+		const int64_t num = 2 * du * mMin - du + 1;
+		kMin = core_maxi64(kMin, (num + 2 * dv - 1) / (2 * dv));
+	}
+	if (dv != 0) {
+		kMax = core_mini64(kMax, (2 * du * mMax + du) / (2 * dv));
+	}
+	if (kMin > kMax) {
+		return;
+	}
+
+	const int32_t width = (int32_t)ctx->m_Width;
+	const int32_t stepU = steep ? width : 1;
+	const int32_t stepV = steep ? vinc : vinc * width;
+
+	// Error term of the first visible pixel. m(k) only changes when it exceeds du.
+	int64_t m = du != 0 ? (2 * kMin * dv + du - 1) / (2 * du) : 0;
+	int64_t error2 = 2 * kMin * dv - 2 * du * m;
+
+	const int32_t u = u0 + (int32_t)kMin;
+	const int32_t v = v0 + vinc * (int32_t)m;
+	{
+		const int64_t mEnd = du != 0 ? (2 * kMax * dv + du - 1) / (2 * du) : 0;
+		const int32_t uEnd = u0 + (int32_t)kMax;
+		const int32_t vEnd = v0 + vinc * (int32_t)mEnd;
+		if (steep) {
+			swrTouchTiles(ctx, core_mini32(v, vEnd), u, core_maxi32(v, vEnd), uEnd);
+		} else {
+			swrTouchTiles(ctx, u, core_mini32(v, vEnd), uEnd, core_maxi32(v, vEnd));
+		}
+	}
+
+	uint32_t* dst = &ctx->m_SampleBuffer[steep ? (v + u * width) : (u + v * width)];
+
+	int64_t k = kMin;
+	while (k <= kMax) {
+		// Steps until the error term exceeds du, i.e. the length of the current span.
+		const int64_t spanLen = dv != 0
+			? core_mini64((du - error2) / (2 * dv) + 1, kMax - k + 1)
+			: kMax - k + 1
+			;
+
+		swrDrawLineSpan(ctx, dst, stepU, (int32_t)spanLen, color);
+
+		dst += stepU * (int32_t)spanLen + stepV;
+		error2 += spanLen * 2 * dv - 2 * du;
+		k += spanLen;
+	}
+}
+
+// Floor of a value which is known to fit in an int32_t.
+static inline int32_t swrFloorToInt(double x)
+{
+	const int32_t i = (int32_t)x;
+	return (double)i > x ? i - 1 : i;
+}
+
+static inline int32_t swrCeilToInt(double x)
+{
+	const int32_t i = (int32_t)x;
+	return (double)i < x ? i + 1 : i;
+}
+
+static inline double swrClampd(double x, double a, double b)
+{
+	return x < a ? a : (x > b ? b : x);
+}
+
+// Liang-Barsky clipping of the segment p0 + t * d, t in [t0, t1], against one boundary.
+// 'q' is the signed distance of p0 from the boundary (positive inside) and 'p' its rate of
+// change. Returns false if the segment is completely outside.
+static inline bool swrClipLineBoundary(double p, double q, double* t0, double* t1)
+{
+	if (p == 0.0) {
+		return q >= 0.0;
+	}
+
+	const double t = -q / p;
+	if (p > 0.0) {
+		*t0 = t > *t0 ? t : *t0;
+	} else {
+		*t1 = t < *t1 ? t : *t1;
+	}
+
+	return *t0 <= *t1;
+}
+
+// Wide and/or anti-aliased line from (x0, y0) to (x1, y1), in pixels. The line is stepped
+// along its major axis (u). Each column covers the pixels whose sample points are less than
+// hv = 0.5 * width * sqrt(1 + slope^2) away from the line's center c(u) along the minor
+// axis (v), so the line is 'width' pixels thick perpendicular to its direction. Its ends
+// are cut along v, half a pixel past both endpoints.
+// Anti-aliased pixels get the fraction of their area inside that shape as alpha (the
+// coverage along v times the coverage along u) and are always blended with
+// SWR_BLEND_MODE_SRC_OVER.
+// The center line is clipped once, with Liang-Barsky, against the scissor rect grown by the
+// line's extent. Columns outside the clipped segment are skipped and each column's v range
+// is clamped to the scissor rect, so pixels are written without any per-pixel tests. Rows
+// (steep lines) are contiguous and are written by swr->fillSpan/swr->blendSpanCoverage.
+void swrRasterizeWideLine(swr_context* ctx, double x0, double y0, double x1, double y1, float width, bool antiAliased, uint32_t color)
+{
+	const bool steep = (x1 - x0) * (x1 - x0) < (y1 - y0) * (y1 - y0);
+	double u0 = steep ? y0 : x0;
+	double v0 = steep ? x0 : y0;
+	double u1 = steep ? y1 : x1;
+	double v1 = steep ? x1 : y1;
+	if (u0 > u1) {
+		{ double tmp = u0; u0 = u1; u1 = tmp; }
+		{ double tmp = v0; v0 = v1; v1 = tmp; }
+	}
+
+	const swr_rect* scissor = &ctx->m_ScissorRect;
+	const int32_t minU = steep ? scissor->m_MinY : scissor->m_MinX;
+	const int32_t maxU = steep ? scissor->m_MaxY : scissor->m_MaxX;
+	const int32_t minV = steep ? scissor->m_MinX : scissor->m_MinY;
+	const int32_t maxV = steep ? scissor->m_MaxX : scissor->m_MaxY;
+
+	const double du = u1 - u0;
+	const double dv = v1 - v0;
+	const double slope = du != 0.0 ? dv / du : 0.0;
+	const float halfWidth = 0.5f * width * core_sqrtf(1.0f + (float)(slope * slope));
+	const double hv = (double)halfWidth;
+
+	// Clip the center line against the scissor rect grown by the largest distance of
+	// a touched pixel from it (half a pixel past the line's extent, plus a pixel of margin).
+	const double marginU = 2.0;
+	const double marginV = hv + 2.0;
+	double t0 = 0.0;
+	double t1 = 1.0;
+	if (!swrClipLineBoundary(du, u0 - (minU - marginU), &t0, &t1)
+		|| !swrClipLineBoundary(-du, (maxU + marginU) - u0, &t0, &t1)
+		|| !swrClipLineBoundary(dv, v0 - (minV - marginV), &t0, &t1)
+		|| !swrClipLineBoundary(-dv, (maxV + marginV) - v0, &t0, &t1)) {
+		return;
+	}
+
+	// Clipped column range. The line's ends are extended by half a pixel along u. The
+	// clipped u values are inside the grown scissor rect so they can be safely converted.
+	const double ue0 = u0 - 0.5;
+	const double ue1 = u1 + 0.5;
+	const double uc0 = t0 > 0.0 ? u0 + du * t0 - 1.0 : ue0;
+	const double uc1 = t1 < 1.0 ? u0 + du * t1 + 1.0 : ue1;
+	const double uMin = swrClampd(uc0, minU - marginU, maxU + marginU);
+	const double uMax = swrClampd(uc1, minU - marginU, maxU + marginU);
+	const int32_t uBegin = core_maxi32(antiAliased ? swrFloorToInt(uMin - 0.5) + 1 : swrCeilToInt(uMin), minU);
+	const int32_t uEnd = core_mini32(antiAliased ? swrCeilToInt(uMax + 0.5) - 1 : swrFloorToInt(uMax), maxU);
+	if (uBegin > uEnd) {
+		return;
+	}
+
+	const int32_t fbWidth = (int32_t)ctx->m_Width;
+	const int32_t stepU = steep ? fbWidth : 1;
+	const int32_t stepV = steep ? 1 : fbWidth;
+	const float srcAlpha = ctx->m_BlendMode == SWR_BLEND_MODE_OPAQUE
+		? 255.0f
+		: (float)(color >> 24)
+		;
+
+	// v range of the rows which can be written, grown by a few pixels so that clamped
+	// values still produce empty ranges when the line is outside the scissor rect.
+	const double vLo = (double)minV - hv - 4.0;
+	const double vHi = (double)maxV + hv + 4.0;
+
+	{
+		const double cBegin = swrClampd(v0 + slope * ((double)uBegin - u0), vLo, vHi);
+		const double cEnd = swrClampd(v0 + slope * ((double)uEnd - u0), vLo, vHi);
+		const int32_t vMin = core_maxi32(swrFloorToInt((cBegin < cEnd ? cBegin : cEnd) - hv - 1.0), minV);
+		const int32_t vMax = core_mini32(swrCeilToInt((cBegin < cEnd ? cEnd : cBegin) + hv + 1.0), maxV);
+		if (steep) {
+			swrTouchTiles(ctx, vMin, uBegin, vMax, uEnd);
+		} else {
+			swrTouchTiles(ctx, uBegin, vMin, uEnd, vMax);
+		}
+	}
+
+	for (int32_t u = uBegin; u <= uEnd; ++u) {
+		const double c = swrClampd(v0 + slope * ((double)u - u0), vLo, vHi);
+
+		int32_t vBegin, vEnd;
+		if (antiAliased) {
+			vBegin = swrFloorToInt(c - hv - 0.5) + 1;
+			vEnd = swrCeilToInt(c + hv + 0.5) - 1;
+		} else {
+			vBegin = swrCeilToInt(c - hv);
+			vEnd = swrCeilToInt(c + hv) - 1;
+		}
+
+		vBegin = core_maxi32(vBegin, minV);
+		vEnd = core_mini32(vEnd, maxV);
+		if (vBegin > vEnd) {
+			continue;
+		}
+
+		uint32_t* dst = &ctx->m_SampleBuffer[u * stepU + vBegin * stepV];
+		const int32_t n = vEnd - vBegin + 1;
+		if (antiAliased) {
+			const double coverageU = (u + 0.5 < ue1 ? u + 0.5 : ue1) - (u - 0.5 > ue0 ? u - 0.5 : ue0);
+			const float alphaScale = (float)swrClampd(coverageU, 0.0, 1.0) * srcAlpha;
+			swrDrawLineSpanCoverage(ctx, dst, stepV, n, color, (float)((double)vBegin - c), halfWidth, alphaScale);
+		} else {
+			swrDrawLineSpan(ctx, dst, stepV, n, color);
+		}
+	}
+}
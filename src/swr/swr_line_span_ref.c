@@ -0,0 +1,27 @@
+#include "swr.h"
+#include "swr_p.h"
+
+void swrFillSpanRef(uint32_t* dst, uint32_t n, uint32_t color, uint32_t blendMode)
+{
+	if (blendMode == SWR_BLEND_MODE_OPAQUE) {
+		for (uint32_t i = 0; i < n; ++i) {
+			dst[i] = color;
+		}
+	} else {
+		for (uint32_t i = 0; i < n; ++i) {
+			dst[i] = swrBlendColor(color, dst[i], blendMode);
+		}
+	}
+}
+
+// Pixel i is at distance d0 + i from the line (see swrLineCoverageAlpha). The result is always 
+// blended with SWR_BLEND_MODE_SRC_OVER.
+void swrBlendSpanCoverageRef(uint32_t* dst, uint32_t n, uint32_t color, float d0, float halfWidth, float alphaScale)
+{
+	const uint32_t rgb = color & 0x00FFFFFF;
+	for (uint32_t i = 0; i < n; ++i) {
+		const float d = d0 + (float)i;
+		const uint32_t alpha = swrLineCoverageAlpha(d, halfWidth, alphaScale);
+		dst[i] = swrBlendColor(rgb | (alpha << 24), dst[i], SWR_BLEND_MODE_SRC_OVER);
+	}
+}
@@ -0,0 +1,66 @@
+#include "swr.h"
+#include "swr_p.h"
+
+#define SWR_VEC_MATH_SSE2
+#include "swr_vec_math.h"
+
+// Same as swrFillSpanRef, 4 pixels at a time.
+void swrFillSpanSSE2(uint32_t* dst, uint32_t n, uint32_t color, uint32_t blendMode)
+{
+	const vec4i v_color = vec4i_fromInt((int32_t)color);
+
+	uint32_t i = 0;
+	if (blendMode == SWR_BLEND_MODE_OPAQUE) {
+		for (; i + 4 <= n; i += 4) {
+			vec4i_toInt4vu(v_color, (int32_t*)&dst[i]);
+		}
+		for (; i < n; ++i) {
+			dst[i] = color;
+		}
+	} else {
+		for (; i + 4 <= n; i += 4) {
+			const vec4i v_dst = vec4i_fromInt4vu((const int32_t*)&dst[i]);
+			const vec4i v_res = blendMode == SWR_BLEND_MODE_SRC_OVER
+				? vec4i_blendSrcOverRGBA8(v_color, v_dst)
+				: (blendMode == SWR_BLEND_MODE_ADDITIVE ? vec4i_blendAddRGBA8(v_color, v_dst) : vec4i_blendMulRGBA8(v_color, v_dst))
+				;
+			vec4i_toInt4vu(v_res, (int32_t*)&dst[i]);
+		}
+		for (; i < n; ++i) {
+			dst[i] = swrBlendColor(color, dst[i], blendMode);
+		}
+	}
+}
+
+// Same as swrBlendSpanCoverageRef, 4 pixels at a time. The coverage is computed with the 
+// same operations in the same order so both produce identical results.
+void swrBlendSpanCoverageSSE2(uint32_t* dst, uint32_t n, uint32_t color, float d0, float halfWidth, float alphaScale)
+{
+	const uint32_t rgb = color & 0x00FFFFFF;
+	const vec4i v_rgb = vec4i_fromInt((int32_t)rgb);
+	const vec4f v_d0 = vec4f_fromFloat(d0);
+	const vec4f v_half = vec4f_fromFloat(0.5f);
+	const vec4f v_zero = vec4f_zero();
+	const vec4f v_halfWidth = vec4f_fromFloat(halfWidth);
+	const vec4f v_negHalfWidth = vec4f_fromFloat(-halfWidth);
+	const vec4f v_alphaScale = vec4f_fromFloat(alphaScale);
+	const vec4i v_four = vec4i_fromInt(4);
+
+	vec4i v_i = vec4i_fromInt4(0, 1, 2, 3);
+	uint32_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		const vec4f v_d = vec4f_add(v_d0, vec4f_fromVec4i(v_i));
+		const vec4f v_coverage = vec4f_max(vec4f_sub(vec4f_min(vec4f_add(v_d, v_half), v_halfWidth), vec4f_max(vec4f_sub(v_d, v_half), v_negHalfWidth)), v_zero);
+		const vec4i v_alpha = vec4i_fromVec4f_trunc(vec4f_add(vec4f_mul(v_coverage, v_alphaScale), v_half));
+		const vec4i v_src = vec4i_or(v_rgb, vec4i_sal(v_alpha, 24));
+		const vec4i v_dst = vec4i_fromInt4vu((const int32_t*)&dst[i]);
+		vec4i_toInt4vu(vec4i_blendSrcOverRGBA8(v_src, v_dst), (int32_t*)&dst[i]);
+		v_i = vec4i_add(v_i, v_four);
+	}
+
+	for (; i < n; ++i) {
+		const float d = d0 + (float)i;
+		const uint32_t alpha = swrLineCoverageAlpha(d, halfWidth, alphaScale);
+		dst[i] = swrBlendColor(rgb | (alpha << 24), dst[i], SWR_BLEND_MODE_SRC_OVER);
+	}
+}
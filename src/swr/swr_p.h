@@ -2,8 +2,11 @@
 #define SWR_SWR_P_H
 
 #include <stdint.h>
+#include <math.h> // lrintf
 
 typedef struct core_allocator_i core_allocator_i;
+typedef struct core_os_thread core_os_thread;
+typedef struct core_os_semaphore core_os_semaphore;
 
 // Make sure enough memory is allocated for all version of drawTriangle function.
 // The tile buffers are used internally to keep track if tile info (might be different 
@@ -12,6 +15,49 @@ typedef struct core_allocator_i core_allocator_i;
 #define SWR_CONFIG_TILEBUF_TILE_HEIGHT 4
 #define SWR_CONFIG_TILEBUF_TILE_SIZE   64
 
+// Hierarchical rasterization. The drawTriangle kernels first classify square blocks 
+// of this size as fully outside, fully inside or partially covered and only run the 
+// per-pixel coverage tests for the latter. Must be a multiple of 8.
+#define SWR_CONFIG_COARSE_BLOCK_SIZE   32
+
+// Guard-band clipping. Triangles extending more than this many pixels past any edge 
+// of the framebuffer are clipped before rasterization. Everything else is rasterized 
+// as is and relies on the bounding box clamp and the edge functions.
+#define SWR_CONFIG_GUARD_BAND_SIZE     2048
+
+// Triangles whose bounding box spans at most this many pixel sample points in both 
+// directions skip tile traversal and are rasterized by swrDrawSmallTriangleRef.
+#define SWR_CONFIG_SMALL_TRIANGLE_SIZE 2
+
+// Maximum number of samples per pixel with multisample anti-aliasing (see setSampleCount).
+#define SWR_CONFIG_MAX_SAMPLES         8
+
+// Maximum number of triangles in a BVH leaf (see createBVH).
+#define SWR_CONFIG_BVH_LEAF_SIZE       64
+
+// BVH nodes deeper than this are split in half by triangle count instead of spatially. 
+// This bounds the depth of the tree, and the recursion of the build, for any mesh.
+#define SWR_CONFIG_BVH_MAX_SPATIAL_DEPTH 32
+
+// Maximum number of triangles per batch when drawing 32-bit index buffers, strips and 
+// fans. Each batch is rebased to 16-bit indices (see rebaseIndices).
+#define SWR_CONFIG_INDEX_BATCH_SIZE    1024
+
+// Binned rasterization. Bin dimensions must be multiples of the largest 
+// block size used by the drawTriangle kernels (8x4) so that a kernel never 
+// touches pixels outside the bin it has been asked to rasterize.
+#define SWR_CONFIG_BIN_WIDTH           64
+#define SWR_CONFIG_BIN_HEIGHT          64
+#define SWR_CONFIG_BIN_CHUNK_CAPACITY  62
+#define SWR_CONFIG_MAX_WORKER_THREADS  63
+
+// Framebuffer tiles, used for fast clears and dirty region tracking. Clearing only marks 
+// tiles as pending and each tile is filled with the clear color the first time something 
+// is drawn into it. Tiles are the same size as bins so that worker threads never share 
+// a tile.
+#define SWR_CONFIG_FB_TILE_WIDTH       SWR_CONFIG_BIN_WIDTH
+#define SWR_CONFIG_FB_TILE_HEIGHT      SWR_CONFIG_BIN_HEIGHT
+
 typedef struct swr_vertex_buffer
 {
 	const void* m_Ptr;
@@ -22,23 +68,514 @@ typedef struct swr_vertex_buffer
 
 typedef struct swr_index_buffer
 {
-	const uint16_t* m_Ptr;
+	const void* m_Ptr;
 	uint32_t m_Count;
-	uint32_t _padding;
+	uint32_t m_Format;
 } swr_index_buffer;
 
+// Vertex attributes interpolated for custom pixel shaders. Each component of each 
+// attribute is a separate scalar (varying), numbered in attribute order. Per-triangle 
+// varyings are stored vertex by vertex, m_NumVaryings floats each.
+typedef struct swr_varying_layout
+{
+	uint8_t m_FirstVarying[SWR_VERTEX_ATTRIB_COUNT];
+	uint8_t m_NumComponents[SWR_VERTEX_ATTRIB_COUNT]; // 0 if the attribute isn't interpolated
+	uint32_t m_NumVaryings;
+} swr_varying_layout;
+
+typedef struct swr_cluster_buffer
+{
+	const swr_cluster* m_Ptr;
+	uint32_t m_Count;
+	uint32_t m_NumTrianglesPerCluster;
+} swr_cluster_buffer;
+
+typedef struct swr_binner swr_binner;
+
+// BVH nodes are stored in depth-first order. A node's left child immediately follows it 
+// and m_SkipNodeID points past its subtree, so the tree can be traversed front to back 
+// without a stack. Leaves reference consecutive triangles so visible neighboring leaves 
+// can be rasterized as a single batch.
+typedef struct swr_bvh_node
+{
+	float m_BoundsMin[2];
+	float m_BoundsMax[2];
+	uint32_t m_SkipNodeID;
+	uint32_t m_FirstTriangle; // Leaves only
+	uint16_t m_NumTriangles;  // 0 for internal nodes
+	uint16_t m_MinVertex;     // Range of BVH vertices referenced by the leaf's triangles (inclusive)
+	uint16_t m_MaxVertex;
+	uint16_t _padding;
+} swr_bvh_node;
+
+typedef struct swr_bvh
+{
+	swr_bvh_node* m_Nodes;
+	uint16_t* m_Indices;   // Triangles in leaf order. Indices refer to BVH vertices.
+	uint16_t* m_VertexIDs; // BVH vertex -> vertex index in the original index buffer. Vertices are numbered in order of first use.
+	uint32_t m_NumNodes;
+	uint32_t m_NumTriangles;
+	uint32_t m_NumVertices;
+	uint32_t m_MaxVertexID; // Largest vertex index in the original index buffer
+} swr_bvh;
+
+// Textures are stored in 4x4 texel blocks, one 64-byte cache line each, with the blocks 
+// in row-major order. Neighboring texels in both directions mostly share cache lines, 
+// so sampling along rotated rows touches a lot fewer lines than a row-major image. 
+// Width and height are padded to whole blocks.
+#define SWR_TEXTURE_BLOCK_SIZE_LOG2 2
+
+// Enough for a full mip chain of the largest texture.
+#define SWR_TEXTURE_MAX_LEVELS 16
+
+typedef struct swr_texture_level
+{
+	const uint32_t* m_Pixels;
+	uint32_t m_Width;
+	uint32_t m_Height;
+	uint32_t m_BlockRowStride; // Texels per row of blocks
+} swr_texture_level;
+
+// Level i + 1 is the 2x2 box filtered level i, down to 1x1. Odd widths/heights are 
+// rounded down, dropping the last column/row of the larger level.
+typedef struct swr_texture
+{
+	uint32_t* m_Pixels; // All levels, in a single allocation
+	uint32_t m_NumLevels;
+	swr_texture_level m_Levels[SWR_TEXTURE_MAX_LEVELS];
+} swr_texture;
+
+// Glyphs are sorted by codepoint. Glyph indices of ASCII codepoints are looked up 
+// directly; everything else is binary searched.
+typedef struct swr_atlas_font
+{
+	uint8_t* m_Atlas;
+	swr_atlas_glyph* m_Glyphs;
+	uint32_t m_AtlasWidth;
+	uint32_t m_AtlasHeight;
+	uint32_t m_NumGlyphs;
+	swr_atlas_font_type m_Type;
+	float m_SDFRange;
+	int32_t m_FallbackGlyph; // -1 if the font has no fallback glyph
+	int32_t m_ASCIIGlyphs[128];
+} swr_atlas_font;
+
+// Fixed-point vertex position to pixel coordinate conversions. Rounding down gives the 
+// last pixel whose sample point is at or before the position, rounding up the first one 
+// at or after it and rounding to nearest the closest one.
+static inline int32_t swrSubpixelFloor(int32_t x)
+{
+	return x >> SWR_CONFIG_SUBPIXEL_BITS;
+}
+
+// a * b / 255, rounded to nearest, for a and b in [0, 255]. Same division as swrBlendColor.
+static inline uint32_t swrMulAlpha(uint32_t a, uint32_t b)
+{
+	const uint32_t t = a * b + 128;
+	return (t + (t >> 8)) >> 8;
+}
+
+// Alpha of an anti-aliased line pixel whose center is at signed distance 'd' from the 
+// line, along the minor axis. The pixel covers [d - 0.5, d + 0.5] and the line 
+// [-halfWidth, halfWidth]. The overlap is scaled by 'alphaScale' (at most 255).
+static inline uint32_t swrLineCoverageAlpha(float d, float halfWidth, float alphaScale)
+{
+	const float coverage = core_maxf(core_minf(d + 0.5f, halfWidth) - core_maxf(d - 0.5f, -halfWidth), 0.0f);
+	return (uint32_t)(coverage * alphaScale + 0.5f);
+}
+
+// Pixels of an 8-pixel glyph row window to write (see swr_api::blitGlyph). Bit x is set 
+// if window pixel x is covered by the glyph and not clipped.
+static inline uint32_t swrGlyphRowMask(uint8_t row, int32_t shift, uint32_t columnMask)
+{
+	const uint32_t bits = shift >= 0
+		? (uint32_t)row >> shift
+		: (uint32_t)row << -shift
+		;
+	return bits & columnMask;
+}
+
+static inline int32_t swrSubpixelCeil(int32_t x)
+{
+	return (x + (1 << SWR_CONFIG_SUBPIXEL_BITS) - 1) >> SWR_CONFIG_SUBPIXEL_BITS;
+}
+
+static inline int32_t swrSubpixelRound(int32_t x)
+{
+	return (x + (1 << (SWR_CONFIG_SUBPIXEL_BITS - 1))) >> SWR_CONFIG_SUBPIXEL_BITS;
+}
+
+// Transformed vertex positions are clamped to +/-SWR_MAX_VERTEX_COORD sub-pixels so that 
+// they can be safely converted to integers. Clamped vertices are always outside the 
+// guard band and the triangles using them are clipped from the original floating point 
+// positions. Coordinates are rounded to nearest, like the cvtps conversions of the SIMD 
+// transform kernels, so that all code paths place a vertex on the same sub-pixel.
+#define SWR_MAX_VERTEX_COORD (1 << 29)
+
+static inline int32_t swrVertexCoordFromFloat(float x)
+{
+	const float maxCoord = (float)SWR_MAX_VERTEX_COORD;
+	return (int32_t)lrintf(x < -maxCoord ? -maxCoord : (x > maxCoord ? maxCoord : x));
+}
+
+// Half-precision floats are converted by moving the sign, exponent and mantissa into
+// place and rebiasing the exponent with a multiplication by 2^112, which also turns
+// denormals into normal floats. Infinities and NaNs become large finite values, which
+// is fine for vertex positions.
+#define SWR_HALF_EXPONENT_SCALE 5.192296858534828e+33f // 2^112
+
+static inline float swrHalfToFloat(uint16_t h)
+{
+	union { uint32_t u; float f; } bits;
+	bits.u = ((uint32_t)(h & 0x8000) << 16) | ((uint32_t)(h & 0x7FFF) << 13);
+	return bits.f * SWR_HALF_EXPONENT_SCALE;
+}
+
+// Blends a source color with the framebuffer color using one of the non-opaque
+// swr_blend_mode equations. All 4 channels are blended the same way. x/255 is
+// computed as ((x + 128) + ((x + 128) >> 8)) >> 8 which is exact for 16-bit x
+// and matches the SIMD implementations (vec4i_blendXXXRGBA8).
+static inline uint32_t swrBlendColor(uint32_t src, uint32_t dst, uint32_t blendMode)
+{
+	const uint32_t srcAlpha = src >> 24;
+
+	uint32_t res = 0;
+	for (uint32_t shift = 0; shift < 32; shift += 8) {
+		const uint32_t s = (src >> shift) & 0xFF;
+		const uint32_t d = (dst >> shift) & 0xFF;
+
+		uint32_t c;
+		if (blendMode == SWR_BLEND_MODE_ADDITIVE) {
+			c = s + d;
+			c = c > 255 ? 255 : c;
+		} else {
+			uint32_t t = blendMode == SWR_BLEND_MODE_MULTIPLY
+				? s * d + 128
+				: s * srcAlpha + d * (255 - srcAlpha) + 128
+				;
+			c = (t + (t >> 8)) >> 8;
+		}
+
+		res |= c << shift;
+	}
+
+	return res;
+}
+
+// Texture sampling. Texture coordinates are interpolated in texels with 8 fractional 
+// bits. Bilinear filtering blends the 2x2 texels around the sample point so its 
+// coordinates are shifted by half a texel to be relative to the texel centers. 
+// The SIMD kernels (swr_textureSample) use the same fixed-point math.
+static inline float swrTexCoordToTexel(float u, uint32_t size, uint32_t filter)
+{
+	return u * (float)(size << 8) - (filter == SWR_TEXTURE_FILTER_BILINEAR ? 128.0f : 0.0f);
+}
+
+// Offset of texel (x, y) in the blocked layout is swrTextureOffsetX(x) + swrTextureOffsetY(y). 
+// The two parts are independent so bilinear filtering computes each of them only twice.
+static inline uint32_t swrTextureOffsetX(uint32_t x)
+{
+	return ((x >> SWR_TEXTURE_BLOCK_SIZE_LOG2) << (SWR_TEXTURE_BLOCK_SIZE_LOG2 * 2)) | (x & ((1u << SWR_TEXTURE_BLOCK_SIZE_LOG2) - 1));
+}
+
+static inline uint32_t swrTextureOffsetY(const swr_texture_level* level, uint32_t y)
+{
+	return (y >> SWR_TEXTURE_BLOCK_SIZE_LOG2) * level->m_BlockRowStride + ((y & ((1u << SWR_TEXTURE_BLOCK_SIZE_LOG2) - 1)) << SWR_TEXTURE_BLOCK_SIZE_LOG2);
+}
+
+// Mip level for a triangle. The mapping from screen to texture space is affine so the 
+// texture coordinate derivatives (what the kernels step per pixel and per row) are the 
+// same over the whole triangle. The level is picked from the larger of the footprints 
+// of a pixel step in x and y, in level 0 texels, rounded to the nearest level.
+static inline const swr_texture_level* swrTextureSelectLevel(const swr_texture* tex, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv)
+{
+	const float dx02 = (float)(x0 - x2);
+	const float dy02 = (float)(y0 - y2);
+	const float dx12 = (float)(x1 - x2);
+	const float dy12 = (float)(y1 - y2);
+	const float det = dx02 * dy12 - dx12 * dy02;
+	if (tex->m_NumLevels == 1 || det == 0.0f) {
+		return &tex->m_Levels[0];
+	}
+
+	const float scale = (float)(1 << SWR_CONFIG_SUBPIXEL_BITS) / det;
+	const float su = (float)tex->m_Levels[0].m_Width * scale;
+	const float sv = (float)tex->m_Levels[0].m_Height * scale;
+	const float du02 = uv[0] - uv[4];
+	const float dv02 = uv[1] - uv[5];
+	const float du12 = uv[2] - uv[4];
+	const float dv12 = uv[3] - uv[5];
+	const float dudx = (du02 * dy12 - du12 * dy02) * su;
+	const float dvdx = (dv02 * dy12 - dv12 * dy02) * sv;
+	const float dudy = (du12 * dx02 - du02 * dx12) * su;
+	const float dvdy = (dv12 * dx02 - dv02 * dx12) * sv;
+	const float rho2 = core_maxf(dudx * dudx + dvdx * dvdx, dudy * dudy + dvdy * dvdy);
+
+	// Level i is used for footprints in [2^(i - 0.5), 2^(i + 0.5)) texels.
+	uint32_t level = 0;
+	float threshold = 2.0f;
+	while (level + 1 < tex->m_NumLevels && rho2 >= threshold) {
+		++level;
+		threshold *= 4.0f;
+	}
+
+	return &tex->m_Levels[level];
+}
+
+static inline uint32_t swrTextureSample(const swr_texture_level* tex, float s, float t, uint32_t filter)
+{
+	const uint32_t w = tex->m_Width;
+	const uint32_t h = tex->m_Height;
+	if (filter == SWR_TEXTURE_FILTER_NEAREST) {
+		const uint32_t x = (uint32_t)core_maxf(core_minf(s, (float)((w << 8) - 1)), 0.0f) >> 8;
+		const uint32_t y = (uint32_t)core_maxf(core_minf(t, (float)((h << 8) - 1)), 0.0f) >> 8;
+		return tex->m_Pixels[swrTextureOffsetX(x) + swrTextureOffsetY(tex, y)];
+	}
+
+	// The second texel of the last row/column has 0 weight. Don't read past the edge.
+	const uint32_t sx = (uint32_t)core_maxf(core_minf(s, (float)((w - 1) << 8)), 0.0f);
+	const uint32_t sy = (uint32_t)core_maxf(core_minf(t, (float)((h - 1) << 8)), 0.0f);
+	const uint32_t fx = sx & 0xFF;
+	const uint32_t fy = sy & 0xFF;
+	const uint32_t x0 = sx >> 8;
+	const uint32_t y0 = sy >> 8;
+	const uint32_t ox0 = swrTextureOffsetX(x0);
+	const uint32_t ox1 = swrTextureOffsetX(x0 + ((fx + 0xFF) >> 8));
+	const uint32_t oy0 = swrTextureOffsetY(tex, y0);
+	const uint32_t oy1 = swrTextureOffsetY(tex, y0 + ((fy + 0xFF) >> 8));
+	const uint32_t c00 = tex->m_Pixels[ox0 + oy0];
+	const uint32_t c10 = tex->m_Pixels[ox1 + oy0];
+	const uint32_t c01 = tex->m_Pixels[ox0 + oy1];
+	const uint32_t c11 = tex->m_Pixels[ox1 + oy1];
+
+	// Weights in 1/256 units. They always sum to 256.
+	const uint32_t w11 = (fx * fy) >> 8;
+	const uint32_t w10 = fx - w11;
+	const uint32_t w01 = fy - w11;
+	const uint32_t w00 = 256 - fx - fy + w11;
+
+	uint32_t res = 0;
+	for (uint32_t shift = 0; shift < 32; shift += 8) {
+		const uint32_t c = 0
+			+ ((c00 >> shift) & 0xFF) * w00
+			+ ((c10 >> shift) & 0xFF) * w10
+			+ ((c01 >> shift) & 0xFF) * w01
+			+ ((c11 >> shift) & 0xFF) * w11
+			;
+		res |= (c >> 8) << shift;
+	}
+
+	return res;
+}
+
+// Pixel shaders of the SIMD kernels. The rasterizer is __forceinline'd and the shader 
+// is passed as a compile-time constant, so each built-in shader gets its own copy of 
+// the traversal with the shading code inlined into the tile loop. Custom shaders 
+// (see bindPixelShader) share a single copy which calls the bound function once per tile.
+#define SWR_PIXEL_SHADER_VERTEX_COLOR 0
+#define SWR_PIXEL_SHADER_TEXTURE      1
+#define SWR_PIXEL_SHADER_CUSTOM       2
+
+// Converts a tile coverage mask from the kernels' column-major layout (pixel (x, y) at 
+// bit y + 4 * x) to the row-major layout of swr_pixel_shader_tile.
+static inline uint32_t swrTileCoverageToRowMajor(uint32_t coverageMask, uint32_t tileWidth)
+{
+	uint32_t res = 0;
+	for (uint32_t x = 0; x < tileWidth; ++x) {
+		for (uint32_t y = 0; y < 4; ++y) {
+			res |= ((coverageMask >> (y + 4 * x)) & 1u) << (x + y * tileWidth);
+		}
+	}
+
+	return res;
+}
+
+// A triangle clipped against a convex region has at most one extra vertex per clip plane.
+#define SWR_CLIP_MAX_VERTICES 7
+
+typedef struct swr_clip_vertex
+{
+	float m_Pos[2];  // Screen space position in sub-pixels.
+	float m_Bary[2]; // Barycentric coordinates relative to vertices 1 and 2 of the original triangle.
+	int32_t m_Src;   // Index of the original vertex (0, 1 or 2) or -1 for vertices created by clipping.
+} swr_clip_vertex;
+
+typedef void (*swr_blit_glyph_func)(uint32_t* dst, uint32_t stride, const uint8_t* rows, uint32_t numRows, int32_t shift, uint32_t columnMask, uint32_t color);
+typedef void (*swr_draw_triangle_func)(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
+typedef void (*swr_draw_triangle_flat_func)(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+typedef void (*swr_draw_triangle_textured_func)(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv);
+
 typedef struct swr_context
 {
 	core_allocator_i* m_TempAllocator;
 	uint32_t* m_FrameBuffer;
+	uint32_t* m_SampleBuffer; // m_NumSamples planes of m_SampleStride pixels. Same as m_FrameBuffer without multisampling.
 	uint32_t m_Width;
 	uint32_t m_Height;
+	uint32_t m_NumSamples;
+	uint32_t m_SampleStride;
+	int32_t m_SampleExtent;   // Largest sample offset in sub-pixels along either axis.
+	int32_t m_SampleOffsets[SWR_CONFIG_MAX_SAMPLES * 2]; // Sub-pixel (x, y) offsets of the sample points from the pixel's integer coordinates.
 	swr_index_buffer m_IndexBuffer;
-	swr_vertex_buffer m_VertexBuffers[2]; // { Position, Color }
+	swr_vertex_buffer m_VertexBuffers[SWR_VERTEX_ATTRIB_COUNT];
+	swr_cluster_buffer m_ClusterBuffer;
 	uint32_t m_BoundBuffers;
 	swr_matrix2d m_WorldToScreenTransform;
+	swr_rect m_ScissorRect;
+	uint32_t m_BlendMode;
+	float m_LineWidth;
+	bool m_LineAntiAliased;
+	const swr_texture* m_Texture; // NULL if no texture is bound
+	uint32_t m_TextureFilter;
+	swr_pixel_shader_func m_PixelShader; // NULL if no pixel shader is bound
+	void* m_PixelShaderUserData;
+	swr_varying_layout m_VaryingLayout;
+	const float* m_Varyings; // Varyings of the triangle being drawn, in the caller's vertex order. NULL if it has none.
 
 	uint8_t* m_TileBuffer[2];
+
+	// Per tile state, m_NumFBTilesX x m_NumFBTilesY bytes each, in a single allocation.
+	uint8_t* m_ClearTiles; // 1 if the tile hasn't been filled with m_ClearColor yet
+	uint8_t* m_DirtyTiles; // 1 if the tile has to be redrawn by the next incremental frame
+	uint8_t* m_DrawnTiles; // 1 if the tile has been drawn into during the current incremental frame
+	uint32_t m_NumFBTilesX;
+	uint32_t m_NumFBTilesY;
+	uint32_t m_ClearColor;
+	bool m_ClearPending; // false if no tile is pending
+	bool m_IncrementalFrame; // true between beginIncrementalFrame and endIncrementalFrame
+
+	core_allocator_i* m_Allocator;
+	swr_binner* m_Binner; // NULL in immediate mode
 } swr_context;
 
+void swrTouchTilesRect(swr_context* ctx, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY);
+
+// Fills the pending clear tiles overlapping the (inclusive) pixel rect and, during 
+// incremental frames, records them as drawn. Must be called before anything reads or 
+// writes pixels inside it.
+static inline void swrTouchTiles(swr_context* ctx, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY)
+{
+	if (ctx->m_ClearPending || ctx->m_IncrementalFrame) {
+		swrTouchTilesRect(ctx, minX, minY, maxX, maxY);
+	}
+}
+
+// Varyings of the triangle being rasterized (see swr_context::m_Varyings) in the 
+// rasterizer's vertex order. If vertices 1 and 2 have been swapped to make the triangle 
+// CCW, the swapped varyings are written to 'buffer' (3 * SWR_CONFIG_MAX_VARYINGS floats).
+static inline const float* swrTriangleVaryings(const swr_context* ctx, bool swapped, float* buffer)
+{
+	const float* varyings = ctx->m_Varyings;
+	if (varyings == NULL || !swapped) {
+		return varyings;
+	}
+
+	const uint32_t n = ctx->m_VaryingLayout.m_NumVaryings;
+	for (uint32_t i = 0; i < n; ++i) {
+		buffer[i] = varyings[i];
+		buffer[n + i] = varyings[n * 2 + i];
+		buffer[n * 2 + i] = varyings[n + i];
+	}
+
+	return buffer;
+}
+
+typedef struct swr_bin_triangle
+{
+	int32_t m_Pos[6];
+	uint32_t m_Color[3];
+	uint32_t m_BlendMode;
+	const swr_texture* m_Texture; // NULL for untextured triangles
+	uint32_t m_TextureFilter;
+	float m_TexCoord[6];
+	swr_pixel_shader_func m_PixelShader; // NULL for textured triangles and when no pixel shader is bound
+	void* m_PixelShaderUserData;
+	const float* m_Varyings; // NULL if the triangle has no varyings
+	swr_varying_layout m_VaryingLayout;
+} swr_bin_triangle;
+
+typedef struct swr_bin_chunk
+{
+	struct swr_bin_chunk* m_Next;
+	uint32_t m_NumTriangles;
+	uint32_t _padding;
+	const swr_bin_triangle* m_Triangles[SWR_CONFIG_BIN_CHUNK_CAPACITY];
+} swr_bin_chunk;
+
+typedef struct swr_bin
+{
+	swr_bin_chunk* m_FirstChunk;
+	swr_bin_chunk* m_LastChunk;
+} swr_bin;
+
+typedef struct swr_worker
+{
+	swr_binner* m_Binner;
+	core_os_thread* m_Thread;
+	swr_context m_Ctx; // Copy of the main context with its own scissor rect and scratch buffers.
+} swr_worker;
+
+// Sort-middle binner. Triangles submitted while a binner is active are stored 
+// in per-bin lists (in submission order) and rasterized by a pool of worker 
+// threads on flush. Each bin is processed by exactly one thread at a time so 
+// no synchronization is needed when writing to the framebuffer.
+typedef struct swr_binner
+{
+	core_allocator_i* m_FrameAllocator; // Linear allocator for triangles and bin chunks. Reset on every flush.
+	swr_bin* m_Bins;
+	swr_worker* m_Workers; // m_Workers[0] is used by the thread calling flush.
+	core_os_semaphore* m_WorkSemaphore;
+	core_os_semaphore* m_DoneSemaphore;
+	uint8_t* m_TileBuffer;
+	uint32_t m_NumBinsX;
+	uint32_t m_NumBinsY;
+	uint32_t m_NumWorkers;
+	uint32_t m_NumTriangles;
+	volatile int32_t m_NextBinID;
+	volatile int32_t m_Quit;
+} swr_binner;
+
+swr_binner* swrBinnerCreate(swr_context* ctx, core_allocator_i* allocator, uint32_t numWorkerThreads);
+void swrBinnerDestroy(swr_binner* binner, core_allocator_i* allocator);
+void swrBinnerAddTriangle(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color0, uint32_t color1, uint32_t color2);
+void swrBinnerAddTriangleFlat(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+void swrBinnerAddTriangleTextured(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const float* uv);
+void swrBinnerFlush(swr_context* ctx);
+
+uint32_t swrClipPolygon(swr_clip_vertex* vertices, uint32_t numVertices, float minX, float minY, float maxX, float maxY);
+
+void swrRasterizeLine(swr_context* ctx, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+void swrRasterizeWideLine(swr_context* ctx, double x0, double y0, double x1, double y1, float width, bool antiAliased, uint32_t color);
+
+swr_bvh* swrCreateBVH(core_allocator_i* allocator, const float* pos, const uint16_t* indices, uint32_t numIndices);
+void swrDestroyBVH(core_allocator_i* allocator, swr_bvh* bvh);
+
+swr_texture* swrCreateTexture(core_allocator_i* allocator, uint32_t w, uint32_t h, const uint32_t* pixels);
+void swrDestroyTexture(core_allocator_i* allocator, swr_texture* tex);
+
+swr_atlas_font* swrCreateAtlasFont(core_allocator_i* allocator, const swr_atlas_font_desc* desc);
+void swrDestroyAtlasFont(core_allocator_i* allocator, swr_atlas_font* font);
+void swrDrawAtlasTextRun(swr_context* ctx, const swr_atlas_font* font, float scale, int32_t x0, int32_t y0, const char* str, const char* end, uint32_t color);
+
+swr_command_list* swrCreateCommandList(core_allocator_i* allocator);
+void swrDestroyCommandList(core_allocator_i* allocator, swr_command_list* cmdList);
+void swrCmdReset(swr_command_list* cmdList);
+void swrCmdClear(swr_command_list* cmdList, uint32_t color);
+void swrCmdSetWorldToScreenTransform(swr_command_list* cmdList, const swr_matrix2d* mtx);
+void swrCmdSetBlendMode(swr_command_list* cmdList, swr_blend_mode mode);
+void swrCmdSetLineStyle(swr_command_list* cmdList, float width, bool antiAliased);
+void swrCmdBindTexture(swr_command_list* cmdList, const swr_texture* tex, swr_texture_filter filter);
+void swrCmdUnbindTexture(swr_command_list* cmdList);
+void swrCmdBindPixelShader(swr_command_list* cmdList, swr_pixel_shader_func func, void* userData);
+void swrCmdUnbindPixelShader(swr_command_list* cmdList);
+void swrCmdBindVertexBuffer(swr_command_list* cmdList, swr_vertex_attrib va, swr_format format, uint32_t stride, uint32_t n, const void* ptr);
+void swrCmdUnbindVertexBuffer(swr_command_list* cmdList, swr_vertex_attrib va);
+void swrCmdBindIndexBuffer(swr_command_list* cmdList, swr_format format, uint32_t n, const void* ptr);
+void swrCmdUnbindIndexBuffer(swr_command_list* cmdList);
+void swrCmdBindClusterBuffer(swr_command_list* cmdList, uint32_t n, uint32_t numTrianglesPerCluster, const swr_cluster* ptr);
+void swrCmdUnbindClusterBuffer(swr_command_list* cmdList);
+void swrCmdDrawPrimitives(swr_command_list* cmdList, swr_primitive_type primType, uint32_t startIndex, uint32_t endIndex, uint32_t numIndices, uint32_t baseIndex, uint32_t baseVertex);
+void swrCmdDrawBVH(swr_command_list* cmdList, const swr_bvh* bvh, uint32_t baseVertex);
+void swrExecuteCommandList(swr_context* ctx, const swr_command_list* cmdList);
+
 #endif // SWR_SWR_P_H
@@ -0,0 +1,23 @@
+#include "swr.h"
+#include "swr_p.h"
+
+// Channels are summed 2 at a time, in the 16-bit halves of a 32-bit integer. 
+// 8 samples of 255 plus the rounding bias still fit in 16 bits.
+void swrResolveSamplesRef(uint32_t numPixels, uint32_t numSamples, uint32_t sampleStride, const uint32_t* samples, uint32_t* dst)
+{
+	const uint32_t shift = numSamples == 4 ? 2 : 3;
+	const uint32_t bias = (numSamples >> 1) * 0x00010001u;
+	for (uint32_t i = 0; i < numPixels; ++i) {
+		const uint32_t* sample = &samples[i];
+
+		uint32_t sumEven = bias;
+		uint32_t sumOdd = bias;
+		for (uint32_t j = 0; j < numSamples; ++j) {
+			sumEven += *sample & 0x00FF00FFu;
+			sumOdd += (*sample >> 8) & 0x00FF00FFu;
+			sample += sampleStride;
+		}
+
+		dst[i] = ((sumEven >> shift) & 0x00FF00FFu) | (((sumOdd >> shift) & 0x00FF00FFu) << 8);
+	}
+}
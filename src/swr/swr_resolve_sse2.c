@@ -0,0 +1,47 @@
+#include "swr.h"
+#include "swr_p.h"
+
+#define SWR_VEC_MATH_SSE2
+#include "swr_vec_math.h"
+
+extern void swrResolveSamplesRef(uint32_t numPixels, uint32_t numSamples, uint32_t sampleStride, const uint32_t* samples, uint32_t* dst);
+
+// Same as swrResolveSamplesRef, 4 pixels at a time.
+static __forceinline void swrResolveSamples_internal(uint32_t numPixels, uint32_t numSamples, uint32_t sampleStride, const uint32_t* samples, uint32_t* dst)
+{
+	const uint32_t shift = numSamples == 4 ? 2 : 3;
+	const vec4i v_bias = vec4i_fromInt((int32_t)((numSamples >> 1) * 0x00010001u));
+	const vec4i v_channelMask = vec4i_fromInt(0x00FF00FF);
+
+	const uint32_t numIter = numPixels >> 2;
+	for (uint32_t i = 0; i < numIter; ++i) {
+		const uint32_t* sample = &samples[i << 2];
+
+		vec4i v_sumEven = v_bias;
+		vec4i v_sumOdd = v_bias;
+		for (uint32_t j = 0; j < numSamples; ++j) {
+			const vec4i v_sample = vec4i_fromInt4vu((const int32_t*)sample);
+			v_sumEven = vec4i_add(v_sumEven, vec4i_and(v_sample, v_channelMask));
+			v_sumOdd = vec4i_add(v_sumOdd, vec4i_and(vec4i_slr(v_sample, 8), v_channelMask));
+			sample += sampleStride;
+		}
+
+		const vec4i v_even = vec4i_and(vec4i_slr(v_sumEven, shift), v_channelMask);
+		const vec4i v_odd = vec4i_and(vec4i_slr(v_sumOdd, shift), v_channelMask);
+		vec4i_toInt4vu(vec4i_or(v_even, vec4i_sal(v_odd, 8)), (int32_t*)&dst[i << 2]);
+	}
+
+	const uint32_t numDone = numIter << 2;
+	if (numDone != numPixels) {
+		swrResolveSamplesRef(numPixels - numDone, numSamples, sampleStride, &samples[numDone], &dst[numDone]);
+	}
+}
+
+void swrResolveSamplesSSE2(uint32_t numPixels, uint32_t numSamples, uint32_t sampleStride, const uint32_t* samples, uint32_t* dst)
+{
+	if (numSamples == 4) {
+		swrResolveSamples_internal(numPixels, 4, sampleStride, samples, dst);
+	} else {
+		swrResolveSamples_internal(numPixels, 8, sampleStride, samples, dst);
+	}
+}
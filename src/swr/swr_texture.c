@@ -0,0 +1,135 @@
+#include "swr.h"
+#include "swr_p.h"
+#include "../core/allocator.h"
+#include "../core/memory.h"
+#include "../core/math.h"
+
+static void swrTextureStoreLevel(swr_texture_level* level, uint32_t* levelPixels, const uint32_t* pixels);
+static void swrTextureDownsample(const uint32_t* src, uint32_t srcWidth, uint32_t srcHeight, uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight);
+
+swr_texture* swrCreateTexture(core_allocator_i* allocator, uint32_t w, uint32_t h, const uint32_t* pixels)
+{
+	if (w == 0 || h == 0 || w > SWR_CONFIG_MAX_TEXTURE_SIZE || h > SWR_CONFIG_MAX_TEXTURE_SIZE) {
+		return NULL;
+	}
+
+	swr_texture* tex = (swr_texture*)CORE_ALLOC(allocator, sizeof(swr_texture));
+	if (!tex) {
+		return NULL;
+	}
+
+	core_memSet(tex, 0, sizeof(swr_texture));
+
+	// Level sizes. Each level is padded to whole blocks so they all start on a cache line.
+	const uint32_t blockSize = 1u << SWR_TEXTURE_BLOCK_SIZE_LOG2;
+	uint32_t levelOffset[SWR_TEXTURE_MAX_LEVELS];
+	uint32_t numTexels = 0;
+	uint32_t levelWidth = w;
+	uint32_t levelHeight = h;
+	while (true) {
+		const uint32_t paddedWidth = (uint32_t)core_roundUp((int32_t)levelWidth, (int32_t)blockSize);
+		const uint32_t paddedHeight = (uint32_t)core_roundUp((int32_t)levelHeight, (int32_t)blockSize);
+
+		swr_texture_level* level = &tex->m_Levels[tex->m_NumLevels];
+		level->m_Width = levelWidth;
+		level->m_Height = levelHeight;
+		level->m_BlockRowStride = paddedWidth * blockSize;
+		levelOffset[tex->m_NumLevels] = numTexels;
+		numTexels += paddedWidth * paddedHeight;
+		tex->m_NumLevels++;
+
+		if (levelWidth == 1 && levelHeight == 1) {
+			break;
+		}
+
+		levelWidth = core_maxu32(levelWidth >> 1, 1);
+		levelHeight = core_maxu32(levelHeight >> 1, 1);
+	}
+
+	const size_t size = sizeof(uint32_t) * (size_t)numTexels;
+	tex->m_Pixels = (uint32_t*)CORE_ALIGNED_ALLOC(allocator, size, 64);
+	if (!tex->m_Pixels) {
+		CORE_FREE(allocator, tex);
+		return NULL;
+	}
+
+	// Padding texels are never sampled.
+	core_memSet(tex->m_Pixels, 0, size);
+	swrTextureStoreLevel(&tex->m_Levels[0], &tex->m_Pixels[levelOffset[0]], pixels);
+
+	// Each level is generated from the row-major pixels of the previous one. Levels
+	// alternate between the two halves of the temp buffer (level i + 2 always fits
+	// where level i was).
+	if (tex->m_NumLevels > 1) {
+		const uint32_t level1Size = tex->m_Levels[1].m_Width * tex->m_Levels[1].m_Height;
+		const uint32_t level2Size = tex->m_NumLevels > 2
+			? tex->m_Levels[2].m_Width * tex->m_Levels[2].m_Height
+			: 0
+			;
+		uint32_t* tempBuffer = (uint32_t*)CORE_ALIGNED_ALLOC(allocator, sizeof(uint32_t) * (size_t)(level1Size + level2Size), 32);
+		if (!tempBuffer) {
+			CORE_ALIGNED_FREE(allocator, tex->m_Pixels, 64);
+			CORE_FREE(allocator, tex);
+			return NULL;
+		}
+
+		uint32_t* levelPixels[2] = { tempBuffer, tempBuffer + level1Size };
+		const uint32_t* src = pixels;
+		for (uint32_t i = 1; i < tex->m_NumLevels; ++i) {
+			const swr_texture_level* srcLevel = &tex->m_Levels[i - 1];
+			swr_texture_level* dstLevel = &tex->m_Levels[i];
+			uint32_t* dst = levelPixels[(i - 1) & 1];
+
+			swrTextureDownsample(src, srcLevel->m_Width, srcLevel->m_Height, dst, dstLevel->m_Width, dstLevel->m_Height);
+			swrTextureStoreLevel(dstLevel, &tex->m_Pixels[levelOffset[i]], dst);
+			src = dst;
+		}
+
+		CORE_ALIGNED_FREE(allocator, tempBuffer, 32);
+	}
+
+	return tex;
+}
+
+void swrDestroyTexture(core_allocator_i* allocator, swr_texture* tex)
+{
+	CORE_ALIGNED_FREE(allocator, tex->m_Pixels, 64);
+	CORE_FREE(allocator, tex);
+}
+
+// Converts row-major pixels to the blocked layout.
+static void swrTextureStoreLevel(swr_texture_level* level, uint32_t* levelPixels, const uint32_t* pixels)
+{
+	const uint32_t blockSize = 1u << SWR_TEXTURE_BLOCK_SIZE_LOG2;
+	const uint32_t w = level->m_Width;
+	const uint32_t h = level->m_Height;
+	for (uint32_t y = 0; y < h; ++y) {
+		uint32_t* dstRow = &levelPixels[swrTextureOffsetY(level, y)];
+		const uint32_t* srcRow = &pixels[y * w];
+		for (uint32_t x = 0; x < w; x += blockSize) {
+			core_memCopy(&dstRow[swrTextureOffsetX(x)], &srcRow[x], sizeof(uint32_t) * core_minu32(blockSize, w - x));
+		}
+	}
+
+	level->m_Pixels = levelPixels;
+}
+
+// A source 1 texel wide or high only shrinks in the other direction. Its single
+// column/row is used for both texels of each 2x2 footprint.
+static void swrTextureDownsample(const uint32_t* src, uint32_t srcWidth, uint32_t srcHeight, uint32_t* dst, uint32_t dstWidth, uint32_t dstHeight)
+{
+	const uint32_t rowStep = srcHeight > 1 ? 2 : 1;
+	const uint32_t nextRowOffset = srcHeight > 1 ? srcWidth : 0;
+	for (uint32_t y = 0; y < dstHeight; ++y) {
+		const uint32_t* row0 = &src[y * rowStep * srcWidth];
+		const uint32_t* row1 = row0 + nextRowOffset;
+		uint32_t* dstRow = &dst[y * dstWidth];
+		if (srcWidth > 1) {
+			swr->downsample2x2(dstWidth, row0, row1, dstRow);
+		} else {
+			const uint32_t column0[2] = { row0[0], row0[0] };
+			const uint32_t column1[2] = { row1[0], row1[0] };
+			swr->downsample2x2(1, column0, column1, dstRow);
+		}
+	}
+}
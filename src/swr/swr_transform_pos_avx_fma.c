@@ -1,8 +1,10 @@
 #include "swr.h"
 #include "swr_p.h"
+#include "../core/memory.h"
 
 #define SWR_VEC_MATH_AVX
 #define SWR_VEC_MATH_FMA
+#define SWR_VEC_MATH_F16C
 #include "swr_vec_math.h"
 
 void swrTransformPos2fTo2iAVX_FMA(uint32_t n, const float* posf, int32_t* posi, const float* mtx)
@@ -13,6 +15,8 @@ void swrTransformPos2fTo2iAVX_FMA(uint32_t n, const float* posf, int32_t* posi,
 	const vec8f m01 = vec8f_fromFloat8(mtx[0], mtx[1], mtx[0], mtx[1], mtx[0], mtx[1], mtx[0], mtx[1]);
 	const vec8f m23 = vec8f_fromFloat8(mtx[2], mtx[3], mtx[2], mtx[3], mtx[2], mtx[3], mtx[2], mtx[3]);
 	const vec8f m45 = vec8f_fromFloat8(mtx[4], mtx[5], mtx[4], mtx[5], mtx[4], mtx[5], mtx[4], mtx[5]);
+	const vec8f vminCoord = vec8f_fromFloat(-(float)SWR_MAX_VERTEX_COORD);
+	const vec8f vmaxCoord = vec8f_fromFloat((float)SWR_MAX_VERTEX_COORD);
 
 	const uint32_t numIter = n >> 3;
 	for (uint32_t i = 0; i < numIter; ++i) {
@@ -27,8 +31,8 @@ void swrTransformPos2fTo2iAVX_FMA(uint32_t n, const float* posf, int32_t* posi,
 		const vec8f dst_xy0_xy1_xy2_xy3 = vec8f_madd(src_x00_x11_x22_x33, m01, vec8f_madd(src_y00_y11_y22_y33, m23, m45));
 		const vec8f dst_xy4_xy5_xy6_xy7 = vec8f_madd(src_x44_x55_x66_x77, m01, vec8f_madd(src_y44_y55_y66_y77, m23, m45));
 
-		vec8i_toInt8vu(vec8i_fromVec8f(dst_xy0_xy1_xy2_xy3), &dst[0]);
-		vec8i_toInt8vu(vec8i_fromVec8f(dst_xy4_xy5_xy6_xy7), &dst[8]);
+		vec8i_toInt8vu(vec8i_fromVec8f(vec8f_min(vec8f_max(dst_xy0_xy1_xy2_xy3, vminCoord), vmaxCoord)), &dst[0]);
+		vec8i_toInt8vu(vec8i_fromVec8f(vec8f_min(vec8f_max(dst_xy4_xy5_xy6_xy7, vminCoord), vmaxCoord)), &dst[8]);
 
 		src += 16;
 		dst += 16;
@@ -43,7 +47,7 @@ void swrTransformPos2fTo2iAVX_FMA(uint32_t n, const float* posf, int32_t* posi,
 
 		const vec8f dst_xy0_xy1_xy2_xy3 = vec8f_madd(src_x00_x11_x22_x33, m01, vec8f_madd(src_y00_y11_y22_y33, m23, m45));
 
-		vec8i_toInt8vu(vec8i_fromVec8f(dst_xy0_xy1_xy2_xy3), &dst[0]);
+		vec8i_toInt8vu(vec8i_fromVec8f(vec8f_min(vec8f_max(dst_xy0_xy1_xy2_xy3, vminCoord), vmaxCoord)), &dst[0]);
 
 		src += 8;
 		dst += 8;
@@ -58,7 +62,7 @@ void swrTransformPos2fTo2iAVX_FMA(uint32_t n, const float* posf, int32_t* posi,
 
 		const vec4f dst_x0_y0_x1_y1 = vec4f_madd(src_x0_x0_x1_x1, vec4f_fromVec8f_low(m01), vec4f_madd(src_y0_y0_y1_y1, vec4f_fromVec8f_low(m23), vec4f_fromVec8f_low(m45)));
 
-		vec4i_toInt4vu(vec4i_fromVec4f(dst_x0_y0_x1_y1), &dst[0]);
+		vec4i_toInt4vu(vec4i_fromVec4f(vec4f_min(vec4f_max(dst_x0_y0_x1_y1, vec4f_fromVec8f_low(vminCoord)), vec4f_fromVec8f_low(vmaxCoord))), &dst[0]);
 
 		src += 4;
 		dst += 4;
@@ -66,7 +70,100 @@ void swrTransformPos2fTo2iAVX_FMA(uint32_t n, const float* posf, int32_t* posi,
 	}
 
 	if (rem) {
-		dst[0] = (int32_t)(mtx[0] * src[0] + mtx[2] * src[1] + mtx[4]);
-		dst[1] = (int32_t)(mtx[1] * src[0] + mtx[3] * src[1] + mtx[5]);
+		dst[0] = swrVertexCoordFromFloat(mtx[0] * src[0] + mtx[2] * src[1] + mtx[4]);
+		dst[1] = swrVertexCoordFromFloat(mtx[1] * src[0] + mtx[3] * src[1] + mtx[5]);
 	}
 }
+
+// Strided and compact position formats. Positions are loaded 4 at a time, with x and y 
+// interleaved as in the 2F kernel above. The 2 components of the 16-bit formats are 
+// loaded together as a single 32-bit word per vertex. SWR_FORMAT_2H requires F16C.
+static __forceinline vec8f swrLoadPos4(const uint8_t* src, uint32_t stride, uint32_t format)
+{
+	if (format == SWR_FORMAT_2F) {
+		if (stride == 8) {
+			return vec8f_fromFloat8vu((const float*)src);
+		}
+
+		const float* p0 = (const float*)&src[0];
+		const float* p1 = (const float*)&src[stride];
+		const float* p2 = (const float*)&src[stride * 2];
+		const float* p3 = (const float*)&src[stride * 3];
+		return vec8f_fromFloat8(p0[0], p0[1], p1[0], p1[1], p2[0], p2[1], p3[0], p3[1]);
+	}
+
+	const vec4i xy = stride == 4
+		? vec4i_fromInt4vu((const int32_t*)src)
+		: vec4i_fromInt4(*(const int32_t*)&src[0], *(const int32_t*)&src[stride], *(const int32_t*)&src[stride * 2], *(const int32_t*)&src[stride * 3])
+		;
+	return format == SWR_FORMAT_2US ? vec8f_fromUint16x8(xy)
+		: format == SWR_FORMAT_2S ? vec8f_fromInt16x8(xy)
+		: vec8f_fromHalf8(xy)
+		;
+}
+
+static __forceinline void swrTransformPosStrided_internal(uint32_t n, const uint8_t* src, uint32_t stride, int32_t* dst, const float* mtx, uint32_t format)
+{
+	const vec8f m01 = vec8f_fromFloat8(mtx[0], mtx[1], mtx[0], mtx[1], mtx[0], mtx[1], mtx[0], mtx[1]);
+	const vec8f m23 = vec8f_fromFloat8(mtx[2], mtx[3], mtx[2], mtx[3], mtx[2], mtx[3], mtx[2], mtx[3]);
+	const vec8f m45 = vec8f_fromFloat8(mtx[4], mtx[5], mtx[4], mtx[5], mtx[4], mtx[5], mtx[4], mtx[5]);
+	const vec8f vminCoord = vec8f_fromFloat(-(float)SWR_MAX_VERTEX_COORD);
+	const vec8f vmaxCoord = vec8f_fromFloat((float)SWR_MAX_VERTEX_COORD);
+
+	// The last 1 to 3 positions are copied to a zero padded local buffer and go 
+	// through the same loop as the rest.
+	const uint32_t posSize = format == SWR_FORMAT_2F ? 8 : 4;
+	const uint32_t rem = n & 3;
+	uint8_t remSrc[32];
+	int32_t remDst[8];
+	if (rem != 0) {
+		core_memSet(remSrc, 0, sizeof(remSrc));
+		for (uint32_t i = 0; i < rem; ++i) {
+			core_memCopy(&remSrc[i * posSize], &src[((n & ~3u) + i) * stride], posSize);
+		}
+	}
+
+	const uint32_t numIter = (n + 3) >> 2;
+	for (uint32_t i = 0; i < numIter; ++i) {
+		const bool isLast = rem != 0 && i == numIter - 1;
+
+		const vec8f src_xy0_xy1_xy2_xy3 = isLast
+			? swrLoadPos4(remSrc, posSize, format)
+			: swrLoadPos4(src, stride, format)
+			;
+
+		const vec8f src_x00_x11_x22_x33 = vec8f_permute(src_xy0_xy1_xy2_xy3, VEC4_SHUFFLE_XXZZ);
+		const vec8f src_y00_y11_y22_y33 = vec8f_permute(src_xy0_xy1_xy2_xy3, VEC4_SHUFFLE_YYWW);
+
+		const vec8f dst_xy0_xy1_xy2_xy3 = vec8f_madd(src_x00_x11_x22_x33, m01, vec8f_madd(src_y00_y11_y22_y33, m23, m45));
+
+		vec8i_toInt8vu(vec8i_fromVec8f(vec8f_min(vec8f_max(dst_xy0_xy1_xy2_xy3, vminCoord), vmaxCoord)), isLast ? remDst : dst);
+
+		src += stride * 4;
+		dst += 8;
+	}
+
+	if (rem != 0) {
+		core_memCopy(dst - 8, remDst, sizeof(int32_t) * 2 * rem);
+	}
+}
+
+void swrTransformPos2fStridedTo2iAVX_FMA(uint32_t n, const float* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	swrTransformPosStrided_internal(n, (const uint8_t*)pos, stride, posi, mtx, SWR_FORMAT_2F);
+}
+
+void swrTransformPos2usTo2iAVX_FMA(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	swrTransformPosStrided_internal(n, (const uint8_t*)pos, stride, posi, mtx, SWR_FORMAT_2US);
+}
+
+void swrTransformPos2sTo2iAVX_FMA(uint32_t n, const int16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	swrTransformPosStrided_internal(n, (const uint8_t*)pos, stride, posi, mtx, SWR_FORMAT_2S);
+}
+
+void swrTransformPos2hTo2iAVX_FMA_F16C(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	swrTransformPosStrided_internal(n, (const uint8_t*)pos, stride, posi, mtx, SWR_FORMAT_2H);
+}
@@ -9,10 +9,74 @@ void swrTransformPos2fTo2iRef(uint32_t n, const float* posf, int32_t* posi, cons
 		const float px = src[0];
 		const float py = src[1];
 
-		dst[0] = (int32_t)(mtx[0] * px + mtx[2] * py + mtx[4]);
-		dst[1] = (int32_t)(mtx[1] * px + mtx[3] * py + mtx[5]);
+		dst[0] = swrVertexCoordFromFloat(mtx[0] * px + mtx[2] * py + mtx[4]);
+		dst[1] = swrVertexCoordFromFloat(mtx[1] * px + mtx[3] * py + mtx[5]);
 
 		src += 2;
 		dst += 2;
 	}
 }
+
+void swrTransformPos2fStridedTo2iRef(uint32_t n, const float* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	const uint8_t* src = (const uint8_t*)pos;
+	int32_t* dst = posi;
+	for (uint32_t i = 0; i < n; ++i) {
+		const float px = ((const float*)src)[0];
+		const float py = ((const float*)src)[1];
+
+		dst[0] = swrVertexCoordFromFloat(mtx[0] * px + mtx[2] * py + mtx[4]);
+		dst[1] = swrVertexCoordFromFloat(mtx[1] * px + mtx[3] * py + mtx[5]);
+
+		src += stride;
+		dst += 2;
+	}
+}
+
+void swrTransformPos2usTo2iRef(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	const uint8_t* src = (const uint8_t*)pos;
+	int32_t* dst = posi;
+	for (uint32_t i = 0; i < n; ++i) {
+		const float px = (float)((const uint16_t*)src)[0];
+		const float py = (float)((const uint16_t*)src)[1];
+
+		dst[0] = swrVertexCoordFromFloat(mtx[0] * px + mtx[2] * py + mtx[4]);
+		dst[1] = swrVertexCoordFromFloat(mtx[1] * px + mtx[3] * py + mtx[5]);
+
+		src += stride;
+		dst += 2;
+	}
+}
+
+void swrTransformPos2sTo2iRef(uint32_t n, const int16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	const uint8_t* src = (const uint8_t*)pos;
+	int32_t* dst = posi;
+	for (uint32_t i = 0; i < n; ++i) {
+		const float px = (float)((const int16_t*)src)[0];
+		const float py = (float)((const int16_t*)src)[1];
+
+		dst[0] = swrVertexCoordFromFloat(mtx[0] * px + mtx[2] * py + mtx[4]);
+		dst[1] = swrVertexCoordFromFloat(mtx[1] * px + mtx[3] * py + mtx[5]);
+
+		src += stride;
+		dst += 2;
+	}
+}
+
+void swrTransformPos2hTo2iRef(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	const uint8_t* src = (const uint8_t*)pos;
+	int32_t* dst = posi;
+	for (uint32_t i = 0; i < n; ++i) {
+		const float px = swrHalfToFloat(((const uint16_t*)src)[0]);
+		const float py = swrHalfToFloat(((const uint16_t*)src)[1]);
+
+		dst[0] = swrVertexCoordFromFloat(mtx[0] * px + mtx[2] * py + mtx[4]);
+		dst[1] = swrVertexCoordFromFloat(mtx[1] * px + mtx[3] * py + mtx[5]);
+
+		src += stride;
+		dst += 2;
+	}
+}
@@ -1,5 +1,6 @@
 #include "swr.h"
 #include "swr_p.h"
+#include "../core/memory.h"
 
 #define SWR_VEC_MATH_SSE2
 #include "swr_vec_math.h"
@@ -14,6 +15,8 @@ void swrTransformPos2fTo2iSSE2(uint32_t n, const float* posf, int32_t* posi, con
 	const vec4f m0101 = vec4f_fromFloat4(mtx[0], mtx[1], mtx[0], mtx[1]);
 	const vec4f m2323 = vec4f_fromFloat4(mtx[2], mtx[3], mtx[2], mtx[3]);
 	const vec4f m4545 = vec4f_fromFloat4(mtx[4], mtx[5], mtx[4], mtx[5]);
+	const vec4f vminCoord = vec4f_fromFloat(-(float)SWR_MAX_VERTEX_COORD);
+	const vec4f vmaxCoord = vec4f_fromFloat((float)SWR_MAX_VERTEX_COORD);
 
 	const uint32_t numIter = n >> 2;
 	for (uint32_t i = 0; i < numIter; ++i) {
@@ -28,8 +31,8 @@ void swrTransformPos2fTo2iSSE2(uint32_t n, const float* posf, int32_t* posi, con
 		const vec4f dst_x0_y0_x1_y1 = vec4f_madd(src_x0_x0_x1_x1, m0101, vec4f_madd(src_y0_y0_y1_y1, m2323, m4545));
 		const vec4f dst_x2_y2_x3_y3 = vec4f_madd(src_x2_x2_x3_x3, m0101, vec4f_madd(src_y2_y2_y3_y3, m2323, m4545));
 
-		vec4i_toInt4vu(vec4i_fromVec4f(dst_x0_y0_x1_y1), &dst[0]);
-		vec4i_toInt4vu(vec4i_fromVec4f(dst_x2_y2_x3_y3), &dst[4]);
+		vec4i_toInt4vu(vec4i_fromVec4f(vec4f_min(vec4f_max(dst_x0_y0_x1_y1, vminCoord), vmaxCoord)), &dst[0]);
+		vec4i_toInt4vu(vec4i_fromVec4f(vec4f_min(vec4f_max(dst_x2_y2_x3_y3, vminCoord), vmaxCoord)), &dst[4]);
 
 		src += 8;
 		dst += 8;
@@ -44,7 +47,7 @@ void swrTransformPos2fTo2iSSE2(uint32_t n, const float* posf, int32_t* posi, con
 
 		const vec4f dst_x0_y0_x1_y1 = vec4f_madd(src_x0_x0_x1_x1, m0101, vec4f_madd(src_y0_y0_y1_y1, m2323, m4545));
 
-		vec4i_toInt4vu(vec4i_fromVec4f(dst_x0_y0_x1_y1), &dst[0]);
+		vec4i_toInt4vu(vec4i_fromVec4f(vec4f_min(vec4f_max(dst_x0_y0_x1_y1, vminCoord), vmaxCoord)), &dst[0]);
 
 		src += 4;
 		dst += 4;
@@ -52,8 +55,8 @@ void swrTransformPos2fTo2iSSE2(uint32_t n, const float* posf, int32_t* posi, con
 	}
 
 	if (rem) {
-		dst[0] = (int32_t)(mtx[0] * src[0] + mtx[2] * src[1] + mtx[4]);
-		dst[1] = (int32_t)(mtx[1] * src[0] + mtx[3] * src[1] + mtx[5]);
+		dst[0] = swrVertexCoordFromFloat(mtx[0] * src[0] + mtx[2] * src[1] + mtx[4]);
+		dst[1] = swrVertexCoordFromFloat(mtx[1] * src[0] + mtx[3] * src[1] + mtx[5]);
 	}
 }
 #else
@@ -120,3 +123,123 @@ void swrTransformPos2fTo2iSSE2(uint32_t n, const float* posf, int32_t* posi, con
 	}
 }
 #endif
+
+// Strided and compact position formats. Positions are loaded 4 at a time into separate 
+// x and y vectors. The 2 components of the 16-bit formats are loaded together as a single 
+// 32-bit word per vertex.
+static __forceinline vec4i swrLoadPos16x2(const uint8_t* src, uint32_t stride)
+{
+	return stride == 4
+		? vec4i_fromInt4vu((const int32_t*)src)
+		: vec4i_fromInt4(*(const int32_t*)&src[0], *(const int32_t*)&src[stride], *(const int32_t*)&src[stride * 2], *(const int32_t*)&src[stride * 3])
+		;
+}
+
+// See swrHalfToFloat(). Only the low 16 bits of each lane are converted.
+static __forceinline vec4f swrHalfToFloat4(vec4i h)
+{
+	const vec4i sign = vec4i_sal(vec4i_and(h, vec4i_fromInt(0x8000)), 16);
+	const vec4i expMant = vec4i_sal(vec4i_and(h, vec4i_fromInt(0x7FFF)), 13);
+	return vec4f_mul(vec4f_fromVec4i_bits(vec4i_or(sign, expMant)), vec4f_fromFloat(SWR_HALF_EXPONENT_SCALE));
+}
+
+static __forceinline void swrLoadPos4(const uint8_t* src, uint32_t stride, uint32_t format, vec4f* x, vec4f* y)
+{
+	if (format == SWR_FORMAT_2F) {
+		const float* p0 = (const float*)&src[0];
+		const float* p1 = (const float*)&src[stride];
+		const float* p2 = (const float*)&src[stride * 2];
+		const float* p3 = (const float*)&src[stride * 3];
+		*x = vec4f_fromFloat4(p0[0], p1[0], p2[0], p3[0]);
+		*y = vec4f_fromFloat4(p0[1], p1[1], p2[1], p3[1]);
+	} else {
+		const vec4i xy = swrLoadPos16x2(src, stride);
+		if (format == SWR_FORMAT_2US) {
+			*x = vec4f_fromVec4i(vec4i_and(xy, vec4i_fromInt(0xFFFF)));
+			*y = vec4f_fromVec4i(vec4i_slr(xy, 16));
+		} else if (format == SWR_FORMAT_2S) {
+			*x = vec4f_fromVec4i(vec4i_sar(vec4i_sal(xy, 16), 16));
+			*y = vec4f_fromVec4i(vec4i_sar(xy, 16));
+		} else {
+			*x = swrHalfToFloat4(xy);
+			*y = swrHalfToFloat4(vec4i_slr(xy, 16));
+		}
+	}
+}
+
+static __forceinline void swrTransformPosStrided_internal(uint32_t n, const uint8_t* src, uint32_t stride, int32_t* dst, const float* mtx, uint32_t format)
+{
+	const vec4f m0 = vec4f_fromFloat(mtx[0]);
+	const vec4f m1 = vec4f_fromFloat(mtx[1]);
+	const vec4f m2 = vec4f_fromFloat(mtx[2]);
+	const vec4f m3 = vec4f_fromFloat(mtx[3]);
+	const vec4f m4 = vec4f_fromFloat(mtx[4]);
+	const vec4f m5 = vec4f_fromFloat(mtx[5]);
+	const vec4f vminCoord = vec4f_fromFloat(-(float)SWR_MAX_VERTEX_COORD);
+	const vec4f vmaxCoord = vec4f_fromFloat((float)SWR_MAX_VERTEX_COORD);
+
+	// The last 1 to 3 positions are copied to a zero padded local buffer and go 
+	// through the same loop as the rest.
+	const uint32_t posSize = format == SWR_FORMAT_2F ? 8 : 4;
+	const uint32_t rem = n & 3;
+	uint8_t remSrc[32];
+	int32_t remDst[8];
+	if (rem != 0) {
+		core_memSet(remSrc, 0, sizeof(remSrc));
+		for (uint32_t i = 0; i < rem; ++i) {
+			core_memCopy(&remSrc[i * posSize], &src[((n & ~3u) + i) * stride], posSize);
+		}
+	}
+
+	const uint32_t numIter = (n + 3) >> 2;
+	for (uint32_t i = 0; i < numIter; ++i) {
+		const bool isLast = rem != 0 && i == numIter - 1;
+
+		vec4f src_x0_x1_x2_x3, src_y0_y1_y2_y3;
+		if (isLast) {
+			swrLoadPos4(remSrc, posSize, format, &src_x0_x1_x2_x3, &src_y0_y1_y2_y3);
+		} else {
+			swrLoadPos4(src, stride, format, &src_x0_x1_x2_x3, &src_y0_y1_y2_y3);
+		}
+
+		const vec4f dst_x0_x1_x2_x3 = vec4f_min(vec4f_max(vec4f_madd(m0, src_x0_x1_x2_x3, vec4f_madd(m2, src_y0_y1_y2_y3, m4)), vminCoord), vmaxCoord);
+		const vec4f dst_y0_y1_y2_y3 = vec4f_min(vec4f_max(vec4f_madd(m1, src_x0_x1_x2_x3, vec4f_madd(m3, src_y0_y1_y2_y3, m5)), vminCoord), vmaxCoord);
+
+		const vec4f dst_x0_x1_y0_y1 = vec4f_shuffle(dst_x0_x1_x2_x3, dst_y0_y1_y2_y3, VEC4_SHUFFLE_XYXY);
+		const vec4f dst_x2_x3_y2_y3 = vec4f_shuffle(dst_x0_x1_x2_x3, dst_y0_y1_y2_y3, VEC4_SHUFFLE_ZWZW);
+
+		const vec4f dst_x0_y0_x1_y1 = vec4f_shuffle(dst_x0_x1_y0_y1, dst_x0_x1_y0_y1, VEC4_SHUFFLE_XZYW);
+		const vec4f dst_x2_y2_x3_y3 = vec4f_shuffle(dst_x2_x3_y2_y3, dst_x2_x3_y2_y3, VEC4_SHUFFLE_XZYW);
+
+		int32_t* d = isLast ? remDst : dst;
+		vec4i_toInt4vu(vec4i_fromVec4f(dst_x0_y0_x1_y1), &d[0]);
+		vec4i_toInt4vu(vec4i_fromVec4f(dst_x2_y2_x3_y3), &d[4]);
+
+		src += stride * 4;
+		dst += 8;
+	}
+
+	if (rem != 0) {
+		core_memCopy(dst - 8, remDst, sizeof(int32_t) * 2 * rem);
+	}
+}
+
+void swrTransformPos2fStridedTo2iSSE2(uint32_t n, const float* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	swrTransformPosStrided_internal(n, (const uint8_t*)pos, stride, posi, mtx, SWR_FORMAT_2F);
+}
+
+void swrTransformPos2usTo2iSSE2(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	swrTransformPosStrided_internal(n, (const uint8_t*)pos, stride, posi, mtx, SWR_FORMAT_2US);
+}
+
+void swrTransformPos2sTo2iSSE2(uint32_t n, const int16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	swrTransformPosStrided_internal(n, (const uint8_t*)pos, stride, posi, mtx, SWR_FORMAT_2S);
+}
+
+void swrTransformPos2hTo2iSSE2(uint32_t n, const uint16_t* pos, uint32_t stride, int32_t* posi, const float* mtx)
+{
+	swrTransformPosStrided_internal(n, (const uint8_t*)pos, stride, posi, mtx, SWR_FORMAT_2H);
+}
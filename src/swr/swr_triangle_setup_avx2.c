@@ -0,0 +1,129 @@
+#include "swr.h"
+#include "swr_p.h"
+#include "../core/math.h"
+
+#define SWR_VEC_MATH_AVX2
+#include "swr_vec_math.h"
+
+uint32_t swrSetupTrianglesAVX2(uint32_t numTriangles, const uint16_t* indices, const int32_t* posi, uint32_t w, uint32_t h, int32_t sampleExtent, uint16_t* visibleIndices, uint32_t* clipTriangles, uint32_t* numClipTriangles)
+{
+	const vec8i vzero = vec8i_zero();
+	const vec8i vallOnes = vec8i_fromInt(-1);
+	const vec8i vmaxExtent = vec8i_fromInt((1 << 15) - 1);
+	const vec8i vbboxMinBias = vec8i_fromInt((1 << SWR_CONFIG_SUBPIXEL_BITS) - 1 - sampleExtent);
+	const vec8i vbboxMaxBias = vec8i_fromInt(sampleExtent);
+	const vec8i vscreenMaxX = vec8i_fromInt((int32_t)w - 1);
+	const vec8i vscreenMaxY = vec8i_fromInt((int32_t)h - 1);
+	const vec8i vguardBandMin = vec8i_fromInt(-(SWR_CONFIG_GUARD_BAND_SIZE << SWR_CONFIG_SUBPIXEL_BITS));
+	const vec8i vguardBandMaxX = vec8i_fromInt(((int32_t)w + SWR_CONFIG_GUARD_BAND_SIZE) << SWR_CONFIG_SUBPIXEL_BITS);
+	const vec8i vguardBandMaxY = vec8i_fromInt(((int32_t)h + SWR_CONFIG_GUARD_BAND_SIZE) << SWR_CONFIG_SUBPIXEL_BITS);
+
+	uint32_t numVisible = 0;
+	uint32_t numClip = 0;
+	for (uint32_t iTri = 0; iTri < numTriangles; iTri += 8) {
+		const uint32_t n = core_minu32(numTriangles - iTri, 8);
+
+		// Gather vertex positions of 8 triangles. Lanes past the end of the index buffer 
+		// duplicate the first triangle and are masked out below.
+		const int32_t* v0[8];
+		const int32_t* v1[8];
+		const int32_t* v2[8];
+		for (uint32_t i = 0; i < 8; ++i) {
+			const uint16_t* tri = &indices[(i < n ? i : 0) * 3];
+			v0[i] = &posi[tri[0] * 2];
+			v1[i] = &posi[tri[1] * 2];
+			v2[i] = &posi[tri[2] * 2];
+		}
+
+		const vec8i x0 = vec8i_fromInt8(v0[0][0], v0[1][0], v0[2][0], v0[3][0], v0[4][0], v0[5][0], v0[6][0], v0[7][0]);
+		const vec8i y0 = vec8i_fromInt8(v0[0][1], v0[1][1], v0[2][1], v0[3][1], v0[4][1], v0[5][1], v0[6][1], v0[7][1]);
+		const vec8i x1 = vec8i_fromInt8(v1[0][0], v1[1][0], v1[2][0], v1[3][0], v1[4][0], v1[5][0], v1[6][0], v1[7][0]);
+		const vec8i y1 = vec8i_fromInt8(v1[0][1], v1[1][1], v1[2][1], v1[3][1], v1[4][1], v1[5][1], v1[6][1], v1[7][1]);
+		const vec8i x2 = vec8i_fromInt8(v2[0][0], v2[1][0], v2[2][0], v2[3][0], v2[4][0], v2[5][0], v2[6][0], v2[7][0]);
+		const vec8i y2 = vec8i_fromInt8(v2[0][1], v2[1][1], v2[2][1], v2[3][1], v2[4][1], v2[5][1], v2[6][1], v2[7][1]);
+
+		const vec8i triMinX = vec8i_min(x0, vec8i_min(x1, x2));
+		const vec8i triMinY = vec8i_min(y0, vec8i_min(y1, y2));
+		const vec8i triMaxX = vec8i_max(x0, vec8i_max(x1, x2));
+		const vec8i triMaxY = vec8i_max(y0, vec8i_max(y1, y2));
+
+		// Triangles extending past the guard band must be clipped.
+		const vec8i needsClip = vec8i_or(
+			vec8i_or(vec8i_sub(triMinX, vguardBandMin), vec8i_sub(triMinY, vguardBandMin)),
+			vec8i_or(vec8i_sub(vguardBandMaxX, triMaxX), vec8i_sub(vguardBandMaxY, triMaxY))
+		);
+
+		// The area only fits in 32 bits if the triangle's extents are less than 2^15 sub-pixels. 
+		// The area of larger triangles is recomputed in 64 bits below.
+		const vec8i areaIsValid = vec8i_xor(vec8i_sar(vec8i_or(
+			vec8i_sub(vmaxExtent, vec8i_sub(triMaxX, triMinX)),
+			vec8i_sub(vmaxExtent, vec8i_sub(triMaxY, triMinY))
+		), 31), vallOnes);
+
+		const vec8i iarea = vec8i_sub(
+			vec8i_mullo(vec8i_sub(x0, x2), vec8i_sub(y1, y0)),
+			vec8i_mullo(vec8i_sub(x1, x0), vec8i_sub(y0, y2))
+		);
+
+		const vec8i bboxMinX = vec8i_max(vec8i_sar(vec8i_add(triMinX, vbboxMinBias), SWR_CONFIG_SUBPIXEL_BITS), vzero);
+		const vec8i bboxMinY = vec8i_max(vec8i_sar(vec8i_add(triMinY, vbboxMinBias), SWR_CONFIG_SUBPIXEL_BITS), vzero);
+		const vec8i bboxMaxX = vec8i_min(vec8i_sar(vec8i_add(triMaxX, vbboxMaxBias), SWR_CONFIG_SUBPIXEL_BITS), vscreenMaxX);
+		const vec8i bboxMaxY = vec8i_min(vec8i_sar(vec8i_add(triMaxY, vbboxMaxBias), SWR_CONFIG_SUBPIXEL_BITS), vscreenMaxY);
+
+		// Reject degenerate triangles and triangles whose clipped bounding box is empty 
+		// (min > max <=> max - min < 0).
+		const vec8i reject = vec8i_or3(
+			vec8i_andnot(needsClip, vec8i_and(vec8i_cmpeq(iarea, vzero), areaIsValid)),
+			vec8i_sub(bboxMaxX, bboxMinX),
+			vec8i_sub(bboxMaxY, bboxMinY)
+		);
+
+		const uint32_t visibleMask = ~vec8i_getSignMask(reject) & ((1u << n) - 1);
+		if (visibleMask != 0) {
+			const uint32_t cwMask = vec8i_getSignMask(iarea);
+			const uint32_t areaIsValidMask = vec8i_getSignMask(areaIsValid);
+			const uint32_t needsClipMask = vec8i_getSignMask(needsClip);
+			for (uint32_t i = 0; i < n; ++i) {
+				if ((visibleMask & (1u << i)) == 0) {
+					continue;
+				}
+
+				// Triangles extending past the guard band are emitted as is and clipped by the caller.
+				if ((needsClipMask & (1u << i)) != 0) {
+					const uint16_t* tri = &indices[i * 3];
+					clipTriangles[numClip++] = numVisible;
+					visibleIndices[0] = tri[0];
+					visibleIndices[1] = tri[1];
+					visibleIndices[2] = tri[2];
+					visibleIndices += 3;
+					++numVisible;
+					continue;
+				}
+
+				bool cw = (cwMask & (1u << i)) != 0;
+				if ((areaIsValidMask & (1u << i)) == 0) {
+					const int64_t iarea64 = (int64_t)(v0[i][0] - v2[i][0]) * (int64_t)(v1[i][1] - v0[i][1]) - (int64_t)(v1[i][0] - v0[i][0]) * (int64_t)(v0[i][1] - v2[i][1]);
+					if (iarea64 == 0) {
+						continue;
+					}
+
+					cw = iarea64 < 0;
+				}
+
+				// Emit the triangle in CCW order so the rasterizer never has to swap vertices.
+				const uint16_t* tri = &indices[i * 3];
+				visibleIndices[0] = tri[0];
+				visibleIndices[1] = cw ? tri[2] : tri[1];
+				visibleIndices[2] = cw ? tri[1] : tri[2];
+				visibleIndices += 3;
+				++numVisible;
+			}
+		}
+
+		indices += n * 3;
+	}
+
+	*numClipTriangles = numClip;
+
+	return numVisible;
+}
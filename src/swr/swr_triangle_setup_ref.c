@@ -0,0 +1,69 @@
+#include "swr.h"
+#include "swr_p.h"
+#include "../core/math.h"
+
+uint32_t swrSetupTrianglesRef(uint32_t numTriangles, const uint16_t* indices, const int32_t* posi, uint32_t w, uint32_t h, int32_t sampleExtent, uint16_t* visibleIndices, uint32_t* clipTriangles, uint32_t* numClipTriangles)
+{
+	const int32_t maxX = (int32_t)w - 1;
+	const int32_t maxY = (int32_t)h - 1;
+	const int32_t guardBandMinX = -(SWR_CONFIG_GUARD_BAND_SIZE << SWR_CONFIG_SUBPIXEL_BITS);
+	const int32_t guardBandMinY = -(SWR_CONFIG_GUARD_BAND_SIZE << SWR_CONFIG_SUBPIXEL_BITS);
+	const int32_t guardBandMaxX = ((int32_t)w + SWR_CONFIG_GUARD_BAND_SIZE) << SWR_CONFIG_SUBPIXEL_BITS;
+	const int32_t guardBandMaxY = ((int32_t)h + SWR_CONFIG_GUARD_BAND_SIZE) << SWR_CONFIG_SUBPIXEL_BITS;
+
+	uint32_t numVisible = 0;
+	uint32_t numClip = 0;
+	for (uint32_t iTri = 0; iTri < numTriangles; ++iTri) {
+		const uint16_t id0 = indices[0];
+		const uint16_t id1 = indices[1];
+		const uint16_t id2 = indices[2];
+		indices += 3;
+
+		const int32_t x0 = posi[id0 * 2 + 0];
+		const int32_t y0 = posi[id0 * 2 + 1];
+		const int32_t x1 = posi[id1 * 2 + 0];
+		const int32_t y1 = posi[id1 * 2 + 1];
+		const int32_t x2 = posi[id2 * 2 + 0];
+		const int32_t y2 = posi[id2 * 2 + 1];
+
+		const int32_t triMinX = core_min3i32(x0, x1, x2);
+		const int32_t triMinY = core_min3i32(y0, y1, y2);
+		const int32_t triMaxX = core_max3i32(x0, x1, x2);
+		const int32_t triMaxY = core_max3i32(y0, y1, y2);
+
+		const int32_t bboxMinX = core_maxi32(swrSubpixelCeil(triMinX - sampleExtent), 0);
+		const int32_t bboxMinY = core_maxi32(swrSubpixelCeil(triMinY - sampleExtent), 0);
+		const int32_t bboxMaxX = core_mini32(swrSubpixelFloor(triMaxX + sampleExtent), maxX);
+		const int32_t bboxMaxY = core_mini32(swrSubpixelFloor(triMaxY + sampleExtent), maxY);
+		if (bboxMinX > bboxMaxX || bboxMinY > bboxMaxY) {
+			continue;
+		}
+
+		// Triangles extending past the guard band are emitted as is and clipped by the caller.
+		if (triMinX < guardBandMinX || triMinY < guardBandMinY || triMaxX > guardBandMaxX || triMaxY > guardBandMaxY) {
+			clipTriangles[numClip++] = numVisible;
+			visibleIndices[0] = id0;
+			visibleIndices[1] = id1;
+			visibleIndices[2] = id2;
+			visibleIndices += 3;
+			++numVisible;
+			continue;
+		}
+
+		const int64_t iarea = (int64_t)(x0 - x2) * (int64_t)(y1 - y0) - (int64_t)(x1 - x0) * (int64_t)(y0 - y2);
+		if (iarea == 0) {
+			continue;
+		}
+
+		// Emit the triangle in CCW order so the rasterizer never has to swap vertices.
+		visibleIndices[0] = id0;
+		visibleIndices[1] = iarea < 0 ? id2 : id1;
+		visibleIndices[2] = iarea < 0 ? id1 : id2;
+		visibleIndices += 3;
+		++numVisible;
+	}
+
+	*numClipTriangles = numClip;
+
+	return numVisible;
+}
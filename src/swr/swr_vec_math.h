@@ -59,6 +59,7 @@ typedef struct vec8i
 static vec4f vec4f_zero(void);
 static vec4f vec4f_fromFloat(float x);
 static vec4f vec4f_fromVec4i(vec4i x);
+static vec4f vec4f_fromVec4i_bits(vec4i x);
 #if defined(SWR_VEC_MATH_AVX) || defined(SWR_VEC_MATH_AVX2)
 static vec4f vec4f_fromVec8f_low(vec8f x);
 static vec4f vec4f_fromVec8f_high(vec8f x);
@@ -66,11 +67,15 @@ static vec4f vec4f_fromVec8f_high(vec8f x);
 static vec4f vec4f_fromFloat4(float x0, float x1, float x2, float x3);
 static vec4f vec4f_fromFloat4va(const float* arr);
 static vec4f vec4f_fromFloat4vu(const float* arr);
+static void vec4f_toFloat4va(vec4f x, float* arr);
+static void vec4f_toFloat4vu(vec4f x, float* arr);
 static vec4f vec4f_fromRGBA8(uint32_t rgba8);
 static uint32_t vec4f_toRGBA8(vec4f x);
 static vec4f vec4f_add(vec4f a, vec4f b);
 static vec4f vec4f_sub(vec4f a, vec4f b);
 static vec4f vec4f_mul(vec4f a, vec4f b);
+static vec4f vec4f_min(vec4f a, vec4f b);
+static vec4f vec4f_max(vec4f a, vec4f b);
 static vec4f vec4f_floor(vec4f x);
 static vec4f vec4f_ceil(vec4f x);
 static vec4f vec4f_madd(vec4f a, vec4f b, vec4f c);
@@ -89,10 +94,16 @@ static vec4f vec4f_getZWZW(vec4f x);
 static vec4i vec4i_zero(void);
 static vec4i vec4i_fromInt(int32_t x);
 static vec4i vec4i_fromVec4f(vec4f x);
+static vec4i vec4i_fromVec4f_trunc(vec4f x);
 static vec4i vec4i_fromInt4(int32_t x0, int32_t x1, int32_t x2, int32_t x3);
 static vec4i vec4i_fromInt4va(const int32_t* arr);
+static vec4i vec4i_fromInt4vu(const int32_t* arr);
+static vec4i vec4i_fromUint16x4vu(const uint16_t* arr);
+static vec4i vec4i_fromUint8x4vu(const uint8_t* arr);
 static void vec4i_toInt4vu(vec4i x, int32_t* arr);
+static void vec4i_toUint16x8vu(vec4i a, vec4i b, uint16_t* arr);
 static void vec4i_toInt4va(vec4i x, int32_t* arr);
+static void vec4i_toInt4va_stream(vec4i x, int32_t* arr);
 static void vec4i_toInt4va_masked(vec4i x, vec4i mask, int32_t* buffer);
 static void vec4i_toInt4va_maskedInv(vec4i x, vec4i maskInv, int32_t* buffer);
 static void vec4i_toInt4vu_maskedInv(vec4i x, vec4i maskInv, int32_t* buffer);
@@ -109,7 +120,17 @@ static vec4i vec4i_sar(vec4i x, uint32_t shift);
 static vec4i vec4i_sal(vec4i x, uint32_t shift);
 static vec4i vec4i_slr(vec4i x, uint32_t shift);
 static vec4i vec4i_cmplt(vec4i a, vec4i b);
+static vec4i vec4i_cmpeq(vec4i a, vec4i b);
+static vec4i vec4i_min(vec4i a, vec4i b);
+static vec4i vec4i_max(vec4i a, vec4i b);
 static vec4i vec4i_packR32G32B32A32_to_RGBA8(vec4i r, vec4i g, vec4i b, vec4i a);
+static vec4i vec4i_blendSrcOverRGBA8(vec4i src, vec4i dst);
+static vec4i vec4i_blendAddRGBA8(vec4i src, vec4i dst);
+static vec4i vec4i_blendMulRGBA8(vec4i src, vec4i dst);
+static vec4i vec4i_bilerpRGBA8(vec4i c00, vec4i c10, vec4i c01, vec4i c11, vec4i fx, vec4i fy);
+static vec4i vec4i_gather(const int32_t* base, vec4i index);
+static vec4i vec4i_evenLanes(vec4i a, vec4i b);
+static vec4i vec4i_oddLanes(vec4i a, vec4i b);
 static bool vec4i_anyNegative(vec4i x);
 static bool vec4i_allNegative(vec4i x);
 static uint32_t vec4i_getSignMask(vec4i x);
@@ -123,12 +144,21 @@ static int32_t vec4i_getW(vec4i a);
 static vec8f vec8f_zero(void);
 static vec8f vec8f_fromFloat(float x);
 static vec8f vec8f_fromVec8i(vec8i x);
+static vec8f vec8f_fromInt16x8(vec4i x);
+static vec8f vec8f_fromUint16x8(vec4i x);
+#if defined(SWR_VEC_MATH_F16C)
+static vec8f vec8f_fromHalf8(vec4i x);
+#endif
 static vec8f vec8f_fromFloat8(float x0, float x1, float x2, float x3, float x4, float x5, float x6, float x7);
 static vec8f vec8f_fromFloat8va(const float* arr);
 static vec8f vec8f_fromFloat8vu(const float* arr);
+static void vec8f_toFloat8va(vec8f x, float* arr);
+static void vec8f_toFloat8vu(vec8f x, float* arr);
 static vec8f vec8f_add(vec8f a, vec8f b);
 static vec8f vec8f_sub(vec8f a, vec8f b);
 static vec8f vec8f_mul(vec8f a, vec8f b);
+static vec8f vec8f_min(vec8f a, vec8f b);
+static vec8f vec8f_max(vec8f a, vec8f b);
 static vec8f vec8f_floor(vec8f x);
 static vec8f vec8f_ceil(vec8f x);
 static vec8f vec8f_madd(vec8f a, vec8f b, vec8f c);
@@ -136,10 +166,13 @@ static vec8f vec8f_madd(vec8f a, vec8f b, vec8f c);
 static vec8i vec8i_zero(void);
 static vec8i vec8i_fromInt(int32_t x);
 static vec8i vec8i_fromVec8f(vec8f x);
+static vec8i vec8i_fromVec8f_trunc(vec8f x);
 static vec8i vec8i_fromInt8(int32_t x0, int32_t x1, int32_t x2, int32_t x3, int32_t x4, int32_t x5, int32_t x6, int32_t x7);
 static vec8i vec8i_fromInt8va(const int32_t* arr);
+static vec8i vec8i_fromInt8vu(const int32_t* arr);
 static void vec8i_toInt8vu(vec8i x, int32_t* arr);
 static void vec8i_toInt8va(vec8i x, int32_t* arr);
+static void vec8i_toInt8va_stream(vec8i x, int32_t* arr);
 #if defined(SWR_VEC_MATH_AVX2)
 static void vec8i_toInt8va_masked(vec8i x, vec8i mask, int32_t* buffer);
 static void vec8i_toInt8va_maskedInv(vec8i x, vec8i maskInv, int32_t* buffer);
@@ -158,7 +191,16 @@ static vec8i vec8i_slr(vec8i x, uint32_t shift);
 static vec8i vec8i_sll(vec8i x, uint32_t shift);
 static vec8i vec8i_sllv(vec8i x, vec8i shift);
 static vec8i vec8i_cmpeq(vec8i a, vec8i b);
+static vec8i vec8i_min(vec8i a, vec8i b);
+static vec8i vec8i_max(vec8i a, vec8i b);
 static vec8i vec8i_packR32G32B32A32_to_RGBA8(vec8i r, vec8i g, vec8i b, vec8i a);
+static vec8i vec8i_blendSrcOverRGBA8(vec8i src, vec8i dst);
+static vec8i vec8i_blendAddRGBA8(vec8i src, vec8i dst);
+static vec8i vec8i_blendMulRGBA8(vec8i src, vec8i dst);
+static vec8i vec8i_bilerpRGBA8(vec8i c00, vec8i c10, vec8i c01, vec8i c11, vec8i fx, vec8i fy);
+static vec8i vec8i_gather(const int32_t* base, vec8i index);
+static vec8i vec8i_evenLanes(vec8i a, vec8i b);
+static vec8i vec8i_oddLanes(vec8i a, vec8i b);
 #endif
 static bool vec8i_anyNegative(vec8i x);
 static bool vec8i_allNegative(vec8i x);